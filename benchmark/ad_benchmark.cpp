@@ -60,10 +60,72 @@ static void BM_test1_fastad(benchmark::State& state)
         autodiff(expr);
         benchmark::DoNotOptimize(expr);
     }
+    state.SetItemsProcessed(state.iterations());
 }
 
 BENCHMARK(BM_test1_fastad);
 
+// FastAD with W scenarios evaluated in lock step (see ad::simd).
+// Items processed are scenarios, to compare throughput against BM_test1_fastad.
+template <size_t W>
+static void BM_test1_fastad_simd(benchmark::State& state)
+{
+    using namespace ad;
+    using pack_t = ad::simd<double, W>;
+    std::vector<Var<pack_t>> x;
+    for (size_t i = 0; i < 100; ++i) {
+        pack_t xi;
+        for (size_t k = 0; k < W; ++k) xi[k] = i / 100. + k * 1e-3;
+        x.emplace_back(xi);
+    }
+    std::vector<Var<pack_t>> w(3);
+    auto expr = ad::bind(
+                (w[0] = x[0] * x[1] - x[2] * sin(x[0]),
+                 w[1] = x[1] * w[0] - cos(w[0]) + 
+                        ad::sum(x.begin(), x.end(), [](const auto& xi) {return xi;}),
+                 w[2] = w[1] + ad::exp(w[1] - w[0])) 
+    );
+
+    for (auto _ : state) {
+        autodiff(expr);
+        benchmark::DoNotOptimize(expr);
+    }
+    state.SetItemsProcessed(state.iterations() * W);
+}
+
+BENCHMARK_TEMPLATE(BM_test1_fastad_simd, 4);
+BENCHMARK_TEMPLATE(BM_test1_fastad_simd, 8);
+
+// FastAD tape (recorded every iteration)
+static void BM_test1_fastad_tape(benchmark::State& state)
+{
+    using namespace ad;
+    std::vector<Var<double>> x;
+    for (size_t i = 0; i < 100; ++i) {
+        x.emplace_back(i / 100.);
+    }
+    Tape<double> tape;
+    std::vector<TapeVar<double>> tx(x.size());
+
+    for (auto _ : state) {
+        tape.clear();
+        for (size_t i = 0; i < x.size(); ++i) {
+            tx[i] = tape.var(x[i]);
+        }
+        auto sum = tx[0];
+        for (size_t i = 1; i < tx.size(); ++i) {
+            sum += tx[i];
+        }
+        auto w0 = tx[0] * tx[1] - tx[2] * sin(tx[0]);
+        auto w1 = tx[1] * w0 - cos(w0) + sum;
+        auto w2 = w1 + ad::exp(w1 - w0);
+        autodiff(w2);
+        benchmark::DoNotOptimize(x[0].get_adj());
+    }
+}
+
+BENCHMARK(BM_test1_fastad_tape);
+
 #ifdef USE_ADEPT
 
 // Adept
@@ -0,0 +1,44 @@
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/log_det.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <benchmark/benchmark.h>
+
+// Compares fixed-size (see ad::fixed_vec, ad::fixed_mat) and dynamic shapes
+// on a 3-factor model: sum(sin(A * x) * x) + log_det(A).
+
+template <class VecType, class MatType>
+static void run(benchmark::State& state, VecType& x, MatType& a)
+{
+    x.get() << 0.3, -1.2, 2.;
+    a.get() << 2, 0.5, 0.1,
+               0.5, 3, 0.2,
+               0.1, 0.2, 4;
+    auto expr = ad::bind(ad::sum(ad::sin(ad::dot(a, x)) * x) +
+                         ad::log_det<ad::LogDetLLT>(a));
+    for (auto _ : state) {
+        ad::autodiff(expr);
+        benchmark::DoNotOptimize(expr);
+    }
+}
+
+static void BM_fixed_3x3(benchmark::State& state)
+{
+    ad::Var<double, ad::fixed_vec<3>> x;
+    ad::Var<double, ad::fixed_mat<3, 3>> a;
+    run(state, x, a);
+}
+
+static void BM_dynamic_3x3(benchmark::State& state)
+{
+    ad::Var<double, ad::vec> x(3);
+    ad::Var<double, ad::mat> a(3, 3);
+    run(state, x, a);
+}
+
+BENCHMARK(BM_fixed_3x3);
+BENCHMARK(BM_dynamic_3x3);
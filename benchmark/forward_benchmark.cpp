@@ -0,0 +1,98 @@
+#include <fastad_bits/forward/core/forward.hpp>
+#include <fastad_bits/forward/core/forward_array.hpp>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+// Gradient of f(x) = sum_i sin(x_i) * x_{i+1} + exp(x_i / (1 + x_{i+1}^2))
+// using forward-mode AD with N tangent lanes.
+// Each pass propagates N directions, so a gradient of size n needs n/N passes.
+
+template <class T>
+static inline T f_test(const std::vector<T>& x)
+{
+    T out = 0.;
+    for (size_t i = 0; i + 1 < x.size(); ++i) {
+        out += ad::sin(x[i]) * x[i+1] + ad::exp(x[i] / (1. + x[i+1] * x[i+1]));
+    }
+    return out;
+}
+
+template <int N>
+static void BM_forward_lanes(benchmark::State& state)
+{
+    using fvar_t = ad::ForwardVar<double, N>;
+    const size_t n = state.range(0);
+    const size_t n_lanes = (N == Eigen::Dynamic) ? n : N;
+    std::vector<fvar_t> x(n);
+    std::vector<double> grad(n);
+
+    for (auto _ : state) {
+        for (size_t begin = 0; begin < n; begin += n_lanes) {
+            for (size_t i = 0; i < n; ++i) {
+                typename fvar_t::adjoint_type dir;
+                if constexpr (N == 1) {
+                    dir = (i == begin);
+                } else {
+                    if constexpr (N == Eigen::Dynamic) dir.resize(n_lanes);
+                    dir.setZero();
+                    if (begin <= i && i < begin + n_lanes) dir(i - begin) = 1;
+                }
+                x[i] = fvar_t(0.01 * i, dir);
+            }
+            fvar_t f = f_test(x);
+            for (size_t l = 0; l < n_lanes && begin + l < n; ++l) {
+                if constexpr (N == 1) {
+                    grad[begin + l] = f.get_adjoint();
+                } else {
+                    grad[begin + l] = f.get_adjoint()(l);
+                }
+            }
+        }
+        benchmark::DoNotOptimize(grad.data());
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_forward_lanes, 1)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_forward_lanes, 4)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_forward_lanes, 8)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_forward_lanes, 16)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_forward_lanes, Eigen::Dynamic)->Arg(16)->Arg(64);
+
+// Directional derivative of sum_i exp(-x_i^2 / 2) * sqrt(1 + x_i^2) over a vector
+// with one ForwardVar per element vs. one ForwardArray.
+
+template <class T>
+static inline auto g_test(const T& x)
+{
+    return ad::exp(-x * x / 2.) * ad::sqrt(1. + x * x);
+}
+
+static void BM_forward_elementwise_scalar(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    std::vector<ad::ForwardVar<double>> x(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = ad::ForwardVar<double>(1e-4 * i, 1.);
+    }
+    for (auto _ : state) {
+        ad::ForwardVar<double> out;
+        for (size_t i = 0; i < n; ++i) {
+            out += g_test(x[i]);
+        }
+        benchmark::DoNotOptimize(out);
+    }
+}
+
+static void BM_forward_elementwise_array(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    ad::ForwardArray<double> x(Eigen::VectorXd::LinSpaced(n, 0., 1e-4 * (n-1)),
+                               Eigen::VectorXd::Ones(n));
+    for (auto _ : state) {
+        auto out = ad::sum(g_test(x));
+        benchmark::DoNotOptimize(out);
+    }
+}
+
+BENCHMARK(BM_forward_elementwise_scalar)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_forward_elementwise_array)->Arg(1000)->Arg(10000);
@@ -0,0 +1,87 @@
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <benchmark/benchmark.h>
+
+// Compares the separate, interleaved, and forward cache layouts (see ad::layout).
+
+// Scalar graph: same expression as BM_test1_fastad in ad_benchmark
+// but with a larger number of scalar nodes.
+template <class Layout>
+static void BM_layout_scalar(benchmark::State& state)
+{
+    using namespace ad;
+    std::vector<Var<double>> x;
+    for (int i = 0; i < state.range(0); ++i) {
+        x.emplace_back(i / static_cast<double>(state.range(0)));
+    }
+    std::vector<Var<double>> w(3);
+    auto expr = ad::bind<Layout>(
+                (w[0] = x[0] * x[1] - x[2] * sin(x[0]),
+                 w[1] = x[1] * w[0] - cos(w[0]) + 
+                        ad::sum(x.begin(), x.end(), [](const auto& xi) {
+                            return ad::sin(xi) * xi + ad::exp(xi) * xi;
+                        }),
+                 w[2] = w[1] + ad::exp(w[1] - w[0])) 
+    );
+
+    for (auto _ : state) {
+        autodiff(expr);
+        benchmark::DoNotOptimize(expr);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_layout_scalar, ad::layout::separate)
+    -> RangeMultiplier(8) -> Range(8, 1 << 15);
+BENCHMARK_TEMPLATE(BM_layout_scalar, ad::layout::interleaved)
+    -> RangeMultiplier(8) -> Range(8, 1 << 15);
+
+// Vector graph: element-wise operations on a single vector variable.
+template <class Layout>
+static void BM_layout_vector(benchmark::State& state)
+{
+    using namespace ad;
+    Var<double, vec> x(state.range(0));
+    x.get().setRandom();
+    auto expr = ad::bind<Layout>(
+            ad::sum(ad::sin(x) * x + ad::exp(x) * x));
+
+    for (auto _ : state) {
+        autodiff(expr);
+        benchmark::DoNotOptimize(expr);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_layout_vector, ad::layout::separate)
+    -> RangeMultiplier(8) -> Range(8, 1 << 15);
+BENCHMARK_TEMPLATE(BM_layout_vector, ad::layout::interleaved)
+    -> RangeMultiplier(8) -> Range(8, 1 << 15);
+
+// Forward evaluation only, where layout::forward binds no adjoints at all
+// (see ad::bind_forward).
+template <class Layout>
+static void BM_layout_feval(benchmark::State& state)
+{
+    using namespace ad;
+    Var<double, vec> x(state.range(0));
+    x.get().setRandom();
+    auto expr = ad::bind<Layout>(
+            ad::sum(ad::sin(x) * x + ad::exp(x) * x));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(evaluate(expr));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_layout_feval, ad::layout::separate)
+    -> RangeMultiplier(8) -> Range(8, 1 << 15);
+BENCHMARK_TEMPLATE(BM_layout_feval, ad::layout::forward)
+    -> RangeMultiplier(8) -> Range(8, 1 << 15);
@@ -0,0 +1,93 @@
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/pow.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+
+// Compares double and float value types,
+// and float values with reductions accumulated in double (AccumType).
+// rel_err is the relative error of the value against a long double reference.
+
+static long double ld(double x) { return x; }
+
+template <class T>
+static std::vector<T> make_data(size_t n)
+{
+    std::vector<T> data(n);
+    for (size_t i = 0; i < n; ++i) {
+        data[i] = 1.3 + std::sin(0.1 * i) + 0.001 * (i % 1000);
+    }
+    return data;
+}
+
+// Normal log-likelihood (up to constants) of every observation, term by term.
+template <class T, class AccumType = void>
+static void BM_precision_likelihood(benchmark::State& state)
+{
+    using namespace ad;
+    const size_t n = state.range(0);
+    auto data = make_data<T>(n);
+    Var<T> mu(1.1), sigma(1.4);
+    auto expr = ad::bind(ad::sum<AccumType>(data.begin(), data.end(),
+                [&](T di) {
+                    return ad::pow<2>((di - mu) / sigma) * -0.5 - ad::log(sigma);
+                }));
+
+    T f = 0;
+    for (auto _ : state) {
+        f = ad::autodiff(expr);
+        benchmark::DoNotOptimize(expr);
+    }
+
+    long double ref = 0;
+    for (size_t i = 0; i < n; ++i) {
+        long double z = (data[i] - ld(mu.get())) / ld(sigma.get());
+        ref += -0.5L * z * z - std::log(ld(sigma.get()));
+    }
+    state.counters["rel_err"] = std::abs((f - ref) / ref);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(BM_precision_likelihood, double)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_precision_likelihood, float)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_precision_likelihood, float, double)->Arg(1000)->Arg(1000000);
+
+// Same likelihood on a vector variable, summed by a single vectorized reduction.
+template <class T, class AccumType = void>
+static void BM_precision_normal_vec(benchmark::State& state)
+{
+    using namespace ad;
+    const size_t n = state.range(0);
+    auto data = make_data<T>(n);
+    Var<T, vec> x(n);
+    Var<T> mu(1.1), sigma(1.4);
+    for (size_t i = 0; i < n; ++i) {
+        x.get(i, 0) = data[i];
+    }
+    auto expr = ad::bind(ad::sum<AccumType>(ad::pow<2>((x - mu) / sigma) * -0.5) -
+                         ad::log(sigma) * static_cast<T>(n));
+
+    T f = 0;
+    for (auto _ : state) {
+        f = ad::autodiff(expr);
+        benchmark::DoNotOptimize(expr);
+    }
+
+    long double ref = 0;
+    for (size_t i = 0; i < n; ++i) {
+        long double z = (data[i] - ld(mu.get())) / ld(sigma.get());
+        ref += -0.5L * z * z;
+    }
+    ref -= n * std::log(ld(sigma.get()));
+    state.counters["rel_err"] = std::abs((f - ref) / ref);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(BM_precision_normal_vec, double)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_precision_normal_vec, float)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_precision_normal_vec, float, double)->Arg(1000)->Arg(1000000);
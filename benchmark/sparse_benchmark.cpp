@@ -0,0 +1,78 @@
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/pow.hpp>
+#include <fastad_bits/reverse/core/sparse.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+// Compares sparse and dense design matrices (see ad::sparse)
+// on the least-squares loss sum((y - X * beta)^2)
+// with a 10000 x 200 design matrix with range(0) nonzeros per row.
+
+static constexpr size_t n_rows = 10000;
+static constexpr size_t n_cols = 200;
+
+static Eigen::SparseMatrix<double> make_design(size_t nnz_per_row)
+{
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (size_t i = 0; i < n_rows; ++i) {
+        for (size_t k = 0; k < nnz_per_row; ++k) {
+            size_t j = (i * 7 + k * 31) % n_cols;
+            triplets.emplace_back(i, j, 1. + 0.001 * (i % 97) - 0.01 * k);
+        }
+    }
+    Eigen::SparseMatrix<double> x(n_rows, n_cols);
+    x.setFromTriplets(triplets.begin(), triplets.end());
+    return x;
+}
+
+template <class DesignType>
+static void run(benchmark::State& state, const DesignType& x)
+{
+    using namespace ad;
+    Var<double, vec> beta(n_cols);
+    beta.get().setConstant(0.1);
+    Eigen::VectorXd y = Eigen::VectorXd::LinSpaced(n_rows, -1., 1.);
+    auto expr = ad::bind(ad::sum(ad::pow<2>(ad::constant(y) - ad::dot(x, beta))));
+
+    for (auto _ : state) {
+        autodiff(expr);
+        benchmark::DoNotOptimize(expr);
+    }
+    state.SetItemsProcessed(state.iterations() * n_rows);
+}
+
+static void BM_sparse_dot_constant(benchmark::State& state)
+{
+    auto x = make_design(state.range(0));
+    run(state, ad::constant_view(x));
+}
+
+static void BM_dense_dot_constant(benchmark::State& state)
+{
+    Eigen::MatrixXd x = make_design(state.range(0));
+    run(state, ad::constant(x));
+}
+
+static void BM_sparse_dot_var(benchmark::State& state)
+{
+    ad::Var<double, ad::sparse> x(make_design(state.range(0)));
+    run(state, x);
+}
+
+static void BM_dense_dot_var(benchmark::State& state)
+{
+    ad::Var<double, ad::mat> x(n_rows, n_cols);
+    x.get() = make_design(state.range(0));
+    run(state, x);
+}
+
+BENCHMARK(BM_sparse_dot_constant)->Arg(2)->Arg(10);
+BENCHMARK(BM_dense_dot_constant)->Arg(2)->Arg(10);
+BENCHMARK(BM_sparse_dot_var)->Arg(2)->Arg(10);
+BENCHMARK(BM_dense_dot_var)->Arg(2)->Arg(10);
@@ -3,6 +3,11 @@
 #include <fastad_bits/reverse/core/var.hpp>
 #include <fastad_bits/reverse/core/eval.hpp>
 #include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/fuse.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/map_sum.hpp>
+#include <fastad_bits/reverse/core/parallel_glue.hpp>
+#include <fastad_bits/reverse/core/parallel_sum.hpp>
 #include <fastad_bits/reverse/core/pow.hpp>
 #include <fastad_bits/reverse/core/sum.hpp>
 #include <benchmark/benchmark.h>
@@ -95,6 +100,158 @@ static void BM_sumnode_fastad_large_vectorized(benchmark::State& state)
 
 BENCHMARK(BM_sumnode_fastad_large_vectorized);
 
+// Normal log-likelihood (up to constants) over many observations,
+// summed serially (range(0) == 0) or in parallel with range(0) threads.
+static void BM_sumnode_fastad_likelihood(benchmark::State& state)
+{
+    using namespace ad;
+    constexpr size_t size = 100000;
+    std::vector<double> values(size);
+    for (size_t i = 0; i < size; ++i) {
+        values[i] = std::sin(0.1 * i);
+    }
+    Var<double> mu(0.1), sigma(1.3);
+    auto f = [&](double v) {
+        return (v - mu) * (v - mu) / (sigma * sigma) + ad::log(sigma);
+    };
+
+    size_t n_threads = state.range(0);
+    util::ThreadPool pool(std::max<size_t>(n_threads, 1));
+    auto run = [&](auto&& expr) {
+        for (auto _ : state) {
+            ad::autodiff(expr);
+            benchmark::DoNotOptimize(expr);
+        }
+    };
+    if (n_threads == 0) {
+        run(ad::bind_forward(ad::sum(values.begin(), values.end(), f)));
+    } else {
+        run(ad::bind(ad::parallel_sum(values.begin(), values.end(), f,
+                                      parallel_policy(pool))));
+    }
+}
+
+BENCHMARK(BM_sumnode_fastad_likelihood)->Arg(0)->Arg(1)->Arg(2)->Arg(4);
+
+// Same likelihood with a single term expression rebound for every observation.
+static void BM_sumnode_fastad_likelihood_map_sum(benchmark::State& state)
+{
+    using namespace ad;
+    constexpr size_t size = 100000;
+    std::vector<double> values(size);
+    for (size_t i = 0; i < size; ++i) {
+        values[i] = std::sin(0.1 * i);
+    }
+    Var<double> mu(0.1), sigma(1.3);
+    auto expr = ad::bind(ad::map_sum(size, [&](size_t i) {
+        return (values[i] - mu) * (values[i] - mu) / (sigma * sigma) + ad::log(sigma);
+    }));
+
+    for (auto _ : state) {
+        ad::autodiff(expr);
+        benchmark::DoNotOptimize(expr);
+    }
+}
+
+BENCHMARK(BM_sumnode_fastad_likelihood_map_sum);
+
+// Forward evaluation only of the same likelihood bound with layout::forward
+// with ad::sum (range(0) == 0) or ad::map_sum (range(0) == 1),
+// as in a line search where the gradient is not needed.
+static void BM_sumnode_fastad_likelihood_value(benchmark::State& state)
+{
+    using namespace ad;
+    constexpr size_t size = 100000;
+    std::vector<double> values(size);
+    for (size_t i = 0; i < size; ++i) {
+        values[i] = std::sin(0.1 * i);
+    }
+    Var<double> mu(0.1), sigma(1.3);
+    auto f = [&](double v) {
+        return (v - mu) * (v - mu) / (sigma * sigma) + ad::log(sigma);
+    };
+
+    auto run = [&](auto&& expr) {
+        for (auto _ : state) {
+            ad::evaluate(expr);
+            benchmark::DoNotOptimize(expr);
+        }
+    };
+    if (state.range(0) == 0) {
+        run(ad::bind(ad::sum(values.begin(), values.end(), f)));
+    } else {
+        run(ad::bind_forward(ad::map_sum(size, [&](size_t i) { return f(values[i]); })));
+    }
+}
+
+BENCHMARK(BM_sumnode_fastad_likelihood_value)->Arg(0)->Arg(1);
+
+// Four independent asset payoffs summed over paths, glued into a portfolio value,
+// evaluated serially (range(0) == 0) or with independent statements
+// in parallel on range(0) threads.
+static void BM_sumnode_fastad_portfolio(benchmark::State& state)
+{
+    using namespace ad;
+    constexpr size_t size = 50000;
+    Var<double, vec> z(size);
+    for (size_t i = 0; i < size; ++i) z.get(i, 0) = std::sin(0.1 * i);
+    Var<double> s1(1.), s2(1.1), s3(0.9), s4(1.2);
+    Var<double> p1, p2, p3, p4;
+    auto payoff = [&](const auto& s) {
+        return ad::sum(ad::exp(z * s) * ad::log(ad::exp(z) + s));
+    };
+    auto make_expr = [&]() {
+        return (p1 = payoff(s1), p2 = payoff(s2),
+                p3 = payoff(s3), p4 = payoff(s4),
+                p1 + p2 + p3 + p4);
+    };
+
+    size_t n_threads = state.range(0);
+    util::ThreadPool pool(std::max<size_t>(n_threads, 1));
+    auto run = [&](auto&& expr) {
+        for (auto _ : state) {
+            ad::autodiff(expr);
+            benchmark::DoNotOptimize(expr);
+        }
+    };
+    if (n_threads == 0) {
+        run(ad::bind(make_expr()));
+    } else {
+        run(ad::bind_parallel(make_expr(), pool));
+    }
+}
+
+BENCHMARK(BM_sumnode_fastad_portfolio)->Arg(0)->Arg(1)->Arg(2)->Arg(4);
+
+// Gaussian kernel on a large vector variable.
+// Arg(1) fuses the element-wise operations into a single node.
+static void BM_sumnode_fastad_large_vector_fused(benchmark::State& state)
+{
+    using namespace ad;
+    const size_t size = state.range(0);
+    Var<double, vec> x(size);
+    Var<double> mu(0.1), sigma(1.3);
+    for (size_t i = 0; i < size; ++i) {
+        x.get(i, 0) = std::sin(0.1 * i);
+    }
+
+    auto kernel = ad::exp(-0.5 * ad::pow<2>((x - mu) / sigma)) / sigma;
+    auto run = [&](auto expr) {
+        auto bound = ad::bind(ad::sum(expr));
+        for (auto _ : state) {
+            ad::autodiff(bound);
+            benchmark::DoNotOptimize(bound);
+        }
+    };
+    if (state.range(1)) run(ad::fuse(kernel));
+    else run(kernel);
+}
+
+BENCHMARK(BM_sumnode_fastad_large_vector_fused)
+    ->Args({1000, 0})->Args({1000, 1})
+    ->Args({100000, 0})->Args({100000, 1})
+    ->Args({1000000, 0})->Args({1000000, 1});
+
 #ifdef USE_ADEPT
 
 // Adept
@@ -1,4 +1,5 @@
 #include <fastad>
+#include <chrono>
 #include <iostream>
 
 enum class option_type {
@@ -56,18 +57,64 @@ int main()
     std::cout << call_price << std::endl;
     std::cout << S.get_adj() << std::endl;
 
-    // reset adjoints before differentiating again
-    S.reset_adj();
-    for (auto& c : cache) c.reset_adj();
-
     auto put_expr = ad::bind(
             black_scholes_option_price<option_type::put>(
                 S, K, sigma, tau, r, cache));
 
-    double put_price = ad::autodiff(put_expr);
+    // reset adjoints of S and the placeholders before differentiating again
+    double put_price = ad::autodiff(put_expr, ad::fresh);
 
     std::cout << put_price << std::endl;
     std::cout << S.get_adj() << std::endl;
 
+    // price and delta for many spot prices at once,
+    // where each worker thread builds its own copy of the expression
+    size_t n_spots = 1000;
+    Eigen::MatrixXd spots = Eigen::VectorXd::LinSpaced(n_spots, 50., 150.);
+    Eigen::MatrixXd results(n_spots, 2);
+    ad::batch_autodiff(
+            [&](auto& x, auto& w) {
+                return black_scholes_option_price<option_type::call>(
+                            x[0], K, sigma, tau, r, w);
+            }, spots, results);
+
+    std::cout << results.row(n_spots / 2) << std::endl;
+
+    // price and delta for 4 spot prices at once, one per lane of a pack,
+    // compared against pricing each spot with its own scalar expression
+    using pack_t = ad::simd<double, 4>;
+    double spots4[] = {90., 100., 110., 120.};
+    ad::Var<pack_t> S4(pack_t::load(spots4));
+    std::vector<ad::Var<pack_t>> cache4;
+    auto call4_expr = ad::bind(
+            black_scholes_option_price<option_type::call>(
+                S4, K, sigma, tau, r, cache4));
+
+    pack_t call4 = ad::autodiff(call4_expr, ad::fresh);
+    for (size_t i = 0; i < pack_t::size(); ++i) {
+        std::cout << call4[i] << ' ' << S4.get_adj()[i] << std::endl;
+    }
+
+    auto ns_per_scenario = [](auto&& f, size_t n_scenarios) {
+        constexpr size_t n_iter = 100000;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n_iter; ++i) f();
+        auto end = std::chrono::steady_clock::now();
+        std::chrono::duration<double, std::nano> elapsed = end - start;
+        return elapsed.count() / (n_iter * n_scenarios);
+    };
+
+    double scalar_ns = ns_per_scenario([&]() {
+        for (double spot : spots4) {
+            S.get() = spot;
+            ad::autodiff(call_expr, ad::fresh);
+        }
+    }, 4);
+    double pack_ns = ns_per_scenario([&]() {
+        ad::autodiff(call4_expr, ad::fresh);
+    }, 4);
+    std::cout << "scalar: " << scalar_ns << " ns/scenario, "
+              << "simd<double, 4>: " << pack_ns << " ns/scenario" << std::endl;
+
     return 0;
 }
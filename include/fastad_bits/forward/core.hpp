@@ -1,3 +1,4 @@
 #pragma once
 #include "core/dualnum.hpp"
 #include "core/forward.hpp"
+#include "core/forward_array.hpp"
@@ -5,13 +5,16 @@ namespace core {
 
 // Underlying data structure containing value and adjoint.
 // Represent value as "w" and adjoint as "df".
-// @tparam T    underlying data type (ex. double)
-template <class T>
+// @tparam T            underlying data type (ex. double)
+// @tparam AdjointType  adjoint data type (ex. double, or an array of directional derivatives).
+//                      Default is T.
+template <class T, class AdjointType = T>
 struct DualNum
 {
     using value_type = T;
+    using adjoint_type = AdjointType;
 
-    DualNum(T w, T df)
+    DualNum(T w, const AdjointType& df)
         : w_(w), df_(df)
     {}
 
@@ -30,24 +33,24 @@ struct DualNum
         return w_ = x;
     }
 
-    value_type& get_adjoint() 
+    adjoint_type& get_adjoint() 
     {
         return df_;
     }
 
-    const value_type& get_adjoint() const
+    const adjoint_type& get_adjoint() const
     {
         return df_;
     }
 
-    value_type& set_adjoint(value_type x) 
+    adjoint_type& set_adjoint(const adjoint_type& x) 
     {
         return df_ = x;
     }
 
 private:
     T w_;
-    T df_;   
+    AdjointType df_;   
 };
 
 } // namepsace core
@@ -1,103 +1,204 @@
 #pragma once
 #include <cmath>
+#include <type_traits>
+#include <Eigen/Core>
 #include <fastad_bits/forward/core/dualnum.hpp>
 
 // Forward-mode Automatic Differentiation
 
-// Unary function definition with function name "f" that operates on ADForward<T> variable x.
+// Unary function definition with function name "f" that operates on ADForward<T, N> variable x.
 // "first" represents code that computes the unary function on x value.
 // "second" represents code that computes the directional derivative of unary function on x value.
 // The variadic arguments are optional and represent code to be placed before executing
 // "first" and "second" for optimization purposes.
+// "second" is linear in x.get_adjoint() and hence is computed on all tangent lanes at once.
 // @tparam  T   underlying data type for x.
+// @tparam  N   number of tangent lanes
 // @param   x   variable to apply unary function to
-// @return a new ADForward<T> with value and adjoint as the mathematical values for f(x), f'(x) * x'.
+// @return a new ADForward<T, N> with value and adjoint as the mathematical values for f(x), f'(x) * x'.
 //
 // Example generation with no variadic arguments:
 //
 // FORWARD_UNARY_FUNC(sin, std::sin(x.get_value()), std::cos(x.get_value()) * x.get_adjoint())
 // =>
-// template <class T> 
-// inline auto sin(const ad::core::ADForward<T>& x) 
+// template <class T, int N> 
+// inline auto sin(const ad::core::ADForward<T, N>& x) 
 // { 
-//      return ad::core::ADForward<T>(std::sin(x.get_value()), std::cos(x.get_value()) * x.get_adjoint()); 
+//      return ad::core::ADForward<T, N>(std::sin(x.get_value()), std::cos(x.get_value()) * x.get_adjoint()); 
 // } 
 //
 // Example generation with variadic arguments:
 //
 // FORWARD_UNARY_FUNC(exp, tmp, tmp * x.get_adjoint(), auto tmp = std::exp(x.get_value());)
 // =>
-// template <class T> 
-// inline auto exp(const ad::core::ADForward<T>& x) 
+// template <class T, int N> 
+// inline auto exp(const ad::core::ADForward<T, N>& x) 
 // { 
 //      auto tmp = std::exp(x.get_value());
-//      return ad::core::ADForward<T>(tmp, tmp * x.get_adjoint()); 
+//      return ad::core::ADForward<T, N>(tmp, tmp * x.get_adjoint()); 
 // } 
 //
 // Note that we only compute std::exp(x.get_value()) once and reuse to compute both "first" and "second".
 #define FORWARD_UNARY_FUNC(f, first, second, ...) \
-template <class T> \
-inline auto f(const ad::core::ADForward<T>& x) \
+template <class T, int N> \
+inline auto f(const ad::core::ADForward<T, N>& x) \
 { \
 	__VA_ARGS__ \
-	return ad::core::ADForward<T>(first, second); \
+	return ad::core::ADForward<T, N>(first, second); \
 } \
 
-// Binary function definition with function name "f" that operates on ADForward<T> variables x, y.
+// Binary function definition with function name "f" that operates on ADForward<T, N> variables x, y.
 // "first" represents code that computes the binary function on x, y values.
 // "second" represents code that computes the directional derivative of binary function on x, y values
 // in the direction of (x.get_adjoint(), y.get_adjoint()).
-// The variadic arguments are optional and represent code to be placed before executing
-// "first" and "second" for optimization purposes.
 // @tparam  T   underlying data type for x.
+// @tparam  N   number of tangent lanes
 // @param   x   one of the variables to apply binary function to
 // @param   y   other variable to apply binary function to
-// @return a new ADForward<T> with value and adjoint as the mathematical values for f(x, y), f'(x, y) * (x', y').
+// @return a new ADForward<T, N> with value and adjoint as the mathematical values for f(x, y), f'(x, y) * (x', y').
 //
-// Example generation with no variadic arguments:
+// Example generation:
 //
 // FORWARD_BINARY_FUNC(operator+, x.get_value() + y.get_value(), x.get_adjoint() + y.get_adjoint())
 // =>
-// template <class T>
-// inline auto operator+(const ad::core::ADForward<T>& x, ad::core::ADForward<T>& y)
+// template <class T, int N>
+// inline auto operator+(const ad::core::ADForward<T, N>& x, const ad::core::ADForward<T, N>& y)
 // {
-//      return ad::core::ADForward<T>(x.get_value() + y.get_value(), x.get_adjoint() + y.get_adjoint());
+//      return ad::core::ADForward<T, N>(x.get_value() + y.get_value(), x.get_adjoint() + y.get_adjoint());
 // }
+//
+// If N is Eigen::Dynamic, an operand with no lanes is a constant
+// and the corresponding overload with an arithmetic constant is used instead.
 #define FORWARD_BINARY_FUNC(f, first, second) \
-template <class T> \
-inline auto f(const ad::core::ADForward<T>& x, const ad::core::ADForward<T>& y) \
+template <class T, int N> \
+inline auto f(const ad::core::ADForward<T, N>& x, const ad::core::ADForward<T, N>& y) \
 { \
-	return ad::core::ADForward<T>(first, second); \
+	if constexpr (N == Eigen::Dynamic) { \
+		if (x.get_adjoint().size() == 0) return f(x.get_value(), y); \
+		if (y.get_adjoint().size() == 0) return f(x, y.get_value()); \
+	} \
+	return ad::core::ADForward<T, N>(first, second); \
+} \
+
+// Binary function definitions with function name "f" where one of the operands is an arithmetic constant.
+// The constant is converted to T and named x (FORWARD_LSCALAR_FUNC) or y (FORWARD_RSCALAR_FUNC)
+// while the other operand is an ADForward<T, N> variable.
+// "first" and "second" are as in FORWARD_BINARY_FUNC, where the constant has no adjoint.
+// Constants are never promoted to ADForward<T, N> since the number of lanes may only be known at runtime.
+#define FORWARD_LSCALAR_FUNC(f, first, second) \
+template <class U, class T, int N \
+        , class = std::enable_if_t<std::is_arithmetic_v<U>> > \
+inline auto f(U c, const ad::core::ADForward<T, N>& y) \
+{ \
+	const T x = static_cast<T>(c); \
+	return ad::core::ADForward<T, N>(first, second); \
+} \
+
+#define FORWARD_RSCALAR_FUNC(f, first, second) \
+template <class T, int N, class U \
+        , class = std::enable_if_t<std::is_arithmetic_v<U>> > \
+inline auto f(const ad::core::ADForward<T, N>& x, U c) \
+{ \
+	const T y = static_cast<T>(c); \
+	return ad::core::ADForward<T, N>(first, second); \
+} \
+
+// Comparison operator definition with name "f" that compares the values of ADForward<T, N> variables.
+// Adjoints do not participate in comparisons.
+// Overloads where one of x, y is an arithmetic constant are also generated.
+#define FORWARD_COMPARISON_FUNC(f, op) \
+template <class T, int N> \
+inline bool f(const ad::core::ADForward<T, N>& x, const ad::core::ADForward<T, N>& y) \
+{ \
+	return x.get_value() op y.get_value(); \
+} \
+template <class T, int N, class U \
+        , class = std::enable_if_t<std::is_arithmetic_v<U>> > \
+inline bool f(const ad::core::ADForward<T, N>& x, U y) \
+{ \
+	return x.get_value() op y; \
+} \
+template <class U, class T, int N \
+        , class = std::enable_if_t<std::is_arithmetic_v<U>> > \
+inline bool f(U x, const ad::core::ADForward<T, N>& y) \
+{ \
+	return x op y.get_value(); \
 } \
 
 namespace ad {
 namespace core {
 
+namespace details {
+
+template <class T, int N>
+struct forward_tangent
+{
+    using type = Eigen::Array<T, N, 1>;
+};
+
+template <class T>
+struct forward_tangent<T, 1>
+{
+    using type = T;
+};
+
+} // namespace details
+
 // Forward variable to store value and adjoint.
 // If x is an ADForward variable that is a result of composing functions of ADForward variables x1,...,xn
 // x.get_value() is the value of the function on these variables and x.get_adjoint() is the adjoint, i.e.
 // directional (total) derivative of the composed functions in the direction of x1.get_adjoint(),...,xn.get_adjoint()
-template <class T>
-struct ADForward : public core::DualNum<T>
+//
+// With N > 1 tangent lanes, the adjoint is an Eigen array of N directional derivatives,
+// one for each of N directions, so that one pass propagates all N directions.
+// Lane-wise operations are vectorized by Eigen.
+// If N is Eigen::Dynamic, the number of lanes is set at runtime by the adjoints of the inputs,
+// and all ADForward operands of an operation must have the same number of lanes,
+// except for constants (e.g. default-constructed or constructed from a value only) which have no lanes.
+// @tparam  T   underlying data type
+// @tparam  N   number of tangent lanes (default 1, in which case the adjoint is a T)
+template <class T, int N = 1>
+struct ADForward : public core::DualNum<T, typename details::forward_tangent<T, N>::type>
 {
-    using data_t = core::DualNum<T>;
+    using data_t = core::DualNum<T, typename details::forward_tangent<T, N>::type>;
+    using typename data_t::adjoint_type;
+    static constexpr int n_lanes = N;
 
     ADForward()
-        : data_t(0, 0)
+        : data_t(0, zero_adjoint())
+    {}
+
+    ADForward(T w)
+        : data_t(w, zero_adjoint())
     {}
 
-    ADForward(T w, T df = 0)
+    ADForward(T w, const adjoint_type& df)
         : data_t(w, df)
     {}
 
     ADForward& operator+=(const ADForward& x);
+    ADForward& operator-=(const ADForward& x);
+    ADForward& operator*=(const ADForward& x);
+    ADForward& operator/=(const ADForward& x);
+
+private:
+    static adjoint_type zero_adjoint()
+    {
+        if constexpr (N == 1) {
+            return 0;
+        } else if constexpr (N == Eigen::Dynamic) {
+            return adjoint_type();
+        } else {
+            return adjoint_type::Zero();
+        }
+    }
 };
 
 } // namespace core
 
 // user-exposed forward variable alias 
-template <class T>
-using ForwardVar = core::ADForward<T>;
+template <class T, int N = 1>
+using ForwardVar = core::ADForward<T, N>;
 
 //================================================================================
 
@@ -134,7 +235,7 @@ FORWARD_UNARY_FUNC(sqrt, tmp, x.get_adjoint() / (2 * tmp),
         auto tmp = std::sqrt(x.get_value());)
 // ad::erf(core::ADForward)
 FORWARD_UNARY_FUNC(erf, std::erf(x.get_value()), 
-        two_over_sqrt_pi * std::exp(-t_sq), 
+        static_cast<T>(two_over_sqrt_pi * std::exp(-t_sq)) * x.get_adjoint(), 
         static constexpr double two_over_sqrt_pi =
                 1.1283791670955126;
         auto t_sq = x.get_value() * x.get_value();)
@@ -158,12 +259,112 @@ FORWARD_BINARY_FUNC(operator*, x.get_value() * y.get_value(),
 FORWARD_BINARY_FUNC(operator/, x.get_value() / y.get_value(), 
         (x.get_adjoint() * y.get_value() - x.get_value() * y.get_adjoint()) / (y.get_value() * y.get_value()))
 
+// Operations with arithmetic constants
+FORWARD_LSCALAR_FUNC(operator+, x + y.get_value(), y.get_adjoint())
+FORWARD_RSCALAR_FUNC(operator+, x.get_value() + y, x.get_adjoint())
+FORWARD_LSCALAR_FUNC(operator-, x - y.get_value(), -y.get_adjoint())
+FORWARD_RSCALAR_FUNC(operator-, x.get_value() - y, x.get_adjoint())
+FORWARD_LSCALAR_FUNC(operator*, x * y.get_value(), x * y.get_adjoint())
+FORWARD_RSCALAR_FUNC(operator*, x.get_value() * y, x.get_adjoint() * y)
+FORWARD_LSCALAR_FUNC(operator/, x / y.get_value(), 
+        -x * y.get_adjoint() / (y.get_value() * y.get_value()))
+FORWARD_RSCALAR_FUNC(operator/, x.get_value() / y, x.get_adjoint() / y)
+
+// Comparison operators (values only)
+FORWARD_COMPARISON_FUNC(operator==, ==)
+FORWARD_COMPARISON_FUNC(operator!=, !=)
+FORWARD_COMPARISON_FUNC(operator<, <)
+FORWARD_COMPARISON_FUNC(operator<=, <=)
+FORWARD_COMPARISON_FUNC(operator>, >)
+FORWARD_COMPARISON_FUNC(operator>=, >=)
+
 // Add current forward variable with x and update current variable with the result.
-template <class T>
-inline ADForward<T>& ADForward<T>::operator+=(const ADForward<T>& x)
+template <class T, int N>
+inline ADForward<T, N>& ADForward<T, N>::operator+=(const ADForward<T, N>& x)
 {
     return *this = *this + x;
 }
 
+// Subtract x from current forward variable and update current variable with the result.
+template <class T, int N>
+inline ADForward<T, N>& ADForward<T, N>::operator-=(const ADForward<T, N>& x)
+{
+    return *this = *this - x;
+}
+
+// Multiply current forward variable with x and update current variable with the result.
+template <class T, int N>
+inline ADForward<T, N>& ADForward<T, N>::operator*=(const ADForward<T, N>& x)
+{
+    return *this = *this * x;
+}
+
+// Divide current forward variable by x and update current variable with the result.
+template <class T, int N>
+inline ADForward<T, N>& ADForward<T, N>::operator/=(const ADForward<T, N>& x)
+{
+    return *this = *this / x;
+}
+
+// Expose unary functions for argument-dependent lookup.
+// This is needed when ADForward is used as the value type of reverse-mode expressions,
+// where these functions are called unqualified from namespace core and from Eigen.
+using ad::operator-;
+using ad::sin;
+using ad::cos;
+using ad::tan;
+using ad::asin;
+using ad::acos;
+using ad::atan;
+using ad::exp;
+using ad::log;
+using ad::sqrt;
+using ad::erf;
+
 } // namespace core
 } // namespace ad
+
+namespace Eigen {
+
+// Allows Eigen matrices and arrays of forward variables,
+// i.e. ad::Var<ad::ForwardVar<T>, ad::vec> and reverse-mode expressions of such variables.
+template <class T, int N>
+struct NumTraits<ad::core::ADForward<T, N>> : NumTraits<T>
+{
+    using Real = ad::core::ADForward<T, N>;
+    using NonInteger = ad::core::ADForward<T, N>;
+    using Nested = ad::core::ADForward<T, N>;
+    using Literal = ad::core::ADForward<T, N>;
+
+    enum {
+        IsComplex = 0,
+        IsInteger = 0,
+        IsSigned = 1,
+        RequireInitialization = 1,
+        ReadCost = (N == Eigen::Dynamic ? Eigen::HugeCost : (N + 1) * NumTraits<T>::ReadCost),
+        AddCost = (N == Eigen::Dynamic ? Eigen::HugeCost : (N + 1) * NumTraits<T>::AddCost),
+        MulCost = (N == Eigen::Dynamic ? Eigen::HugeCost :
+                   (2 * N + 1) * NumTraits<T>::MulCost + N * NumTraits<T>::AddCost)
+    };
+};
+
+// Allows mixing forward variables and their underlying data type in Eigen expressions.
+template <class T, int N>
+struct ScalarBinaryOpTraits<ad::core::ADForward<T, N>, T>
+{
+    using ReturnType = ad::core::ADForward<T, N>;
+};
+
+template <class T, int N>
+struct ScalarBinaryOpTraits<T, ad::core::ADForward<T, N>>
+{
+    using ReturnType = ad::core::ADForward<T, N>;
+};
+
+} // namespace Eigen
+
+#undef FORWARD_UNARY_FUNC
+#undef FORWARD_BINARY_FUNC
+#undef FORWARD_LSCALAR_FUNC
+#undef FORWARD_RSCALAR_FUNC
+#undef FORWARD_COMPARISON_FUNC
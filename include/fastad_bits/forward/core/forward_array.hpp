@@ -0,0 +1,308 @@
+#pragma once
+#include <cassert>
+#include <type_traits>
+#include <utility>
+#include <fastad_bits/forward/core/forward.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/util/shape_traits.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/value.hpp>
+#include <Eigen/Core>
+
+// Forward-mode Automatic Differentiation on vectors and matrices
+
+// Unary function definition with function name "f" that operates on ADForwardArray<T, S> variable x.
+// The function is applied element-wise using the functor "functor" of reverse/core/unary.hpp
+// (see details::forward_array_unary).
+// @tparam  XType   ADForwardArray<T, S> (possibly an rvalue, whose storage is then reused)
+// @param   x       variable to apply unary function to
+// @return a new ADForwardArray<T, S> with values f(x) and tangents f'(x) * x'.
+#define FORWARD_ARRAY_UNARY_FUNC(f, functor) \
+template <class XType \
+        , class = std::enable_if_t<ad::core::is_forward_array_v<XType>> > \
+inline auto f(XType&& x) \
+{ \
+	return ad::core::details::forward_array_unary<ad::core::functor>( \
+			std::forward<XType>(x)); \
+} \
+
+// Binary function definition with function name "f" that operates on ADForwardArray<T, S> variables x, y
+// of the same dimensions, or where one of x, y is an arithmetic constant.
+// The function is applied element-wise using the functor "functor" of reverse/core/binary.hpp
+// (see details::forward_array_binary).
+// @tparam  XType   ADForwardArray<T, S> or arithmetic type
+// @tparam  YType   ADForwardArray<T, S> or arithmetic type
+// @param   x       one of the variables to apply binary function to
+// @param   y       other variable to apply binary function to
+// @return a new ADForwardArray<T, S> with values f(x, y) and tangents f'(x, y) * (x', y').
+#define FORWARD_ARRAY_BINARY_FUNC(f, functor) \
+template <class XType \
+        , class YType \
+        , class = std::enable_if_t< \
+            (ad::core::is_forward_array_v<XType> && \
+             ad::core::is_forward_array_v<YType>) || \
+            (ad::core::is_forward_array_v<XType> && \
+             std::is_arithmetic_v<std::decay_t<YType>>) || \
+            (std::is_arithmetic_v<std::decay_t<XType>> && \
+             ad::core::is_forward_array_v<YType>) > > \
+inline auto f(XType&& x, YType&& y) \
+{ \
+	return ad::core::details::forward_array_binary<ad::core::functor>( \
+			std::forward<XType>(x), std::forward<YType>(y)); \
+} \
+
+namespace ad {
+namespace core {
+
+// Forward variable of vector or matrix shape to store values and adjoints (tangents).
+// Values and tangents are stored as Eigen objects of the same dimensions,
+// so that every function is applied as a vectorized operation over all elements
+// instead of one ADForward<T> object per element.
+// If x is a result of composing functions of such variables x1,...,xn,
+// x.get_adjoint() is the directional derivative of x in the direction of x1.get_adjoint(),...,xn.get_adjoint().
+// @tparam  T           underlying data type
+// @tparam  ShapeType   shape of variable (one of vec, mat)
+template <class T, class ShapeType>
+struct ADForwardArray
+{
+    static_assert(std::is_same_v<ShapeType, ad::vec> ||
+                  std::is_same_v<ShapeType, ad::mat>,
+                  "ADForwardArray must be of vector or matrix shape");
+
+    using value_t = T;
+    using shape_t = ShapeType;
+    using var_t = util::constant_var_t<T, ShapeType>;
+
+    explicit ADForwardArray(size_t rows, size_t cols = 1)
+        : w_(var_t::Zero(rows, cols))
+        , df_(var_t::Zero(rows, cols))
+    {
+        if constexpr (std::is_same_v<shape_t, ad::vec>) {
+            assert(cols == 1);
+        }
+    }
+
+    template <class WDerived, class DfDerived>
+    ADForwardArray(const Eigen::DenseBase<WDerived>& w,
+                   const Eigen::DenseBase<DfDerived>& df)
+        : w_(w)
+        , df_(df)
+    {
+        assert(w_.rows() == df_.rows());
+        assert(w_.cols() == df_.cols());
+    }
+
+    ADForwardArray(var_t&& w, var_t&& df)
+        : w_(std::move(w))
+        , df_(std::move(df))
+    {
+        assert(w_.rows() == df_.rows());
+        assert(w_.cols() == df_.cols());
+    }
+
+    var_t& get_value() { return w_; }
+    const var_t& get_value() const { return w_; }
+    var_t& get_adjoint() { return df_; }
+    const var_t& get_adjoint() const { return df_; }
+
+    size_t rows() const { return w_.rows(); }
+    size_t cols() const { return w_.cols(); }
+    size_t size() const { return w_.size(); }
+
+private:
+    var_t w_;
+    var_t df_;
+};
+
+/*
+ * Check if (decayed) T is ADForwardArray
+ */
+namespace details {
+
+template <class T>
+struct is_forward_array : std::false_type
+{};
+
+template <class T, class ShapeType>
+struct is_forward_array<ADForwardArray<T, ShapeType>> : std::true_type
+{};
+
+} // namespace details
+
+template <class T>
+inline constexpr bool is_forward_array_v =
+    details::is_forward_array<std::decay_t<T>>::value;
+
+namespace details {
+
+/**
+ * Returns the value and tangent operands of x as a pair.
+ * An arithmetic constant has a zero tangent.
+ */
+template <class ValueType, class XType>
+inline auto forward_array_operands(XType&& x)
+{
+    if constexpr (is_forward_array_v<XType>) {
+        return std::make_pair(util::to_array(x.get_value()),
+                              util::to_array(x.get_adjoint()));
+    } else {
+        return std::make_pair(static_cast<ValueType>(x), ValueType(0));
+    }
+}
+
+/**
+ * Applies the element-wise unary functor Unary on x.
+ * The value is Unary::fmap(x) and the tangent is Unary::bmap(x', x, f(x)),
+ * since the Jacobian of an element-wise function is diagonal.
+ *
+ * f(x) is evaluated once into a new value array, from which the tangent is derived.
+ * If x is an rvalue, the tangent overwrites the tangent of x
+ * and the new value array replaces the value of x,
+ * so that each intermediate of a long expression allocates a single array.
+ */
+template <class Unary, class XType>
+inline auto forward_array_unary(XType&& x)
+{
+    using array_t = std::decay_t<XType>;
+    using var_t = typename array_t::var_t;
+    auto&& a_x = util::to_array(x.get_value());
+    auto&& a_dx = util::to_array(x.get_adjoint());
+
+    if constexpr (std::is_lvalue_reference_v<XType>) {
+        var_t w = Unary::fmap(a_x).matrix();
+        var_t df = Unary::bmap(a_dx, a_x, w.array()).matrix();
+        return array_t(std::move(w), std::move(df));
+    } else {
+        var_t w = Unary::fmap(a_x).matrix();
+        a_dx = Unary::bmap(a_dx, a_x, w.array());
+        x.get_value() = std::move(w);
+        return array_t(std::move(x));
+    }
+}
+
+/**
+ * Applies the element-wise binary functor Binary on x and y.
+ * The value is Binary::fmap(x, y) and the tangent is
+ * Binary::blmap(x', x, y, f(x, y)) + Binary::brmap(y', x, y, f(x, y)),
+ * where the term of an arithmetic constant is omitted.
+ *
+ * f(x, y) is evaluated once, and if either x or y is an rvalue ADForwardArray,
+ * its storage is reused for the result as in forward_array_unary.
+ */
+template <class Binary, class XType, class YType>
+inline auto forward_array_binary(XType&& x, YType&& y)
+{
+    constexpr bool x_is_array = is_forward_array_v<XType>;
+    constexpr bool y_is_array = is_forward_array_v<YType>;
+    using array_t = std::decay_t<std::conditional_t<x_is_array, XType, YType>>;
+    using value_t = typename array_t::value_t;
+    using var_t = typename array_t::var_t;
+
+    auto x_ops = forward_array_operands<value_t>(x);
+    auto y_ops = forward_array_operands<value_t>(y);
+    auto& a_x = x_ops.first;
+    auto& a_dx = x_ops.second;
+    auto& a_y = y_ops.first;
+    auto& a_dy = y_ops.second;
+
+    if constexpr (x_is_array && y_is_array) {
+        assert(a_x.rows() == a_y.rows());
+        assert(a_x.cols() == a_y.cols());
+    }
+
+    auto tangent = [&](const auto& a_f) {
+        if constexpr (x_is_array && y_is_array) {
+            return Binary::blmap(a_dx, a_x, a_y, a_f) +
+                   Binary::brmap(a_dy, a_x, a_y, a_f);
+        } else if constexpr (x_is_array) {
+            return Binary::blmap(a_dx, a_x, a_y, a_f);
+        } else {
+            return Binary::brmap(a_dy, a_x, a_y, a_f);
+        }
+    };
+
+    if constexpr (x_is_array && !std::is_lvalue_reference_v<XType>) {
+        var_t w = Binary::fmap(a_x, a_y).matrix();
+        a_dx = tangent(w.array());
+        x.get_value() = std::move(w);
+        return array_t(std::move(x));
+    } else if constexpr (y_is_array && !std::is_lvalue_reference_v<YType>) {
+        var_t w = Binary::fmap(a_x, a_y).matrix();
+        a_dy = tangent(w.array());
+        y.get_value() = std::move(w);
+        return array_t(std::move(y));
+    } else {
+        var_t w = Binary::fmap(a_x, a_y).matrix();
+        var_t df = tangent(w.array()).matrix();
+        return array_t(std::move(w), std::move(df));
+    }
+}
+
+} // namespace details
+
+} // namespace core
+
+// user-exposed forward variable alias for vector and matrix shapes
+template <class T, class ShapeType = vec>
+using ForwardArray = core::ADForwardArray<T, ShapeType>;
+
+//================================================================================
+
+// Unary functions
+
+// ad::sin(core::ADForwardArray)
+FORWARD_ARRAY_UNARY_FUNC(sin, Sin)
+// ad::cos(core::ADForwardArray)
+FORWARD_ARRAY_UNARY_FUNC(cos, Cos)
+// ad::tan(core::ADForwardArray)
+FORWARD_ARRAY_UNARY_FUNC(tan, Tan)
+// ad::asin(core::ADForwardArray)
+FORWARD_ARRAY_UNARY_FUNC(asin, Arcsin)
+// ad::acos(core::ADForwardArray)
+FORWARD_ARRAY_UNARY_FUNC(acos, Arccos)
+// ad::atan(core::ADForwardArray)
+FORWARD_ARRAY_UNARY_FUNC(atan, Arctan)
+// ad::exp(core::ADForwardArray)
+FORWARD_ARRAY_UNARY_FUNC(exp, Exp)
+// ad::log(core::ADForwardArray)
+FORWARD_ARRAY_UNARY_FUNC(log, Log)
+// ad::sqrt(core::ADForwardArray)
+FORWARD_ARRAY_UNARY_FUNC(sqrt, Sqrt)
+// ad::erf(core::ADForwardArray)
+FORWARD_ARRAY_UNARY_FUNC(erf, Erf)
+
+/**
+ * Sums all elements of a forward array.
+ *
+ * @return  scalar forward variable with the sum of values and the sum of tangents
+ */
+template <class T, class S>
+inline auto sum(const core::ADForwardArray<T, S>& x)
+{
+    return ForwardVar<T>(x.get_value().sum(), x.get_adjoint().sum());
+}
+
+//================================================================================
+
+// Operators
+
+namespace core {
+
+// Negate forward array
+FORWARD_ARRAY_UNARY_FUNC(operator-, UnaryMinus)
+
+// Add forward arrays
+FORWARD_ARRAY_BINARY_FUNC(operator+, Add)
+// Subtract forward arrays
+FORWARD_ARRAY_BINARY_FUNC(operator-, Sub)
+// Multiply forward arrays (element-wise)
+FORWARD_ARRAY_BINARY_FUNC(operator*, Mul)
+// Divide forward arrays (element-wise)
+FORWARD_ARRAY_BINARY_FUNC(operator/, Div)
+
+} // namespace core
+} // namespace ad
+
+#undef FORWARD_ARRAY_UNARY_FUNC
+#undef FORWARD_ARRAY_BINARY_FUNC
@@ -1,20 +1,36 @@
 #pragma once
+#include "fastad_bits/reverse/core/batch.hpp"
 #include "fastad_bits/reverse/core/binary.hpp"
 #include "fastad_bits/reverse/core/bind.hpp"
+#include "fastad_bits/reverse/core/cholesky.hpp"
 #include "fastad_bits/reverse/core/constant.hpp"
 #include "fastad_bits/reverse/core/dot.hpp"
 #include "fastad_bits/reverse/core/eq.hpp"
 #include "fastad_bits/reverse/core/eval.hpp"
 #include "fastad_bits/reverse/core/expr_base.hpp"
 #include "fastad_bits/reverse/core/for_each.hpp"
+#include "fastad_bits/reverse/core/fuse.hpp"
 #include "fastad_bits/reverse/core/glue.hpp"
+#include "fastad_bits/reverse/core/hessian.hpp"
 #include "fastad_bits/reverse/core/if_else.hpp"
+#include "fastad_bits/reverse/core/inverse.hpp"
+#include "fastad_bits/reverse/core/jacobian.hpp"
+#include "fastad_bits/reverse/core/llt.hpp"
+#include "fastad_bits/reverse/core/map_sum.hpp"
 #include "fastad_bits/reverse/core/norm.hpp"
+#include "fastad_bits/reverse/core/parallel_glue.hpp"
+#include "fastad_bits/reverse/core/parallel_sum.hpp"
 #include "fastad_bits/reverse/core/pow.hpp"
 #include "fastad_bits/reverse/core/prod.hpp"
+#include "fastad_bits/reverse/core/profile.hpp"
+#include "fastad_bits/reverse/core/solve.hpp"
+#include "fastad_bits/reverse/core/sparse.hpp"
 #include "fastad_bits/reverse/core/sum.hpp"
+#include "fastad_bits/reverse/core/tape.hpp"
+#include "fastad_bits/reverse/core/trace.hpp"
+#include "fastad_bits/reverse/core/transpose.hpp"
 #include "fastad_bits/reverse/core/unary.hpp"
 #include "fastad_bits/reverse/core/value_view.hpp"
 #include "fastad_bits/reverse/core/var.hpp"
 #include "fastad_bits/reverse/core/var_view.hpp"
-//#include "fastad_bits/reverse/core/hessian.hpp"
+#include "fastad_bits/reverse/core/visit.hpp"
@@ -0,0 +1,88 @@
+#pragma once
+#include <cassert>
+#include <vector>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/util/thread_pool.hpp>
+#include <Eigen/Core>
+
+namespace ad {
+
+/**
+ * Computes the value and gradient of a scalar function at every row of inputs.
+ * Rows are split into contiguous blocks, one block per worker of the pool.
+ * Every worker builds its own copy of the expression through expr_factory
+ * so that no cache, variable, or placeholder is shared between threads.
+ *
+ * The factory is called once per worker as expr_factory(x, w) where
+ * x is a std::vector<Var<value_t>> of size inputs.cols() viewing the current point
+ * and w is an (initially empty) std::vector<Var<value_t>>
+ * that the factory may resize and use as placeholders.
+ * The factory must return an expression of scalar shape
+ * and may be called concurrently, so it must not refer to
+ * any variable other than x and w.
+ * In particular, a factorization created with ad::shared_llt must be created by the factory
+ * rather than captured, since the workers would otherwise write to it concurrently.
+ *
+ * For each row i of inputs, outputs(i, 0) is set to the function value
+ * and outputs(i, j+1) is set to the partial derivative w.r.t. x[j].
+ *
+ * @tparam  ExprFactory     type of expression factory
+ * @tparam  InputDerived    Eigen matrix type of inputs
+ * @tparam  OutputDerived   Eigen matrix type of outputs
+ * @param   expr_factory    callable that creates the expression from (x, w)
+ * @param   inputs          matrix of points where each row is one point
+ * @param   outputs         matrix of size inputs.rows() x (inputs.cols() + 1)
+ * @param   pool            thread pool to run the workers on
+ */
+template <class ExprFactory, class InputDerived, class OutputDerived>
+inline void batch_autodiff(ExprFactory&& expr_factory,
+                           const Eigen::MatrixBase<InputDerived>& inputs,
+                           Eigen::MatrixBase<OutputDerived>& outputs,
+                           util::ThreadPool& pool)
+{
+    using value_t = typename InputDerived::Scalar;
+
+    assert(outputs.rows() == inputs.rows());
+    assert(outputs.cols() == inputs.cols() + 1);
+
+    const size_t n_vars = inputs.cols();
+
+    pool.parallel_for(inputs.rows(),
+        [&](size_t begin, size_t end) {
+            std::vector<Var<value_t>> x(n_vars);
+            std::vector<Var<value_t>> w;
+            auto expr = ad::bind(expr_factory(x, w));
+
+            for (size_t i = begin; i < end; ++i) {
+                for (size_t j = 0; j < n_vars; ++j) {
+                    x[j].get() = inputs(i, j);
+                    x[j].reset_adj();
+                }
+                for (auto& wj : w) wj.reset_adj();
+
+                outputs(i, 0) = ad::autodiff(expr);
+                for (size_t j = 0; j < n_vars; ++j) {
+                    outputs(i, j+1) = x[j].get_adj();
+                }
+            }
+        });
+}
+
+/**
+ * Overload that creates a temporary thread pool with n_threads workers.
+ * Prefer the pool overload when calling repeatedly.
+ */
+template <class ExprFactory, class InputDerived, class OutputDerived>
+inline void batch_autodiff(ExprFactory&& expr_factory,
+                           const Eigen::MatrixBase<InputDerived>& inputs,
+                           Eigen::MatrixBase<OutputDerived>& outputs,
+                           size_t n_threads = util::ThreadPool::default_n_threads())
+{
+    util::ThreadPool pool(n_threads);
+    batch_autodiff(std::forward<ExprFactory>(expr_factory),
+                   inputs, outputs, pool);
+}
+
+} // namespace ad
@@ -2,8 +2,13 @@
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/util/cse_registry.hpp>
+#include <fastad_bits/util/numeric.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/fuse.hpp>
+#include <fastad_bits/util/macros.hpp>
+#include <fastad_bits/util/soa_context.hpp>
 #include <fastad_bits/util/value.hpp>
 
 namespace ad {
@@ -37,7 +42,7 @@ template <class Binary
         , class LeftExprType
         , class RightExprType>
 struct BinaryNode:
-    ValueAdjView<typename util::expr_traits<LeftExprType>::value_t,
+    ValueAdjView<util::common_value_t<LeftExprType, RightExprType>,
                  util::max_shape_t<typename util::shape_traits<LeftExprType>::shape_t,
                                    typename util::shape_traits<RightExprType>::shape_t>
                 >,
@@ -74,6 +79,23 @@ public:
     using typename value_adj_view_t::var_t;
     using typename value_adj_view_t::ptr_pack_t;
 
+    static constexpr bool cse_aware = util::is_cse_aware_v<left_t> &&
+                                      util::is_cse_aware_v<right_t>;
+    static constexpr bool soa_aware = 
+        !Binary::is_comparison &&
+        util::is_scl_v<left_t> && util::is_scl_v<right_t> &&
+        util::is_soa_aware_v<left_t> && util::is_soa_aware_v<right_t> &&
+        std::is_same_v<typename util::expr_traits<left_t>::value_t, common_value_t> &&
+        std::is_same_v<typename util::expr_traits<right_t>::value_t, common_value_t>;
+    static constexpr bool fuse_aware = 
+        !Binary::is_comparison &&
+        util::is_fuse_aware_v<left_t> && util::is_fuse_aware_v<right_t> &&
+        std::is_same_v<typename util::expr_traits<left_t>::value_t, common_value_t> &&
+        std::is_same_v<typename util::expr_traits<right_t>::value_t, common_value_t>;
+    static constexpr size_t fuse_scalars = 
+        util::fuse_scalars<left_t>() + util::fuse_scalars<right_t>();
+    static constexpr bool fuse_rebuildable = true;
+
     BinaryNode(const left_t& expr_lhs, 
                const right_t& expr_rhs)
         : value_adj_view_t(nullptr, nullptr,
@@ -99,6 +121,8 @@ public:
      */
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
+        if (cse_alias_) return this->get();
         auto&& lval = util::to_array(expr_lhs_.feval());
         auto&& rval = util::to_array(expr_rhs_.feval());
         util::to_array(this->get()) = util::cast_to<value_t>(Binary::fmap(lval, rval));
@@ -120,6 +144,7 @@ public:
     template <class T>
     void beval(const T& seed)
     {
+        FASTAD_PROFILE(beval);
         static_cast<void>(seed);
         if constexpr (!Binary::is_comparison) {
             auto&& a_val = util::to_array(this->get());
@@ -138,6 +163,8 @@ public:
     /**
      * Binds left expression, then right expression, then itself.
      * If Binary operation is only comparison, bind value only.
+     * If bound with common subexpression elimination and an equal expression
+     * was bound before, views its cache instead and skips forward evaluation.
      *
      * @return  next pointer pack not bound by left, right, or itself.
      */
@@ -145,12 +172,12 @@ public:
     {
         begin = expr_lhs_.bind_cache(begin);
         begin = expr_rhs_.bind_cache(begin);
+        cse_alias_ = false;
+        if constexpr (cse_aware) {
+            if (begin.cse && cse_bind(*begin.cse)) return begin;
+        }
         if constexpr (Binary::is_comparison) {
-            auto adj = begin.adj;
-            begin.adj = nullptr;
-            begin = value_adj_view_t::bind(begin);
-            begin.adj = adj;
-            return begin;
+            return value_adj_view_t::bind_value(begin);
         } else {
             return value_adj_view_t::bind(begin);
         }
@@ -179,9 +206,133 @@ public:
         }
     }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(expr_lhs_);
+        f(expr_rhs_);
+    }
+
+    /**
+     * Rebuilds the node with f applied to its children (see ad::fuse).
+     */
+    template <class F>
+    auto fuse_rebuild(F&& f) const
+    {
+        auto lhs = f(expr_lhs_);
+        auto rhs = f(expr_rhs_);
+        return BinaryNode<Binary, decltype(lhs), decltype(rhs)>(lhs, rhs);
+    }
+
+    bool cse_alias() const { return cse_alias_; }
+
+    /**
+     * Structure-of-arrays evaluation of this node only (see util::SoAContext).
+     */
+    void soa_feval(util::SoAContext<value_t>& ctx, size_t self, const size_t* children) const
+    {
+        auto a_l = ctx.val(children[0]);
+        auto a_r = ctx.val(children[1]);
+        auto a_val = ctx.val(self);
+        a_val = Binary::fmap(a_l, a_r);
+    }
+
+    void soa_beval(util::SoAContext<value_t>& ctx, size_t self, const size_t* children) const
+    {
+        auto a_l = ctx.val(children[0]);
+        auto a_r = ctx.val(children[1]);
+        auto a_val = ctx.val(self);
+        auto a_adj = ctx.adj(self);
+        auto a_l_adj = ctx.adj(children[0]);
+        auto a_r_adj = ctx.adj(children[1]);
+        // constants do not need adjoints
+        if constexpr (!util::is_constant_v<right_t>) {
+            a_r_adj = Binary::brmap(a_adj, a_l, a_r, a_val);
+        }
+        if constexpr (!util::is_constant_v<left_t>) {
+            a_l_adj = Binary::blmap(a_adj, a_l, a_r, a_val);
+        }
+    }
+
+    /**
+     * Fused element-wise evaluation (see FusedNode).
+     * Constants do not need seeds.
+     */
+    ptr_pack_t fuse_bind(ptr_pack_t begin) 
+    { 
+        begin = expr_lhs_.fuse_bind(begin);
+        return expr_rhs_.fuse_bind(begin);
+    }
+
+    auto fuse_make()
+    {
+        return std::tuple<util::fuse_block_t<value_t, shape_t>,
+                          decltype(expr_lhs_.fuse_make()),
+                          decltype(expr_rhs_.fuse_make())>();
+    }
+
+    template <class V>
+    void fuse_feval(size_t begin, size_t n, V& v)
+    {
+        auto& l = std::get<1>(v);
+        auto& r = std::get<2>(v);
+        expr_lhs_.fuse_feval(begin, n, l);
+        expr_rhs_.fuse_feval(begin, n, r);
+        std::get<0>(v) = Binary::fmap(util::fuse_view(std::get<0>(l)),
+                                      util::fuse_view(std::get<0>(r)));
+    }
+
+    template <class V, class S>
+    void fuse_beval(size_t begin, size_t n, const V& v, const S& seed, value_t* acc)
+    {
+        using left_shape_t = typename util::shape_traits<left_t>::shape_t;
+        using right_shape_t = typename util::shape_traits<right_t>::shape_t;
+        const auto& l = std::get<1>(v);
+        const auto& r = std::get<2>(v);
+        auto a_seed = util::fuse_view(seed);
+        auto a_l = util::fuse_view(std::get<0>(l));
+        auto a_r = util::fuse_view(std::get<0>(r));
+        auto a_val = util::fuse_view(std::get<0>(v));
+        if constexpr (!util::is_constant_v<right_t>) {
+            const util::fuse_block_t<value_t, right_shape_t> r_seed =
+                Binary::brmap(a_seed, a_l, a_r, a_val);
+            expr_rhs_.fuse_beval(begin, n, r, r_seed, 
+                                 acc + util::fuse_scalars<left_t>());
+        }
+        if constexpr (!util::is_constant_v<left_t>) {
+            const util::fuse_block_t<value_t, left_shape_t> l_seed =
+                Binary::blmap(a_seed, a_l, a_r, a_val);
+            expr_lhs_.fuse_beval(begin, n, l, l_seed, acc);
+        }
+    }
+
+    void fuse_flush(const value_t* acc) 
+    { 
+        expr_lhs_.fuse_flush(acc); 
+        expr_rhs_.fuse_flush(acc + util::fuse_scalars<left_t>()); 
+    }
+
 private:
+    /**
+     * Views the cache of an equal expression bound before, if any,
+     * and registers itself otherwise.
+     * Kept out of line so that bind_cache stays small (see FASTAD_NOINLINE).
+     * @return  true if it views the cache of an equal expression.
+     */
+    FASTAD_NOINLINE bool cse_bind(util::CSERegistry& cse)
+    {
+        if (auto* other = cse.find(*this)) {
+            cse_alias_ = true;
+            value_adj_view_t::bind({other->data(), other->data_adj()});
+            return true;
+        }
+        cse.insert(*this);
+        return false;
+    }
+
     left_t expr_lhs_;
     right_t expr_rhs_;
+    bool cse_alias_ = false;
 };
 
 /* 
@@ -244,10 +395,10 @@ template <class Derived1 \
 inline auto name(const Derived1& node1, \
                  const Derived2& node2) \
 { \
-    using expr1_t = util::convert_to_ad_t<Derived1>; \
-    using expr2_t = util::convert_to_ad_t<Derived2>; \
-    expr1_t expr1 = node1; \
-    expr2_t expr2 = node2; \
+    using expr1_t = util::convert_to_ad_as_t<Derived1, Derived2>; \
+    using expr2_t = util::convert_to_ad_as_t<Derived2, Derived1>; \
+    expr1_t expr1(node1); \
+    expr2_t expr2(node2); \
     if constexpr (util::is_constant_v<expr1_t> && \
                   util::is_constant_v<expr2_t>) { \
         return ad::constant(struct_name::fmap( \
@@ -269,7 +420,7 @@ BINARY_STRUCT(Add, false,
         static_cast<void>(y); 
         static_cast<void>(f); 
         if constexpr (!util::is_eigen_v<T> && util::is_eigen_v<U>) {
-            return seed.sum();
+            return util::accum_sum(seed);
         } else {
             return seed;
         },
@@ -277,7 +428,7 @@ BINARY_STRUCT(Add, false,
         static_cast<void>(y); 
         static_cast<void>(f); 
         if constexpr (util::is_eigen_v<T> && !util::is_eigen_v<U>) {
-            return seed.sum();
+            return util::accum_sum(seed);
         } else {
             return seed;
         });
@@ -289,7 +440,7 @@ BINARY_STRUCT(Sub, false,
         static_cast<void>(y); 
         static_cast<void>(f); 
         if constexpr (!util::is_eigen_v<T> && util::is_eigen_v<U>) {
-            return seed.sum();
+            return util::accum_sum(seed);
         } else {
             return seed;
         },
@@ -297,7 +448,7 @@ BINARY_STRUCT(Sub, false,
         static_cast<void>(y); 
         static_cast<void>(f); 
         if constexpr (util::is_eigen_v<T> && !util::is_eigen_v<U>) {
-            return -(seed.sum());
+            return -util::accum_sum(seed);
         } else {
             return -seed;
         });
@@ -308,14 +459,14 @@ BINARY_STRUCT(Mul, false,
         static_cast<void>(x); 
         static_cast<void>(f); 
         if constexpr (!util::is_eigen_v<T> && util::is_eigen_v<U>) {
-            return (seed * y).sum();
+            return util::accum_sum(seed * y);
         } else {
             return seed * y;
         },
         static_cast<void>(y); 
         static_cast<void>(f); 
         if constexpr (util::is_eigen_v<T> && !util::is_eigen_v<U>) {
-            return (seed * x).sum();
+            return util::accum_sum(seed * x);
         } else {
             return seed * x;
         });
@@ -326,13 +477,13 @@ BINARY_STRUCT(Div, false,
         static_cast<void>(x); 
         static_cast<void>(f); 
         if constexpr (!util::is_eigen_v<T> && util::is_eigen_v<U>) {
-            return (seed / y).sum();
+            return util::accum_sum(seed / y);
         } else {
             return seed / y;
         },
         static_cast<void>(x);
         if constexpr (util::is_eigen_v<T> && !util::is_eigen_v<U>) {
-            return (-seed * f / y).sum();
+            return util::accum_sum(-seed * f / y);
         } else {
             return -seed * f / y;
         });
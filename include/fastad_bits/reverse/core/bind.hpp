@@ -1,6 +1,13 @@
 #pragma once
+#include <algorithm>
+#include <memory>
+#include <type_traits>
 #include <vector>
 #include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/util/cache_arena.hpp>
+#include <fastad_bits/util/cse_registry.hpp>
+#include <fastad_bits/util/leaf_registry.hpp>
+#include <fastad_bits/util/ptr_pack.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 
 namespace ad {
@@ -12,6 +19,33 @@ namespace core {
  * This is for convenience purposes so that users do not have
  * to worry about creating the cache line themselves.
  *
+ * The cache is either owned by the object or carved out of a CacheArena.
+ * In the latter case, the arena owns the memory and the object
+ * must not be used after the arena is reset or destroyed.
+ *
+ * The layout of the cache is chosen by a layout policy (see ad::layout).
+ *
+ * If constructed with the ad::cse tag, the expression is bound with
+ * common subexpression elimination (see CSERegistry):
+ * every sub-expression that is equal to one bound before it
+ * (same structure viewing the same variables and constants)
+ * views the cache of the latter and is not forward-evaluated again.
+ * Backward evaluation still propagates through every occurrence,
+ * so that the adjoints of the leaves accumulate all contributions.
+ * The cache is then only as large as needed after elimination.
+ *
+ * While binding, every distinct leaf (VarView) and placeholder (EqNode)
+ * of the expression is collected into a leaf registry (see util::LeafRegistry).
+ * reset_adjoints() then zeroes all of their adjoints and the internal adjoint cache,
+ * and gradient() gathers the adjoints of the leaves into a flat vector.
+ * Leaves of a map_sum are only known after its first forward evaluation.
+ *
+ * An expression bound with layout::forward (see ad::bind_forward)
+ * only has a value cache and must not be backward evaluated,
+ * which is asserted by autodiff and evaluate_adj (see forward_only()).
+ * rebind() binds the same expression again with another layout,
+ * e.g. to switch to a full bind once adjoints are needed.
+ *
  * @tparam  ExprType    expression type
  */
 
@@ -20,32 +54,261 @@ struct ExprBind
 {
     using expr_t = ExprType;
     using value_t = typename util::expr_traits<expr_t>::value_t;
+    using leaf_registry_t = util::LeafRegistry<value_t>;
+    using gradient_t = Eigen::Matrix<value_t, Eigen::Dynamic, 1>;
 
-    ExprBind(const expr_t& expr)
+    template <class Layout = layout::separate>
+    ExprBind(const expr_t& expr, Layout = Layout())
         : expr_{expr}
         , val_cache_()
         , adj_cache_()
+        , leaves_(std::make_unique<leaf_registry_t>())
     {
-        auto size_pack = expr_.bind_cache_size();
+        auto size_pack = Layout::cache_size(expr_.bind_cache_size());
         val_cache_.resize(size_pack(0));
         adj_cache_.resize(size_pack(1));
-        expr_.bind_cache({val_cache_.data(), adj_cache_.data()});
+        bind<Layout>(val_cache_.data(), adj_cache_.data(), size_pack(1));
+    }
+
+    template <class Layout = layout::separate>
+    ExprBind(const expr_t& expr, util::CacheArena& arena, Layout = Layout())
+        : expr_{expr}
+        , val_cache_()
+        , adj_cache_()
+        , leaves_(std::make_unique<leaf_registry_t>())
+    {
+        auto size_pack = Layout::cache_size(expr_.bind_cache_size());
+        value_t* val = arena.allocate<value_t>(size_pack(0));
+        value_t* adj = arena.allocate<value_t>(size_pack(1));
+        bind<Layout>(val, adj, size_pack(1));
     }
-    
+
+    template <class Layout = layout::separate>
+    ExprBind(const expr_t& expr, cse_t, Layout = Layout())
+        : expr_{expr}
+        , val_cache_()
+        , adj_cache_()
+        , leaves_(std::make_unique<leaf_registry_t>())
+        , cse_{true}
+    {
+        auto size_pack = cse_cache_size<Layout>();
+        val_cache_.resize(size_pack(0));
+        adj_cache_.resize(size_pack(1));
+        cse_bind<Layout>(val_cache_.data(), adj_cache_.data(), leaves_.get());
+        adj_ = adj_cache_.data();
+        adj_size_ = size_pack(1);
+    }
+
+    template <class Layout = layout::separate>
+    ExprBind(const expr_t& expr, util::CacheArena& arena, cse_t, Layout = Layout())
+        : expr_{expr}
+        , val_cache_()
+        , adj_cache_()
+        , leaves_(std::make_unique<leaf_registry_t>())
+        , cse_{true}
+    {
+        auto size_pack = cse_cache_size<Layout>();
+        value_t* val = arena.allocate<value_t>(size_pack(0));
+        value_t* adj = arena.allocate<value_t>(size_pack(1));
+        cse_bind<Layout>(val, adj, leaves_.get());
+        adj_ = adj;
+        adj_size_ = size_pack(1);
+    }
+
     expr_t& get() { return expr_; }
+    const expr_t& get() const { return expr_; }
+
+    /**
+     * Binds the expression again to a new cache owned by the object with layout Layout,
+     * with common subexpression elimination if it was bound with it.
+     * The leaves are registered again.
+     * Values and adjoints of the previous cache are not carried over.
+     */
+    template <class Layout = layout::separate>
+    void rebind(Layout = Layout())
+    {
+        leaves_ = std::make_unique<leaf_registry_t>();
+        if (cse_) {
+            auto size_pack = cse_cache_size<Layout>();
+            val_cache_.resize(size_pack(0));
+            adj_cache_.resize(size_pack(1));
+            cse_bind<Layout>(val_cache_.data(), adj_cache_.data(), leaves_.get());
+            adj_ = adj_cache_.data();
+            adj_size_ = size_pack(1);
+        } else {
+            auto size_pack = Layout::cache_size(expr_.bind_cache_size());
+            val_cache_.resize(size_pack(0));
+            adj_cache_.resize(size_pack(1));
+            bind<Layout>(val_cache_.data(), adj_cache_.data(), size_pack(1));
+        }
+    }
+
+    /**
+     * Zeroes the adjoints of every leaf and placeholder of the expression
+     * and the internal adjoint cache,
+     * so that the next backward evaluation starts from a fresh gradient.
+     * Adjoints interleaved with values (see layout::interleaved)
+     * are overwritten by backward evaluation and are not reset.
+     */
+    void reset_adjoints()
+    {
+        leaves_->zero();
+        std::fill(adj_, adj_ + adj_size_, value_t(0));
+    }
+
+    /**
+     * Returns the adjoints of every leaf of the expression, placeholders excluded,
+     * as a flat vector in the order the leaves were first bound.
+     */
+    gradient_t gradient() const
+    {
+        gradient_t out(leaves_->size());
+        leaves_->gather(out.data());
+        return out;
+    }
+
+    const leaf_registry_t& leaves() const { return *leaves_; }
+
+    /**
+     * Returns true if the expression is bound with layout::forward,
+     * i.e. it has no adjoint cache and must not be backward evaluated.
+     */
+    bool forward_only() const { return forward_only_; }
 
 private:
-    expr_t expr_; 
+    /**
+     * Binds expression to val and adj with the leaf registry.
+     */
+    template <class Layout>
+    void bind(value_t* val, value_t* adj, size_t adj_size)
+    {
+        auto begin = Layout::ptr_pack(val, adj);
+        begin.leaves = leaves_.get();
+        expr_.bind_cache(begin);
+        adj_ = adj;
+        adj_size_ = adj_size;
+        forward_only_ = std::is_same_v<Layout, layout::forward>;
+    }
+
+    /**
+     * Binds expression with common subexpression elimination
+     * and registers its leaves to leaves if non-null.
+     * @return  next pointer pack not bound by the expression
+     */
+    template <class Layout>
+    auto cse_bind(value_t* val, value_t* adj, leaf_registry_t* leaves = nullptr)
+    {
+        util::CSERegistry registry;
+        auto begin = Layout::ptr_pack(val, adj);
+        begin.cse = &registry;
+        begin.leaves = leaves;
+        forward_only_ = std::is_same_v<Layout, layout::forward>;
+        return expr_.bind_cache(begin);
+    }
+
+    /**
+     * Computes the buffer sizes needed to bind with common subexpression elimination
+     * by binding once to temporary buffers of the size without elimination.
+     */
+    template <class Layout>
+    util::SizePack cse_cache_size()
+    {
+        auto size_pack = Layout::cache_size(expr_.bind_cache_size());
+        Eigen::Matrix<value_t, Eigen::Dynamic, 1> val(size_pack(0));
+        Eigen::Matrix<value_t, Eigen::Dynamic, 1> adj(size_pack(1));
+        auto end = cse_bind<Layout>(val.data(), adj.data());
+        size_t val_size = end.val - val.data();
+        size_t adj_size = end.interleaved ? 0 : end.adj - adj.data();
+        return {val_size, adj_size};
+    }
+
+    expr_t expr_;
     Eigen::Matrix<value_t, Eigen::Dynamic, 1> val_cache_;
     Eigen::Matrix<value_t, Eigen::Dynamic, 1> adj_cache_;
+    std::unique_ptr<leaf_registry_t> leaves_;
+    value_t* adj_ = nullptr;
+    size_t adj_size_ = 0;
+    bool cse_ = false;
+    bool forward_only_ = false;
 };
 
 } // namespace core
 
-template <class Derived>
+using CacheArena = util::CacheArena;
+
+/**
+ * Binds expression to a cache owned by the returned object.
+ *
+ * @tparam  Layout  layout policy of the cache (see ad::layout).
+ *                  Default is separate value and adjoint buffers.
+ */
+template <class Layout = layout::separate, class Derived>
 inline auto bind(const core::ExprBase<Derived>& expr)
 {
-    return core::ExprBind<Derived>(expr.self());
+    return core::ExprBind<Derived>(expr.self(), Layout());
+}
+
+/**
+ * Binds expression to a cache carved out of arena.
+ * No heap allocation occurs unless the arena needs to grow.
+ * The returned object must not be used after arena is reset or destroyed.
+ *
+ * @tparam  Layout  layout policy of the cache (see ad::layout).
+ *                  Default is separate value and adjoint buffers.
+ */
+template <class Layout = layout::separate, class Derived>
+inline auto bind(const core::ExprBase<Derived>& expr, CacheArena& arena)
+{
+    return core::ExprBind<Derived>(expr.self(), arena, Layout());
+}
+
+/**
+ * Binds expression to a value cache owned by the returned object
+ * for forward evaluation only (see layout::forward).
+ * No adjoint cache is allocated.
+ * The returned object can be rebound for backward evaluation (see core::ExprBind::rebind).
+ */
+template <class Derived>
+inline auto bind_forward(const core::ExprBase<Derived>& expr)
+{
+    return core::ExprBind<Derived>(expr.self(), layout::forward());
+}
+
+/**
+ * Binds expression to a value cache carved out of arena
+ * for forward evaluation only (see layout::forward).
+ * The returned object must not be used after arena is reset or destroyed.
+ */
+template <class Derived>
+inline auto bind_forward(const core::ExprBase<Derived>& expr, CacheArena& arena)
+{
+    return core::ExprBind<Derived>(expr.self(), arena, layout::forward());
+}
+
+/**
+ * Binds expression to a cache owned by the returned object
+ * with common subexpression elimination (see core::ExprBind).
+ *
+ * @tparam  Layout  layout policy of the cache (see ad::layout).
+ *                  Default is separate value and adjoint buffers.
+ */
+template <class Layout = layout::separate, class Derived>
+inline auto bind(const core::ExprBase<Derived>& expr, cse_t)
+{
+    return core::ExprBind<Derived>(expr.self(), cse, Layout());
+}
+
+/**
+ * Binds expression to a cache carved out of arena
+ * with common subexpression elimination (see core::ExprBind).
+ *
+ * @tparam  Layout  layout policy of the cache (see ad::layout).
+ *                  Default is separate value and adjoint buffers.
+ */
+template <class Layout = layout::separate, class Derived>
+inline auto bind(const core::ExprBase<Derived>& expr, CacheArena& arena, cse_t)
+{
+    return core::ExprBind<Derived>(expr.self(), arena, cse, Layout());
 }
 
 } // namespace ad
@@ -0,0 +1,150 @@
+#pragma once
+#include <limits>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/value.hpp>
+#include <Eigen/Dense>
+
+namespace ad {
+namespace core {
+
+/**
+ * CholeskyNode represents the lower Cholesky factor L of a positive definite matrix A = L L^T.
+ * Only the lower triangle of A is read, as in Eigen::LLT.
+ * No other shapes are permitted for this node.
+ *
+ * Backward evaluation reuses L from forward evaluation:
+ * the adjoint of A is the symmetric part of L^{-T} P L^{-1},
+ * where P is the lower triangle of L^T tril(seed) with its diagonal halved.
+ * Both products with L^{-1} are triangular solves in-place in the adjoint cache,
+ * so that no inverse is formed.
+ * If A is not positive definite, the value is NaN and backward evaluation does nothing.
+ *
+ * The node assumes the same value type and shape as that of the matrix expression.
+ *
+ * @tparam  ExprType        type of matrix expression
+ */
+
+template <class ExprType>
+struct CholeskyNode:
+    ValueAdjView<typename util::expr_traits<ExprType>::value_t,
+                 typename util::shape_traits<ExprType>::shape_t>,
+    ExprBase<CholeskyNode<ExprType>>
+{
+private:
+    using expr_t = ExprType;
+    using expr_value_t = typename util::expr_traits<expr_t>::value_t;
+
+    static_assert(util::is_mat_v<expr_t>);
+
+public:
+    using value_adj_view_t = ValueAdjView<expr_value_t,
+          typename util::shape_traits<expr_t>::shape_t>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    CholeskyNode(const expr_t& expr)
+        : value_adj_view_t(nullptr, nullptr, expr.rows(), expr.cols())
+        , expr_{expr}
+        , llt_(expr.rows())
+        , work_(expr.rows(), expr.cols())
+    {
+        assert(expr.rows() == expr.cols());
+    }
+
+    const var_t& feval()
+    {
+        FASTAD_PROFILE(feval);
+        llt_.compute(expr_.feval());
+        if (!valid()) {
+            this->get().fill(std::numeric_limits<value_t>::quiet_NaN());
+            return this->get();
+        }
+        return this->get() = llt_.matrixL();
+    }
+
+    template <class T>
+    void beval(const T& seed)
+    {
+        FASTAD_PROFILE(beval);
+        if (!valid()) return;
+        auto& adj = this->get_adj();
+        auto L = this->get().template triangularView<Eigen::Lower>();
+
+        util::to_array(adj) = seed;
+        work_ = adj.template triangularView<Eigen::Lower>();
+        adj.noalias() = L.transpose() * work_;
+        adj.template triangularView<Eigen::StrictlyUpper>().setZero();
+        adj.diagonal() *= 0.5;
+        L.transpose().solveInPlace(adj);
+        L.template solveInPlace<Eigen::OnTheRight>(adj);
+        work_ = 0.5 * (adj + adj.transpose());
+        expr_.beval(work_.array());
+    }
+
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        begin = expr_.bind_cache(begin);
+        return value_adj_view_t::bind(begin);
+    }
+
+    util::SizePack bind_cache_size() const
+    {
+        return expr_.bind_cache_size() +
+                single_bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const
+    {
+        return {this->size(), this->size()};
+    }
+
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(expr_);
+    }
+
+private:
+    bool valid() const { return llt_.info() == Eigen::Success; }
+
+    using mat_t = util::constant_var_t<value_t, shape_t>;
+    expr_t expr_;
+    Eigen::LLT<mat_t, Eigen::Lower> llt_;
+    mat_t work_;
+};
+
+} // namespace core
+
+/*
+ * Creates a Cholesky factor expression node.
+ * If x is a constant, the factor is computed once with Eigen::LLT.
+ */
+template <class T
+        , class = std::enable_if_t<
+            util::is_convertible_to_ad_v<T> &&
+            util::any_ad_v<T> > >
+inline auto cholesky(const T& x)
+{
+    using expr_t = util::convert_to_ad_t<T>;
+    using value_t = typename util::expr_traits<expr_t>::value_t;
+    using shape_t = typename util::shape_traits<expr_t>::shape_t;
+    expr_t expr = x;
+
+    // optimization for when expression is constant
+    if constexpr (util::is_constant_v<expr_t>) {
+        static_assert(util::is_mat_v<expr_t>);
+        using var_t = util::constant_var_t<value_t, shape_t>;
+        var_t out = expr.feval().llt().matrixL();
+        return ad::constant(out);
+    } else {
+        return core::CholeskyNode<expr_t>(expr);
+    }
+}
+
+} // namespace ad
@@ -5,6 +5,8 @@
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/ptr_pack.hpp>
 #include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/cse_registry.hpp>
+#include <fastad_bits/util/fuse.hpp>
 
 namespace ad {
 namespace core {
@@ -37,6 +39,10 @@ struct ConstantView:
     using var_t = Eigen::Map<const util::constant_var_t<value_t, shape_t>>;
     using ptr_pack_t = util::PtrPack<value_t>;
 
+    static constexpr bool cse_aware = true;
+    static constexpr bool fuse_aware = std::is_arithmetic_v<value_t>;
+    static constexpr size_t fuse_scalars = 0;
+
     ConstantView(const value_t* begin,
                  size_t rows,
                  size_t cols)
@@ -75,6 +81,41 @@ struct ConstantView:
     constexpr size_t cols() const { return val_.cols(); }
     const value_t* data() const { return val_.data(); }
 
+    /**
+     * Two constant viewers are equal subexpressions if they view the same values.
+     */
+    size_t cse_hash() const 
+    { 
+        return util::hash_combine(std::hash<const void*>()(data()), size()); 
+    }
+    bool cse_equal(const ConstantView& other) const 
+    { 
+        return data() == other.data() &&
+                rows() == other.rows() &&
+                cols() == other.cols();
+    }
+    constexpr bool cse_reads(const void*, const void*) const { return false; }
+    constexpr bool cse_alias() const { return false; }
+
+    /**
+     * Fused element-wise evaluation (see FusedNode).
+     */
+    template <class T>
+    constexpr T fuse_bind(T begin) const { return begin; }
+
+    auto fuse_make() const { return std::tuple<util::fuse_block_t<value_t, shape_t>>(); }
+
+    template <class V>
+    void fuse_feval(size_t begin, size_t n, V& v) const
+    {
+        std::get<0>(v) = Eigen::Map<const Eigen::Array<value_t, Eigen::Dynamic, 1>>(
+                data() + begin, n);
+    }
+
+    template <class V, class S>
+    void fuse_beval(size_t, size_t, const V&, const S&, value_t*) const {}
+    void fuse_flush(const value_t*) const {}
+
 private:
     var_t val_;
 };
@@ -92,6 +133,12 @@ public:
     using value_adj_view_t = Constant<value_t, shape_t>;
     using ptr_pack_t = util::PtrPack<value_t>;
 
+    static constexpr bool cse_aware = std::is_arithmetic_v<value_t>;
+    static constexpr bool soa_aware = std::is_arithmetic_v<value_t> &&
+                                      std::is_same_v<shape_t, ad::scl>;
+    static constexpr bool fuse_aware = std::is_arithmetic_v<value_t>;
+    static constexpr size_t fuse_scalars = 0;
+
     template <class T>
     Constant(const T& c)
         :c_(c)
@@ -146,6 +193,53 @@ public:
         }
     }
 
+    /**
+     * Two constants are equal subexpressions if they have the same values.
+     */
+    size_t cse_hash() const 
+    { 
+        const size_t n = rows() * cols();
+        size_t h = std::hash<value_t>()((n > 0) ? data()[0] : 0);
+        return util::hash_combine(h, n); 
+    }
+    bool cse_equal(const Constant& other) const 
+    { 
+        if constexpr (util::is_scl_v<this_t>) {
+            return c_ == other.c_;
+        } else {
+            return c_.rows() == other.c_.rows() &&
+                    c_.cols() == other.c_.cols() &&
+                    (c_.array() == other.c_.array()).all();
+        }
+    }
+    constexpr bool cse_reads(const void*, const void*) const { return false; }
+    constexpr bool cse_alias() const { return false; }
+
+    /**
+     * Fused element-wise evaluation (see FusedNode).
+     */
+    template <class T>
+    constexpr T fuse_bind(T begin) const { return begin; }
+
+    auto fuse_make() const { return std::tuple<util::fuse_block_t<value_t, shape_t>>(); }
+
+    template <class V>
+    void fuse_feval(size_t begin, size_t n, V& v) const
+    {
+        if constexpr (util::is_scl_v<this_t>) {
+            static_cast<void>(begin);
+            static_cast<void>(n);
+            std::get<0>(v) = c_;
+        } else {
+            std::get<0>(v) = Eigen::Map<const Eigen::Array<value_t, Eigen::Dynamic, 1>>(
+                    c_.data() + begin, n);
+        }
+    }
+
+    template <class V, class S>
+    void fuse_beval(size_t, size_t, const V&, const S&, value_t*) const {}
+    void fuse_flush(const value_t*) const {}
+
 private:
     var_t c_;
 };
@@ -171,18 +265,22 @@ inline auto constant_view(const ValueType* x,
 }
 
 template <class ValueType
-        , class = std::enable_if_t<std::is_arithmetic_v<ValueType>> >
+        , class = std::enable_if_t<std::is_arithmetic_v<ValueType> ||
+                                   util::is_simd_v<ValueType>> >
 inline auto constant(ValueType x)
 {
     return core::Constant<ValueType, ad::scl>(x);
 }
 
+/**
+ * The shape is ad::vec, or ad::fixed_vec if the size of x is known at compile-time.
+ */
 template <class Derived
         , class = std::enable_if_t<util::is_eigen_vector_v<Derived>> >
 inline auto constant(const Eigen::EigenBase<Derived>& x)
 {
     using value_t = typename Derived::Scalar;
-    return core::Constant<value_t, ad::vec>(x);
+    return core::Constant<value_t, util::eigen_shape_t<Derived>>(x);
 }
 
 /** 
@@ -199,4 +297,20 @@ inline auto constant(const Eigen::EigenBase<Derived>& x)
     return core::Constant<value_t, ShapeType>(x);
 }
 
+/**
+ * Matrices whose extents are known at compile-time have shape ad::fixed_mat.
+ */
+template <class Derived
+        , class = std::enable_if_t<
+            util::is_eigen_v<Derived> &&
+            Derived::ColsAtCompileTime != 1 &&
+            !std::is_void_v<util::eigen_shape_t<Derived>> &&
+            !util::is_eigen_matrix_v<Derived> > 
+        , class = void>
+inline auto constant(const Eigen::EigenBase<Derived>& x)
+{
+    using value_t = typename Derived::Scalar;
+    return core::Constant<value_t, util::eigen_shape_t<Derived>>(x);
+}
+
 } // namespace ad
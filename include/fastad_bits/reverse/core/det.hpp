@@ -2,6 +2,7 @@
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/llt.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/size_pack.hpp>
 #include <fastad_bits/util/value.hpp>
@@ -50,13 +51,24 @@ public:
         assert(expr.rows() == expr.cols());
     }
 
+    DetNode(const expr_t& expr,
+            const decomp_t& decomp)
+        : value_adj_view_t(nullptr, nullptr, 1, 1)
+        , expr_{expr}
+        , decomp_(decomp)
+    {
+        assert(expr.rows() == expr.cols());
+    }
+
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         return this->get() = decomp_.fmap(expr_.feval());
     }
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         if (seed == 0 || !decomp_.valid()) return;
         auto a_inv_t = decomp_.bmap().array();
         expr_.beval((seed * this->get()) * a_inv_t);
@@ -65,11 +77,7 @@ public:
     ptr_pack_t bind_cache(ptr_pack_t begin)
     {
         begin = expr_.bind_cache(begin);
-        auto adj = begin.adj;
-        begin.adj = nullptr;
-        begin = value_adj_view_t::bind(begin);
-        begin.adj = adj;
-        return begin;
+        return value_adj_view_t::bind_value(begin);
     }
 
     util::SizePack bind_cache_size() const 
@@ -83,6 +91,17 @@ public:
         return {this->size(), 0}; 
     }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(expr_);
+    }
+
+    /**
+     * Returns the factorization state shared with other nodes, if any (see ad::shared_llt).
+     */
+    const void* shared_state() const { return details::shared_state(decomp_); }
+
 private:
     using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
     expr_t expr_;
@@ -93,14 +112,17 @@ private:
 
 /*
  * Default method for decomposing a matrix for determinant.
+ * Decompositions are templated on the shape of the matrix
+ * so that fixed-size matrices (see ad::fixed_mat) use fixed-size decompositions.
  */
-template <class ValueType>
+template <class ValueType, class ShapeType = ad::mat>
 struct DetFullPivLU
 {
     using value_t = ValueType;
 
     DetFullPivLU(size_t rows)
         : lu_(rows, rows)
+        , inv_t_(rows, rows)
     {}
     
     template <class T>
@@ -110,22 +132,32 @@ struct DetFullPivLU
         return lu_.determinant();
     }
 
-    auto bmap() const 
+    // Since P A Q = L U, A^{-T} = P^T L^{-T} U^{-T} Q^T.
+    // Solved in-place into a preallocated workspace,
+    // since lu_.inverse() allocates every time.
+    const auto& bmap()
     {
-        return lu_.inverse().transpose();
+        const auto& lu = lu_.matrixLU();
+        inv_t_.setIdentity();
+        inv_t_ = lu_.permutationQ().transpose() * inv_t_;
+        lu.template triangularView<Eigen::Upper>().transpose().solveInPlace(inv_t_);
+        lu.template triangularView<Eigen::UnitLower>().transpose().solveInPlace(inv_t_);
+        inv_t_ = lu_.permutationP().transpose() * inv_t_;
+        return inv_t_;
     }
 
     bool valid() const { return lu_.isInvertible(); }
 
 private:
-    using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
+    using mat_t = util::constant_var_t<value_t, ShapeType>;
     Eigen::FullPivLU<mat_t> lu_;
+    mat_t inv_t_;
 };
 
 /*
  * Decomposing a positive or negative semi-definite matrix for determinant.
  */
-template <class ValueType>
+template <class ValueType, class ShapeType = ad::mat>
 struct DetLDLT
 {
     using value_t = ValueType;
@@ -155,7 +187,7 @@ struct DetLDLT
     bool valid() const { return valid_; }
 
 private:
-    using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
+    using mat_t = util::constant_var_t<value_t, ShapeType>;
     bool valid_ = false;
     Eigen::LDLT<mat_t> ldlt_;
     mat_t inv_;
@@ -163,42 +195,36 @@ private:
 
 /*
  * Decomposing a positive definite matrix for determinant.
+ * The factorization may be shared with other nodes on the same matrix (see ad::shared_llt).
  */
-template <class ValueType>
+template <class ValueType, class ShapeType = ad::mat>
 struct DetLLT
 {
     using value_t = ValueType;
 
     DetLLT(size_t rows)
         : llt_(rows)
-        , inv_()
+    {}
+
+    DetLLT(const LLTFactor<value_t, ShapeType>& llt)
+        : llt_(llt)
     {}
     
     template <class T>
     value_t fmap(const Eigen::MatrixBase<T>& X)
     {
         llt_.compute(X);
-        value_t det = llt_.matrixL().determinant();
-        return det * det;
+        return llt_.det();
     }
 
-    // Important to save the inverse, since otherwise Eigen
-    // will dynamically allocate every time and result in bad-alloc.
-    const auto& bmap() 
-    {
-        size_t n = llt_.rows();
-        return inv_ = llt_.solve(mat_t::Identity(n, n));
-    }
+    const auto& bmap() const { return llt_.inverse(); }
 
-    bool valid() const 
-    {
-        return (llt_.info() == Eigen::Success); 
-    }
+    bool valid() const { return llt_.valid(); }
+
+    const void* shared_state() const { return llt_.shared_state(); }
 
 private:
-    using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
-    Eigen::LLT<mat_t> llt_;
-    mat_t inv_;
+    LLTFactor<value_t, ShapeType> llt_;
 };
 
 /*
@@ -208,7 +234,7 @@ private:
  * If x is a constant, the decomposition is ignored and 
  * will always just invoke member function determinant of the underlying Eigen object.
  */
-template <template <class> class DecompType = DetFullPivLU
+template <template <class...> class DecompType = DetFullPivLU
         , class T
         , class = std::enable_if_t<
             util::is_convertible_to_ad_v<T> &&
@@ -226,7 +252,37 @@ inline auto det(const T& x)
         var_t out = expr.feval().determinant();
         return ad::constant(out);
     } else {
-        return core::DetNode<DecompType<value_t>, expr_t>(expr);
+        return core::DetNode<DecompType<value_t, typename util::shape_traits<expr_t>::shape_t>, expr_t>(expr);
+    }
+}
+
+/*
+ * Creates a determinant expression node with DetLLT
+ * that shares the Cholesky factorization llt with other nodes on x (see ad::shared_llt).
+ */
+template <class T
+        , class ValueType
+        , class ShapeType
+        , class = std::enable_if_t<
+            util::is_convertible_to_ad_v<T> &&
+            util::any_ad_v<T> > >
+inline auto det(const T& x,
+                const LLTFactor<ValueType, ShapeType>& llt)
+{
+    using expr_t = util::convert_to_ad_t<T>;
+    using value_t = typename util::expr_traits<expr_t>::value_t;
+    static_assert(std::is_same_v<value_t, ValueType>);
+    expr_t expr = x;
+
+    // optimization for when expression is constant
+    if constexpr (util::is_constant_v<expr_t>) {
+        static_assert(!util::is_scl_v<expr_t>);
+        using var_t = util::constant_var_t<value_t, ad::scl>;
+        var_t out = expr.feval().determinant();
+        return ad::constant(out);
+    } else {
+        using decomp_t = DetLLT<value_t, ShapeType>;
+        return core::DetNode<decomp_t, expr_t>(expr, decomp_t(llt));
     }
 }
 
@@ -2,6 +2,8 @@
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/sparse.hpp>
+#include <fastad_bits/util/numeric.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/value.hpp>
 #include <fastad_bits/util/size_pack.hpp>
@@ -11,8 +13,27 @@ namespace core {
 namespace details {
 
 /*
- * Returns the the dot-product shape given left and right shapes
+ * Returns the the dot-product shape given left and right shapes.
+ * The product of fixed-size shapes is fixed-size (see ad::fixed_mat).
  */
+template <class T, class U, class Default>
+struct fixed_dot_shape
+{
+    using type = Default;
+};
+
+template <size_t R, size_t K, class Default>
+struct fixed_dot_shape<ad::fixed_mat<R, K>, ad::fixed_vec<K>, Default>
+{
+    using type = ad::fixed_vec<R>;
+};
+
+template <size_t R, size_t K, size_t C, class Default>
+struct fixed_dot_shape<ad::fixed_mat<R, K>, ad::fixed_mat<K, C>, Default>
+{
+    using type = ad::fixed_mat<R, C>;
+};
+
 template <class T, class U, class=void>
 struct dot_shape;
 
@@ -21,13 +42,35 @@ struct dot_shape<T, U, std::enable_if_t<
                         util::is_mat_v<T> &&
                         util::is_vec_v<U>> >
 {
-    using type = ad::vec;
+    using type = typename fixed_dot_shape<
+        typename util::shape_traits<T>::shape_t,
+        typename util::shape_traits<U>::shape_t,
+        ad::vec>::type;
 };
 
 template <class T, class U>
 struct dot_shape<T, U, std::enable_if_t<
                         util::is_mat_v<T> &&
                         util::is_mat_v<U>> >
+{
+    using type = typename fixed_dot_shape<
+        typename util::shape_traits<T>::shape_t,
+        typename util::shape_traits<U>::shape_t,
+        ad::mat>::type;
+};
+
+template <class T, class U>
+struct dot_shape<T, U, std::enable_if_t<
+                        util::is_sparse_v<T> &&
+                        util::is_vec_v<U>> >
+{
+    using type = ad::vec;
+};
+
+template <class T, class U>
+struct dot_shape<T, U, std::enable_if_t<
+                        util::is_sparse_v<T> &&
+                        util::is_mat_v<U>> >
 {
     using type = ad::mat;
 };
@@ -49,14 +92,16 @@ using dot_shape_t = typename dot_shape<T,U>::type;
  *
  * @tparam  LHSExprType     type of left expression
  * @tparam  RHSExprType     type of right expression
+ * @tparam  AccumType       type to accumulate the products in (see util::accum_t)
  */
 
 template <class LHSExprType
-        , class RHSExprType>
+        , class RHSExprType
+        , class AccumType = void>
 struct DotNode:
     ValueAdjView<typename util::expr_traits<LHSExprType>::value_t,
                  details::dot_shape_t<LHSExprType, RHSExprType>>,
-    ExprBase<DotNode<LHSExprType, RHSExprType>>
+    ExprBase<DotNode<LHSExprType, RHSExprType, AccumType>>
 {
 private:
     using lhs_t = LHSExprType;
@@ -77,6 +122,8 @@ public:
     using typename value_adj_view_t::var_t;
     using typename value_adj_view_t::ptr_pack_t;
 
+    static constexpr bool fuse_rebuildable = true;
+
     DotNode(const lhs_t& lhs,
             const rhs_t& rhs)
         : value_adj_view_t(nullptr, nullptr, lhs.rows(), rhs.cols())
@@ -88,17 +135,21 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& lhs_val = lhs_.feval();
         auto&& rhs_val = rhs_.feval();
-        return this->get() = lhs_val * rhs_val;
+        return this->get() = util::accum_product<AccumType>(lhs_val, rhs_val);
     }
 
     template <class T>
     void beval(const T& seed)
     {
+        FASTAD_PROFILE(beval);
         util::to_array(this->get_adj()) = seed;
-        auto a_ladj = util::to_array(this->get_adj() * rhs_.get().transpose());
-        auto a_radj = util::to_array(lhs_.get().transpose() * this->get_adj());
+        auto a_ladj = util::to_array(
+                util::accum_product<AccumType>(this->get_adj(), rhs_.get().transpose()));
+        auto a_radj = util::to_array(
+                util::accum_product<AccumType>(lhs_.get().transpose(), this->get_adj()));
         rhs_.beval(a_radj);
         lhs_.beval(a_ladj);
     }
@@ -122,6 +173,127 @@ public:
         return {this->size(), this->size()};
     }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(lhs_);
+        f(rhs_);
+    }
+
+    /**
+     * Rebuilds the node with f applied to its children (see ad::fuse).
+     */
+    template <class F>
+    auto fuse_rebuild(F&& f) const
+    {
+        auto lhs = f(lhs_);
+        auto rhs = f(rhs_);
+        return DotNode<decltype(lhs), decltype(rhs), AccumType>(lhs, rhs);
+    }
+
+
+private:
+    lhs_t lhs_;
+    rhs_t rhs_;
+};
+
+/**
+ * SparseDotNode represents the product of a sparse matrix (see ad::sparse)
+ * with a dense matrix or column vector.
+ * The left expression must be a sparse VarView or ConstantView.
+ *
+ * Forward evaluation is a sparse-dense product
+ * and backward evaluation propagates the sparse-transpose product to the right expression.
+ * If the sparse matrix is a variable, only the adjoints of its stored entries are computed
+ * (see VarView::beval_product), so that time and memory scale with the number of nonzeros
+ * rather than rows x cols.
+ *
+ * @tparam  LHSExprType     type of left (sparse) expression
+ * @tparam  RHSExprType     type of right expression
+ */
+
+template <class LHSExprType
+        , class RHSExprType>
+struct SparseDotNode:
+    ValueAdjView<typename util::expr_traits<LHSExprType>::value_t,
+                 details::dot_shape_t<LHSExprType, RHSExprType>>,
+    ExprBase<SparseDotNode<LHSExprType, RHSExprType>>
+{
+private:
+    using lhs_t = LHSExprType;
+    using rhs_t = RHSExprType;
+    using lhs_value_t = typename 
+        util::expr_traits<lhs_t>::value_t;
+
+    static_assert(util::is_sparse_v<lhs_t>);
+    static_assert(std::is_same_v<
+            typename util::expr_traits<lhs_t>::value_t,
+            typename util::expr_traits<rhs_t>::value_t>);
+
+public:
+    using value_adj_view_t = ValueAdjView<lhs_value_t,
+          details::dot_shape_t<lhs_t, rhs_t> >;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    SparseDotNode(const lhs_t& lhs,
+                  const rhs_t& rhs)
+        : value_adj_view_t(nullptr, nullptr, lhs.rows(), rhs.cols())
+        , lhs_{lhs}
+        , rhs_{rhs}
+    {
+        assert(lhs.cols() == rhs.rows());
+    }
+
+    const var_t& feval()
+    {
+        FASTAD_PROFILE(feval);
+        auto lhs_val = lhs_.feval();
+        auto&& rhs_val = rhs_.feval();
+        this->get().noalias() = lhs_val * rhs_val;
+        return this->get();
+    }
+
+    template <class T>
+    void beval(const T& seed)
+    {
+        FASTAD_PROFILE(beval);
+        util::to_array(this->get_adj()) = seed;
+        auto lhs_val = lhs_.get();
+        if constexpr (!util::is_constant_v<lhs_t>) {
+            lhs_.beval_product(this->get_adj(), rhs_.get());
+        }
+        auto a_radj = util::to_array(lhs_val.transpose() * this->get_adj());
+        rhs_.beval(a_radj);
+    }
+
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        begin = lhs_.bind_cache(begin);
+        begin = rhs_.bind_cache(begin);
+        return value_adj_view_t::bind(begin);
+    }
+
+    util::SizePack bind_cache_size() const 
+    { 
+        return single_bind_cache_size() + 
+                lhs_.bind_cache_size() + 
+                rhs_.bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const
+    {
+        return {this->size(), this->size()};
+    }
+
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(lhs_);
+        f(rhs_);
+    }
 
 private:
     lhs_t lhs_;
@@ -130,7 +302,8 @@ private:
 
 } // namespace core
 
-template <class T1
+template <class AccumType = void
+        , class T1
         , class T2
         , class = std::enable_if_t<
             !util::is_scl_v<util::convert_to_ad_t<T1>> &&
@@ -157,8 +330,10 @@ inline auto dot(const T1& x,
         using var_t = util::constant_var_t<expr2_value_t, shape_t>;
         var_t out = expr1.feval() * expr2.feval();
         return ad::constant(out);
+    } else if constexpr (util::is_sparse_v<expr1_t>) {
+        return core::SparseDotNode<expr1_t, expr2_t>(expr1, expr2);
     } else {
-        return core::DotNode<expr1_t, expr2_t>(expr1, expr2);
+        return core::DotNode<expr1_t, expr2_t, AccumType>(expr1, expr2);
     }
 }
 
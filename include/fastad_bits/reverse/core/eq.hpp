@@ -1,6 +1,8 @@
 #pragma once
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/util/cse_registry.hpp>
+#include <fastad_bits/util/numeric.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/size_pack.hpp>
 #include <fastad_bits/util/ptr_pack.hpp>
@@ -67,6 +69,11 @@ public:
     using typename value_adj_view_t::var_t;
     using typename value_adj_view_t::ptr_pack_t;
 
+    static constexpr bool fuse_rebuildable = true;
+
+    // the root of the expression views the placeholder (see memory_report)
+    static constexpr bool rebinds_child_root = true;
+
     EqNode(const var_view_t& var_view, 
            const expr_t& expr)
         : value_adj_view_t(nullptr, nullptr,
@@ -88,6 +95,7 @@ public:
      */
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         return this->get() = var_view_.get() = expr_.feval();
     }
 
@@ -101,6 +109,7 @@ public:
     template <class T>
     void beval(const T& seed)
     {
+        FASTAD_PROFILE(beval);
         var_view_.beval(seed);
         auto&& a_adj = util::to_array(var_view_.get_adj());
         expr_.beval(a_adj);
@@ -114,6 +123,13 @@ public:
      * are viewing the same values to save space and copying.
      * Ignores expression if it is a VarView.
      *
+     * If bound with common subexpression elimination,
+     * the root is not rebound if it already views the cache of an equal expression
+     * (its value is then copied into the placeholder on forward evaluation),
+     * and is never registered, since it now views the placeholder.
+     * Every registered expression that reads the placeholder is invalidated.
+     * The placeholder is registered to the leaf registry, if any (see util::LeafRegistry).
+     *
      * @return  next pointer not bound by expression.
      */
     ptr_pack_t bind_cache(ptr_pack_t begin)
@@ -124,13 +140,29 @@ public:
         value_adj_view_t::bind(var_ptr_pack);
 
         begin = expr_.bind_cache(begin);
-        auto size_pack = expr_.single_bind_cache_size();
-        begin.val -= size_pack(0);
-        begin.adj -= size_pack(1);
 
-        // only bind root to var_view's values, not recursively down
-        using expr_value_adj_view_t = typename expr_t::value_adj_view_t;
-        static_cast<expr_value_adj_view_t&>(expr_).bind(var_ptr_pack);
+        bool is_alias = false;
+        if constexpr (util::is_cse_aware_v<expr_t>) {
+            is_alias = expr_.cse_alias();
+        }
+
+        if (!is_alias) {
+            begin.release(expr_.single_bind_cache_size());
+
+            // only bind root to var_view's values, not recursively down
+            using expr_value_adj_view_t = typename expr_t::value_adj_view_t;
+            static_cast<expr_value_adj_view_t&>(expr_).bind(var_ptr_pack);
+        }
+
+        if (begin.cse) {
+            begin.cse->erase(&expr_);
+            begin.cse->invalidate(var_view_.data(), 
+                                  var_view_.data() + var_view_.size());
+        }
+        if (begin.leaves) {
+            begin.leaves->add(var_view_.data(), var_view_.data_adj(),
+                              var_view_.size(), true);
+        }
 
         return begin;
     }
@@ -153,6 +185,27 @@ public:
     util::SizePack single_bind_cache_size() const
     { return {0,0}; }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(expr_);
+    }
+
+    /**
+     * Rebuilds the node with f applied to its children (see ad::fuse).
+     */
+    template <class F>
+    auto fuse_rebuild(F&& f) const
+    {
+        auto expr = f(expr_);
+        return EqNode<var_view_t, decltype(expr)>(var_view_, expr);
+    }
+
+    /**
+     * Returns the placeholder assigned by this node.
+     */
+    const var_view_t& placeholder() const { return var_view_; }
+
 private:
     var_view_t var_view_;
     expr_t expr_;
@@ -239,6 +292,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         cache_.get() = var_view_.get();  // save previous lhs
         auto&& a_v = util::to_array(var_view_.get());
         auto&& a_expr = util::to_array(expr_.feval());
@@ -249,6 +303,7 @@ public:
     template <class T>
     void beval(const T& seed)
     {
+        FASTAD_PROFILE(beval);
         var_view_.beval(seed);
 
         // copy old value first before back-evaluating 
@@ -275,12 +330,24 @@ public:
      * binds the RHS expression, but DOES NOT bind the root of RHS to LHS like EqNode.
      * Needs to cache the previous LHS value, so we store a member value viewer to bind.
      *
+     * If bound with common subexpression elimination,
+     * every registered expression that reads the variable is invalidated.
+     * The variable is registered to the leaf registry as a placeholder, if any.
+     *
      * @return  next pointer not bound by expression or itself.
      */
     ptr_pack_t bind_cache(ptr_pack_t begin)
     {
         value_adj_view_t::bind({var_view_.data(), var_view_.data_adj()});
         begin = expr_.bind_cache(begin);
+        if (begin.cse) {
+            begin.cse->invalidate(var_view_.data(),
+                                  var_view_.data() + var_view_.size());
+        }
+        if (begin.leaves) {
+            begin.leaves->add(var_view_.data(), var_view_.data_adj(),
+                              var_view_.size(), true);
+        }
         begin = cache_.bind(begin);
         return begin;
     }
@@ -296,6 +363,17 @@ public:
         return {cache_.size(), cache_.size()}; 
     }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(expr_);
+    }
+
+    /**
+     * Returns the placeholder assigned by this node.
+     */
+    const var_view_t& placeholder() const { return var_view_; }
+
 private:
     value_adj_view_t cache_;
     var_view_t var_view_;
@@ -312,7 +390,7 @@ struct AddEq
     static inline constexpr auto blmap(const S& seed, const T&, const U&) 
     {
         if constexpr (!util::is_eigen_v<T> && util::is_eigen_v<U>) {
-            return seed.sum();
+            return util::accum_sum(seed);
         } else {
             return seed;
         }
@@ -322,7 +400,7 @@ struct AddEq
     static inline constexpr auto brmap(const S& seed, const T&, const U&) 
     { 
         if constexpr (util::is_eigen_v<T> && !util::is_eigen_v<U>) {
-            return seed.sum();
+            return util::accum_sum(seed);
         } else {
             return seed;
         }
@@ -339,7 +417,7 @@ struct SubEq
     static inline constexpr auto blmap(const S& seed, const T&, const U&) 
     {
         if constexpr (!util::is_eigen_v<T> && util::is_eigen_v<U>) {
-            return seed.sum();
+            return util::accum_sum(seed);
         } else {
             return seed;
         }
@@ -349,7 +427,7 @@ struct SubEq
     static inline constexpr auto brmap(const S& seed, const T&, const U&) 
     { 
         if constexpr (util::is_eigen_v<T> && !util::is_eigen_v<U>) {
-            return -(seed.sum());
+            return -util::accum_sum(seed);
         } else {
             return -seed;
         }
@@ -366,7 +444,7 @@ struct MulEq
     static inline constexpr auto blmap(const S& seed, const T&, const U& y) 
     { 
         if constexpr (!util::is_eigen_v<T> && util::is_eigen_v<U>) {
-            return (seed * y).sum();
+            return util::accum_sum(seed * y);
         } else {
             return seed * y;
         }
@@ -376,7 +454,7 @@ struct MulEq
     static inline constexpr auto brmap(const S& seed, const T& x, const U&) 
     { 
         if constexpr (util::is_eigen_v<T> && !util::is_eigen_v<U>) {
-            return (seed * x).sum();
+            return util::accum_sum(seed * x);
         } else {
             return seed * x;
         }
@@ -393,7 +471,7 @@ struct DivEq
     static inline constexpr auto blmap(const S& seed, const T&, const U& y) 
     { 
         if constexpr (!util::is_eigen_v<T> && util::is_eigen_v<U>) {
-            return (seed / y).sum();
+            return util::accum_sum(seed / y);
         } else {
             return seed / y;
         }
@@ -404,7 +482,7 @@ struct DivEq
     { 
         static_cast<void>(x);
         if constexpr (util::is_eigen_v<T> && !util::is_eigen_v<U>) {
-            return (-seed * x / (y * y)).sum();
+            return util::accum_sum(-seed * x / (y * y));
         } else {
             return -seed * x / (y * y);
         }
@@ -1,4 +1,5 @@
 #pragma once
+#include <cassert>
 #include <cstdlib>
 #include <type_traits>
 #include <tuple>
@@ -61,6 +62,7 @@ inline std::enable_if_t<util::is_scl_v<std::decay_t<ExprType>>>
 evaluate_adj(core::ExprBind<ExprType>& expr, 
              typename util::expr_traits<std::decay_t<ExprType>>::value_t seed = 1.)
 {
+    assert(!expr.forward_only());
     evaluate_adj(expr.get(), seed);
 }
 
@@ -69,6 +71,7 @@ inline std::enable_if_t<!util::is_scl_v<std::decay_t<ExprType>>>
 evaluate_adj(core::ExprBind<ExprType>&& expr, 
              const Eigen::ArrayBase<T>& seed)
 {
+    assert(!expr.forward_only());
     evaluate_adj(expr.get(), seed);
 }
 
@@ -119,6 +122,7 @@ inline auto autodiff(core::ExprBind<ExprType>& expr,
                      typename util::expr_traits<
                         std::decay_t<ExprType>>::value_t seed = 1.)
 {
+    assert(!expr.forward_only());
     return autodiff(expr.get(), seed);
 }
 
@@ -129,6 +133,7 @@ template <class ExprType
 inline auto autodiff(core::ExprBind<ExprType>& expr,
                      const Eigen::ArrayBase<T>& seed)
 {
+    assert(!expr.forward_only());
     return autodiff(expr.get(), seed);
 }
 
@@ -139,6 +144,7 @@ inline auto autodiff(core::ExprBind<ExprType>&& expr,
                      typename util::expr_traits<
                         std::decay_t<ExprType>>::value_t seed = 1.)
 {
+    assert(!expr.forward_only());
     return autodiff(expr.get(), seed);
 }
 
@@ -149,6 +155,49 @@ template <class ExprType
 inline auto autodiff(core::ExprBind<ExprType>&& expr,
                      const Eigen::ArrayBase<T>& seed)
 {
+    assert(!expr.forward_only());
+    return autodiff(expr.get(), seed);
+}
+
+/**
+ * Tag to evaluate an ExprBind from a fresh gradient (see ExprBind::reset_adjoints).
+ */
+struct fresh_t {};
+inline constexpr fresh_t fresh{};
+
+/** 
+ * Evaluates expression both in the forward and backward direction of reverse-mode AD
+ * after zeroing the adjoints of every leaf and placeholder of the expression,
+ * so that the adjoints hold exactly the gradient of this evaluation.
+ *
+ * @tparam ExprType expression type
+ * @param expr  expression to forward and backward evaluate
+ * Returns the forward expression value
+ */
+
+template <class ExprType
+        , class = std::enable_if_t<util::is_scl_v<std::decay_t<ExprType>>> 
+        >
+inline auto autodiff(core::ExprBind<ExprType>& expr,
+                     fresh_t,
+                     typename util::expr_traits<
+                        std::decay_t<ExprType>>::value_t seed = 1.)
+{
+    assert(!expr.forward_only());
+    expr.reset_adjoints();
+    return autodiff(expr.get(), seed);
+}
+
+template <class ExprType
+        , class T
+        , class = std::enable_if_t<!util::is_scl_v<std::decay_t<ExprType>>> 
+        >
+inline auto autodiff(core::ExprBind<ExprType>& expr,
+                     fresh_t,
+                     const Eigen::ArrayBase<T>& seed)
+{
+    assert(!expr.forward_only());
+    expr.reset_adjoints();
     return autodiff(expr.get(), seed);
 }
 
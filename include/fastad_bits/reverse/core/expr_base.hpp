@@ -1,5 +1,9 @@
 #pragma once
 #include <type_traits>
+#include <fastad_bits/util/macros.hpp>
+#ifdef FASTAD_ENABLE_PROFILING
+#include <fastad_bits/util/profile.hpp>
+#endif
 
 namespace ad {
 namespace core {
@@ -11,6 +15,9 @@ namespace core {
  * like the Basic Nodes as well as ForEach, etc.
  * This is mainly used for type-checking when operator overloading and defining
  * user-friendly functions for math operations.
+ *
+ * If FASTAD_ENABLE_PROFILING is defined, it also holds the profiling statistics
+ * of the node (see util::ProfileStat).
  */
 
 template <class Derived>
@@ -20,6 +27,14 @@ struct ExprBase
     { return *static_cast<const Derived*>(this); }
     Derived& self()
     { return *static_cast<Derived*>(this); }
+
+#ifdef FASTAD_ENABLE_PROFILING
+    util::ProfileStat& profile_stat() { return profile_stat_; }
+    const util::ProfileStat& profile_stat() const { return profile_stat_; }
+
+private:
+    util::ProfileStat profile_stat_;
+#endif
 };
 
 } // namespace core
@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include <vector>
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/util/type_traits.hpp>
@@ -54,6 +56,7 @@ public:
      */
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         if (vec_.size() == 0) { return this->get(); }
         std::for_each(vec_.begin(), vec_.end(), 
                 [](auto& expr) { expr.feval(); }
@@ -69,6 +72,7 @@ public:
     template <class T>
     void beval(const T& seed)
     {
+        FASTAD_PROFILE(beval);
         if (vec_.size() == 0) return;
         auto it = vec_.rbegin();
         it->beval(seed);
@@ -106,8 +110,191 @@ public:
 
     util::SizePack single_bind_cache_size() const { return {0,0}; }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        for (const auto& expr : vec_) f(expr);
+    }
+
+private:
+    std::vector<vec_elem_t> vec_;
+};
+
+/**
+ * CheckpointForEachIterNode represents the same collection of expressions as ForEachIterNode,
+ * but only keeps the caches of stride consecutive expressions (steps) at any time.
+ * This is useful for long chains of time-steps where ForEachIterNode
+ * would need a cache that grows linearly with the number of steps.
+ *
+ * Step i is bound to slot i % stride, where every slot is large enough for any step.
+ * Steps [s * stride, (s+1) * stride) form segment s.
+ * Forward evaluation evaluates every step in order,
+ * so that only the last segment remains in the slots.
+ * Backward evaluation processes segments in reverse order and
+ * recomputes (forward evaluates) a segment if it is not currently in the slots
+ * before backward evaluating its steps in reverse order.
+ *
+ * Recomputing a step only relies on the values of the variables and placeholders it reads,
+ * so every step must be re-evaluable: it may only assign to placeholders with EqNode
+ * (no compound assignments such as +=), and it must not assign to a placeholder
+ * that is read by an earlier step.
+ * This holds for the usual time-stepping chain w[i+1] = f(w[i]).
+ *
+ * The total cache size is stride times the largest step cache size (plus the node value),
+ * and the total number of recomputed steps is the number of steps before the last segment.
+ * Hence stride trades memory for recomputation:
+ * stride >= number of steps never recomputes, and stride == 1 keeps a single step cache.
+ *
+ * @tparam  VecType     type of vector of expressions to for-each over 
+ */
+
+template <class VecType>
+struct CheckpointForEachIterNode: 
+    ValueAdjView<typename util::expr_traits< 
+                    typename VecType::value_type >::value_t,
+                 typename util::shape_traits< 
+                    typename VecType::value_type >::shape_t >,
+    ExprBase<CheckpointForEachIterNode<VecType>>
+{
+private:
+    using vec_elem_t = typename VecType::value_type;
+    using elem_value_t = typename util::expr_traits<vec_elem_t>::value_t;
+    using elem_shape_t = typename util::shape_traits<vec_elem_t>::shape_t;
+
+public:
+    using value_adj_view_t = ValueAdjView<elem_value_t, elem_shape_t>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    // the expressions share the slots (see memory_report)
+    static constexpr bool binds_subtree = true;
+
+    CheckpointForEachIterNode(const VecType& vec, size_t stride)
+        : value_adj_view_t(nullptr, nullptr,
+                           (vec.size() == 0) ? 0 : vec[0].rows(),
+                           (vec.size() == 0) ? 0 : vec[0].cols())
+        , vec_(vec)
+        , stride_(std::max<size_t>(stride, 1))
+        , curr_segment_(n_segments())
+    {}
+
+    /** 
+     * Forward evaluation on every functored expression in order.
+     * Afterwards, the last segment is the one cached.
+     * If there are no expressions, it is undefined behavior
+     * doing any computations with the return value.
+     *
+     * @return  copy of the last functored expression forward evaluation value
+     */
+    const var_t& feval()
+    {
+        FASTAD_PROFILE(feval);
+        if (vec_.size() == 0) { return this->get(); }
+        for (auto& expr : vec_) {
+            expr.feval();
+        }
+        curr_segment_ = n_segments() - 1;
+        return this->get() = vec_.back().get();
+    }
+
+    /**
+     * Backward evaluation seeds the last functored expression with seed,
+     * and backward evaluates every expression in reverse order with 0 seed
+     * (see ForEachIterNode::beval).
+     * Every segment that is not currently cached is first recomputed.
+     * It is assumed that feval is called before beval.
+     */
+    template <class T>
+    void beval(const T& seed)
+    {
+        FASTAD_PROFILE(beval);
+        if (vec_.size() == 0) return;
+        const size_t n = vec_.size();
+        for (size_t s = n_segments(); s-- > 0;) {
+            const size_t begin = s * stride_;
+            const size_t end = std::min(begin + stride_, n);
+            if (s != curr_segment_) {
+                for (size_t i = begin; i < end; ++i) {
+                    vec_[i].feval();
+                }
+                curr_segment_ = s;
+            }
+            for (size_t i = end; i-- > begin;) {
+                if (i == n-1) vec_[i].beval(seed);
+                else vec_[i].beval(0);
+            }
+        }
+    }
+
+    /**
+     * Binds every expression to its slot, then binds its own value after all slots.
+     * Slots are overwritten by recomputation, so common subexpression elimination
+     * is suspended while binding the expressions.
+     * The value is owned (rather than viewing the last expression)
+     * since the slot of the last expression may be overwritten by recomputation.
+     * The adjoint is not bound since seeds are passed on directly.
+     *
+     * @return  the next pointer pack not bound by any slot or itself.
+     */
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        if (vec_.size() == 0) return begin;
+        const util::SizePack slot_size = max_bind_cache_size();
+        if (begin.cse) begin.cse->suspend();
+        for (size_t i = 0; i < vec_.size(); ++i) {
+            ptr_pack_t slot = begin;
+            slot.skip(slot_size * (i % stride_));
+            vec_[i].bind_cache(slot);
+        }
+        if (begin.cse) begin.cse->resume();
+        begin.skip(slot_size * n_slots());
+        curr_segment_ = n_segments();
+        return value_adj_view_t::bind_value(begin);
+    }
+
+    /**
+     * Returns the peak cache size needed,
+     * which is the number of slots times the largest step cache size,
+     * and the values of the node itself.
+     * @return  size pack
+     */
+    util::SizePack bind_cache_size() const 
+    { 
+        return max_bind_cache_size() * n_slots() +
+                single_bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const 
+    { 
+        return {(vec_.size() == 0) ? 0 : this->size(), 0}; 
+    }
+
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        for (const auto& expr : vec_) f(expr);
+    }
+
+    size_t stride() const { return stride_; }
+
 private:
+    size_t n_slots() const { return std::min(stride_, vec_.size()); }
+    size_t n_segments() const { return (vec_.size() + stride_ - 1) / stride_; }
+
+    util::SizePack max_bind_cache_size() const
+    {
+        util::SizePack out = util::SizePack::Zero();
+        for (const auto& expr : vec_) {
+            out = out.max(expr.bind_cache_size());
+        }
+        return out;
+    }
+
     std::vector<vec_elem_t> vec_;
+    size_t stride_;
+    size_t curr_segment_;   // segment currently in the slots (n_segments() if none)
 };
 
 } // namespace core
@@ -128,4 +315,24 @@ inline auto for_each(Iter begin, Iter end, Lmda f)
     return core::ForEachIterNode<std::vector<expr_t>>(exprs);
 }
 
+/**
+ * Helper function to create a CheckpointForEachIterNode.
+ * Only the caches of stride consecutive expressions are kept at any time,
+ * and the rest are recomputed during backward evaluation.
+ *
+ * @param   stride  number of expressions whose caches are kept
+ */
+template <class Iter, class Lmda>
+inline auto checkpointed_for_each(Iter begin, Iter end, Lmda f, size_t stride)
+{
+    using expr_t = std::decay_t<decltype(f(*begin))>;
+    std::vector<expr_t> exprs;
+    exprs.reserve(std::distance(begin, end));
+    std::for_each(begin, end, 
+            [&](const auto& x) {
+                exprs.emplace_back(f(x));
+            });
+    return core::CheckpointForEachIterNode<std::vector<expr_t>>(exprs, stride);
+}
+
 } // namespace ad
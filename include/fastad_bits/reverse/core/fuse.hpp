@@ -0,0 +1,208 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/util/fuse.hpp>
+#include <fastad_bits/util/shape_traits.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/value.hpp>
+
+namespace ad {
+namespace core {
+
+/**
+ * FusedNode evaluates a chain of element-wise operations on vectors or matrices
+ * (UnaryNode, BinaryNode, PowNode on variables and constants) as a single node.
+ * Ex.
+ * exp(-0.5 * pow<2>((x - mu) / sigma))
+ *
+ * Unfused, every node of the expression caches a value and an adjoint as large as x,
+ * and each of them is written and read back once in each direction.
+ * Instead, the fused node walks the elements in blocks of util::fuse_block_size,
+ * and computes the values of every node of a block in temporaries that stay in cache.
+ * Forward evaluation only stores the value of the root,
+ * and backward evaluation recomputes the values of a block
+ * then propagates the adjoints of the block down to the leaves right away.
+ * Hence only the root caches a value and an adjoint,
+ * at the cost of evaluating the operations once more during backward evaluation.
+ *
+ * Adjoints of scalar leaves (e.g. mu, sigma) are summed over the blocks
+ * and added to the leaves once at the end of backward evaluation.
+ *
+ * @tparam  ExprType    type of element-wise expression (see util::is_fuse_aware_v)
+ */
+
+template <class ExprType>
+struct FusedNode:
+    ValueAdjView<typename util::expr_traits<ExprType>::value_t,
+                 typename util::shape_traits<ExprType>::shape_t>,
+    ExprBase<FusedNode<ExprType>>
+{
+private:
+    using expr_t = ExprType;
+    static_assert(util::is_fuse_aware_v<expr_t>);
+    static_assert(!util::is_scl_v<expr_t>,
+                  "fused evaluation only supports vector and matrix expressions");
+
+    using block_t = decltype(std::declval<expr_t&>().fuse_make());
+
+public:
+    using value_adj_view_t = ValueAdjView<
+        typename util::expr_traits<expr_t>::value_t,
+        typename util::shape_traits<expr_t>::shape_t >;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    // the expression binds no cache of its own (see memory_report)
+    static constexpr bool binds_subtree = true;
+
+    FusedNode(const expr_t& expr)
+        : value_adj_view_t(nullptr, nullptr, expr.rows(), expr.cols())
+        , expr_(expr)
+    {}
+
+    /**
+     * Forward evaluation computes the values of the expression block by block
+     * and caches only the values of the root.
+     *
+     * @return  const reference of the cached result.
+     */
+    const var_t& feval()
+    {
+        FASTAD_PROFILE(feval);
+        block_t v;
+        for (size_t begin = 0; begin < this->size(); begin += util::fuse_block_size) {
+            const size_t n = std::min(util::fuse_block_size, this->size() - begin);
+            expr_.fuse_feval(begin, n, v);
+            Eigen::Map<Eigen::Array<value_t, Eigen::Dynamic, 1>>(
+                    this->data() + begin, n) = std::get<0>(v);
+        }
+        return this->get();
+    }
+
+    /**
+     * Backward evaluation sets current adjoint to seed,
+     * then for every block recomputes the values of the expression
+     * and backward evaluates it with the adjoints of the block.
+     * It is assumed that feval is called before beval.
+     */
+    template <class T>
+    void beval(const T& seed)
+    {
+        FASTAD_PROFILE(beval);
+        auto&& a_adj = util::to_array(this->get_adj());
+        a_adj = seed;
+
+        // one more element so that the array is never empty
+        std::array<value_t, expr_t::fuse_scalars + 1> acc{};
+        block_t v;
+        for (size_t begin = 0; begin < this->size(); begin += util::fuse_block_size) {
+            const size_t n = std::min(util::fuse_block_size, this->size() - begin);
+            expr_.fuse_feval(begin, n, v);
+            Eigen::Map<const Eigen::Array<value_t, Eigen::Dynamic, 1>> b_seed(
+                    this->data_adj() + begin, n);
+            expr_.fuse_beval(begin, n, v, b_seed, acc.data());
+        }
+        expr_.fuse_flush(acc.data());
+    }
+
+    /**
+     * Binds the leaves of the expression then binds itself.
+     * The expression itself does not cache anything.
+     * @return  next pointer pack not bound by itself.
+     */
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        begin = expr_.fuse_bind(begin);
+        return value_adj_view_t::bind(begin);
+    }
+
+    util::SizePack bind_cache_size() const
+    {
+        return single_bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const
+    {
+        return {this->size(), this->size()};
+    }
+
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(expr_);
+    }
+
+private:
+    expr_t expr_;
+};
+
+namespace details {
+
+/**
+ * Replaces every maximal element-wise subtree of expr on vectors or matrices
+ * by a FusedNode, and rebuilds the nodes above them (see util::is_fuse_rebuildable_v).
+ * Leaves, scalar and constant expressions are kept as they are.
+ * If nothing is fused, returns expr itself with the same type.
+ */
+template <class ExprType>
+inline auto fuse(const ExprType& expr)
+{
+    using expr_t = ExprType;
+    if constexpr (util::is_fuse_aware_v<expr_t> &&
+                  util::is_fuse_rebuildable_v<expr_t> &&
+                  !util::is_scl_v<expr_t> &&
+                  !util::is_constant_v<expr_t>) {
+        return FusedNode<expr_t>(expr);
+    } else if constexpr (util::is_fuse_rebuildable_v<expr_t>) {
+        auto f = [](const auto& child) { return details::fuse(child); };
+        using rebuilt_t = decltype(expr.fuse_rebuild(f));
+        if constexpr (std::is_same_v<rebuilt_t, expr_t>) {
+            return expr;
+        } else {
+            return expr.fuse_rebuild(f);
+        }
+    } else {
+        return expr;
+    }
+}
+
+} // namespace details
+
+/**
+ * Checks if ad::fuse fuses any subtree of an expression of type T.
+ */
+template <class T>
+inline constexpr bool is_fusable_v = !std::is_same_v<
+    decltype(details::fuse(std::declval<const T&>())), T>;
+
+} // namespace core
+
+/**
+ * Helper function to fuse the element-wise subtrees of an expression
+ * on vectors or matrices into single nodes (see core::FusedNode).
+ * The subtrees may sit under nodes that do not support fused evaluation,
+ * e.g. in sum(exp(-0.5 * pow<2>((x - mu) / s))) only the argument of sum is fused.
+ * It is a compile-time error if the expression has nothing to fuse.
+ *
+ * @param   expr    expression with element-wise subtrees
+ */
+template <class ExprType
+        , class = std::enable_if_t<util::is_convertible_to_ad_v<ExprType>>>
+inline auto fuse(const ExprType& expr)
+{
+    using expr_t = util::convert_to_ad_t<ExprType>;
+    static_assert(core::is_fusable_v<expr_t>,
+                  "expression has no element-wise subtree on vectors or matrices to fuse");
+    expr_t ad_expr = expr;
+    return core::details::fuse(ad_expr);
+}
+
+} // namespace ad
@@ -47,6 +47,8 @@ public:
     using typename value_adj_view_t::var_t;
     using typename value_adj_view_t::ptr_pack_t;
 
+    static constexpr bool fuse_rebuildable = true;
+
     GlueNode(const left_t& expr_lhs, 
              const right_t& expr_rhs)
         : value_adj_view_t(nullptr, nullptr,
@@ -66,6 +68,7 @@ public:
      */
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         expr_lhs_.feval(); 
         return this->get() = expr_rhs_.feval();
     }
@@ -81,6 +84,7 @@ public:
     template <class T>
     void beval(const T& seed)
     {
+        FASTAD_PROFILE(beval);
         expr_rhs_.beval(seed); 
         expr_lhs_.beval(0);
     }
@@ -115,6 +119,27 @@ public:
     util::SizePack single_bind_cache_size() const
     { return {0,0}; }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(expr_lhs_);
+        f(expr_rhs_);
+    }
+
+    /**
+     * Rebuilds the node with f applied to its children (see ad::fuse).
+     */
+    template <class F>
+    auto fuse_rebuild(F&& f) const
+    {
+        auto lhs = f(expr_lhs_);
+        auto rhs = f(expr_rhs_);
+        return GlueNode<decltype(lhs), decltype(rhs)>(lhs, rhs);
+    }
+
+    const left_t& lhs() const { return expr_lhs_; }
+    const right_t& rhs() const { return expr_rhs_; }
+
 private:
     left_t expr_lhs_;
     right_t expr_rhs_;
@@ -1,133 +1,260 @@
 #pragma once
-#include <type_traits>
-#include <algorithm>
-#include "eval.hpp"
-#include "forward.hpp"
-#include "type_traits.hpp"
+#include <cassert>
+#include <vector>
+#include <fastad_bits/forward/core/forward.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <Eigen/Core>
 
 namespace ad {
 namespace core {
 
-template <class Iter, class T>
-Iter compute_hess(Iter it, const Vec<ForwardVar<T>>& x)
+/**
+ * Performs one forward-over-reverse pass of a scalar expression
+ * whose value type is ForwardVar<T>.
+ *
+ * The values of x are set to point and their forward (tangent) adjoints are set to direction.
+ * The reverse-mode adjoints of x and w are then reset,
+ * and the expression is forward and backward evaluated with seed 1.
+ * Since every node value carries its directional derivative,
+ * the backward evaluation also propagates the directional derivative of every adjoint.
+ * On return, for every k,
+ *
+ *  x[k].get_adj().get_value()      = df/dx_k (point)
+ *  x[k].get_adj().get_adjoint()    = (H(point) * direction)_k
+ *
+ * @tparam  ExprType    expression type
+ * @tparam  T           underlying data type
+ * @tparam  PDerived    Eigen vector type of point
+ * @tparam  DDerived    Eigen vector type of direction
+ * @param   expr        expression to evaluate
+ * @param   x           variables that expr differentiates w.r.t.
+ * @param   w           placeholders used by expr
+ * @param   point       point to evaluate at
+ * @param   direction   direction to differentiate the gradient in
+ * @return  forward evaluation of expr
+ */
+template <class ExprType
+        , class T
+        , class PDerived
+        , class DDerived>
+inline auto hessian_pass(ExprType& expr,
+                         std::vector<Var<ForwardVar<T>>>& x,
+                         std::vector<Var<ForwardVar<T>>>& w,
+                         const Eigen::MatrixBase<PDerived>& point,
+                         const Eigen::MatrixBase<DDerived>& direction)
 {
-    std::for_each(x.cbegin(), x.cend(),
-        [&it](const typename Vec<ForwardVar<T>>::value_type& xi) mutable {
-            *it = xi.get_adjoint().get_adjoint();
-            ++it;
-        });
-    return it;
+    for (size_t k = 0; k < x.size(); ++k) {
+        x[k].get() = ForwardVar<T>(point(k), direction(k));
+        x[k].reset_adj();
+    }
+    for (auto& wk : w) wk.reset_adj();
+    return ad::autodiff(expr);
 }
 
-template <size_t... opt_sizes, class HessIter, class T, class Exgen>
-inline void hessian_gen(HessIter hess_begin, Vec<ForwardVar<T>>& x, Exgen&& gen)
+} // namespace core
+
+/**
+ * Computes the value, gradient, and Hessian of a scalar function at x
+ * using forward-over-reverse mode.
+ * The function is built as a reverse-mode expression with value type ForwardVar<T>.
+ * The expression is bound once and then evaluated x.size() times,
+ * where the jth pass propagates the unit tangent e_j through the forward and backward evaluations,
+ * and yields the jth column of the Hessian.
+ *
+ * The factory is called once as f(x, w) where
+ * x is a std::vector<Var<ForwardVar<T>>> of size x.size()
+ * and w is an (initially empty) std::vector<Var<ForwardVar<T>>>
+ * that the factory may resize and use as placeholders (see batch_autodiff).
+ * The factory must return an expression of scalar shape.
+ *
+ * @tparam  F           type of expression factory
+ * @tparam  XDerived    Eigen vector type of x
+ * @tparam  HDerived    Eigen matrix type of H
+ * @tparam  GDerived    Eigen vector type of grad
+ * @param   f           callable that creates the expression from (x, w)
+ * @param   x           point to evaluate at
+ * @param   H           matrix of size x.size() x x.size() to store the Hessian
+ * @param   grad        vector of size x.size() to store the gradient
+ * @return  function value at x
+ */
+template <class F
+        , class XDerived
+        , class HDerived
+        , class GDerived>
+inline auto hessian(F&& f,
+                    const Eigen::MatrixBase<XDerived>& x,
+                    Eigen::MatrixBase<HDerived>& H,
+                    Eigen::MatrixBase<GDerived>& grad)
 {
-    auto it = hess_begin;
-    auto expr = std::get<0>(gen.template generate<opt_sizes...>(x));
-
-    for (size_t i = 0; i < x.size(); ++i)
-    {
-        x.reset_adjoint();
-        if (i > 0) {
-            x[i-1].get_value().set_adjoint(0);  // set the (i-1)th forward variable's adjoint back to 0
+    using value_t = typename XDerived::Scalar;
+    using vec_t = Eigen::Matrix<value_t, Eigen::Dynamic, 1>;
+
+    const size_t n = x.size();
+    assert(static_cast<size_t>(H.rows()) == n);
+    assert(static_cast<size_t>(H.cols()) == n);
+    assert(static_cast<size_t>(grad.size()) == n);
+
+    std::vector<Var<ForwardVar<value_t>>> xv(n);
+    std::vector<Var<ForwardVar<value_t>>> w;
+    auto expr = ad::bind(f(xv, w));
+
+    vec_t direction = vec_t::Zero(n);
+    value_t out = 0;
+    for (size_t j = 0; j < n; ++j) {
+        direction(j) = 1;
+        out = core::hessian_pass(expr, xv, w, x, direction).get_value();
+        direction(j) = 0;
+        for (size_t k = 0; k < n; ++k) {
+            H(k, j) = xv[k].get_adj().get_adjoint();
         }
-        x[i].get_value().set_adjoint(1); // set the ith forward variable's adjoint to 1
-        autodiff(expr);
-        // Record Hessian first column
-        // Advance iterator to next column of matrix
-        it = compute_hess(it, x);
     }
-}
 
-template <size_t... opt_sizes, class HessIter, class GradIter, class T, class Exgen>
-inline void hessian_gen(HessIter hess_begin, GradIter grad_begin, Vec<ForwardVar<T>>& x, Exgen&& gen)
-{
-    auto it = hess_begin;
-    auto expr = std::get<0>(gen.template generate<opt_sizes...>(x));
-
-    for (size_t i = 0; i < x.size(); ++i)
-    {
-        x.reset_adjoint();
-        if (i > 0) {
-            x[i-1].get_value().set_adjoint(0);  // set the (i-1)th forward variable's adjoint back to 0
-        }
-        x[i].get_value().set_adjoint(1); // set the ith forward variable's adjoint to 1
-        autodiff(expr);
-
-        // Record gradient
-        *grad_begin = expr.get_value().get_adjoint(); // get expression forward value's adjoint
-        ++grad_begin;
-        // Record Hessian first column
-        // Advance iterator to next column of matrix
-        it = compute_hess(it, x);
+    for (size_t k = 0; k < n; ++k) {
+        grad(k) = xv[k].get_adj().get_value();
     }
+    return out;
 }
 
-} // namespace core
+/**
+ * Overload that does not store the gradient.
+ */
+template <class F
+        , class XDerived
+        , class HDerived>
+inline auto hessian(F&& f,
+                    const Eigen::MatrixBase<XDerived>& x,
+                    Eigen::MatrixBase<HDerived>& H)
+{
+    Eigen::Matrix<typename XDerived::Scalar, Eigen::Dynamic, 1> grad(x.size());
+    return hessian(std::forward<F>(f), x, H, grad);
+}
 
-// The function will store only the hessian into object pointed by hess_begin.
-// This overload will only be enabled if all of the iterators
-// are dereferenceable like a pointer, i.e., valid iterators.
-// @param   hess_begin  column-wise iterator of a 2d-array or matrix to store hessian
-// @param   begin       iterator to first underlying data
-// @param   end         iterator to one past last underlying data
-// @param   f           lambda function to compute hessian and gradient of
-//                      it is expected that the arguments follow the specs of exgen
-//                      and in addition are declared with auto or Vec<ForwardVar<T>> for some T.
-template <size_t... opt_sizes, class HessIter, class Iter, class F
-    , class = std::enable_if_t<
-    utils::is_pointer_like_dereferenceable<HessIter>::value &&
-    utils::is_pointer_like_dereferenceable<Iter>::value
-    >
->
-inline void hessian(HessIter hess_begin, Iter begin, Iter end, F&& f)
+/**
+ * Computes the value, gradient, and Hessian-vector product H(x) * v of a scalar function
+ * without forming the Hessian.
+ * This requires exactly one forward and one backward evaluation,
+ * where the tangent v is propagated through both evaluations.
+ *
+ * The expression is already bound from the variables xv and placeholders w
+ * it was created with (see hessian for the convention),
+ * so that repeated products (e.g. in Newton-CG) reuse the variables and the cache
+ * instead of recreating and rebinding the expression.
+ *
+ * @tparam  ExprType    expression type
+ * @tparam  T           underlying data type
+ * @tparam  XDerived    Eigen vector type of x
+ * @tparam  VDerived    Eigen vector type of v
+ * @tparam  HvDerived   Eigen vector type of Hv
+ * @tparam  GDerived    Eigen vector type of grad
+ * @param   expr        bound expression of scalar shape created from (xv, w)
+ * @param   xv          variables of size x.size() that expr differentiates w.r.t.
+ * @param   w           placeholders used by expr
+ * @param   x           point to evaluate at
+ * @param   v           vector to multiply the Hessian with
+ * @param   Hv          vector of size x.size() to store H(x) * v
+ * @param   grad        vector of size x.size() to store the gradient
+ * @return  function value at x
+ */
+template <class ExprType
+        , class T
+        , class XDerived
+        , class VDerived
+        , class HvDerived
+        , class GDerived>
+inline auto hessian_vector(ExprType& expr,
+                           std::vector<Var<ForwardVar<T>>>& xv,
+                           std::vector<Var<ForwardVar<T>>>& w,
+                           const Eigen::MatrixBase<XDerived>& x,
+                           const Eigen::MatrixBase<VDerived>& v,
+                           Eigen::MatrixBase<HvDerived>& Hv,
+                           Eigen::MatrixBase<GDerived>& grad)
 {
-    using T = typename std::iterator_traits<Iter>::value_type;
-    auto gen = make_exgen<ForwardVar<T>>(std::forward<F>(f));
-    Vec<ForwardVar<T>> x(begin, end);
-    core::hessian_gen<opt_sizes...>(hess_begin, x, gen);
+    const size_t n = x.size();
+    assert(xv.size() == n);
+    assert(static_cast<size_t>(v.size()) == n);
+    assert(static_cast<size_t>(Hv.size()) == n);
+    assert(static_cast<size_t>(grad.size()) == n);
+
+    T out = core::hessian_pass(expr, xv, w, x, v).get_value();
+    for (size_t k = 0; k < n; ++k) {
+        grad(k) = xv[k].get_adj().get_value();
+        Hv(k) = xv[k].get_adj().get_adjoint();
+    }
+    return out;
 }
 
-// The function will store the hessian into object pointed by hess_begin,
-// and store gradient as well into object pointed by grad_begin.
-// This overload will only be enabled if all of the iterators
-// are dereferenceable like a pointer, i.e., valid iterators.
-// @param   hess_begin  column-wise iterator of a 2d-array or matrix to store hessian
-// @param   grad_begin  iterator of a array or 1-d matrix to store gradient
-// @param   begin       iterator to first underlying data
-// @param   end         iterator to one past last underlying data
-// @param   f           lambda function to compute hessian and gradient of
-//                      it is expected that the arguments follow the specs of exgen
-//                      and in addition are declared with auto or Vec<ForwardVar<T>> for some T.
-template <size_t... opt_sizes, class HessIter, class GradIter, class Iter, class F
-    , class = std::enable_if_t<
-    utils::is_pointer_like_dereferenceable<HessIter>::value &&
-    utils::is_pointer_like_dereferenceable<GradIter>::value &&
-    utils::is_pointer_like_dereferenceable<Iter>::value
-    > >
-inline void hessian(HessIter hess_begin, GradIter grad_begin, Iter begin, Iter end, F&& f)
+/**
+ * Overload that does not store the gradient.
+ */
+template <class ExprType
+        , class T
+        , class XDerived
+        , class VDerived
+        , class HvDerived>
+inline auto hessian_vector(ExprType& expr,
+                           std::vector<Var<ForwardVar<T>>>& xv,
+                           std::vector<Var<ForwardVar<T>>>& w,
+                           const Eigen::MatrixBase<XDerived>& x,
+                           const Eigen::MatrixBase<VDerived>& v,
+                           Eigen::MatrixBase<HvDerived>& Hv)
 {
-    using T = typename std::iterator_traits<Iter>::value_type;
-    auto gen = make_exgen<ForwardVar<T>>(std::forward<F>(f));
-    Vec<ForwardVar<T>> x(begin, end);
-    core::hessian_gen<opt_sizes...>(hess_begin, grad_begin, x, gen);
+    Eigen::Matrix<T, Eigen::Dynamic, 1> grad(x.size());
+    return hessian_vector(expr, xv, w, x, v, Hv, grad);
 }
 
-template <size_t... opt_sizes, class Matrix_T, class Iter, class F>
-inline void hessian(Mat<Matrix_T>& hess_mat, Iter begin, Iter end, F&& f)
+/**
+ * Computes the value, gradient, and Hessian-vector product H(x) * v of a scalar function
+ * from an expression factory following the same convention as in hessian.
+ * The expression is created and bound on every call;
+ * bind it once and use the overload above to compute several products.
+ *
+ * @tparam  F           type of expression factory
+ * @tparam  XDerived    Eigen vector type of x
+ * @tparam  VDerived    Eigen vector type of v
+ * @tparam  HvDerived   Eigen vector type of Hv
+ * @tparam  GDerived    Eigen vector type of grad
+ * @param   f           callable that creates the expression from (x, w)
+ * @param   x           point to evaluate at
+ * @param   v           vector to multiply the Hessian with
+ * @param   Hv          vector of size x.size() to store H(x) * v
+ * @param   grad        vector of size x.size() to store the gradient
+ * @return  function value at x
+ */
+template <class F
+        , class XDerived
+        , class VDerived
+        , class HvDerived
+        , class GDerived>
+inline auto hessian_vector(F&& f,
+                           const Eigen::MatrixBase<XDerived>& x,
+                           const Eigen::MatrixBase<VDerived>& v,
+                           Eigen::MatrixBase<HvDerived>& Hv,
+                           Eigen::MatrixBase<GDerived>& grad)
 {
-    const size_t n = static_cast<size_t>(std::distance(begin, end));
-    hess_mat.zeros(n, n);
-    hessian<opt_sizes...>(hess_mat.begin(), begin, end, std::forward<F>(f));
+    using value_t = typename XDerived::Scalar;
+
+    std::vector<Var<ForwardVar<value_t>>> xv(x.size());
+    std::vector<Var<ForwardVar<value_t>>> w;
+    auto expr = ad::bind(f(xv, w));
+    return hessian_vector(expr, xv, w, x, v, Hv, grad);
 }
 
-template <size_t... opt_sizes, class Matrix_T, class F, class Iter>
-inline void hessian(Mat<Matrix_T>& hess_mat, Mat<Matrix_T>& grad_mat, Iter begin, Iter end, F&& f)
+/**
+ * Overload that does not store the gradient.
+ */
+template <class F
+        , class XDerived
+        , class VDerived
+        , class HvDerived>
+inline auto hessian_vector(F&& f,
+                           const Eigen::MatrixBase<XDerived>& x,
+                           const Eigen::MatrixBase<VDerived>& v,
+                           Eigen::MatrixBase<HvDerived>& Hv)
 {
-    const size_t n = static_cast<size_t>(std::distance(begin, end));
-    hess_mat.zeros(n, n);
-    grad_mat.zeros(1, n);
-    hessian<opt_sizes...>(hess_mat.begin(), grad_mat.begin(), begin, end, std::forward<F>(f));
+    Eigen::Matrix<typename XDerived::Scalar, Eigen::Dynamic, 1> grad(x.size());
+    return hessian_vector(std::forward<F>(f), x, v, Hv, grad);
 }
 
 } // namespace ad
@@ -4,6 +4,7 @@
 #include <fastad_bits/reverse/core/constant.hpp>
 #include <fastad_bits/util/shape_traits.hpp>
 #include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/simd.hpp>
 #include <fastad_bits/util/size_pack.hpp>
 #include <fastad_bits/util/value.hpp>
 
@@ -19,6 +20,12 @@ namespace core {
  * Both if and else expressions must have same value and shape type.
  * Currently, condition expression can only be a scalar.
  *
+ * If the condition is a pack (see ad::simd), every lane takes its own branch:
+ * both expressions are evaluated, the node binds its own value
+ * and selects the value of each lane from the branch of that lane.
+ * Backward evaluation seeds each expression only in the lanes that took it.
+ * Both expressions must then be well-defined on every lane.
+ *
  * @tparam  CondExprType    type of condition expression
  * @tparam  IfExprType      type of expression in if-statement
  * @tparam  ElseExprType    type of expression in else-statement
@@ -55,6 +62,11 @@ private:
     // restrict value combinations
     static_assert(std::is_same_v<if_value_t, else_value_t>);
 
+    // condition is a pack: select lane-wise
+    static constexpr bool is_lane_wise = util::is_simd_v<
+        typename util::expr_traits<cond_t>::value_t>;
+    static_assert(!is_lane_wise || util::is_scl_v<if_t>);
+
 public:
     using value_adj_view_t = ValueAdjView<if_value_t, if_shape_t>;
     using typename value_adj_view_t::value_t;
@@ -62,6 +74,8 @@ public:
     using typename value_adj_view_t::var_t;
     using typename value_adj_view_t::ptr_pack_t;
 
+    static constexpr bool fuse_rebuildable = true;
+
     IfElseNode(const cond_t& cond_expr,
                const if_t& if_expr,
                const else_t& else_expr)
@@ -77,36 +91,91 @@ public:
 
     const auto& feval()
     {
-        return cond_expr_.feval() ? 
-                if_expr_.feval() : else_expr_.feval();
+        FASTAD_PROFILE(feval);
+        if constexpr (is_lane_wise) {
+            auto&& cond = cond_expr_.feval();
+            return this->get() = util::select(cond, 
+                                              if_expr_.feval(), 
+                                              else_expr_.feval());
+        } else {
+            return cond_expr_.feval() ? 
+                    if_expr_.feval() : else_expr_.feval();
+        }
     }
 
     template <class T>
     void beval(const T& seed)
     {
-        if (cond_expr_.get()) {
+        FASTAD_PROFILE(beval);
+        if constexpr (is_lane_wise) {
+            auto&& cond = cond_expr_.get();
+            if_expr_.beval(util::select(cond, seed, 0));
+            else_expr_.beval(util::select(cond, 0, seed));
+        } else if (cond_expr_.get()) {
             if_expr_.beval(seed);
         } else {
             else_expr_.beval(seed);
         } 
     }
 
+    /**
+     * Binds condition, then if and else expressions.
+     * Only one of if and else expressions is forward-evaluated,
+     * so common subexpression elimination is suspended while binding them.
+     * If the condition is a pack, binds itself to the selected values.
+     *
+     * @return  next pointer pack not bound by any expression.
+     */
     ptr_pack_t bind_cache(ptr_pack_t begin)
     {
         begin = cond_expr_.bind_cache(begin);
+        if (begin.cse) begin.cse->suspend();
         begin = if_expr_.bind_cache(begin);
-        return else_expr_.bind_cache(begin);
+        begin = else_expr_.bind_cache(begin);
+        if (begin.cse) begin.cse->resume();
+        if constexpr (is_lane_wise) {
+            begin = value_adj_view_t::bind_value(begin);
+        }
+        return begin;
     }
 
     util::SizePack bind_cache_size() const 
     { 
         return cond_expr_.bind_cache_size() +
                 if_expr_.bind_cache_size() + 
-                else_expr_.bind_cache_size();
+                else_expr_.bind_cache_size() +
+                single_bind_cache_size();
     }
 
     util::SizePack single_bind_cache_size() const
-    { return {0,0}; }
+    { 
+        if constexpr (is_lane_wise) {
+            return {this->size(), 0};
+        } else {
+            return {0,0}; 
+        }
+    }
+
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(cond_expr_);
+        f(if_expr_);
+        f(else_expr_);
+    }
+
+    /**
+     * Rebuilds the node with f applied to its children (see ad::fuse).
+     */
+    template <class F>
+    auto fuse_rebuild(F&& f) const
+    {
+        auto cond_expr = f(cond_expr_);
+        auto if_expr = f(if_expr_);
+        auto else_expr = f(else_expr_);
+        return IfElseNode<decltype(cond_expr), decltype(if_expr), decltype(else_expr)>(
+                cond_expr, if_expr, else_expr);
+    }
 
 private:
     cond_t cond_expr_;
@@ -129,8 +198,8 @@ inline constexpr auto if_else(const CondType& c,
                               const ElseType& e)
 {
     using cond_t = util::convert_to_ad_t<CondType>;
-    using if_t = util::convert_to_ad_t<IfType>;
-    using else_t = util::convert_to_ad_t<ElseType>;
+    using if_t = util::convert_to_ad_as_t<IfType, ElseType>;
+    using else_t = util::convert_to_ad_as_t<ElseType, IfType>;
     using if_value_t = typename util::expr_traits<if_t>::value_t;
     using if_shape_t = typename util::shape_traits<if_t>::shape_t;
 
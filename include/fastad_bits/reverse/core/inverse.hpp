@@ -0,0 +1,202 @@
+#pragma once
+#include <limits>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/solve.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/value.hpp>
+
+namespace ad {
+namespace core {
+
+/**
+ * InverseNode represents the inverse of a square matrix.
+ * No other shapes are permitted for this node.
+ * Decomposition functor of type DecompType (see ad::solve) is provided to
+ * define the policy in how to factorize the matrix.
+ *
+ * Forward evaluation solves for the identity in-place in the cache.
+ * Backward evaluation only reuses the inverse Y to compute -Y^T seed Y^T
+ * into a preallocated workspace, so it does not factorize again.
+ * Prefer ad::solve when the inverse is only multiplied with,
+ * since it never forms the inverse.
+ *
+ * The node assumes the same value type and shape as that of the matrix expression.
+ *
+ * @tparam  DecompType      decomposition type
+ * @tparam  ExprType        type of matrix expression
+ */
+
+template <class DecompType, class ExprType>
+struct InverseNode:
+    ValueAdjView<typename util::expr_traits<ExprType>::value_t,
+                 typename util::shape_traits<ExprType>::shape_t>,
+    ExprBase<InverseNode<DecompType, ExprType>>
+{
+private:
+    using decomp_t = DecompType;
+    using expr_t = ExprType;
+    using expr_value_t = typename util::expr_traits<expr_t>::value_t;
+
+    static_assert(util::is_mat_v<expr_t>);
+
+public:
+    using value_adj_view_t = ValueAdjView<expr_value_t,
+          typename util::shape_traits<expr_t>::shape_t>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    InverseNode(const expr_t& expr)
+        : InverseNode(expr, expr.rows(), 0)
+    {}
+
+    InverseNode(const expr_t& expr,
+                const decomp_t& decomp)
+        : InverseNode(expr, decomp, 0)
+    {}
+
+private:
+    // constructs the decomposition in place from decomp_arg,
+    // so that an unfactorized decomposition is never copied.
+    template <class DecompArgType>
+    InverseNode(const expr_t& expr,
+                const DecompArgType& decomp_arg,
+                int)
+        : value_adj_view_t(nullptr, nullptr, expr.rows(), expr.cols())
+        , expr_{expr}
+        , decomp_(decomp_arg)
+        , work_(expr.rows(), expr.cols())
+    {
+        assert(expr.rows() == expr.cols());
+    }
+
+public:
+
+    const var_t& feval()
+    {
+        FASTAD_PROFILE(feval);
+        decomp_.compute(expr_.feval());
+        if (!decomp_.valid()) {
+            this->get().fill(std::numeric_limits<value_t>::quiet_NaN());
+            return this->get();
+        }
+        this->get().setIdentity();
+        decomp_.solve(this->get());
+        return this->get();
+    }
+
+    template <class T>
+    void beval(const T& seed)
+    {
+        FASTAD_PROFILE(beval);
+        if (!decomp_.valid()) return;
+        auto& adj = this->get_adj();
+        util::to_array(adj) = seed;
+        work_.noalias() = this->get().transpose() * adj;
+        adj.noalias() = -work_ * this->get().transpose();
+        expr_.beval(util::to_array(adj));
+    }
+
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        begin = expr_.bind_cache(begin);
+        return value_adj_view_t::bind(begin);
+    }
+
+    util::SizePack bind_cache_size() const
+    {
+        return expr_.bind_cache_size() +
+                single_bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const
+    {
+        return {this->size(), this->size()};
+    }
+
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(expr_);
+    }
+
+    /**
+     * Returns the factorization state shared with other nodes, if any (see ad::shared_llt).
+     */
+    const void* shared_state() const { return details::shared_state(decomp_); }
+
+private:
+    using mat_t = util::constant_var_t<value_t, shape_t>;
+    expr_t expr_;
+    decomp_t decomp_;
+    mat_t work_;
+};
+
+} // namespace core
+
+/*
+ * Creates an inverse expression node with a policy that defines the decomposition.
+ * The default decomposition is Eigen::PartialPivLU.
+ * Currently, we support SolveLDLT and SolveLLT for some specialized matrices.
+ * If x is a constant, the decomposition is ignored and
+ * will always just invoke member function inverse of the underlying Eigen object.
+ */
+template <template <class...> class DecompType = SolvePartialPivLU
+        , class T
+        , class = std::enable_if_t<
+            util::is_convertible_to_ad_v<T> &&
+            util::any_ad_v<T> > >
+inline auto inverse(const T& x)
+{
+    using expr_t = util::convert_to_ad_t<T>;
+    using value_t = typename util::expr_traits<expr_t>::value_t;
+    using shape_t = typename util::shape_traits<expr_t>::shape_t;
+    expr_t expr = x;
+
+    // optimization for when expression is constant
+    if constexpr (util::is_constant_v<expr_t>) {
+        static_assert(util::is_mat_v<expr_t>);
+        using var_t = util::constant_var_t<value_t, shape_t>;
+        var_t out = expr.feval().inverse();
+        return ad::constant(out);
+    } else {
+        return core::InverseNode<DecompType<value_t, shape_t>, expr_t>(expr);
+    }
+}
+
+/*
+ * Creates an inverse expression node with SolveLLT
+ * that shares the Cholesky factorization llt with other nodes on x (see ad::shared_llt).
+ */
+template <class T
+        , class ValueType
+        , class ShapeType
+        , class = std::enable_if_t<
+            util::is_convertible_to_ad_v<T> &&
+            util::any_ad_v<T> > >
+inline auto inverse(const T& x,
+                    const LLTFactor<ValueType, ShapeType>& llt)
+{
+    using expr_t = util::convert_to_ad_t<T>;
+    using value_t = typename util::expr_traits<expr_t>::value_t;
+    using shape_t = typename util::shape_traits<expr_t>::shape_t;
+    static_assert(std::is_same_v<value_t, ValueType>);
+    expr_t expr = x;
+
+    // optimization for when expression is constant
+    if constexpr (util::is_constant_v<expr_t>) {
+        static_assert(util::is_mat_v<expr_t>);
+        using var_t = util::constant_var_t<value_t, shape_t>;
+        var_t out = expr.feval().inverse();
+        return ad::constant(out);
+    } else {
+        using decomp_t = SolveLLT<value_t, ShapeType>;
+        return core::InverseNode<decomp_t, expr_t>(expr, decomp_t(llt));
+    }
+}
+
+} // namespace ad
@@ -0,0 +1,235 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/visit.hpp>
+#include <fastad_bits/util/leaf_registry.hpp>
+#include <fastad_bits/util/shape_traits.hpp>
+#include <fastad_bits/util/simd.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <Eigen/Core>
+
+namespace ad {
+namespace core {
+namespace details {
+
+/**
+ * Computes the Jacobian of expr w.r.t. x (see ad::jacobian),
+ * calling reset() before the first backward evaluation and after every row
+ * to zero every adjoint that backward evaluation accumulates into.
+ */
+template <class ExprType
+        , class VarType
+        , class Derived
+        , class ResetType>
+inline auto jacobian(ExprType& expr,
+                     VarType& x,
+                     Eigen::MatrixBase<Derived>& J,
+                     ResetType reset)
+{
+    using expr_t = std::decay_t<ExprType>;
+    using value_t = typename util::expr_traits<expr_t>::value_t;
+
+    assert(static_cast<size_t>(J.rows()) == expr.size());
+    assert(static_cast<size_t>(J.cols()) == x.size());
+
+    auto&& out = evaluate(expr);
+
+    Eigen::Map<Eigen::Array<value_t, Eigen::Dynamic, 1>>
+        x_adj(x.data_adj(), x.size());
+    reset();
+
+    if constexpr (util::is_scl_v<expr_t>) {
+        evaluate_adj(expr, value_t(1));
+        J.row(0) = x_adj.matrix().transpose();
+        reset();
+    } else {
+        using seed_t = std::conditional_t<util::is_vec_v<expr_t>,
+              Eigen::Array<value_t, Eigen::Dynamic, 1>,
+              Eigen::Array<value_t, Eigen::Dynamic, Eigen::Dynamic> >;
+        seed_t seed = seed_t::Zero(expr.rows(), expr.cols());
+        for (size_t i = 0; i < expr.size(); ++i) {
+            seed(i) = 1;
+            evaluate_adj(expr, seed);
+            seed(i) = 0;
+            J.row(i) = x_adj.matrix().transpose();
+            reset();
+        }
+    }
+    return out;
+}
+
+} // namespace details
+} // namespace core
+
+/**
+ * Computes the Jacobian of expression w.r.t. the variable x.
+ * Row i of J is the gradient of the ith output of expr w.r.t. x,
+ * where outputs and the elements of x are both ordered in column-major order.
+ *
+ * The expression is forward-evaluated only once.
+ * Every row is then one backward evaluation with a unit seed,
+ * after which the adjoints of x are copied into the row.
+ * The factory overload below computes several rows per backward evaluation
+ * and should be preferred for expressions with many outputs.
+ *
+ * Before every row, the adjoints of every leaf (VarView) of expr,
+ * of every placeholder assigned in expr (see EqNode, OpEqNode), and of x are zeroed,
+ * since leaves and placeholders accumulate their adjoints.
+ * Intermediate nodes overwrite their adjoints on every backward evaluation.
+ * All of these adjoints are zero on return.
+ *
+ * @tparam  ExprType    expression type
+ * @tparam  VarType     variable viewer type
+ * @tparam  Derived     Eigen matrix type of J
+ * @param   expr        expression to differentiate
+ * @param   x           variable to differentiate w.r.t.
+ * @param   J           matrix of size expr.size() x x.size()
+ * @return  forward evaluation of expr
+ */
+template <class ExprType
+        , class VarType
+        , class Derived
+        , class = std::enable_if_t<util::is_expr_v<std::decay_t<ExprType>>> >
+inline auto jacobian(ExprType&& expr,
+                     VarType& x,
+                     Eigen::MatrixBase<Derived>& J)
+{
+    using expr_t = std::decay_t<ExprType>;
+    using value_t = typename util::expr_traits<expr_t>::value_t;
+
+    // Nodes are visited as const, but the adjoints belong to the variables they view.
+    util::LeafRegistry<value_t> leaves;
+    ad::visit(expr, [&](const auto& node, size_t) {
+        using node_t = std::decay_t<decltype(node)>;
+        if constexpr (util::is_var_view_v<node_t>) {
+            leaves.add(node.data(), const_cast<value_t*>(node.data_adj()),
+                       node.size());
+        } else if constexpr (core::details::has_placeholder<node_t>::value) {
+            const auto& w = node.placeholder();
+            leaves.add(w.data(), const_cast<value_t*>(w.data_adj()),
+                       w.size(), true);
+        }
+    });
+
+    return core::details::jacobian(expr, x, J, [&]() {
+        leaves.zero();
+        x.reset_adj();
+    });
+}
+
+/**
+ * Overload for ExprBind helper class.
+ * Between rows, the adjoints of every leaf and placeholder of the expression
+ * are zeroed (see ExprBind::reset_adjoints), which are all zero on return.
+ */
+template <class ExprType
+        , class VarType
+        , class Derived>
+inline auto jacobian(core::ExprBind<ExprType>& expr,
+                     VarType& x,
+                     Eigen::MatrixBase<Derived>& J)
+{
+    assert(!expr.forward_only());
+    return core::details::jacobian(expr.get(), x, J, [&]() {
+        expr.reset_adjoints();
+        x.reset_adj();
+    });
+}
+
+/**
+ * Computes the value and Jacobian of a function of the vector x
+ * using vector-mode reverse AD, where K rows are computed by every backward evaluation.
+ *
+ * The function is built as a reverse-mode expression with value type simd<T, K>
+ * (see ad::simd), whose K lanes hold K independent adjoints of every node.
+ * Every lane of the values of x holds the same point,
+ * so the expression is forward-evaluated only once for all lanes.
+ * The outputs are then seeded K at a time, one unit seed per lane,
+ * and one backward evaluation propagates all K seeds together,
+ * so that lane k of the adjoints of x is one row of J.
+ * A Jacobian with m rows thus takes ceil(m / K) backward evaluations.
+ *
+ * The factory is called once as f(x) where x is a Var<simd<T, K>, vec> of size x.size(),
+ * and must return an expression of scalar, vector or matrix shape.
+ * Every other variable, placeholder and Eigen constant it uses
+ * must have value type simd<T, K>, e.g. A.template cast<simd<T, K>>().
+ * Literals are broadcast to every lane.
+ * The expression is bound with ad::bind,
+ * and the adjoints of all its leaves and placeholders are zeroed before every evaluation
+ * (see ExprBind::reset_adjoints).
+ *
+ * @tparam  K           number of rows computed per backward evaluation
+ * @tparam  F           type of expression factory
+ * @tparam  XDerived    Eigen vector type of x
+ * @tparam  JDerived    Eigen matrix type of J
+ * @param   f           callable that creates the expression from x
+ * @param   x           point to evaluate at
+ * @param   J           matrix of size (output size) x x.size() to store the Jacobian
+ * @return  forward evaluation of the expression at x
+ */
+template <size_t K = 4
+        , class F
+        , class XDerived
+        , class JDerived>
+inline auto jacobian(F&& f,
+                     const Eigen::MatrixBase<XDerived>& x,
+                     Eigen::MatrixBase<JDerived>& J)
+{
+    using value_t = typename XDerived::Scalar;
+    using pack_t = simd<value_t, K>;
+
+    const size_t n = x.size();
+    assert(static_cast<size_t>(J.cols()) == n);
+
+    Var<pack_t, vec> xv(n);
+    for (size_t j = 0; j < n; ++j) xv.get()(j) = pack_t(x(j));
+    auto expr = ad::bind(f(xv));
+
+    using expr_t = std::decay_t<decltype(expr.get())>;
+    const size_t m = expr.get().size();
+    assert(static_cast<size_t>(J.rows()) == m);
+
+    // copies lanes [0, n_lanes) of the adjoints of x into the rows starting at i
+    auto store_rows = [&](size_t i, size_t n_lanes) {
+        for (size_t j = 0; j < n; ++j) {
+            const pack_t& adj = xv.data_adj()[j];
+            for (size_t k = 0; k < n_lanes; ++k) J(i + k, j) = adj[k];
+        }
+    };
+
+    auto&& out = evaluate(expr);
+
+    if constexpr (util::is_scl_v<expr_t>) {
+        pack_t seed(0);
+        seed[0] = 1;
+        expr.reset_adjoints();
+        evaluate_adj(expr, seed);
+        store_rows(0, 1);
+        return out[0];
+    } else {
+        using seed_t = std::conditional_t<util::is_vec_v<expr_t>,
+              Eigen::Array<pack_t, Eigen::Dynamic, 1>,
+              Eigen::Array<pack_t, Eigen::Dynamic, Eigen::Dynamic> >;
+        using out_t = std::conditional_t<util::is_vec_v<expr_t>,
+              Eigen::Array<value_t, Eigen::Dynamic, 1>,
+              Eigen::Array<value_t, Eigen::Dynamic, Eigen::Dynamic> >;
+
+        out_t value = out.unaryExpr([](const pack_t& v) { return v[0]; });
+
+        seed_t seed = seed_t::Constant(expr.get().rows(), expr.get().cols(), pack_t(0));
+        for (size_t i = 0; i < m; i += K) {
+            const size_t n_lanes = std::min(K, m - i);
+            for (size_t k = 0; k < n_lanes; ++k) seed(i + k)[k] = 1;
+            expr.reset_adjoints();
+            evaluate_adj(expr.get(), seed);
+            store_rows(i, n_lanes);
+            for (size_t k = 0; k < n_lanes; ++k) seed(i + k)[k] = 0;
+        }
+        return value;
+    }
+}
+
+} // namespace ad
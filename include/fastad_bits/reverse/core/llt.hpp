@@ -0,0 +1,209 @@
+#pragma once
+#include <cmath>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/util/numeric.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <Eigen/Dense>
+
+namespace ad {
+
+/**
+ * LLTFactor is the Cholesky factorization A = L L^T of a positive definite matrix
+ * used by the nodes on that matrix (e.g. DetLLT, LogDetLLT, SolveLLT, normal and Wishart log-pdfs).
+ *
+ * compute(A) factorizes A.
+ * A shared factor factorizes only if A differs from the last matrix it factorized,
+ * so that nodes on the same matrix share one factorization within a pass,
+ * and a matrix that does not change across passes is factorized once.
+ * The inverse of A, which some adjoints require in full,
+ * is solved in-place into a preallocated workspace at most once per factorization.
+ *
+ * Copies are independent by default.
+ * A factor created with ad::shared_llt shares its state with all of its copies,
+ * so passing it to several nodes shares the factorization among them (see ad::shared_llt).
+ *
+ * @tparam  ValueType   value type of the matrix
+ * @tparam  ShapeType   shape of the matrix (see ad::fixed_mat)
+ */
+template <class ValueType, class ShapeType = ad::mat>
+struct LLTFactor
+{
+    using value_t = ValueType;
+    using mat_t = util::constant_var_t<value_t, ShapeType>;
+
+    LLTFactor(size_t rows, bool shared = false)
+        : state_{std::make_shared<state_t>(rows)}
+        , shared_{shared}
+    {}
+
+    LLTFactor(const LLTFactor& other)
+        : state_{other.shared_ ?
+                 other.state_ :
+                 std::make_shared<state_t>(*other.state_)}
+        , shared_{other.shared_}
+    {}
+
+    LLTFactor& operator=(const LLTFactor& other)
+    {
+        if (this != &other) {
+            state_ = other.shared_ ?
+                     other.state_ :
+                     std::make_shared<state_t>(*other.state_);
+            shared_ = other.shared_;
+        }
+        return *this;
+    }
+
+    template <class T>
+    void compute(const Eigen::MatrixBase<T>& A)
+    {
+        auto& s = *state_;
+        if (shared_) {
+            if (s.computed && s.a == A) return;
+            s.a = A;
+            s.llt.compute(s.a);
+        } else {
+            s.llt.compute(A);
+        }
+        s.computed = true;
+        s.has_inverse = false;
+        s.log_det = 2 * util::accum_sum(
+                s.llt.matrixLLT().diagonal().array().log());
+    }
+
+    bool valid() const
+    {
+        return state_->computed &&
+               (state_->llt.info() == Eigen::Success);
+    }
+
+    auto matrixL() const { return state_->llt.matrixL(); }
+
+    // log det(A)
+    value_t log_det() const { return state_->log_det; }
+
+    // det(A)
+    value_t det() const
+    {
+        value_t det_l = state_->llt.matrixLLT().diagonal().prod();
+        return det_l * det_l;
+    }
+
+    // X <- A^{-1} X
+    template <class T>
+    void solve(Eigen::MatrixBase<T>& X) const
+    {
+        state_->llt.solveInPlace(X);
+    }
+
+    const mat_t& inverse() const
+    {
+        auto& s = *state_;
+        if (!s.has_inverse) {
+            s.inv.setIdentity();
+            s.llt.solveInPlace(s.inv);
+            s.has_inverse = true;
+        }
+        return s.inv;
+    }
+
+    /**
+     * Returns the state shared with the copies of this factor,
+     * or nullptr if the factor is not shared.
+     * Nodes holding a factor expose it as shared_state()
+     * so that ParallelGlueNode orders statements sharing a factor.
+     */
+    const void* shared_state() const
+    {
+        return shared_ ? state_.get() : nullptr;
+    }
+
+private:
+    struct state_t
+    {
+        state_t(size_t rows)
+            : llt(rows)
+            , a(rows, rows)
+            , inv(rows, rows)
+        {}
+
+        Eigen::LLT<mat_t, Eigen::Lower> llt;
+        mat_t a;    // last matrix factorized (shared factors only)
+        mat_t inv;
+        value_t log_det = 0;
+        bool computed = false;
+        bool has_inverse = false;
+    };
+
+    std::shared_ptr<state_t> state_;
+    bool shared_;
+};
+
+/*
+ * Creates a Cholesky factorization of the matrix expression x
+ * to share among the nodes on x it is passed to, e.g.
+ *
+ *  auto llt = ad::shared_llt(sigma);
+ *  auto expr = ad::bind(ad::log_det(sigma, llt) +
+ *                       ad::normal_adj_log_pdf(x, mu, sigma, llt));
+ *
+ * factorizes sigma once per evaluation instead of once per node,
+ * and solves for its inverse at most once in backward evaluation.
+ * The nodes need not be given the same expression,
+ * but since x is only factorized again when its value changes,
+ * they should evaluate to the same matrix.
+ * Evaluating a node writes to the shared factorization, even in backward evaluation.
+ * Statements of ad::bind_parallel sharing a factorization are not evaluated concurrently,
+ * and ad::parallel_sum evaluates its terms serially if they reach a shared factorization.
+ * A shared factorization must not be reachable from expressions evaluated concurrently
+ * otherwise, e.g. by the workers of ad::batch_autodiff.
+ */
+template <class T
+        , class = std::enable_if_t<
+            util::is_convertible_to_ad_v<T> > >
+inline auto shared_llt(const T& x)
+{
+    using expr_t = util::convert_to_ad_t<T>;
+    using value_t = typename util::expr_traits<expr_t>::value_t;
+    using shape_t = typename util::shape_traits<expr_t>::shape_t;
+    static_assert(util::is_mat_v<expr_t>);
+    expr_t expr = x;
+    assert(expr.rows() == expr.cols());
+    return LLTFactor<value_t, shape_t>(expr.rows(), true);
+}
+
+namespace core {
+namespace details {
+
+/*
+ * Checks if T exposes the state it shares with other nodes (see LLTFactor::shared_state).
+ */
+template <class T, class = void>
+struct has_shared_state: std::false_type
+{};
+
+template <class T>
+struct has_shared_state<T, std::void_t<
+    decltype(std::declval<const T&>().shared_state())> >: std::true_type
+{};
+
+/**
+ * Returns the state x shares with other nodes, or nullptr if it does not share any.
+ */
+template <class T>
+inline const void* shared_state(const T& x)
+{
+    if constexpr (has_shared_state<T>::value) {
+        return x.shared_state();
+    } else {
+        static_cast<void>(x);
+        return nullptr;
+    }
+}
+
+} // namespace details
+} // namespace core
+} // namespace ad
@@ -0,0 +1,235 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <optional>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/util/adjoint_scratch.hpp>
+#include <fastad_bits/util/leaf_registry.hpp>
+#include <fastad_bits/util/macros.hpp>
+#include <fastad_bits/util/numeric.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+
+namespace ad {
+namespace core {
+
+/**
+ * MapSumNode represents a summation of a scalar expression f(i) over indices i = 0,...,n-1.
+ * Ex.
+ * f(0) + f(1) + ... + f(n-1)
+ *
+ * Unlike SumIterNode, which stores and binds one expression per term,
+ * only a single term expression is kept along with the functor f.
+ * Forward evaluation creates f(i) for each index in place of the previous term,
+ * binds it to the same cache, and forward and backward evaluates it with seed 1,
+ * accumulating the gradient w.r.t. the leaves into scratch buffers (see util::AdjointScratch).
+ * Since the node is scalar, backward evaluation with seed s
+ * then only adds s times the scratch buffers to the leaf adjoints.
+ * Hence the memory is proportional to the size of one term instead of n terms,
+ * and every term is created, bound, and evaluated once per ad::autodiff.
+ * Value-only evaluations (e.g. line searches) should bind with layout::forward
+ * (see ad::bind_forward), in which case the terms are not backward evaluated.
+ *
+ * Every f(i) must have the same structure, i.e. only the data it views may differ,
+ * and must only read leaves (Var, VarView) and constants.
+ * In particular it must not assign to placeholders (EqNode, OpEqNode)
+ * or read placeholders assigned by other expressions.
+ *
+ * @tparam  ExprType    type of term expression f(i)
+ * @tparam  Lmda        type of functor f taking an index and returning ExprType
+ * @tparam  AccumType   type to accumulate the terms in (see util::accum_t)
+ */
+
+template <class ExprType, class Lmda, class AccumType = void>
+struct MapSumNode:
+    ValueAdjView<typename util::expr_traits<ExprType>::value_t,
+                 ad::scl>,
+    ExprBase<MapSumNode<ExprType, Lmda, AccumType>>
+{
+private:
+    using expr_t = ExprType;
+    using expr_value_t = typename util::expr_traits<expr_t>::value_t;
+
+    static_assert(util::is_scl_v<expr_t>,
+                  "map_sum only supports scalar expressions");
+
+public:
+    using value_adj_view_t = ValueAdjView<expr_value_t, ad::scl>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    MapSumNode(size_t n, const Lmda& f)
+        : value_adj_view_t(nullptr, nullptr, 1, 1)
+        , n_{n}
+        , f_{f}
+    {
+        if (n_ > 0) expr_.emplace(f_(0));
+    }
+
+    /**
+     * Forward evaluate by creating, binding, and evaluating f(i) for i = 0,...,n-1,
+     * and accumulating the results.
+     * The gradient of every term is accumulated into the scratch buffers.
+     * Leaves seen for the first time are registered to the leaf registry, if any.
+     * If bound for forward evaluation only (see layout::forward),
+     * the terms are not backward evaluated.
+     *
+     * @return forward evaluation of sum of f(i) for every i.
+     */
+    const var_t& feval()
+    {
+        FASTAD_PROFILE(feval);
+        ptr_pack_t begin = expr_begin_;
+        const value_t seed = begin.forward ? 0 : 1;
+        if (!begin.forward) begin.leaf_adj = &scratch_;
+        scratch_.zero();
+        util::accum_t<value_t, AccumType> sum = 0;
+        for (size_t i = 0; i < n_; ++i) {
+            emplace_term(i);
+            sum += eval_term(begin, seed);
+        }
+        if (leaves_) {
+            leaves_->add(scratch_, n_registered_);
+            n_registered_ = scratch_.size();
+        }
+        return this->get() = sum;
+    }
+
+    /**
+     * Backward evaluate by adding seed times the gradient accumulated
+     * during the last forward evaluation to the leaf adjoints.
+     * Note that since this node is always scalar, beval does not have to be templated.
+     */
+    void beval(value_t seed)
+    {
+        FASTAD_PROFILE(beval);
+        scratch_.flush(seed);
+    }
+
+    /**
+     * Reserve the cache of one term expression then bind itself to a scalar.
+     * Every term is bound to the reserved cache during forward evaluation
+     * with the leaf adjoints redirected to the scratch buffers.
+     * Common subexpression elimination does not apply to the term,
+     * since it views different data for every index.
+     * If the leaf adjoints are redirected to scratch buffers (see ParallelSumIterNode),
+     * the scratch buffers are flushed into them instead of the leaf adjoints.
+     *
+     * @return  the next pointer pack not bound by the term and itself.
+     */
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        if (expr_) {
+            expr_begin_ = begin;
+            expr_begin_.cse = nullptr;
+            expr_begin_.leaves = nullptr;
+            scratch_ = util::AdjointScratch<value_t>(begin.leaf_adj);
+            // leaves redirected to scratch buffers are registered by their owner
+            leaves_ = begin.leaf_adj ? nullptr : begin.leaves;
+            n_registered_ = 0;
+            expr_size_ = expr_->bind_cache_size();
+            begin.skip(expr_size_);
+        }
+        return value_adj_view_t::bind_value(begin);
+    }
+
+    util::SizePack bind_cache_size() const
+    {
+        return (expr_ ? expr_->bind_cache_size() : util::SizePack::Zero()) +
+                single_bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const
+    {
+        return {this->size(), 0};
+    }
+
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        if (expr_) f(*expr_);
+    }
+
+private:
+    /**
+     * Creates f(i) in place of the previous term.
+     */
+    void emplace_term(size_t i)
+    {
+#ifdef FASTAD_ENABLE_PROFILING
+        // the new term starts with empty statistics,
+        // so the counters of every term are accumulated into the same tree
+        profile_carry_.save(*expr_);
+        expr_.emplace(f_(i));
+        profile_carry_.restore(*expr_);
+#else
+        expr_.emplace(f_(i));
+#endif
+        assert((expr_->bind_cache_size() == expr_size_).all());
+    }
+
+    /**
+     * Binds the current term with begin and forward evaluates it,
+     * then backward evaluates it with seed if seed is not zero.
+     * The term is evaluated once per index, so the node methods of the term
+     * are inlined here regardless of the inlining budget left by the translation unit
+     * (see FASTAD_FLATTEN).
+     * The functor f is only called by emplace_term, which is not flattened.
+     *
+     * @return  forward evaluation of the term.
+     */
+    FASTAD_FLATTEN value_t eval_term(const ptr_pack_t& begin, value_t seed = 0)
+    {
+        expr_->bind_cache(begin);
+        value_t out = expr_->feval();
+        if (seed != 0) expr_->beval(seed);
+        return out;
+    }
+
+    size_t n_;
+    Lmda f_;
+    std::optional<expr_t> expr_;
+    ptr_pack_t expr_begin_{nullptr, nullptr};
+    util::SizePack expr_size_ = util::SizePack::Zero();
+    util::AdjointScratch<value_t> scratch_;
+    util::LeafRegistry<value_t>* leaves_ = nullptr;
+    size_t n_registered_ = 0;
+#ifdef FASTAD_ENABLE_PROFILING
+    util::ProfileCarry profile_carry_;
+#endif
+};
+
+} // namespace core
+
+/**
+ * Helper function to create a MapSumNode that sums f(i) for i = 0,...,n-1.
+ * If the expression type is constant, returns a constant of the sum.
+ * AccumType is the type to accumulate in (see util::accum_t).
+ *
+ * @param   n   number of terms
+ * @param   f   functor taking an index (size_t) and returning a scalar expression
+ */
+template <class AccumType = void, class Lmda>
+inline auto map_sum(size_t n, Lmda&& f)
+{
+    using lmda_t = std::decay_t<Lmda>;
+    using expr_t = std::decay_t<decltype(f(size_t(0)))>;
+    using value_t = typename util::expr_traits<expr_t>::value_t;
+
+    // optimized for f that returns a constant node
+    if constexpr (util::is_constant_v<expr_t>) {
+        util::accum_t<value_t, AccumType> sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += f(i).feval();
+        }
+        return ad::constant(static_cast<value_t>(sum));
+    } else {
+        return core::MapSumNode<expr_t, lmda_t, AccumType>(n, std::forward<Lmda>(f));
+    }
+}
+
+} // namespace ad
@@ -2,6 +2,7 @@
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/util/numeric.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/size_pack.hpp>
 #include <fastad_bits/util/value.hpp>
@@ -19,13 +20,14 @@ namespace core {
  * It is always a scalar shape.
  *
  * @tparam  ExprType     type of vector expression
+ * @tparam  AccumType    type to accumulate the squares in (see util::accum_t)
  */
 
-template <class ExprType>
+template <class ExprType, class AccumType = void>
 struct NormNode:
     ValueAdjView<typename util::expr_traits<ExprType>::value_t,
                  ad::scl>,
-    ExprBase<NormNode<ExprType>>
+    ExprBase<NormNode<ExprType, AccumType>>
 {
 private:
     using expr_t = ExprType;
@@ -40,6 +42,8 @@ public:
     using typename value_adj_view_t::var_t;
     using typename value_adj_view_t::ptr_pack_t;
 
+    static constexpr bool fuse_rebuildable = true;
+
     NormNode(const expr_t& expr)
         : value_adj_view_t(nullptr, nullptr, 1, 1)
         , expr_{expr}
@@ -47,24 +51,22 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& res = expr_.feval();
-        return this->get() = res.squaredNorm();
+        return this->get() = util::accum_sum<AccumType>(util::to_array(res).square());
     }
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         auto&& a_expr = util::to_array(expr_.get());
-        expr_.beval(seed * 2. * a_expr);
+        expr_.beval(seed * 2 * a_expr);
     }
 
     ptr_pack_t bind_cache(ptr_pack_t begin)
     {
         begin = expr_.bind_cache(begin);
-        auto adj = begin.adj;
-        begin.adj = nullptr;
-        begin = value_adj_view_t::bind(begin);
-        begin.adj = adj;
-        return begin;
+        return value_adj_view_t::bind_value(begin);
     }
 
     util::SizePack bind_cache_size() const 
@@ -78,13 +80,30 @@ public:
         return {this->size(), 0}; 
     }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(expr_);
+    }
+
+    /**
+     * Rebuilds the node with f applied to its children (see ad::fuse).
+     */
+    template <class F>
+    auto fuse_rebuild(F&& f) const
+    {
+        auto expr = f(expr_);
+        return NormNode<decltype(expr), AccumType>(expr);
+    }
+
 private:
     expr_t expr_;
 };
 
 } // namespace core
 
-template <class T
+template <class AccumType = void
+        , class T
         , class = std::enable_if_t<
             util::is_convertible_to_ad_v<T> &&
             util::any_ad_v<T> > >
@@ -98,10 +117,10 @@ inline auto norm(const T& x)
     if constexpr (util::is_constant_v<expr_t>) {
         static_assert(!util::is_scl_v<expr_t>);
         using var_t = util::constant_var_t<value_t, ad::scl>;
-        var_t out = expr.feval().squaredNorm();
+        var_t out = util::accum_sum<AccumType>(expr.feval().array().square());
         return ad::constant(out);
     } else {
-        return core::NormNode<expr_t>(expr);
+        return core::NormNode<expr_t, AccumType>(expr);
     }
 }
 
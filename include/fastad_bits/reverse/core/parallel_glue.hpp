@@ -0,0 +1,363 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/llt.hpp>
+#include <fastad_bits/reverse/core/map_sum.hpp>
+#include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/reverse/core/visit.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/thread_pool.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+
+namespace ad {
+namespace core {
+namespace details {
+
+template <class T>
+struct is_map_sum: std::false_type
+{};
+
+template <class ExprType, class Lmda, class AccumType>
+struct is_map_sum<MapSumNode<ExprType, Lmda, AccumType>>: std::true_type
+{};
+
+/**
+ * Flattens a tree of GlueNodes into the tuple of its statements
+ * in the order they are evaluated.
+ */
+template <class ExprType>
+inline auto glue_statements(const ExprType& expr)
+{
+    return std::make_tuple(expr);
+}
+
+template <class LeftExprType, class RightExprType>
+inline auto glue_statements(const GlueNode<LeftExprType, RightExprType>& expr)
+{
+    return std::tuple_cat(glue_statements(expr.lhs()),
+                          glue_statements(expr.rhs()));
+}
+
+} // namespace details
+
+/*
+ * ParallelGlueNode represents evaluation of multiple statements like GlueNode,
+ * but runs statements that do not depend on each other concurrently.
+ * Ex.
+ * w1 = f(x), w2 = g(y), w3 = h(w1, w2)
+ * The first two statements can be evaluated at the same time in both passes.
+ *
+ * When bound, every statement is analysed with ad::visit:
+ * it touches the values and adjoints of every leaf (VarView) it reads
+ * and every placeholder it assigns (EqNode, OpEqNode),
+ * and it writes the values of the placeholders it assigns.
+ * A factorization shared among nodes (see ad::shared_llt) is written by every statement using it.
+ * Statement j runs after statement i < j in the forward pass
+ * if one writes a value the other touches,
+ * and before statement i in the backward pass if they touch a common variable,
+ * since backward evaluation accumulates into its adjoints.
+ * Overlapping views of the same variable are a common variable.
+ * A statement containing a map_sum is ordered with every other statement,
+ * since its leaves are only known once it is forward evaluated.
+ * Each pass then submits every statement to the thread pool
+ * as soon as the statements it depends on are done.
+ *
+ * Common subexpression elimination is suspended for the statements,
+ * since a statement viewing the cache of another would race with it.
+ * The statements must not evaluate on the same thread pool themselves
+ * (e.g. with ad::parallel_sum), since a worker cannot wait for the pool.
+ *
+ * ParallelGlueNode assumes the value and shape type of the last statement
+ * and views precisely whatever it views.
+ * The last statement is backward evaluated with the seed and the others with 0.
+ *
+ * @tparam  ExprTypes   types of statements to evaluate in order
+ */
+
+template <class... ExprTypes>
+struct ParallelGlueNode:
+    ValueAdjView<typename util::expr_traits<
+                    std::tuple_element_t<sizeof...(ExprTypes)-1,
+                                         std::tuple<ExprTypes...>> >::value_t,
+                 typename util::shape_traits<
+                    std::tuple_element_t<sizeof...(ExprTypes)-1,
+                                         std::tuple<ExprTypes...>> >::shape_t>,
+    ExprBase<ParallelGlueNode<ExprTypes...>>
+{
+private:
+    static constexpr size_t n_exprs = sizeof...(ExprTypes);
+    using exprs_t = std::tuple<ExprTypes...>;
+    using last_t = std::tuple_element_t<n_exprs-1, exprs_t>;
+    using last_value_t = typename util::expr_traits<last_t>::value_t;
+    using last_shape_t = typename util::shape_traits<last_t>::shape_t;
+    using graph_t = std::array<std::vector<size_t>, n_exprs>;
+
+    static_assert((util::is_expr_v<ExprTypes> && ...));
+
+public:
+    using value_adj_view_t = ValueAdjView<last_value_t, last_shape_t>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    ParallelGlueNode(const exprs_t& exprs, util::ThreadPool& pool)
+        : value_adj_view_t(nullptr, nullptr,
+                           std::get<n_exprs-1>(exprs).rows(),
+                           std::get<n_exprs-1>(exprs).cols())
+        , exprs_(exprs)
+        , pool_{&pool}
+    {}
+
+    /**
+     * Forward evaluates every statement after the statements it depends on.
+     * By this point, bind has already been called,
+     * so the current node is viewing the same values as the last statement.
+     *
+     * @return  last statement forward evaluation result
+     */
+    const var_t& feval()
+    {
+        FASTAD_PROFILE(feval);
+        run(fwd_succ_, fwd_indeg_, [&](auto& expr, auto) { expr.feval(); });
+        return this->get();
+    }
+
+    /**
+     * Backward evaluates the last statement with seed
+     * and the others with 0, every statement after the statements it depends on.
+     */
+    template <class T>
+    void beval(const T& seed)
+    {
+        FASTAD_PROFILE(beval);
+        run(bwd_succ_, bwd_indeg_, [&](auto& expr, auto i) {
+            if constexpr (decltype(i)::value == n_exprs-1) expr.beval(seed);
+            else expr.beval(0);
+        });
+    }
+
+    /**
+     * Binds every statement in order, binds itself
+     * to whatever the last statement root is bound to,
+     * then builds the dependency graphs of both passes.
+     *
+     * @return  the next pointer pack not bound by any of the statements
+     */
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        if (begin.cse) begin.cse->suspend();
+        std::apply([&](auto&... exprs) {
+            ((begin = exprs.bind_cache(begin)), ...);
+        }, exprs_);
+        if (begin.cse) begin.cse->resume();
+        auto& last = std::get<n_exprs-1>(exprs_);
+        value_adj_view_t::bind({last.data(), last.data_adj()});
+        build_graphs();
+        return begin;
+    }
+
+    util::SizePack bind_cache_size() const
+    {
+        return std::apply([](const auto&... exprs) -> util::SizePack {
+            return (exprs.bind_cache_size() + ...);
+        }, exprs_);
+    }
+
+    util::SizePack single_bind_cache_size() const
+    { return {0,0}; }
+
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        std::apply([&](const auto&... exprs) { (f(exprs), ...); }, exprs_);
+    }
+
+    /**
+     * Returns the statements that statement i depends on in the forward pass,
+     * i.e. that must be forward evaluated before it.
+     */
+    std::vector<size_t> dependencies(size_t i) const
+    {
+        std::vector<size_t> out;
+        for (size_t j = 0; j < i; ++j) {
+            for (size_t k : fwd_succ_[j]) {
+                if (k == i) out.push_back(j);
+            }
+        }
+        return out;
+    }
+
+private:
+    // Atomic counter that copies as zero,
+    // since counters are only meaningful during a pass.
+    struct counter_t
+    {
+        counter_t() =default;
+        counter_t(const counter_t&) {}
+        counter_t& operator=(const counter_t&) { return *this; }
+        std::atomic<size_t> n{0};
+    };
+
+    // Memory ranges [begin, end) read and written by a statement.
+    struct access_t
+    {
+        using range_t = std::pair<uintptr_t, uintptr_t>;
+
+        static bool overlap(const std::vector<range_t>& x,
+                            const std::vector<range_t>& y)
+        {
+            for (const auto& a : x) {
+                for (const auto& b : y) {
+                    if (a.first < b.second && b.first < a.second) return true;
+                }
+            }
+            return false;
+        }
+
+        std::vector<range_t> touched;
+        std::vector<range_t> written;
+        bool opaque = false;
+    };
+
+    template <class ExprType>
+    static access_t analyse(const ExprType& expr)
+    {
+        access_t out;
+        auto range = [](const auto& view) {
+            auto begin = reinterpret_cast<uintptr_t>(view.data());
+            return std::make_pair(begin, begin + view.size() * sizeof(*view.data()));
+        };
+        auto visitor = [&](const auto& node, size_t) {
+            using node_t = std::decay_t<decltype(node)>;
+            if constexpr (util::is_var_view_v<node_t>) {
+                out.touched.push_back(range(node));
+            } else if constexpr (details::has_placeholder<node_t>::value) {
+                out.touched.push_back(range(node.placeholder()));
+                out.written.push_back(range(node.placeholder()));
+            } else if constexpr (details::is_map_sum<node_t>::value) {
+                out.opaque = true;
+            }
+            if constexpr (details::has_shared_state<node_t>::value) {
+                if (const void* state = node.shared_state()) {
+                    auto begin = reinterpret_cast<uintptr_t>(state);
+                    out.touched.emplace_back(begin, begin + 1);
+                    out.written.emplace_back(begin, begin + 1);
+                }
+            }
+        };
+        details::visit(expr, visitor, 0);
+        return out;
+    }
+
+    void build_graphs()
+    {
+        std::array<access_t, n_exprs> access;
+        size_t k = 0;
+        std::apply([&](const auto&... exprs) {
+            ((access[k++] = analyse(exprs)), ...);
+        }, exprs_);
+
+        for (k = 0; k < n_exprs; ++k) {
+            fwd_succ_[k].clear();
+            bwd_succ_[k].clear();
+            fwd_indeg_[k] = bwd_indeg_[k] = 0;
+        }
+        for (size_t j = 1; j < n_exprs; ++j) {
+            for (size_t i = 0; i < j; ++i) {
+                const auto& a = access[i];
+                const auto& b = access[j];
+                bool opaque = a.opaque || b.opaque;
+                if (opaque ||
+                    access_t::overlap(a.written, b.touched) ||
+                    access_t::overlap(a.touched, b.written)) {
+                    fwd_succ_[i].push_back(j);
+                    ++fwd_indeg_[j];
+                }
+                if (opaque || access_t::overlap(a.touched, b.touched)) {
+                    bwd_succ_[j].push_back(i);
+                    ++bwd_indeg_[i];
+                }
+            }
+        }
+    }
+
+    /**
+     * Calls f(statement, index) on every statement on the thread pool,
+     * each once all of its predecessors in graph succ are done.
+     * Index is passed as std::integral_constant.
+     */
+    template <class F>
+    void run(const graph_t& succ, const std::array<size_t, n_exprs>& indeg, F&& f)
+    {
+        for (size_t i = 0; i < n_exprs; ++i) {
+            counters_[i].n.store(indeg[i], std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < n_exprs; ++i) {
+            if (indeg[i] == 0) submit(i, succ, f);
+        }
+        pool_->wait();
+    }
+
+    template <class F>
+    void submit(size_t i, const graph_t& succ, F& f)
+    {
+        pool_->submit([this, i, &succ, &f]() {
+            call(i, f, std::make_index_sequence<n_exprs>());
+            for (size_t j : succ[i]) {
+                if (counters_[j].n.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    submit(j, succ, f);
+                }
+            }
+        });
+    }
+
+    template <class F, size_t... I>
+    void call(size_t i, F& f, std::index_sequence<I...>)
+    {
+        ((i == I ? f(std::get<I>(exprs_), std::integral_constant<size_t, I>())
+                 : void()), ...);
+    }
+
+    exprs_t exprs_;
+    util::ThreadPool* pool_;
+    graph_t fwd_succ_;
+    graph_t bwd_succ_;
+    std::array<size_t, n_exprs> fwd_indeg_ = {};
+    std::array<size_t, n_exprs> bwd_indeg_ = {};
+    std::array<counter_t, n_exprs> counters_;
+};
+
+} // namespace core
+
+/**
+ * Binds expression to a cache owned by the returned object
+ * so that independent statements glued with operator, run concurrently
+ * on the workers of pool (see core::ParallelGlueNode).
+ * The pool must outlive the returned object.
+ *
+ * @tparam  Layout  layout policy of the cache (see ad::layout).
+ *                  Default is separate value and adjoint buffers.
+ */
+template <class Layout = layout::separate, class Derived>
+inline auto bind_parallel(const core::ExprBase<Derived>& expr,
+                          util::ThreadPool& pool)
+{
+    auto exprs = core::details::glue_statements(expr.self());
+    auto node = std::apply([&](const auto&... exprs) {
+        return core::ParallelGlueNode<std::decay_t<decltype(exprs)>...>(
+                std::make_tuple(exprs...), pool);
+    }, exprs);
+    return core::ExprBind<decltype(node)>(node, Layout());
+}
+
+} // namespace ad
@@ -0,0 +1,299 @@
+#pragma once
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/llt.hpp>
+#include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/visit.hpp>
+#include <fastad_bits/util/adjoint_scratch.hpp>
+#include <fastad_bits/util/cse_registry.hpp>
+#include <fastad_bits/util/leaf_registry.hpp>
+#include <fastad_bits/util/numeric.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/thread_pool.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+
+namespace ad {
+
+/**
+ * Execution policy of ad::parallel_sum.
+ * The terms are split into n_partitions contiguous partitions of (almost) equal size,
+ * which are evaluated by the workers of pool.
+ * The number of partitions is fixed independently of the number of threads
+ * so that the result does not depend on it,
+ * and bounds the memory of the scratch buffers (see ParallelSumIterNode).
+ * It should be a few times the number of threads to balance the load.
+ * The pool must outlive every expression created with the policy.
+ */
+struct parallel_policy
+{
+    static constexpr size_t default_n_partitions = 64;
+
+    explicit parallel_policy(util::ThreadPool& pool,
+                             size_t n_partitions = default_n_partitions)
+        : pool{&pool}
+        , n_partitions{std::max<size_t>(n_partitions, 1)}
+    {}
+
+    util::ThreadPool* pool;
+    size_t n_partitions;
+};
+
+namespace core {
+
+/**
+ * ParallelSumIterNode represents a summation of scalar expressions
+ * like SumIterNode, but evaluates partitions of the expressions in parallel.
+ *
+ * The expressions are split into a fixed number of contiguous partitions
+ * (see parallel_policy), which the workers evaluate in parallel.
+ * Each partition binds the adjoints of the leaves it reads
+ * to its own scratch buffers (see util::AdjointScratch),
+ * so that backward evaluation of different partitions never writes to the same memory.
+ * A leaf read by every expression then costs one scratch buffer per partition,
+ * regardless of the number of expressions.
+ * The scratch buffers are added to the leaf adjoints one partition at a time in order,
+ * and the partial sums of the forward evaluation are reduced in order as well.
+ * Since the partitions only depend on the number of expressions and of partitions,
+ * the value and the gradient are bitwise identical for any number of threads.
+ *
+ * The expressions must only read leaves (Var, VarView) and constants,
+ * i.e. they must not assign to placeholders (EqNode, OpEqNode)
+ * or read placeholders assigned by other expressions,
+ * since those are shared between partitions.
+ * Expressions that rebind their sub-expressions while evaluating (see MapSumNode)
+ * flush their own scratch buffers into the scratch buffers of their partition.
+ * Those leaves are registered to the leaf registry, if any,
+ * after the backward evaluation following the forward evaluation that first reaches them.
+ *
+ * Nodes sharing a factorization (see ad::shared_llt) write to its state
+ * in forward and backward evaluation.
+ * If any expression reaches such a state, the partitions are evaluated
+ * one after the other on the calling thread instead (see serial()),
+ * which gives the same result as the parallel evaluation.
+ *
+ * @tparam  VecType     type of vector of expressions to sum over
+ * @tparam  AccumType   type to accumulate the expressions in (see util::accum_t)
+ */
+
+template <class VecType, class AccumType = void>
+struct ParallelSumIterNode:
+    ValueAdjView<typename util::expr_traits<
+                    typename VecType::value_type >::value_t,
+                 ad::scl>,
+    ExprBase<ParallelSumIterNode<VecType, AccumType>>
+{
+private:
+    using vec_elem_t = typename VecType::value_type;
+    using elem_value_t = typename util::expr_traits<vec_elem_t>::value_t;
+
+    static_assert(util::is_scl_v<vec_elem_t>,
+                  "parallel_sum only supports scalar expressions");
+
+public:
+    using value_adj_view_t = ValueAdjView<elem_value_t, ad::scl>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    ParallelSumIterNode(const VecType& exprs, const parallel_policy& policy)
+        : value_adj_view_t(nullptr, nullptr, 1, 1)
+        , exprs_{exprs}
+        , pool_{policy.pool}
+        , n_partitions_{std::min(policy.n_partitions, exprs_.size())}
+        , partials_(n_partitions_, 0)
+        , scratch_(n_partitions_)
+        , n_registered_(n_partitions_, 0)
+        , serial_{reaches_shared_state()}
+    {}
+
+    /**
+     * Forward evaluate every partition in parallel,
+     * each accumulating its expressions left to right,
+     * then accumulate the partial sums in partition order.
+     *
+     * @return forward evaluation of sum of every expr.
+     */
+    const var_t& feval()
+    {
+        FASTAD_PROFILE(feval);
+        for_each_partition(
+            [&](size_t begin, size_t end) {
+                for (size_t c = begin; c < end; ++c) {
+                    util::accum_t<value_t, AccumType> sum = 0;
+                    for (size_t i = partition_begin(c); i < partition_begin(c+1); ++i) {
+                        sum += exprs_[i].feval();
+                    }
+                    partials_[c] = sum;
+                }
+            });
+        util::accum_t<value_t, AccumType> sum = 0;
+        for (const auto& partial : partials_) {
+            sum += partial;
+        }
+        this->get() = sum;
+        return this->get();
+    }
+
+    /**
+     * Backward evaluate every partition in parallel from right to left with the same seed
+     * into the scratch buffers of the partition.
+     * Then add the scratch buffers to the leaf adjoints in partition order.
+     * Note that since this node is always scalar, beval does not have to be templated.
+     */
+    void beval(value_t seed)
+    {
+        FASTAD_PROFILE(beval);
+        for_each_partition(
+            [&](size_t begin, size_t end) {
+                for (size_t c = begin; c < end; ++c) {
+                    for (size_t i = partition_begin(c+1); i > partition_begin(c); --i) {
+                        exprs_[i-1].beval(seed);
+                    }
+                }
+            });
+        for (size_t c = 0; c < n_partitions_; ++c) {
+            auto& scratch = scratch_[c];
+            scratch.flush();
+            scratch.zero();
+            if (leaves_ && n_registered_[c] < scratch.size()) {
+                leaves_->add(scratch, n_registered_[c]);
+                n_registered_[c] = scratch.size();
+            }
+        }
+    }
+
+    /**
+     * Bind the expressions of every partition from left to right
+     * with the leaf adjoints redirected to the scratch buffers of the partition,
+     * then bind itself to a scalar.
+     * Common subexpression elimination is suspended for the expressions,
+     * since an expression viewing the cache of another partition would race with it.
+     * The leaves behind the scratch buffers are registered to the leaf registry, if any.
+     *
+     * @return  the next pointer pack not bound by any of the expressions and itself.
+     */
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        auto* leaf_adj = begin.leaf_adj;
+        if (begin.cse) begin.cse->suspend();
+        for (size_t c = 0; c < n_partitions_; ++c) {
+            begin.leaf_adj = &scratch_[c];
+            for (size_t i = partition_begin(c); i < partition_begin(c+1); ++i) {
+                begin = exprs_[i].bind_cache(begin);
+            }
+        }
+        if (begin.cse) begin.cse->resume();
+        begin.leaf_adj = leaf_adj;
+        leaves_ = begin.leaves;
+        for (size_t c = 0; c < n_partitions_; ++c) {
+            if (leaves_) leaves_->add(scratch_[c]);
+            n_registered_[c] = scratch_[c].size();
+        }
+        return value_adj_view_t::bind_value(begin);
+    }
+
+    util::SizePack bind_cache_size() const
+    {
+        util::SizePack out = util::SizePack::Zero();
+        for (const auto& expr : exprs_) {
+            out += expr.bind_cache_size();
+        }
+        return out + single_bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const
+    {
+        return {this->size(), 0};
+    }
+
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        for (const auto& expr : exprs_) f(expr);
+    }
+
+    /**
+     * Returns the number of partitions, which is the number of partitions of the policy
+     * unless there are fewer expressions.
+     */
+    size_t n_partitions() const { return n_partitions_; }
+
+    /**
+     * Returns true if the partitions are evaluated serially
+     * because an expression reaches the state shared by a factorization.
+     */
+    bool serial() const { return serial_; }
+
+private:
+    bool reaches_shared_state() const
+    {
+        bool out = false;
+        auto visitor = [&](const auto& node, size_t) {
+            out = out || (details::shared_state(node) != nullptr);
+        };
+        for (const auto& expr : exprs_) {
+            details::visit(expr, visitor, 0);
+            if (out) break;
+        }
+        return out;
+    }
+
+    // f(begin, end) evaluates partitions [begin, end)
+    template <class F>
+    void for_each_partition(F&& f)
+    {
+        if (serial_) f(0, n_partitions_);
+        else pool_->parallel_for(n_partitions_, f);
+    }
+
+    // the first n % n_partitions_ partitions have one more expression than the others
+    size_t partition_begin(size_t c) const
+    {
+        size_t size = exprs_.size() / n_partitions_;
+        size_t remainder = exprs_.size() % n_partitions_;
+        return c * size + std::min(c, remainder);
+    }
+
+    std::vector<vec_elem_t> exprs_;
+    util::ThreadPool* pool_;
+    size_t n_partitions_;
+    std::vector<util::accum_t<value_t, AccumType>> partials_;
+    std::vector<util::AdjointScratch<value_t>> scratch_;
+    util::LeafRegistry<value_t>* leaves_ = nullptr;
+    std::vector<size_t> n_registered_;  // number of scratch buffers registered per partition
+    bool serial_;
+};
+
+} // namespace core
+
+/**
+ * Helper function to create a ParallelSumIterNode
+ * that sums f over [begin, end) using the thread pool of policy.
+ * If each expression type is constant, the sum is computed serially
+ * and returned as a constant as in ad::sum.
+ * AccumType is the type to accumulate in (see util::accum_t).
+ */
+template <class AccumType = void, class Iter, class Lmda>
+inline auto parallel_sum(Iter begin, Iter end, Lmda&& f,
+                         const parallel_policy& policy)
+{
+    using expr_t = std::decay_t<decltype(f(*begin))>;
+
+    if constexpr (util::is_constant_v<expr_t>) {
+        return ad::sum<AccumType>(begin, end, std::forward<Lmda>(f));
+    } else {
+        std::vector<expr_t> exprs;
+        exprs.reserve(std::distance(begin, end));
+        std::for_each(begin, end,
+                [&](const auto& x) {
+                    exprs.emplace_back(f(x));
+                });
+        return core::ParallelSumIterNode<std::vector<expr_t>, AccumType>(exprs, policy);
+    }
+}
+
+} // namespace ad
@@ -7,13 +7,16 @@
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/fuse.hpp>
+#include <fastad_bits/util/simd.hpp>
+#include <fastad_bits/util/soa_context.hpp>
 #include <fastad_bits/util/value.hpp>
 
 namespace ad {
 namespace core {
 
 /*
- * Utility pow function for scalars.
+ * Utility pow function for scalars and packs (see ad::simd).
  */
 
 // Primary definition: exp > 0
@@ -49,9 +52,9 @@ struct PowFunc<n, false>
     template <class BaseType>
     static auto evaluate(const BaseType& base)
     {
-        return (base == 0) ? 
-            std::numeric_limits<BaseType>::infinity() : 
-            PowFunc<-n>::evaluate(1./base);
+        return util::select(base == 0,
+            std::numeric_limits<BaseType>::infinity(),
+            PowFunc<-n>::evaluate(1./base));
     }
 };
 
@@ -83,6 +86,12 @@ public:
     using typename value_adj_view_t::var_t;
     using typename value_adj_view_t::ptr_pack_t;
 
+    static constexpr bool soa_aware = util::is_scl_v<expr_t> &&
+                                      util::is_soa_aware_v<expr_t>;
+    static constexpr bool fuse_aware = util::is_fuse_aware_v<expr_t>;
+    static constexpr size_t fuse_scalars = util::fuse_scalars<expr_t>();
+    static constexpr bool fuse_rebuildable = true;
+
     PowNode(const expr_t& expr)
         : value_adj_view_t(nullptr, nullptr, expr.rows(), expr.cols())
         , expr_{expr}
@@ -90,6 +99,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         if constexpr (util::is_scl_v<expr_t>) {
             return this->get() =
                     PowFunc<exp_>::evaluate(expr_.feval()); 
@@ -101,6 +111,7 @@ public:
     template <class T>
     void beval(const T& seed)
     {
+        FASTAD_PROFILE(beval);
         static_cast<void>(seed);
 
         // derivative of x^0 = c is 0
@@ -132,7 +143,7 @@ public:
                                         0 : a_val(i,j) / a_expr(i,j);
                                 });
                     } else {
-                        return a_expr == 0 ? 0 : a_val / a_expr;
+                        return util::select(a_expr == 0, 0, a_val / a_expr);
                     }
                 };
                 auto corrected_seed = exp * a_adj * correct_seed();
@@ -150,9 +161,9 @@ public:
                                         exp * a_adj(i,j) * a_val(i,j) / a_expr(i,j);
                                 });
                     } else {
-                        return a_expr == 0 ? 
-                                -std::numeric_limits<value_t>::infinity():
-                                exp * a_adj * a_val / a_expr;
+                        return util::select(a_expr == 0,
+                                -std::numeric_limits<value_t>::infinity(),
+                                exp * a_adj * a_val / a_expr);
                     }
                 };
                 expr_.beval(correct_seed());
@@ -165,11 +176,7 @@ public:
     { 
         begin = expr_.bind_cache(begin);
         if constexpr (exp == 0 || exp == 1) {
-            auto adj = begin.adj;
-            begin.adj = nullptr;
-            begin = value_adj_view_t::bind(begin);
-            begin.adj = adj;
-            return begin;
+            return value_adj_view_t::bind_value(begin);
         } else {
             return value_adj_view_t::bind(begin);
         }
@@ -190,6 +197,112 @@ public:
         }
     }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(expr_);
+    }
+
+    /**
+     * Rebuilds the node with f applied to its children (see ad::fuse).
+     */
+    template <class F>
+    auto fuse_rebuild(F&& f) const
+    {
+        auto expr = f(expr_);
+        return PowNode<exp, decltype(expr)>(expr);
+    }
+
+    /**
+     * Structure-of-arrays evaluation of this node only (see util::SoAContext).
+     * Every lane is computed as in the scalar case.
+     */
+    void soa_feval(util::SoAContext<value_t>& ctx, size_t self, const size_t* children) const
+    {
+        const value_t* x = ctx.val(children[0]).data();
+        value_t* f = ctx.val(self).data();
+        for (size_t k = 0; k < ctx.lanes(); ++k) {
+            f[k] = PowFunc<exp_>::evaluate(x[k]);
+        }
+    }
+
+    void soa_beval(util::SoAContext<value_t>& ctx, size_t self, const size_t* children) const
+    {
+        const value_t* x = ctx.val(children[0]).data();
+        const value_t* f = ctx.val(self).data();
+        const value_t* seed = ctx.adj(self).data();
+        value_t* x_adj = ctx.adj(children[0]).data();
+        for (size_t k = 0; k < ctx.lanes(); ++k) {
+            if constexpr (exp == 0) {
+                x_adj[k] = 0;
+            } else if constexpr (exp == 1) {
+                x_adj[k] = seed[k];
+            } else if constexpr (exp > 1) {
+                x_adj[k] = util::select(x[k] == 0, 0, exp * seed[k] * f[k] / x[k]);
+            } else {
+                x_adj[k] = util::select(x[k] == 0,
+                    -std::numeric_limits<value_t>::infinity(),
+                    exp * seed[k] * f[k] / x[k]);
+            }
+        }
+    }
+
+    /**
+     * Fused element-wise evaluation (see FusedNode).
+     * Non-negative exponents are expanded into multiplications as in the scalar case.
+     */
+    ptr_pack_t fuse_bind(ptr_pack_t begin) { return expr_.fuse_bind(begin); }
+
+    auto fuse_make()
+    {
+        return std::tuple<util::fuse_block_t<value_t, shape_t>,
+                          decltype(expr_.fuse_make())>();
+    }
+
+    template <class V>
+    void fuse_feval(size_t begin, size_t n, V& v)
+    {
+        auto& x = std::get<1>(v);
+        expr_.fuse_feval(begin, n, x);
+        auto a_x = util::fuse_view(std::get<0>(x));
+        if constexpr (util::is_scl_v<expr_t> || exp > 0) {
+            std::get<0>(v) = PowFunc<exp_>::evaluate(a_x);
+        } else if constexpr (exp == 0) {
+            std::get<0>(v).setOnes(n);
+        } else {
+            std::get<0>(v) = a_x.pow(value_t(exp_));
+        }
+    }
+
+    template <class V, class S>
+    void fuse_beval(size_t begin, size_t n, const V& v, const S& seed, value_t* acc)
+    {
+        // derivative of x^0 = c is 0
+        if constexpr (exp == 0) {
+            return;
+        } else if constexpr (exp == 1) {
+            expr_.fuse_beval(begin, n, std::get<1>(v), seed, acc);
+        } else {
+            const auto& x = std::get<1>(v);
+            auto a_x = util::fuse_view(std::get<0>(x));
+            auto a_val = util::fuse_view(std::get<0>(v));
+            auto a_seed = util::fuse_view(seed);
+            constexpr value_t zero_seed = (exp > 1) ? 
+                0 : -std::numeric_limits<value_t>::infinity();
+            using block_t = util::fuse_block_t<value_t, shape_t>;
+            const block_t x_seed = [&]() -> block_t {
+                if constexpr (util::is_scl_v<expr_t>) {
+                    return (a_x == 0) ? zero_seed : exp * a_seed * a_val / a_x;
+                } else {
+                    return (a_x == 0).select(zero_seed, exp * a_seed * a_val / a_x);
+                }
+            }();
+            expr_.fuse_beval(begin, n, x, x_seed, acc);
+        }
+    }
+
+    void fuse_flush(const value_t* acc) { expr_.fuse_flush(acc); }
+
 private:
     expr_t expr_;
     static constexpr int64_t exp_ = exp;
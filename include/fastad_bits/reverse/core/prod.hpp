@@ -54,6 +54,7 @@ public:
      */
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         this->ones();
         for (auto& expr : exprs_) {
             util::to_array(this->get()) *= util::to_array(expr.feval());
@@ -67,6 +68,7 @@ public:
     template <class T>
     void beval(const T& seed)
     {
+        FASTAD_PROFILE(beval);
         if (exprs_.size() == 0) return;
         auto&& a_val = util::to_array(this->get());
         auto&& a_adj = util::to_array(this->get_adj());
@@ -130,6 +132,12 @@ public:
         return {this->size(), this->size()}; 
     }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        for (const auto& expr : exprs_) f(expr);
+    }
+
 private:
     VecType exprs_;
 };
@@ -158,6 +166,8 @@ public:
     using typename value_adj_view_t::var_t;
     using typename value_adj_view_t::ptr_pack_t;
 
+    static constexpr bool fuse_rebuildable = true;
+
     ProdElemNode(const expr_t& expr)
         : value_adj_view_t(nullptr, nullptr, 1, 1)
         , expr_{expr}
@@ -171,6 +181,7 @@ public:
      */
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& res = expr_.feval();
         if constexpr (util::is_scl_v<expr_t>) {
             return this->get() = res;
@@ -187,6 +198,7 @@ public:
      */
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         for (size_t k = 0; k < expr_.cols(); ++k) {
             for (size_t l = 0; l < expr_.rows(); ++l) {
 
@@ -219,12 +231,8 @@ public:
     ptr_pack_t bind_cache(ptr_pack_t begin)
     {
         begin = expr_.bind_cache(begin);
-        begin.adj = adj_cache_.bind(begin.adj);
-        auto adj = begin.adj;
-        begin.adj = nullptr;
-        begin = value_adj_view_t::bind(begin);
-        begin.adj = adj;
-        return begin;
+        begin.bind_adj(adj_cache_);
+        return value_adj_view_t::bind_value(begin);
     }
 
     util::SizePack bind_cache_size() const 
@@ -238,6 +246,22 @@ public:
         return {this->size(), expr_.size()}; 
     }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(expr_);
+    }
+
+    /**
+     * Rebuilds the node with f applied to its children (see ad::fuse).
+     */
+    template <class F>
+    auto fuse_rebuild(F&& f) const
+    {
+        auto expr = f(expr_);
+        return ProdElemNode<decltype(expr)>(expr);
+    }
+
 private:
     using value_view_t = ValueView<value_t, expr_shape_t>;
     expr_t expr_;
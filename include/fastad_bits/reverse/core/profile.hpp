@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#ifdef FASTAD_ENABLE_PROFILING
+#include <fastad_bits/util/profile.hpp>
+#endif
+
+namespace ad {
+
+#ifdef FASTAD_ENABLE_PROFILING
+namespace core {
+
+/**
+ * Prints stat and its children indented by depth (see ad::profile_report).
+ */
+inline void print_profile(std::ostream& os, const util::ProfileStat& stat, size_t depth)
+{
+    using util::ProfilePhase;
+    std::string name = std::string(2 * depth, ' ') + stat.name;
+    os << std::left << std::setw(32) << name << std::right;
+    for (auto phase : {ProfilePhase::feval, ProfilePhase::beval}) {
+        os << std::setw(10) << stat.counter(phase).calls
+           << std::setw(14) << stat.counter(phase).ticks
+           << std::setw(14) << stat.exclusive_ticks(phase);
+    }
+    os << std::setw(10) << stat.bytes << '\n';
+    for (const auto* child : stat.children) {
+        print_profile(os, *child, depth + 1);
+    }
+}
+
+} // namespace core
+#endif
+
+/**
+ * Prints the profiling tree of an evaluated expression to os:
+ * for every node, the number of calls and the inclusive and exclusive ticks
+ * of forward and backward evaluation, and the bytes of cache it binds itself.
+ * Ticks are cycles on x86 and nanoseconds elsewhere (see util::profile_ticks).
+ * Leaves and constants are not instrumented.
+ *
+ * Requires FASTAD_ENABLE_PROFILING to be defined before including FastAD,
+ * otherwise only a note is printed.
+ */
+template <class Derived>
+inline void profile_report(const core::ExprBase<Derived>& expr,
+                           std::ostream& os = std::cout)
+{
+#ifdef FASTAD_ENABLE_PROFILING
+    os << std::left << std::setw(32) << "node" << std::right
+       << std::setw(10) << "fcalls"
+       << std::setw(14) << "feval incl"
+       << std::setw(14) << "feval excl"
+       << std::setw(10) << "bcalls"
+       << std::setw(14) << "beval incl"
+       << std::setw(14) << "beval excl"
+       << std::setw(10) << "bytes" << '\n';
+    core::print_profile(os, expr.profile_stat(), 0);
+#else
+    static_cast<void>(expr);
+    os << "profiling disabled: define FASTAD_ENABLE_PROFILING\n";
+#endif
+}
+
+template <class ExprType>
+inline void profile_report(const core::ExprBind<ExprType>& expr,
+                           std::ostream& os = std::cout)
+{
+    profile_report(expr.get(), os);
+}
+
+/**
+ * Resets the profiling counters of every node of an expression.
+ */
+template <class Derived>
+inline void profile_reset(core::ExprBase<Derived>& expr)
+{
+#ifdef FASTAD_ENABLE_PROFILING
+    expr.profile_stat().reset();
+#else
+    static_cast<void>(expr);
+#endif
+}
+
+template <class ExprType>
+inline void profile_reset(core::ExprBind<ExprType>& expr)
+{
+    profile_reset(expr.get());
+}
+
+} // namespace ad
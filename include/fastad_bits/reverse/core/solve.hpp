@@ -0,0 +1,376 @@
+#pragma once
+#include <limits>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/llt.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/value.hpp>
+#include <Eigen/Dense>
+
+namespace ad {
+namespace core {
+
+/**
+ * SolveNode represents the solution x of the linear system A x = b.
+ * The left expression must be a square matrix shape, and the right be a matrix or column vector.
+ * No other shapes are permitted for this node.
+ * Decomposition functor of type DecompType is provided to
+ * define the policy in how to factorize A.
+ *
+ * A is factorized once in forward evaluation and the factorization is reused
+ * in backward evaluation, where the adjoint of b is the solution of A^T y = seed
+ * and the adjoint of A is -y x^T.
+ * No inverse is formed.
+ * If A is a constant, it is only factorized at construction.
+ *
+ * We assert that the value type be the same for the two expressions.
+ * The node assumes the shape of b.
+ *
+ * @tparam  DecompType      decomposition type
+ * @tparam  AExprType       type of matrix expression
+ * @tparam  BExprType       type of right-hand side expression
+ */
+
+template <class DecompType
+        , class AExprType
+        , class BExprType>
+struct SolveNode:
+    ValueAdjView<typename util::expr_traits<AExprType>::value_t,
+                 typename util::shape_traits<BExprType>::shape_t>,
+    ExprBase<SolveNode<DecompType, AExprType, BExprType>>
+{
+private:
+    using decomp_t = DecompType;
+    using a_t = AExprType;
+    using b_t = BExprType;
+    using a_value_t = typename util::expr_traits<a_t>::value_t;
+
+    static_assert(util::is_mat_v<a_t>);
+    static_assert(util::is_vec_v<b_t> || util::is_mat_v<b_t>);
+    static_assert(std::is_same_v<
+            typename util::expr_traits<a_t>::value_t,
+            typename util::expr_traits<b_t>::value_t>);
+
+public:
+    using value_adj_view_t = ValueAdjView<a_value_t,
+          typename util::shape_traits<b_t>::shape_t>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    SolveNode(const a_t& a,
+              const b_t& b)
+        : SolveNode(a, b, a.rows(), 0)
+    {}
+
+    SolveNode(const a_t& a,
+              const b_t& b,
+              const decomp_t& decomp)
+        : SolveNode(a, b, decomp, 0)
+    {}
+
+private:
+    // constructs the decomposition in place from decomp_arg,
+    // so that an unfactorized decomposition is never copied.
+    template <class DecompArgType>
+    SolveNode(const a_t& a,
+              const b_t& b,
+              const DecompArgType& decomp_arg,
+              int)
+        : value_adj_view_t(nullptr, nullptr, b.rows(), b.cols())
+        , a_{a}
+        , b_{b}
+        , decomp_(decomp_arg)
+        , a_adj_()
+    {
+        assert(a.rows() == a.cols());
+        assert(a.cols() == b.rows());
+        if constexpr (util::is_constant_v<a_t>) {
+            decomp_.compute(a_.get());
+        } else {
+            a_adj_.resize(a.rows(), a.cols());
+        }
+    }
+
+public:
+
+    const var_t& feval()
+    {
+        FASTAD_PROFILE(feval);
+        auto&& a_val = a_.feval();
+        auto&& b_val = b_.feval();
+        if constexpr (!util::is_constant_v<a_t>) {
+            decomp_.compute(a_val);
+        }
+        if (!decomp_.valid()) {
+            this->get().fill(std::numeric_limits<value_t>::quiet_NaN());
+            return this->get();
+        }
+        this->get() = b_val;
+        decomp_.solve(this->get());
+        return this->get();
+    }
+
+    template <class T>
+    void beval(const T& seed)
+    {
+        FASTAD_PROFILE(beval);
+        if (!decomp_.valid()) return;
+        auto& adj = this->get_adj();
+        util::to_array(adj) = seed;
+        decomp_.solve_transpose(adj);
+        if constexpr (!util::is_constant_v<a_t>) {
+            a_adj_.noalias() = -adj * this->get().transpose();
+            a_.beval(a_adj_.array());
+        }
+        b_.beval(util::to_array(adj));
+    }
+
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        begin = a_.bind_cache(begin);
+        begin = b_.bind_cache(begin);
+        return value_adj_view_t::bind(begin);
+    }
+
+    util::SizePack bind_cache_size() const
+    {
+        return single_bind_cache_size() +
+                a_.bind_cache_size() +
+                b_.bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const
+    {
+        return {this->size(), this->size()};
+    }
+
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(a_);
+        f(b_);
+    }
+
+    /**
+     * Returns the factorization state shared with other nodes, if any (see ad::shared_llt).
+     */
+    const void* shared_state() const { return details::shared_state(decomp_); }
+
+private:
+    using mat_t = util::constant_var_t<value_t,
+          typename util::shape_traits<a_t>::shape_t>;
+    a_t a_;
+    b_t b_;
+    decomp_t decomp_;
+    mat_t a_adj_;
+};
+
+} // namespace core
+
+/*
+ * Default method for decomposing a matrix for linear solves.
+ * Decompositions are templated on the shape of the matrix
+ * so that fixed-size matrices (see ad::fixed_mat) use fixed-size decompositions.
+ * Every solve overwrites its argument with the solution,
+ * which Eigen computes in-place without allocating.
+ */
+template <class ValueType, class ShapeType = ad::mat>
+struct SolvePartialPivLU
+{
+    using value_t = ValueType;
+
+    SolvePartialPivLU(size_t rows)
+        : lu_(rows)
+    {}
+
+    template <class T>
+    void compute(const Eigen::MatrixBase<T>& A)
+    {
+        lu_.compute(A);
+        valid_ = (lu_.matrixLU().diagonal().array() != 0).all();
+    }
+
+    // X <- A^{-1} X
+    template <class T>
+    void solve(Eigen::MatrixBase<T>& X) const
+    {
+        X = lu_.solve(X);
+    }
+
+    // X <- A^{-T} X
+    template <class T>
+    void solve_transpose(Eigen::MatrixBase<T>& X) const
+    {
+        X = lu_.transpose().solve(X);
+    }
+
+    bool valid() const { return valid_; }
+
+private:
+    using mat_t = util::constant_var_t<value_t, ShapeType>;
+    bool valid_ = false;
+    Eigen::PartialPivLU<mat_t> lu_;
+};
+
+/*
+ * Decomposing a positive or negative semi-definite matrix for linear solves.
+ */
+template <class ValueType, class ShapeType = ad::mat>
+struct SolveLDLT
+{
+    using value_t = ValueType;
+
+    SolveLDLT(size_t rows)
+        : ldlt_(rows)
+    {}
+
+    template <class T>
+    void compute(const Eigen::MatrixBase<T>& A)
+    {
+        ldlt_.compute(A);
+        valid_ = (ldlt_.info() == Eigen::Success) &&
+                 (ldlt_.vectorD().array() != 0).all();
+    }
+
+    template <class T>
+    void solve(Eigen::MatrixBase<T>& X) const
+    {
+        X = ldlt_.solve(X);
+    }
+
+    template <class T>
+    void solve_transpose(Eigen::MatrixBase<T>& X) const
+    {
+        solve(X);
+    }
+
+    bool valid() const { return valid_; }
+
+private:
+    using mat_t = util::constant_var_t<value_t, ShapeType>;
+    bool valid_ = false;
+    Eigen::LDLT<mat_t> ldlt_;
+};
+
+/*
+ * Decomposing a positive definite matrix for linear solves.
+ * The factorization may be shared with other nodes on the same matrix (see ad::shared_llt).
+ */
+template <class ValueType, class ShapeType = ad::mat>
+struct SolveLLT
+{
+    using value_t = ValueType;
+
+    SolveLLT(size_t rows)
+        : llt_(rows)
+    {}
+
+    SolveLLT(const LLTFactor<value_t, ShapeType>& llt)
+        : llt_(llt)
+    {}
+
+    template <class T>
+    void compute(const Eigen::MatrixBase<T>& A)
+    {
+        llt_.compute(A);
+    }
+
+    template <class T>
+    void solve(Eigen::MatrixBase<T>& X) const
+    {
+        llt_.solve(X);
+    }
+
+    template <class T>
+    void solve_transpose(Eigen::MatrixBase<T>& X) const
+    {
+        solve(X);
+    }
+
+    bool valid() const { return llt_.valid(); }
+
+    const void* shared_state() const { return llt_.shared_state(); }
+
+private:
+    LLTFactor<value_t, ShapeType> llt_;
+};
+
+/*
+ * Creates a linear solve expression node with a policy that defines the decomposition of a.
+ * The default decomposition is Eigen::PartialPivLU.
+ * Currently, we support SolveLDLT and SolveLLT for some specialized matrices.
+ * If both a and b are constants, the decomposition is ignored and
+ * the solution is computed once with Eigen::PartialPivLU.
+ */
+template <template <class...> class DecompType = SolvePartialPivLU
+        , class T1
+        , class T2
+        , class = std::enable_if_t<
+            util::is_convertible_to_ad_v<T1> &&
+            util::is_convertible_to_ad_v<T2> &&
+            util::any_ad_v<T1, T2> > >
+inline auto solve(const T1& a,
+                  const T2& b)
+{
+    using a_expr_t = util::convert_to_ad_t<T1>;
+    using b_expr_t = util::convert_to_ad_t<T2>;
+    using value_t = typename util::expr_traits<a_expr_t>::value_t;
+    using a_shape_t = typename util::shape_traits<a_expr_t>::shape_t;
+    a_expr_t a_expr = a;
+    b_expr_t b_expr = b;
+
+    // optimization for when both expressions are constant
+    if constexpr (util::is_constant_v<a_expr_t> &&
+                  util::is_constant_v<b_expr_t>) {
+        using var_t = util::constant_var_t<value_t,
+              typename util::shape_traits<b_expr_t>::shape_t>;
+        var_t out = a_expr.feval().partialPivLu().solve(b_expr.feval());
+        return ad::constant(out);
+    } else {
+        return core::SolveNode<DecompType<value_t, a_shape_t>,
+                               a_expr_t, b_expr_t>(a_expr, b_expr);
+    }
+}
+
+/*
+ * Creates a linear solve expression node with SolveLLT
+ * that shares the Cholesky factorization llt with other nodes on a (see ad::shared_llt).
+ */
+template <class T1
+        , class T2
+        , class ValueType
+        , class ShapeType
+        , class = std::enable_if_t<
+            util::is_convertible_to_ad_v<T1> &&
+            util::is_convertible_to_ad_v<T2> &&
+            util::any_ad_v<T1, T2> > >
+inline auto solve(const T1& a,
+                  const T2& b,
+                  const LLTFactor<ValueType, ShapeType>& llt)
+{
+    using a_expr_t = util::convert_to_ad_t<T1>;
+    using b_expr_t = util::convert_to_ad_t<T2>;
+    using value_t = typename util::expr_traits<a_expr_t>::value_t;
+    static_assert(std::is_same_v<value_t, ValueType>);
+    a_expr_t a_expr = a;
+    b_expr_t b_expr = b;
+
+    // optimization for when both expressions are constant
+    if constexpr (util::is_constant_v<a_expr_t> &&
+                  util::is_constant_v<b_expr_t>) {
+        using var_t = util::constant_var_t<value_t,
+              typename util::shape_traits<b_expr_t>::shape_t>;
+        var_t out = a_expr.feval().llt().solve(b_expr.feval());
+        return ad::constant(out);
+    } else {
+        using decomp_t = SolveLLT<value_t, ShapeType>;
+        return core::SolveNode<decomp_t, a_expr_t, b_expr_t>(
+                a_expr, b_expr, decomp_t(llt));
+    }
+}
+
+} // namespace ad
@@ -0,0 +1,339 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/var_view.hpp>
+#include <fastad_bits/util/adjoint_scratch.hpp>
+#include <fastad_bits/util/leaf_registry.hpp>
+#include <fastad_bits/util/ptr_pack.hpp>
+#include <fastad_bits/util/shape_traits.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <Eigen/SparseCore>
+
+namespace ad {
+namespace core {
+
+/**
+ * SparseView views a sparse matrix in compressed storage,
+ * i.e. the arrays of Eigen::SparseMatrix in compressed mode:
+ * the nnz stored values, the inner index of every stored value,
+ * and the outer_size + 1 offsets of every outer vector into them.
+ * For column-major storage (CSC), inner indices are rows and outer vectors are columns,
+ * and for row-major storage (CSR), the other way around.
+ *
+ * The view never owns the indices.
+ * size() is the number of stored values, so that memory scales with nnz.
+ *
+ * @tparam  ValueType   underlying data type (may be const)
+ * @tparam  Options     Eigen::ColMajor or Eigen::RowMajor
+ */
+
+template <class ValueType, int Options>
+struct SparseView
+{
+    using value_t = std::remove_const_t<ValueType>;
+    using sparse_t = Eigen::SparseMatrix<value_t, Options>;
+    using index_t = typename sparse_t::StorageIndex;
+    using var_t = Eigen::Map<const sparse_t>;
+    static constexpr bool row_major = (Options & Eigen::RowMajorBit);
+
+    SparseView(ValueType* val,
+               size_t rows,
+               size_t cols,
+               size_t nnz,
+               const index_t* outer,
+               const index_t* inner)
+        : val_(val)
+        , rows_(rows)
+        , cols_(cols)
+        , nnz_(nnz)
+        , outer_(outer)
+        , inner_(inner)
+    {}
+
+    var_t get() const { return view(val_); }
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    size_t size() const { return nnz_; }
+    size_t nonZeros() const { return nnz_; }
+    size_t outer_size() const { return row_major ? rows_ : cols_; }
+    ValueType* data() const { return val_; }
+    const index_t* outer_index() const { return outer_; }
+    const index_t* inner_index() const { return inner_; }
+
+protected:
+    var_t view(const value_t* val) const
+    {
+        return var_t(rows_, cols_, nnz_, outer_, inner_, val);
+    }
+
+    /**
+     * Calls f(k, i, j) for every stored value k at row i and column j.
+     */
+    template <class F>
+    void for_each_nonzero(F f) const
+    {
+        for (size_t o = 0; o < outer_size(); ++o) {
+            for (index_t k = outer_[o]; k < outer_[o+1]; ++k) {
+                const size_t in = inner_[k];
+                if constexpr (row_major) f(k, o, in);
+                else f(k, in, o);
+            }
+        }
+    }
+
+    ValueType* val_;
+    size_t rows_;
+    size_t cols_;
+    size_t nnz_;
+    const index_t* outer_;
+    const index_t* inner_;
+};
+
+} // namespace core
+
+/*
+ * VarView specialization for sparse matrices (see ad::sparse).
+ * It views the stored values and their adjoints, which share the sparsity pattern.
+ * The sparsity pattern is fixed:
+ * backward evaluation only accumulates adjoints into stored entries.
+ *
+ * @tparam  ValueType   underlying data type
+ * @tparam  Options     Eigen::ColMajor or Eigen::RowMajor
+ */
+
+template <class ValueType, int Options>
+struct VarView<ValueType, basic_sparse<Options>>:
+    core::SparseView<ValueType, Options>,
+    core::ExprBase<VarView<ValueType, basic_sparse<Options>>>
+{
+    using base_t = core::SparseView<ValueType, Options>;
+    using typename base_t::value_t;
+    using typename base_t::index_t;
+    using typename base_t::var_t;
+    using shape_t = basic_sparse<Options>;
+    using ptr_pack_t = util::PtrPack<value_t>;
+
+    VarView(value_t* val,
+            value_t* adj,
+            size_t rows,
+            size_t cols,
+            size_t nnz,
+            const index_t* outer,
+            const index_t* inner)
+        : base_t(val, rows, cols, nnz, outer, inner)
+        , adj_(adj)
+    {}
+
+    var_t get_adj() const { return this->view(adj_); }
+    value_t* data_adj() const { return adj_; }
+
+    /**
+     * Forward-evaluation simply returns the underlying value.
+     */
+    var_t feval() const { return this->get(); }
+
+    /**
+     * Backward-evaluation increments the adjoint of every stored entry
+     * by the corresponding entry of the dense seed.
+     * Entries of the seed outside of the sparsity pattern are ignored.
+     */
+    template <class T>
+    void beval(const T& seed)
+    {
+        this->for_each_nonzero([&](index_t k, size_t i, size_t j) {
+            adj_[k] += seed(i, j);
+        });
+    }
+
+    /**
+     * Backward-evaluation with seed lhs * rhs^T
+     * without forming it: only the entries in the sparsity pattern are computed.
+     * This is the adjoint of the product of the sparse matrix with rhs
+     * given the adjoint lhs of the product (see SparseDotNode).
+     */
+    template <class L, class R>
+    void beval_product(const L& lhs, const R& rhs)
+    {
+        this->for_each_nonzero([&](index_t k, size_t i, size_t j) {
+            if constexpr (R::ColsAtCompileTime == 1) {
+                adj_[k] += lhs(i) * rhs(j);
+            } else {
+                adj_[k] += lhs.row(i).dot(rhs.row(j));
+            }
+        });
+    }
+
+    /**
+     * Cache bind size is 0, as for every other VarView.
+     * If the pointer pack provides an adjoint scratch,
+     * the adjoints are rebound to its scratch buffer (see util::AdjointScratch).
+     * Otherwise, the leaf registers itself if the pointer pack provides a leaf registry.
+     */
+    template <class T>
+    T bind_cache(T begin)
+    {
+        if constexpr (std::is_same_v<typename T::value_t, value_t>) {
+            if (begin.leaf_adj) {
+                adj_ = begin.leaf_adj->bind(this->data(), adj_, this->size());
+            } else if (begin.leaves) {
+                begin.leaves->add(this->data(), adj_, this->size());
+            }
+        }
+        return begin;
+    }
+    util::SizePack bind_cache_size() const { return {0,0}; }
+    util::SizePack single_bind_cache_size() const { return {0,0}; }
+
+    void reset_adj() { std::fill(adj_, adj_ + this->size(), value_t(0)); }
+
+private:
+    value_t* adj_;
+};
+
+/**
+ * Var specialization for sparse matrices.
+ * It owns a compressed Eigen::SparseMatrix for the values and the sparsity pattern,
+ * and the nnz adjoints.
+ */
+
+template <class ValueType, int Options>
+struct Var<ValueType, basic_sparse<Options>>:
+    VarView<ValueType, basic_sparse<Options>>
+{
+private:
+    using base_t = VarView<ValueType, basic_sparse<Options>>;
+    using sparse_t = typename base_t::sparse_t;
+    using adj_t = Eigen::Matrix<ValueType, Eigen::Dynamic, 1>;
+
+public:
+    using typename base_t::value_t;
+    using typename base_t::shape_t;
+    using typename base_t::var_t;
+
+    /**
+     * Constructs a variable with the sparsity pattern and values of x.
+     * Explicitly stored zeros are kept as variables.
+     */
+    template <class Derived>
+    explicit Var(const Eigen::SparseMatrixBase<Derived>& x)
+        : base_t(nullptr, nullptr, x.rows(), x.cols(), 0, nullptr, nullptr)
+        , val_(x)
+    {
+        val_.makeCompressed();
+        adj_ = adj_t::Zero(val_.nonZeros());
+        rebind();
+    }
+
+    Var(const Var& v)
+        : base_t(v)
+        , val_(v.val_)
+        , adj_(v.adj_)
+    { rebind(); }
+
+    Var(Var&& v)
+        : base_t(std::move(v))
+        , val_(std::move(v.val_))
+        , adj_(std::move(v.adj_))
+    { rebind(); }
+
+    Var& operator=(const Var& v)
+    {
+        if (this == &v) return *this;
+        val_ = v.val_;
+        adj_ = v.adj_;
+        rebind();
+        return *this;
+    }
+
+    Var& operator=(Var&& v)
+    {
+        if (this == &v) return *this;
+        val_ = std::move(v.val_);
+        adj_ = std::move(v.adj_);
+        rebind();
+        return *this;
+    }
+
+private:
+    void rebind()
+    {
+        static_cast<base_t&>(*this) = base_t(
+                val_.valuePtr(), adj_.data(),
+                val_.rows(), val_.cols(), val_.nonZeros(),
+                val_.outerIndexPtr(), val_.innerIndexPtr());
+    }
+
+    sparse_t val_;
+    adj_t adj_;
+};
+
+namespace core {
+
+/**
+ * ConstantView specialization for sparse matrices.
+ * It views the arrays of a compressed sparse matrix as constants.
+ *
+ * @tparam  ValueType   underlying data type
+ * @tparam  Options     Eigen::ColMajor or Eigen::RowMajor
+ */
+
+template <class ValueType, int Options>
+struct ConstantView<ValueType, basic_sparse<Options>>:
+    SparseView<const ValueType, Options>,
+    ConstantBase<ConstantView<ValueType, basic_sparse<Options>>>
+{
+    using base_t = SparseView<const ValueType, Options>;
+    using typename base_t::value_t;
+    using typename base_t::index_t;
+    using typename base_t::var_t;
+    using shape_t = basic_sparse<Options>;
+    using value_adj_view_t = ConstantView<value_t, shape_t>;
+    using ptr_pack_t = util::PtrPack<value_t>;
+
+    using base_t::base_t;
+
+    var_t feval() const { return this->get(); }
+
+    template <class T>
+    void beval(const T&) const {}
+
+    template <class T>
+    constexpr T bind(T begin) const { return begin; }
+
+    template <class T>
+    constexpr T bind_cache(T begin) const { return begin; }
+
+    util::SizePack bind_cache_size() const { return {0,0}; }
+    util::SizePack single_bind_cache_size() const { return {0,0}; }
+};
+
+} // namespace core
+
+/**
+ * Helper function to view a compressed sparse matrix
+ * (Eigen::SparseMatrix or Eigen::Map<Eigen::SparseMatrix>) as a constant.
+ * The shape is ad::sparse or ad::sparse_row depending on the storage order of x.
+ */
+template <class Derived>
+inline auto constant_view(const Eigen::SparseCompressedBase<Derived>& x)
+{
+    using value_t = typename Derived::Scalar;
+    constexpr int options = Derived::IsRowMajor ? Eigen::RowMajor : Eigen::ColMajor;
+    assert(x.isCompressed());
+    return core::ConstantView<value_t, basic_sparse<options>>(
+            x.valuePtr(), x.rows(), x.cols(), x.nonZeros(),
+            x.outerIndexPtr(), x.innerIndexPtr());
+}
+
+// Explicit template instantiation to help compile-time
+template struct VarView<double, sparse>;
+template struct VarView<double, sparse_row>;
+template struct Var<double, sparse>;
+template struct Var<double, sparse_row>;
+
+} // namespace ad
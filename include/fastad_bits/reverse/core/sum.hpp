@@ -1,9 +1,12 @@
 #pragma once
+#include <algorithm>
 #include <iterator>
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/util/numeric.hpp>
 #include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/soa_context.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/value.hpp>
 
@@ -19,20 +22,25 @@ namespace core {
  * and does not depend on other xj values.
  *
  * @tparam  VecType     type of vector of expressions to sum over 
+ * @tparam  AccumType   type to accumulate scalar expressions in (see util::accum_t)
  */
 
-template <class VecType>
+template <class VecType, class AccumType = void>
 struct SumIterNode:
     ValueAdjView<typename util::expr_traits< 
                     typename VecType::value_type >::value_t,
                  typename util::shape_traits< 
                     typename VecType::value_type >::shape_t >,
-    ExprBase<SumIterNode<VecType>>
+    ExprBase<SumIterNode<VecType, AccumType>>
 {
 private:
     using vec_elem_t = typename VecType::value_type;
     using elem_value_t = typename util::expr_traits<vec_elem_t>::value_t;
     using elem_shape_t = typename util::shape_traits<vec_elem_t>::shape_t;
+
+    // scalar expressions that support structure-of-arrays evaluation
+    // are evaluated one node at a time across all expressions
+    static constexpr bool soa_ = util::is_soa_aware_v<vec_elem_t>;
     
 public:
     using value_adj_view_t = ValueAdjView<elem_value_t, elem_shape_t>;
@@ -41,24 +49,52 @@ public:
     using typename value_adj_view_t::var_t;
     using typename value_adj_view_t::ptr_pack_t;
 
+    // in structure-of-arrays layout, the expressions are bound through soa_ctx_
+    // (see memory_report)
+    static constexpr bool binds_subtree = soa_;
+
     SumIterNode(const VecType& exprs)
         : value_adj_view_t(nullptr, nullptr,
                        (exprs.size() == 0) ? 0 : exprs[0].rows(),
                        (exprs.size() == 0) ? 0 : exprs[0].cols())
         , exprs_{exprs}
-    {}
+    {
+        if constexpr (soa_) {
+            if (!exprs_.empty()) soa_ctx_.layout(exprs_[0], exprs_.size());
+        }
+    }
 
     /** 
      * Forward evaluate by evaluating every expression left to right
      * and accumulating the results.
+     * If the expressions support structure-of-arrays evaluation,
+     * every node is evaluated on all expressions at once instead,
+     * and the results are accumulated left to right.
      *
      * @return forward evaluation of sum of functor on every expr.
      */
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         this->zero();
-        for (auto& expr : exprs_) {
-            this->get() += expr.feval();
+        if constexpr (soa_) {
+            if (exprs_.empty()) return this->get();
+            const value_t* a_val = soa_ctx_.feval(exprs_[0]).data();
+            util::accum_t<value_t, AccumType> sum = 0;
+            for (size_t k = 0; k < exprs_.size(); ++k) {
+                sum += a_val[k];
+            }
+            this->get() = sum;
+        } else if constexpr (util::is_scl_v<vec_elem_t>) {
+            util::accum_t<value_t, AccumType> sum = 0;
+            for (auto& expr : exprs_) {
+                sum += expr.feval();
+            }
+            this->get() = sum;
+        } else {
+            for (auto& expr : exprs_) {
+                this->get() += expr.feval();
+            }
         }
         return this->get();
     }
@@ -69,30 +105,53 @@ public:
      * The point is that seed may be an Eigen expression and should be evaluated first.
      * Then we reuse the evaluated values, rather than reusing the expression, 
      * which will lead to multiple evaluations.
+     * If the expressions support structure-of-arrays evaluation,
+     * every node is backward evaluated on all expressions at once.
      *
      * Note: this may break some cases I'm not sure...
      */
     template <class T>
     void beval(const T& seed)
     {
+        FASTAD_PROFILE(beval);
         if (exprs_.empty()) return;
         auto&& a_adj = util::to_array(this->get_adj());
         a_adj = seed;
-        std::for_each(exprs_.rbegin(), exprs_.rend(),
-            [&](auto& expr) {
-                expr.beval(a_adj);
-            });
+        if constexpr (soa_) {
+            soa_ctx_.adj(0).setConstant(this->get_adj());
+            soa_ctx_.template beval<AccumType>(exprs_[0]);
+        } else {
+            std::for_each(exprs_.rbegin(), exprs_.rend(),
+                [&](auto& expr) {
+                    expr.beval(a_adj);
+                });
+        }
     }
 
     /**
      * Bind every expression from left to right then bind itself.
+     * If the expressions support structure-of-arrays evaluation,
+     * the values and adjoints of every node of all expressions are bound instead,
+     * and every expression records the leaves it views.
      *
      * @return  the next pointer not bound by any of the expressions and itself.
      */
     ptr_pack_t bind_cache(ptr_pack_t begin)
     {
-        for (auto& expr : exprs_) {
-            begin = expr.bind_cache(begin);
+        if constexpr (soa_) {
+            const size_t size = exprs_.size() * soa_ctx_.slots();
+            value_t* vals = begin.val;
+            begin.skip({size, 0});
+            soa_ctx_.bind(vals, begin.adj);
+            begin.skip({0, size});
+            for (size_t k = 0; k < exprs_.size(); ++k) {
+                soa_ctx_.bind_lane(exprs_[k], k, begin.leaf_adj, begin.leaves);
+            }
+            soa_ctx_.share();
+        } else {
+            for (auto& expr : exprs_) {
+                begin = expr.bind_cache(begin);
+            }
         }
         return value_adj_view_t::bind(begin);
     }
@@ -100,8 +159,13 @@ public:
     util::SizePack bind_cache_size() const 
     { 
         util::SizePack out = util::SizePack::Zero();
-        for (const auto& expr : exprs_) {
-            out += expr.bind_cache_size();
+        if constexpr (soa_) {
+            const size_t size = exprs_.size() * soa_ctx_.slots();
+            out = {size, size};
+        } else {
+            for (const auto& expr : exprs_) {
+                out += expr.bind_cache_size();
+            }
         }
         return out + single_bind_cache_size();
     }
@@ -111,8 +175,15 @@ public:
         return {this->size(), this->size()}; 
     }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        for (const auto& expr : exprs_) f(expr);
+    }
+
 private:
     std::vector<vec_elem_t> exprs_;
+    util::SoAContext<value_t> soa_ctx_;
 };
 
 /** 
@@ -123,14 +194,15 @@ private:
  * since the partial derivative w.r.t. e_ij is simply e'_ij
  * and does not depend on other e_ij values.
  *
- * @tparam  VecType     type of vector of expressions to sum over 
+ * @tparam  ExprType    type of expression to sum over 
+ * @tparam  AccumType   type to accumulate the elements in (see util::accum_t)
  */
 
-template <class ExprType>
+template <class ExprType, class AccumType = void>
 struct SumElemNode:
     ValueAdjView<typename util::expr_traits<ExprType>::value_t,
                  ad::scl>,
-    ExprBase<SumElemNode<ExprType>>
+    ExprBase<SumElemNode<ExprType, AccumType>>
 {
 private:
     using expr_t = ExprType;
@@ -143,6 +215,8 @@ public:
     using typename value_adj_view_t::var_t;
     using typename value_adj_view_t::ptr_pack_t;
 
+    static constexpr bool fuse_rebuildable = true;
+
     SumElemNode(const expr_t& expr)
         : value_adj_view_t(nullptr, nullptr, 1, 1)
         , expr_{expr}
@@ -155,11 +229,12 @@ public:
      */
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& res = expr_.feval();
         if constexpr (util::is_scl_v<expr_t>) {
             return this->get() = res;
         } else {
-            return this->get() = res.sum();
+            return this->get() = util::accum_sum<AccumType>(res);
         }
     }
 
@@ -169,6 +244,7 @@ public:
      */
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         expr_.beval(seed);
     }
 
@@ -180,11 +256,7 @@ public:
     ptr_pack_t bind_cache(ptr_pack_t begin)
     {
         begin = expr_.bind_cache(begin);
-        auto adj = begin.adj;
-        begin.adj = nullptr;
-        begin = value_adj_view_t::bind(begin);
-        begin.adj = adj;
-        return begin;
+        return value_adj_view_t::bind_value(begin);
     }
 
     util::SizePack bind_cache_size() const 
@@ -198,6 +270,22 @@ public:
         return {this->size(), 0}; 
     }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(expr_);
+    }
+
+    /**
+     * Rebuilds the node with f applied to its children (see ad::fuse).
+     */
+    template <class F>
+    auto fuse_rebuild(F&& f) const
+    {
+        auto expr = f(expr_);
+        return SumElemNode<decltype(expr), AccumType>(expr);
+    }
+
 private:
     expr_t expr_;
 };
@@ -212,8 +300,9 @@ private:
  * If not constant, then SumIterNode is returned that will effectively be a noop.
  * Otherwise, if there is at least one expression to iterate over, 
  * returns a SumIterNode that will not be a noop.
+ * AccumType is the type to accumulate in (see util::accum_t).
  */
-template <class Iter, class Lmda>
+template <class AccumType = void, class Iter, class Lmda>
 inline auto sum(Iter begin, Iter end, Lmda&& f)
 {
     using expr_t = std::decay_t<decltype(f(*begin))>;
@@ -236,11 +325,12 @@ inline auto sum(Iter begin, Iter end, Lmda&& f)
                 [&](const auto& x) {
                     exprs.emplace_back(f(x));
                 });
-        return core::SumIterNode<std::vector<expr_t>>(exprs);
+        return core::SumIterNode<std::vector<expr_t>, AccumType>(exprs);
     }
 }
 
-template <class Derived
+template <class AccumType = void
+        , class Derived
         , class = std::enable_if_t<
             util::is_convertible_to_ad_v<Derived> &&
             util::any_ad_v<Derived> > >
@@ -253,10 +343,10 @@ inline auto sum(const Derived& x)
     if constexpr (util::is_constant_v<expr_t>) {
         if constexpr (util::is_scl_v<expr_t>) return expr;
         else {
-            return ad::constant(expr.feval().array().sum());
+            return ad::constant(util::accum_sum<AccumType>(expr.feval().array()));
         }
     } else {
-        return core::SumElemNode<expr_t>(expr);
+        return core::SumElemNode<expr_t, AccumType>(expr);
     }
 }
 
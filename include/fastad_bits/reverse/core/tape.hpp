@@ -0,0 +1,404 @@
+#pragma once
+#include <cassert>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var_view.hpp>
+
+// Unary function definition with function name "f" that records
+// the functor "functor" of reverse/core/unary.hpp applied on TapeVar<T> variable x.
+// @tparam  T   underlying data type for x
+// @param   x   variable to apply unary function to
+// @return a new TapeVar<T> whose operation is recorded on the tape of x.
+#define TAPE_UNARY_FUNC(f, functor) \
+template <class T> \
+inline auto f(const ad::core::TapeVar<T>& x) \
+{ \
+    return x.tape()->template record_unary<ad::core::functor>(x); \
+} \
+
+// Binary function definition with function name "f" that records
+// the functor "functor" of reverse/core/binary.hpp applied on x and y,
+// where at least one of x, y is a TapeVar<T> and the other may be an arithmetic constant.
+// A constant is not recorded as an operand, so that the operation only has
+// the partial derivative w.r.t. the TapeVar<T> operand.
+// @tparam  T   underlying data type
+// @param   x   one of the variables to apply binary function to
+// @param   y   other variable to apply binary function to
+// @return a new TapeVar<T> whose operation is recorded on the tape of x or y.
+#define TAPE_BINARY_FUNC(f, functor) \
+template <class T> \
+inline auto f(const ad::core::TapeVar<T>& x, \
+              const ad::core::TapeVar<T>& y) \
+{ \
+    assert(x.tape() == y.tape()); \
+    return x.tape()->template record_binary<ad::core::functor>(x, y); \
+} \
+template <class T, class U \
+        , class = std::enable_if_t<std::is_arithmetic_v<U>> > \
+inline auto f(const ad::core::TapeVar<T>& x, U y) \
+{ \
+    return x.tape()->template record_binary<ad::core::functor>( \
+            x, static_cast<T>(y)); \
+} \
+template <class T, class U \
+        , class = std::enable_if_t<std::is_arithmetic_v<U>> > \
+inline auto f(U x, const ad::core::TapeVar<T>& y) \
+{ \
+    return y.tape()->template record_binary<ad::core::functor>( \
+            static_cast<T>(x), y); \
+} \
+
+// Comparison definition with function name "f" that compares
+// the values of x and y only (no operation is recorded).
+// This allows a recorded graph to branch on data.
+#define TAPE_COMPARISON_FUNC(f, op) \
+template <class T> \
+inline bool f(const ad::core::TapeVar<T>& x, \
+              const ad::core::TapeVar<T>& y) \
+{ return x.get_value() op y.get_value(); } \
+template <class T, class U \
+        , class = std::enable_if_t<std::is_arithmetic_v<U>> > \
+inline bool f(const ad::core::TapeVar<T>& x, U y) \
+{ return x.get_value() op y; } \
+template <class T, class U \
+        , class = std::enable_if_t<std::is_arithmetic_v<U>> > \
+inline bool f(U x, const ad::core::TapeVar<T>& y) \
+{ return x op y.get_value(); } \
+
+namespace ad {
+namespace core {
+
+template <class T>
+struct Tape;
+
+/**
+ * TapeVar is a handle to a value recorded on a Tape.
+ * It stores its value, the tape, and the position of its entry on the tape,
+ * so it is cheap to copy and has no compile-time graph type.
+ * Since the value lives in the handle, recording an operation
+ * never reads back from the tape.
+ * Every arithmetic operation on TapeVar objects appends one entry to the tape.
+ *
+ * A default-constructed TapeVar is not on any tape and
+ * may only be assigned to.
+ *
+ * @tparam  T   underlying data type
+ */
+template <class T>
+struct TapeVar
+{
+    using value_t = T;
+
+    TapeVar() =default;
+
+    TapeVar(Tape<T>* tape, size_t index, value_t value)
+        : tape_(tape)
+        , index_(index)
+        , value_(value)
+    {}
+
+    Tape<T>* tape() const { return tape_; }
+    size_t index() const { return index_; }
+
+    value_t get_value() const { return value_; }
+
+    /**
+     * @return  adjoint computed by the last backward sweep of the tape
+     */
+    value_t get_adj() const { return tape_->get_adj(index_); }
+
+    template <class U>
+    TapeVar& operator+=(const U& x) { return *this = *this + x; }
+    template <class U>
+    TapeVar& operator-=(const U& x) { return *this = *this - x; }
+    template <class U>
+    TapeVar& operator*=(const U& x) { return *this = *this * x; }
+    template <class U>
+    TapeVar& operator/=(const U& x) { return *this = *this / x; }
+
+private:
+    Tape<T>* tape_ = nullptr;
+    size_t index_ = 0;
+    value_t value_ = 0;
+};
+
+/**
+ * Tape is a runtime-recorded reverse-mode engine.
+ * As opposed to expression templates, the graph is not a C++ type,
+ * but a flat, contiguous log of operations recorded while TapeVar objects are computed.
+ * This means the topology may depend on data (loop counts, branches)
+ * and the compile time does not grow with the size of the model.
+ *
+ * Every entry of the log stores an opcode (the number of operands),
+ * the positions of at most two operands,
+ * and the partial derivatives w.r.t. those operands.
+ * The partials are computed during recording using the same
+ * bmap/blmap/brmap functors as UnaryNode and BinaryNode,
+ * so the backward sweep is a single loop over the log in reverse order
+ * that only does multiply-adds.
+ *
+ * Leaves are created with var(), either from a value
+ * or from a Var (or VarView) whose adjoint then receives the gradient,
+ * so a tape can be used to differentiate w.r.t. the same variables
+ * as an expression template.
+ *
+ * clear() empties the log but keeps its capacity,
+ * so that recording the same function repeatedly does not allocate.
+ *
+ * @tparam  T   underlying data type
+ */
+template <class T>
+struct Tape
+{
+    using value_t = T;
+    using tape_var_t = TapeVar<T>;
+
+    enum class Op : unsigned char
+    {
+        leaf,
+        unary,
+        binary
+    };
+
+    struct Entry
+    {
+        Entry(Op op, size_t lhs, size_t rhs, value_t dlhs, value_t drhs)
+            : lhs(lhs), rhs(rhs), dlhs(dlhs), drhs(drhs), op(op)
+        {}
+
+        size_t lhs;
+        size_t rhs;
+        value_t dlhs;
+        value_t drhs;
+        Op op;
+    };
+
+    /**
+     * Records a new leaf with value v.
+     */
+    tape_var_t var(value_t v)
+    {
+        return push(v, Op::leaf, 0, 0, 0, 0);
+    }
+
+    /**
+     * Records a new leaf with the value of x.
+     * Every backward sweep adds the adjoint of the leaf to the adjoint of x.
+     * x must outlive the tape recording.
+     */
+    tape_var_t var(VarView<value_t, scl>& x)
+    {
+        auto out = var(x.get());
+        leaves_.emplace_back(out.index(), x.data_adj());
+        return out;
+    }
+
+    /**
+     * Records Unary applied on x.
+     */
+    template <class Unary>
+    tape_var_t record_unary(const tape_var_t& x)
+    {
+        value_t x_val = x.get_value();
+        value_t f = Unary::fmap(x_val);
+        value_t dx = Unary::bmap(value_t(1), x_val, f);
+        return push(f, Op::unary, x.index(), 0, dx, 0);
+    }
+
+    /**
+     * Records Binary applied on x and y.
+     */
+    template <class Binary>
+    tape_var_t record_binary(const tape_var_t& x, const tape_var_t& y)
+    {
+        value_t x_val = x.get_value();
+        value_t y_val = y.get_value();
+        value_t f = Binary::fmap(x_val, y_val);
+        value_t dx = Binary::blmap(value_t(1), x_val, y_val, f);
+        value_t dy = Binary::brmap(value_t(1), x_val, y_val, f);
+        return push(f, Op::binary, x.index(), y.index(), dx, dy);
+    }
+
+    /**
+     * Records Binary applied on x and a constant y.
+     */
+    template <class Binary>
+    tape_var_t record_binary(const tape_var_t& x, value_t y)
+    {
+        value_t x_val = x.get_value();
+        value_t f = Binary::fmap(x_val, y);
+        value_t dx = Binary::blmap(value_t(1), x_val, y, f);
+        return push(f, Op::unary, x.index(), 0, dx, 0);
+    }
+
+    /**
+     * Records Binary applied on a constant x and y.
+     */
+    template <class Binary>
+    tape_var_t record_binary(value_t x, const tape_var_t& y)
+    {
+        value_t y_val = y.get_value();
+        value_t f = Binary::fmap(x, y_val);
+        value_t dy = Binary::brmap(value_t(1), x, y_val, f);
+        return push(f, Op::unary, y.index(), 0, dy, 0);
+    }
+
+    /**
+     * Backward sweep from y with the given seed.
+     * All adjoints on the tape are first reset,
+     * then propagated in a single reverse pass over the log.
+     * Finally, the adjoints of the leaves created from Var objects
+     * are added to the adjoints of those variables.
+     *
+     * @param   y       recorded variable to differentiate
+     * @param   seed    initial adjoint of y
+     */
+    void backward(const tape_var_t& y, value_t seed = 1)
+    {
+        assert(y.tape() == this);
+        assert(y.index() < size());
+
+        adj_.assign(size(), 0);
+        adj_[y.index()] = seed;
+
+        const Entry* entries = entries_.data();
+        value_t* adj = adj_.data();
+        for (size_t i = y.index() + 1; i-- > 0;) {
+            const Entry& e = entries[i];
+            const value_t a = adj[i];
+            switch (e.op) {
+                case Op::binary:
+                    adj[e.rhs] += e.drhs * a;
+                    [[fallthrough]];
+                case Op::unary:
+                    adj[e.lhs] += e.dlhs * a;
+                    break;
+                case Op::leaf:
+                    break;
+            }
+        }
+
+        for (const auto& leaf : leaves_) {
+            *leaf.second += adj[leaf.first];
+        }
+    }
+
+    /**
+     * Clears the log while keeping its capacity.
+     * All TapeVar objects recorded so far are invalidated.
+     */
+    void clear()
+    {
+        adj_.clear();
+        entries_.clear();
+        leaves_.clear();
+    }
+
+    /**
+     * Reserves memory for n entries.
+     */
+    void reserve(size_t n)
+    {
+        adj_.reserve(n);
+        entries_.reserve(n);
+    }
+
+    size_t size() const { return entries_.size(); }
+    value_t get_adj(size_t i) const { return adj_[i]; }
+
+private:
+    tape_var_t push(value_t v, Op op,
+                    size_t lhs, size_t rhs,
+                    value_t dlhs, value_t drhs)
+    {
+        entries_.emplace_back(op, lhs, rhs, dlhs, drhs);
+        return tape_var_t(this, entries_.size() - 1, v);
+    }
+
+    std::vector<value_t> adj_;
+    std::vector<Entry> entries_;
+    std::vector<std::pair<size_t, value_t*>> leaves_;
+};
+
+} // namespace core
+
+// user-exposed tape aliases
+template <class T>
+using Tape = core::Tape<T>;
+
+template <class T>
+using TapeVar = core::TapeVar<T>;
+
+/**
+ * Backward sweep of the tape of y.
+ * Overload for TapeVar, which is already forward evaluated during recording.
+ *
+ * @return  value of y
+ */
+template <class T>
+inline auto autodiff(const core::TapeVar<T>& y, T seed = 1)
+{
+    y.tape()->backward(y, seed);
+    return y.get_value();
+}
+
+//================================================================================
+
+// Unary functions
+
+// ad::sin(core::TapeVar)
+TAPE_UNARY_FUNC(sin, Sin)
+// ad::cos(core::TapeVar)
+TAPE_UNARY_FUNC(cos, Cos)
+// ad::tan(core::TapeVar)
+TAPE_UNARY_FUNC(tan, Tan)
+// ad::asin(core::TapeVar)
+TAPE_UNARY_FUNC(asin, Arcsin)
+// ad::acos(core::TapeVar)
+TAPE_UNARY_FUNC(acos, Arccos)
+// ad::atan(core::TapeVar)
+TAPE_UNARY_FUNC(atan, Arctan)
+// ad::exp(core::TapeVar)
+TAPE_UNARY_FUNC(exp, Exp)
+// ad::log(core::TapeVar)
+TAPE_UNARY_FUNC(log, Log)
+// ad::sqrt(core::TapeVar)
+TAPE_UNARY_FUNC(sqrt, Sqrt)
+// ad::erf(core::TapeVar)
+TAPE_UNARY_FUNC(erf, Erf)
+
+//================================================================================
+
+// Operators
+
+namespace core {
+
+// Negate tape variable
+TAPE_UNARY_FUNC(operator-, UnaryMinus)
+
+// Add tape variables
+TAPE_BINARY_FUNC(operator+, Add)
+// Subtract tape variables
+TAPE_BINARY_FUNC(operator-, Sub)
+// Multiply tape variables
+TAPE_BINARY_FUNC(operator*, Mul)
+// Divide tape variables
+TAPE_BINARY_FUNC(operator/, Div)
+
+// Compare values of tape variables
+TAPE_COMPARISON_FUNC(operator<, <)
+TAPE_COMPARISON_FUNC(operator<=, <=)
+TAPE_COMPARISON_FUNC(operator>, >)
+TAPE_COMPARISON_FUNC(operator>=, >=)
+TAPE_COMPARISON_FUNC(operator==, ==)
+TAPE_COMPARISON_FUNC(operator!=, !=)
+
+} // namespace core
+} // namespace ad
+
+#undef TAPE_UNARY_FUNC
+#undef TAPE_BINARY_FUNC
+#undef TAPE_COMPARISON_FUNC
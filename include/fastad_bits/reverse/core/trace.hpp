@@ -0,0 +1,124 @@
+#pragma once
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/value.hpp>
+
+namespace ad {
+namespace core {
+
+/**
+ * TraceNode represents the trace of a matrix,
+ * i.e. the sum of its diagonal entries.
+ * No other shapes are permitted for this node.
+ *
+ * The node assumes the same value type as that of the matrix expression.
+ * It is always a scalar shape.
+ *
+ * @tparam  ExprType        type of matrix expression
+ */
+
+template <class ExprType>
+struct TraceNode:
+    ValueAdjView<typename util::expr_traits<ExprType>::value_t,
+                 ad::scl>,
+    ExprBase<TraceNode<ExprType>>
+{
+private:
+    using expr_t = ExprType;
+    using expr_value_t = typename util::expr_traits<expr_t>::value_t;
+
+    static_assert(util::is_mat_v<expr_t>);
+
+public:
+    using value_adj_view_t = ValueAdjView<expr_value_t, ad::scl>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    static constexpr bool fuse_rebuildable = true;
+
+    TraceNode(const expr_t& expr)
+        : value_adj_view_t(nullptr, nullptr, 1, 1)
+        , expr_{expr}
+    {}
+
+    const var_t& feval()
+    {
+        FASTAD_PROFILE(feval);
+        return this->get() = expr_.feval().trace();
+    }
+
+    void beval(value_t seed)
+    {
+        FASTAD_PROFILE(beval);
+        if (seed == 0) return;
+        expr_.beval(seed * mat_t::Identity(expr_.rows(), expr_.cols()).array());
+    }
+
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        begin = expr_.bind_cache(begin);
+        return value_adj_view_t::bind_value(begin);
+    }
+
+    util::SizePack bind_cache_size() const
+    {
+        return expr_.bind_cache_size() +
+                single_bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const
+    {
+        return {this->size(), 0};
+    }
+
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(expr_);
+    }
+
+    /**
+     * Rebuilds the node with f applied to its children (see ad::fuse).
+     */
+    template <class F>
+    auto fuse_rebuild(F&& f) const
+    {
+        auto expr = f(expr_);
+        return TraceNode<decltype(expr)>(expr);
+    }
+
+private:
+    using mat_t = util::constant_var_t<value_t,
+          typename util::shape_traits<expr_t>::shape_t>;
+    expr_t expr_;
+};
+
+} // namespace core
+
+template <class T
+        , class = std::enable_if_t<
+            util::is_convertible_to_ad_v<T> &&
+            util::any_ad_v<T> > >
+inline auto trace(const T& x)
+{
+    using expr_t = util::convert_to_ad_t<T>;
+    using value_t = typename util::expr_traits<expr_t>::value_t;
+    expr_t expr = x;
+
+    // optimization for when expression is constant
+    if constexpr (util::is_constant_v<expr_t>) {
+        static_assert(util::is_mat_v<expr_t>);
+        using var_t = util::constant_var_t<value_t, ad::scl>;
+        var_t out = expr.feval().trace();
+        return ad::constant(out);
+    } else {
+        return core::TraceNode<expr_t>(expr);
+    }
+}
+
+} // namespace ad
@@ -0,0 +1,157 @@
+#pragma once
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/value.hpp>
+
+namespace ad {
+namespace core {
+namespace details {
+
+/*
+ * Returns the transposed shape of a matrix shape.
+ * The transpose of a fixed-size shape is fixed-size (see ad::fixed_mat).
+ */
+template <class T>
+struct transpose_shape
+{
+    using type = ad::mat;
+};
+
+template <size_t R, size_t C>
+struct transpose_shape<ad::fixed_mat<R, C>>
+{
+    using type = ad::fixed_mat<C, R>;
+};
+
+template <class T>
+using transpose_shape_t = typename transpose_shape<T>::type;
+
+} // namespace details
+
+/**
+ * TransposeNode represents the transpose of a matrix.
+ * Currently, we do not support the feature for vectors,
+ * since row vectors are not supported.
+ * No other shapes are permitted for this node.
+ *
+ * Backward evaluation passes the transposed seed to the matrix expression
+ * as an Eigen expression, so that it is never copied.
+ * Hence the node only binds its values and no adjoints.
+ *
+ * The node assumes the same value type as that of the matrix expression.
+ *
+ * @tparam  ExprType        type of matrix expression
+ */
+
+template <class ExprType>
+struct TransposeNode:
+    ValueAdjView<typename util::expr_traits<ExprType>::value_t,
+                 details::transpose_shape_t<
+                    typename util::shape_traits<ExprType>::shape_t>>,
+    ExprBase<TransposeNode<ExprType>>
+{
+private:
+    using expr_t = ExprType;
+    using expr_value_t = typename util::expr_traits<expr_t>::value_t;
+
+    static_assert(util::is_mat_v<expr_t>);
+
+public:
+    using value_adj_view_t = ValueAdjView<expr_value_t,
+          details::transpose_shape_t<
+            typename util::shape_traits<expr_t>::shape_t>>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    static constexpr bool fuse_rebuildable = true;
+
+    TransposeNode(const expr_t& expr)
+        : value_adj_view_t(nullptr, nullptr, expr.cols(), expr.rows())
+        , expr_{expr}
+    {}
+
+    const var_t& feval()
+    {
+        FASTAD_PROFILE(feval);
+        return this->get() = expr_.feval().transpose();
+    }
+
+    template <class T>
+    void beval(const T& seed)
+    {
+        FASTAD_PROFILE(beval);
+        if constexpr (util::is_eigen_v<T>) {
+            expr_.beval(seed.transpose().array());
+        } else {
+            expr_.beval(seed);
+        }
+    }
+
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        begin = expr_.bind_cache(begin);
+        return value_adj_view_t::bind_value(begin);
+    }
+
+    util::SizePack bind_cache_size() const
+    {
+        return expr_.bind_cache_size() +
+                single_bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const
+    {
+        return {this->size(), 0};
+    }
+
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(expr_);
+    }
+
+    /**
+     * Rebuilds the node with f applied to its children (see ad::fuse).
+     */
+    template <class F>
+    auto fuse_rebuild(F&& f) const
+    {
+        auto expr = f(expr_);
+        return TransposeNode<decltype(expr)>(expr);
+    }
+
+private:
+    expr_t expr_;
+};
+
+} // namespace core
+
+template <class T
+        , class = std::enable_if_t<
+            util::is_convertible_to_ad_v<T> &&
+            util::any_ad_v<T> > >
+inline auto transpose(const T& x)
+{
+    using expr_t = util::convert_to_ad_t<T>;
+    using value_t = typename util::expr_traits<expr_t>::value_t;
+    using shape_t = core::details::transpose_shape_t<
+        typename util::shape_traits<expr_t>::shape_t>;
+    expr_t expr = x;
+
+    // optimization for when expression is constant
+    if constexpr (util::is_constant_v<expr_t>) {
+        static_assert(util::is_mat_v<expr_t>);
+        using var_t = util::constant_var_t<value_t, shape_t>;
+        var_t out = expr.feval().transpose();
+        return ad::constant(out);
+    } else {
+        return core::TransposeNode<expr_t>(expr);
+    }
+}
+
+} // namespace ad
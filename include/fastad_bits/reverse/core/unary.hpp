@@ -4,9 +4,13 @@
 #include <fastad_bits/forward/core/forward.hpp>    
 #include <fastad_bits/reverse/core/constant.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/util/cse_registry.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/shape_traits.hpp>
 #include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/fuse.hpp>
+#include <fastad_bits/util/macros.hpp>
+#include <fastad_bits/util/soa_context.hpp>
 #include <fastad_bits/util/value.hpp>
 
 namespace ad {
@@ -49,6 +53,13 @@ public:
     using typename value_adj_view_t::var_t;
     using typename value_adj_view_t::ptr_pack_t;
 
+    static constexpr bool cse_aware = util::is_cse_aware_v<expr_t>;
+    static constexpr bool soa_aware = util::is_scl_v<expr_t> &&
+                                      util::is_soa_aware_v<expr_t>;
+    static constexpr bool fuse_aware = util::is_fuse_aware_v<expr_t>;
+    static constexpr size_t fuse_scalars = util::fuse_scalars<expr_t>();
+    static constexpr bool fuse_rebuildable = true;
+
     UnaryNode(const expr_t& expr)
         : value_adj_view_t(nullptr, nullptr, expr.rows(), expr.cols())
         , expr_(expr)
@@ -62,6 +73,8 @@ public:
      */
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
+        if (cse_alias_) return this->get();
         auto&& a_expr = util::to_array(expr_.feval());
         util::to_array(this->get()) = Unary::fmap(a_expr);
         return this->get();
@@ -81,6 +94,7 @@ public:
     template <class T>
     void beval(const T& seed)
     {
+        FASTAD_PROFILE(beval);
         auto&& a_val = util::to_array(this->get());
         auto&& a_adj = util::to_array(this->get_adj());
         auto&& a_expr = util::to_array(expr_.get());
@@ -90,11 +104,17 @@ public:
 
     /**
      * First binds for underlying expression then binds itself.
+     * If bound with common subexpression elimination and an equal expression
+     * was bound before, views its cache instead and skips forward evaluation.
      * @return  next pointer pack not bound by underlying expression and itself.
      */
     ptr_pack_t bind_cache(ptr_pack_t begin)
     { 
         begin = expr_.bind_cache(begin);
+        cse_alias_ = false;
+        if constexpr (cse_aware) {
+            if (begin.cse && cse_bind(*begin.cse)) return begin;
+        }
         return value_adj_view_t::bind(begin);
     }
 
@@ -115,8 +135,95 @@ public:
         return {this->size(), this->size()};
     }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(expr_);
+    }
+
+    /**
+     * Rebuilds the node with f applied to its children (see ad::fuse).
+     */
+    template <class F>
+    auto fuse_rebuild(F&& f) const
+    {
+        auto expr = f(expr_);
+        return UnaryNode<Unary, decltype(expr)>(expr);
+    }
+
+    bool cse_alias() const { return cse_alias_; }
+
+    /**
+     * Structure-of-arrays evaluation of this node only (see util::SoAContext).
+     */
+    void soa_feval(util::SoAContext<value_t>& ctx, size_t self, const size_t* children) const
+    {
+        auto a_expr = ctx.val(children[0]);
+        auto a_val = ctx.val(self);
+        a_val = Unary::fmap(a_expr);
+    }
+
+    void soa_beval(util::SoAContext<value_t>& ctx, size_t self, const size_t* children) const
+    {
+        auto a_expr = ctx.val(children[0]);
+        auto a_val = ctx.val(self);
+        auto a_adj = ctx.adj(self);
+        auto a_expr_adj = ctx.adj(children[0]);
+        a_expr_adj = Unary::bmap(a_adj, a_expr, a_val);
+    }
+
+    /**
+     * Fused element-wise evaluation (see FusedNode).
+     */
+    ptr_pack_t fuse_bind(ptr_pack_t begin) { return expr_.fuse_bind(begin); }
+
+    auto fuse_make()
+    {
+        return std::tuple<util::fuse_block_t<value_t, shape_t>,
+                          decltype(expr_.fuse_make())>();
+    }
+
+    template <class V>
+    void fuse_feval(size_t begin, size_t n, V& v)
+    {
+        auto& x = std::get<1>(v);
+        expr_.fuse_feval(begin, n, x);
+        std::get<0>(v) = Unary::fmap(util::fuse_view(std::get<0>(x)));
+    }
+
+    template <class V, class S>
+    void fuse_beval(size_t begin, size_t n, const V& v, const S& seed, value_t* acc)
+    {
+        const auto& x = std::get<1>(v);
+        const util::fuse_block_t<value_t, shape_t> x_seed = 
+            Unary::bmap(util::fuse_view(seed), 
+                        util::fuse_view(std::get<0>(x)), 
+                        util::fuse_view(std::get<0>(v)));
+        expr_.fuse_beval(begin, n, x, x_seed, acc);
+    }
+
+    void fuse_flush(const value_t* acc) { expr_.fuse_flush(acc); }
+
 private:
+    /**
+     * Views the cache of an equal expression bound before, if any,
+     * and registers itself otherwise.
+     * Kept out of line so that bind_cache stays small (see FASTAD_NOINLINE).
+     * @return  true if it views the cache of an equal expression.
+     */
+    FASTAD_NOINLINE bool cse_bind(util::CSERegistry& cse)
+    {
+        if (auto* other = cse.find(*this)) {
+            cse_alias_ = true;
+            value_adj_view_t::bind({other->data(), other->data_adj()});
+            return true;
+        }
+        cse.insert(*this);
+        return false;
+    }
+
     expr_t expr_;
+    bool cse_alias_ = false;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -223,7 +330,7 @@ UNARY_STRUCT(Arcsin,
              return asin(x);, 
              static_cast<void>(f); 
              USING_STD_AD_EIGEN(sqrt);
-             return seed / sqrt(1. - x * x););
+             return seed / sqrt(util::literal<T>(1) - x * x););
 
 // Arccos struct (degrees)
 UNARY_STRUCT(Arccos, 
@@ -237,7 +344,7 @@ UNARY_STRUCT(Arctan,
              USING_STD_AD_EIGEN(atan);
              return atan(x);, 
              static_cast<void>(f); 
-             return seed / (1. + x * x););
+             return seed / (util::literal<T>(1) + x * x););
 
 // Exp struct
 UNARY_STRUCT(Exp, 
@@ -258,15 +365,15 @@ UNARY_STRUCT(Sqrt,
              USING_STD_AD_EIGEN(sqrt);
              return sqrt(x);,
              static_cast<void>(x);
-             return 0.5 * seed / f;);
+             return util::literal<U>(0.5) * seed / f;);
 
 // Erf struct
 UNARY_STRUCT(Erf,
              USING_STD_AD_EIGEN(erf);
              return erf(x);,
              static_cast<void>(f); 
-             static constexpr double two_over_sqrt_pi =
-                1.1283791670955126;
+             const auto two_over_sqrt_pi = 
+                util::literal<T>(1.1283791670955126);
              return two_over_sqrt_pi * seed * Exp::fmap(-x * x););
 
 // operator- (IMPORTANT TO DECLARE IN core)
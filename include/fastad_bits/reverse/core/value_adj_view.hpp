@@ -44,10 +44,29 @@ struct ValueAdjView
     value_t& get_adj(size_t i, size_t j) { return adj_view_.get(i,j); }
     const value_t& get_adj(size_t i, size_t j) const { return adj_view_.get(i,j); }
 
+    /**
+     * Binds values then adjoints to the next available pointers.
+     * @return  the next pointer pack not bound by current object.
+     */
     ptr_pack_t bind(ptr_pack_t begin)
     { 
-        begin.val = base_t::bind(begin.val);
-        begin.adj = adj_view_.bind(begin.adj);
+        begin.bind_val(static_cast<base_t&>(*this));
+        begin.bind_adj(adj_view_);
+        return begin;
+    }
+
+    /**
+     * Binds only values to the next available pointers.
+     * Adjoints view nothing.
+     * This is used by nodes that never need to store their adjoints,
+     * such as scalar nodes which take their seed by value.
+     *
+     * @return  the next pointer pack not bound by current object.
+     */
+    ptr_pack_t bind_value(ptr_pack_t begin)
+    {
+        adj_view_.bind(nullptr);
+        begin.bind_val(static_cast<base_t&>(*this));
         return begin;
     }
 
@@ -172,5 +172,84 @@ private:
     var_t val_;
 };
 
+/**
+ * Fixed-size vectors and matrices view their values with fixed-size maps.
+ * The runtime sizes passed at construction must match the compile-time extents.
+ */
+template <class ValueType, size_t N>
+struct ValueView<ValueType, fixed_vec<N>>
+{
+    using value_t = ValueType;
+    using shape_t = fixed_vec<N>;
+    using var_t = util::shape_to_raw_view_t<value_t, shape_t>;
+
+    ValueView(value_t* begin, size_t rows=N, size_t=1)
+        : val_(begin)
+    {
+        assert(rows == N);
+        static_cast<void>(rows);
+    }
+     
+    var_t& get() { return val_; }
+    const var_t& get() const { return val_; }
+    value_t& get(size_t i, size_t) { return val_(i); }
+    const value_t& get(size_t i, size_t) const { return val_(i); }
+
+    value_t* bind(value_t* begin)
+    { 
+        new (&val_) var_t(begin);
+        return begin + this->size(); 
+    }
+
+    constexpr size_t size() const { return N; }
+    constexpr size_t rows() const { return N; }
+    constexpr size_t cols() const { return 1; }
+    value_t* data() { return val_.data(); }
+    const value_t* data() const { return val_.data(); }
+    void zero() { val_.setZero(); }
+    void ones() { val_.setOnes(); }
+
+private:
+    var_t val_;
+};
+
+template <class ValueType, size_t R, size_t C>
+struct ValueView<ValueType, fixed_mat<R, C>>
+{
+    using value_t = ValueType;
+    using shape_t = fixed_mat<R, C>;
+    using var_t = util::shape_to_raw_view_t<value_t, shape_t>;
+
+    ValueView(value_t* begin, size_t rows=R, size_t cols=C)
+        : val_(begin)
+    {
+        assert(rows == R && cols == C);
+        static_cast<void>(rows);
+        static_cast<void>(cols);
+    }
+     
+    var_t& get() { return val_; }
+    const var_t& get() const { return val_; }
+    value_t& get(size_t i, size_t j) { return val_(i,j); }
+    const value_t& get(size_t i, size_t j) const { return val_(i,j); }
+
+    value_t* bind(value_t* begin)
+    { 
+        new (&val_) var_t(begin);
+        return begin + this->size(); 
+    }
+
+    constexpr size_t size() const { return R * C; }
+    constexpr size_t rows() const { return R; }
+    constexpr size_t cols() const { return C; }
+    value_t* data() { return val_.data(); }
+    const value_t* data() const { return val_.data(); }
+    void zero() { val_.setZero(); }
+    void ones() { val_.setOnes(); }
+
+private:
+    var_t val_;
+};
+
 } // namespace core
 } // namespace ad
@@ -8,7 +8,7 @@ namespace ad {
  * Var objects are VarView, since they view themselves.
  * Var objects own the variable value(s) and partial derivative(s), or adjoint(s).
  *
- * ShapeType must be one of scl, vec, or mat.
+ * ShapeType must be one of scl, vec, mat, or their fixed-size versions.
  * All other specializations are disabled (see VarView).
  *
  * @tparam ValueType    underlying data type
@@ -219,8 +219,105 @@ private:
     mat_t adj_;
 };
 
+/**
+ * Fixed-size vector and matrix variables own fixed-size Eigen objects,
+ * so that they do not allocate.
+ */
+template <class ValueType, size_t N>
+struct Var<ValueType, fixed_vec<N>>:
+    VarView<ValueType, fixed_vec<N>>
+{
+private:
+    using base_t = VarView<ValueType, fixed_vec<N>>;
+    using vec_t = Eigen::Matrix<typename base_t::value_t, N, 1>;
+
+public:
+    using typename base_t::value_t;
+    using typename base_t::shape_t;
+    using typename base_t::var_t;
+    using base_t::operator=;
+
+    Var()
+        : base_t(nullptr, nullptr) 
+        , val_(vec_t::Zero())
+        , adj_(vec_t::Zero())
+    { rebind(); }
+
+    Var(const Var& v)
+        : base_t(v)
+        , val_(v.val_)
+        , adj_(v.adj_)
+    { rebind(); }
+
+    Var& operator=(const Var& v)
+    {
+        if (this == &v) return *this;
+        val_ = v.val_;
+        adj_ = v.adj_;
+        rebind();
+        return *this;
+    }
+
+private:
+    void rebind() 
+    {
+        this->bind({val_.data(), adj_.data()});
+    }
+
+    vec_t val_;
+    vec_t adj_;
+};
+
+template <class ValueType, size_t R, size_t C>
+struct Var<ValueType, fixed_mat<R, C>>:
+    VarView<ValueType, fixed_mat<R, C>>
+{
+private:
+    using base_t = VarView<ValueType, fixed_mat<R, C>>;
+    using mat_t = Eigen::Matrix<typename base_t::value_t, R, C>;
+
+public:
+    using typename base_t::value_t;
+    using typename base_t::shape_t;
+    using typename base_t::var_t;
+    using base_t::operator=;
+
+    Var()
+        : base_t(nullptr, nullptr) 
+        , val_(mat_t::Zero())
+        , adj_(mat_t::Zero())
+    { rebind(); }
+
+    Var(const Var& v)
+        : base_t(v)
+        , val_(v.val_)
+        , adj_(v.adj_)
+    { rebind(); }
+
+    Var& operator=(const Var& v)
+    {
+        if (this == &v) return *this;
+        val_ = v.val_;
+        adj_ = v.adj_;
+        rebind();
+        return *this;
+    }
+
+private:
+    void rebind() 
+    {
+        this->bind({val_.data(), adj_.data()});
+    }
+
+    mat_t val_;
+    mat_t adj_;
+};
+
 template struct Var<double, scl>;
 template struct Var<double, vec>;
 template struct Var<double, mat>;
+template struct Var<float, scl>;
+template struct Var<float, vec>;
+template struct Var<float, mat>;
 
 } // namespace ad
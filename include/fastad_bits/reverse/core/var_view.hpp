@@ -1,10 +1,15 @@
 #pragma once
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/util/shape_traits.hpp>
+#include <fastad_bits/util/numeric.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/value.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/util/adjoint_scratch.hpp>
+#include <fastad_bits/util/cse_registry.hpp>
+#include <fastad_bits/util/fuse.hpp>
+#include <fastad_bits/util/leaf_registry.hpp>
 #include <Eigen/Core>
 
 namespace ad {
@@ -41,6 +46,11 @@ struct VarViewBase<VarView<ValueType, ShapeType>>:
     using typename value_adj_view_t::ptr_pack_t;
     using var_view_t = VarView<value_t, shape_t>;
 
+    static constexpr bool cse_aware = true;
+    static constexpr bool soa_aware = std::is_same_v<shape_t, ad::scl>;
+    static constexpr bool fuse_aware = true;
+    static constexpr size_t fuse_scalars = std::is_same_v<shape_t, ad::scl> ? 1 : 0;
+
     VarViewBase(size_t rows, size_t cols) 
         : VarViewBase(nullptr, nullptr, rows, cols) {}
 
@@ -56,7 +66,7 @@ struct VarViewBase<VarView<ValueType, ShapeType>>:
                 util::is_convertible_to_ad_v<Derived>> >
     inline auto operator=(const Derived& x) const
     {
-        using expr_t = util::convert_to_ad_t<Derived>;
+        using expr_t = util::convert_to_ad_as_t<Derived, var_view_t>;
         expr_t expr = x;
         return EqNode<var_view_t, expr_t>(
                 static_cast<const var_view_t&>(*this), expr);
@@ -95,11 +105,92 @@ struct VarViewBase<VarView<ValueType, ShapeType>>:
 
     /**
      * Cache bind size is 0 since it will never get rebound once an expression is constructed.
+     * If the pointer pack provides an adjoint scratch, 
+     * the adjoint is rebound to its scratch buffer (see util::AdjointScratch).
+     * Otherwise, the leaf registers itself if the pointer pack provides a leaf registry.
      */
     template <class T>
-    constexpr T bind_cache(T begin) { return begin; }
+    T bind_cache(T begin) 
+    { 
+        if constexpr (std::is_same_v<typename T::value_t, value_t>) {
+            if (begin.leaf_adj) {
+                value_t* adj = begin.leaf_adj->bind(
+                        this->data(), this->data_adj(), this->size());
+                value_adj_view_t::bind({this->data(), adj});
+            } else if (begin.leaves) {
+                begin.leaves->add(this->data(), this->data_adj(), this->size());
+            }
+        }
+        return begin; 
+    }
     util::SizePack bind_cache_size() const { return {0,0}; }
     util::SizePack single_bind_cache_size() const { return {0,0}; }
+
+    /**
+     * Two variable viewers are equal subexpressions if they view the same values.
+     */
+    size_t cse_hash() const 
+    { 
+        return util::hash_combine(std::hash<const void*>()(this->data()), 
+                                  this->size()); 
+    }
+    bool cse_equal(const VarViewBase& other) const 
+    { 
+        return this->data() == other.data() &&
+                this->rows() == other.rows() &&
+                this->cols() == other.cols();
+    }
+    bool cse_reads(const void* begin, const void* end) const 
+    { 
+        return util::overlaps(begin, end, 
+                              this->data(), this->data() + this->size()); 
+    }
+    constexpr bool cse_alias() const { return false; }
+
+    /**
+     * Fused element-wise evaluation (see FusedNode).
+     * A scalar accumulates its adjoint in acc until fuse_flush.
+     */
+    template <class T>
+    T fuse_bind(T begin) { return bind_cache(begin); }
+
+    auto fuse_make() { return std::tuple<util::fuse_block_t<value_t, shape_t>>(); }
+
+    template <class V>
+    void fuse_feval(size_t begin, size_t n, V& v) const
+    {
+        if constexpr (std::is_same_v<shape_t, ad::scl>) {
+            static_cast<void>(begin);
+            static_cast<void>(n);
+            std::get<0>(v) = *this->data();
+        } else {
+            std::get<0>(v) = Eigen::Map<const Eigen::Array<value_t, Eigen::Dynamic, 1>>(
+                    this->data() + begin, n);
+        }
+    }
+
+    template <class V, class S>
+    void fuse_beval(size_t begin, size_t n, const V&, const S& seed, value_t* acc)
+    {
+        if constexpr (std::is_same_v<shape_t, ad::scl>) {
+            static_cast<void>(begin);
+            static_cast<void>(n);
+            acc[0] += seed;
+        } else {
+            static_cast<void>(acc);
+            Eigen::Map<Eigen::Array<value_t, Eigen::Dynamic, 1>>(
+                    this->data_adj() + begin, n) += seed;
+        }
+    }
+
+    void fuse_flush(const value_t* acc) 
+    { 
+        if constexpr (std::is_same_v<shape_t, ad::scl>) {
+            *this->data_adj() += acc[0];
+        } else {
+            static_cast<void>(acc);
+        }
+    }
 };
 
 } // namespace core
@@ -109,11 +200,11 @@ struct VarViewBase<VarView<ValueType, ShapeType>>:
  * VarView objects are precisely the leaves of the computation tree.
  * VarView objects view the variable value(s) and partial derivative(s), or adjoint(s).
  *
- * ShapeType must be one of scl, vec, or mat.
+ * ShapeType must be one of scl, vec, mat, or their fixed-size versions.
  * All other specializations are disabled.
  *
  * @tparam ValueType    underlying data type
- * @tparam ShapeType    shape of variable (one of scl, vec, mat).
+ * @tparam ShapeType    shape of variable (one of scl, vec, mat, fixed_vec<N>, fixed_mat<R, C>).
  *                      Default is scl.
  */
 
@@ -188,10 +279,58 @@ struct VarView<ValueType, mat>:
     {}
 };
 
+/*
+ * Fixed-size vector and matrix (see ad::fixed_vec and ad::fixed_mat).
+ */
+template <class ValueType, size_t N>
+struct VarView<ValueType, fixed_vec<N>>: 
+    core::VarViewBase<VarView<ValueType, fixed_vec<N>>>
+{
+    using base_t = core::VarViewBase<VarView<ValueType, fixed_vec<N>>>;
+    using typename base_t::value_t;
+    using base_t::operator=;
+
+    VarView(value_t* val,
+            value_t* adj,
+            size_t = N,
+            size_t = 1)
+        : base_t(val, adj, N, 1)
+    {}
+
+    // subviews
+    auto operator()(size_t i) {
+        assert(i < N);
+        return VarView<value_t, scl>(base_t::data() + i, 
+                                     base_t::data_adj() + i);
+    }
+    auto operator[](size_t i) {
+        return operator()(i);
+    }
+};
+
+template <class ValueType, size_t R, size_t C>
+struct VarView<ValueType, fixed_mat<R, C>>: 
+    core::VarViewBase<VarView<ValueType, fixed_mat<R, C>>>
+{
+    using base_t = core::VarViewBase<VarView<ValueType, fixed_mat<R, C>>>;
+    using typename base_t::value_t;
+    using base_t::operator=;
+
+    VarView(value_t* val,
+            value_t* adj,
+            size_t = R,
+            size_t = C)
+        : base_t(val, adj, R, C)
+    {}
+};
+
 // Explicit template instantiation to help compile-time
 template struct VarView<double, scl>;
 template struct VarView<double, vec>;
 template struct VarView<double, mat>;
+template struct VarView<float, scl>;
+template struct VarView<float, vec>;
+template struct VarView<float, mat>;
 
 /*
  * Useful operator overloads
@@ -206,7 +345,7 @@ template struct VarView<double, mat>;
                      const Derived& x)  \
     { \
         using var_view_t = VarView<ValueType, ShapeType>; \
-        using expr_t = util::convert_to_ad_t<Derived>; \
+        using expr_t = util::convert_to_ad_as_t<Derived, var_view_t>; \
         expr_t expr = x; \
         return core::OpEqNode<core::strct, var_view_t, expr_t>(var, expr); \
     } 
@@ -0,0 +1,262 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/util/cse_registry.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/type_name.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+
+namespace ad {
+namespace core {
+
+/**
+ * Visitor protocol:
+ * every node with sub-expressions defines for_each_child (see util::has_children_v).
+ * Placeholders assigned by EqNode and OpEqNode are not children,
+ * since they are not evaluated as part of the expression.
+ */
+namespace details {
+
+// placeholders are exposed by the nodes assigning them (EqNode, OpEqNode)
+template <class T, class = void>
+struct has_placeholder: std::false_type
+{};
+
+template <class T>
+struct has_placeholder<T, std::void_t<
+    decltype(std::declval<const T&>().placeholder())> >:
+    std::true_type
+{};
+
+template <class T, class Visitor>
+inline void visit(const T& node, Visitor& v, size_t depth)
+{
+    v(node, depth);
+    if constexpr (util::has_children_v<T>) {
+        node.for_each_child([&](const auto& child) {
+            visit(child, v, depth + 1);
+        });
+    }
+}
+
+/*
+ * Nodes that bind the caches of their sub-expressions themselves
+ * rather than through the bind_cache of every sub-expression
+ * (FusedNode, SumIterNode in structure-of-arrays layout, CheckpointForEachIterNode)
+ * define a static member binds_subtree that is true.
+ * Their bind_cache_size() is the cache bound by the whole subtree.
+ * Nodes that rebind the root of their sub-expression to other memory (EqNode)
+ * define a static member rebinds_child_root that is true.
+ */
+template <class T, class = void>
+struct binds_subtree: std::false_type
+{};
+
+template <class T>
+struct binds_subtree<T, std::enable_if_t<T::binds_subtree>>: std::true_type
+{};
+
+template <class T, class = void>
+struct rebinds_child_root: std::false_type
+{};
+
+template <class T>
+struct rebinds_child_root<T, std::enable_if_t<T::rebinds_child_root>>: std::true_type
+{};
+
+/*
+ * Walks the nodes of a bound expression along the path taken by bind_cache
+ * and calls v(node, size) with the cache size bound by every node.
+ * A node bound to the cache of an equal expression (see util::CSERegistry),
+ * or whose root was rebound by its parent, binds no cache itself,
+ * but its sub-expressions are still bound.
+ */
+template <class T, class Visitor>
+inline void visit_cache(const T& node, Visitor& v, bool root_bound)
+{
+    if constexpr (binds_subtree<T>::value) {
+        v(node, node.bind_cache_size());
+    } else {
+        if constexpr (util::is_cse_aware_v<T> && util::has_children_v<T>) {
+            root_bound = root_bound && !node.cse_alias();
+        }
+        v(node, root_bound ? node.single_bind_cache_size() :
+                             util::SizePack::Zero());
+        if constexpr (util::has_children_v<T>) {
+            node.for_each_child([&](const auto& child) {
+                visit_cache(child, v, !rebinds_child_root<T>::value);
+            });
+        }
+    }
+}
+
+/*
+ * Returns the bytes of the nodes below node that are not stored inside node itself,
+ * e.g. the expressions held in the vector of a SumIterNode.
+ * A child is stored inside its parent if its address is within the parent object.
+ */
+template <class T>
+inline size_t outer_object_bytes(const T& node)
+{
+    size_t bytes = 0;
+    if constexpr (util::has_children_v<T>) {
+        const char* begin = reinterpret_cast<const char*>(&node);
+        const char* end = begin + sizeof(T);
+        node.for_each_child([&](const auto& child) {
+            const char* p = reinterpret_cast<const char*>(&child);
+            if (p < begin || p >= end) bytes += sizeof(child);
+            bytes += outer_object_bytes(child);
+        });
+    }
+    return bytes;
+}
+
+template <class Derived, class Visitor>
+inline void visit_cache(const ExprBase<Derived>& expr, Visitor&& v)
+{
+    visit_cache(expr.self(), v, true);
+}
+
+template <class ExprType, class Visitor>
+inline void visit_cache(const ExprBind<ExprType>& expr, Visitor&& v)
+{
+    visit_cache(expr.get(), v, true);
+}
+
+} // namespace details
+} // namespace core
+
+/**
+ * Visits every node of expr in pre-order, i.e. a node before its children.
+ * The visitor is called as v(node, depth) with the node as its own type,
+ * so that it can dispatch on the node type at compile-time.
+ * The root has depth 0.
+ */
+template <class Derived, class Visitor>
+inline void visit(const core::ExprBase<Derived>& expr, Visitor&& v)
+{
+    core::details::visit(expr.self(), v, 0);
+}
+
+template <class ExprType, class Visitor>
+inline void visit(const core::ExprBind<ExprType>& expr, Visitor&& v)
+{
+    core::details::visit(expr.get(), v, 0);
+}
+
+/**
+ * Returns the number of nodes of expr, including leaves and constants.
+ */
+template <class ExprType>
+inline size_t node_count(const ExprType& expr)
+{
+    size_t n = 0;
+    ad::visit(expr, [&](const auto&, size_t) { ++n; });
+    return n;
+}
+
+/**
+ * Returns the depth of expr, i.e. the largest number of edges from the root to a leaf.
+ */
+template <class ExprType>
+inline size_t expr_depth(const ExprType& expr)
+{
+    size_t depth = 0;
+    ad::visit(expr, [&](const auto&, size_t d) { depth = std::max(depth, d); });
+    return depth;
+}
+
+/**
+ * Returns the distinct leaves (VarView) of expr as pairs of
+ * the pointer to their values and their size, in the order they are visited.
+ */
+template <class ExprType>
+inline std::vector<std::pair<const void*, size_t>> leaf_set(const ExprType& expr)
+{
+    std::vector<std::pair<const void*, size_t>> out;
+    std::set<std::pair<const void*, size_t>> seen;
+    ad::visit(expr, [&](const auto& node, size_t) {
+        using node_t = std::decay_t<decltype(node)>;
+        if constexpr (util::is_var_view_v<node_t>) {
+            std::pair<const void*, size_t> leaf(node.data(), node.size());
+            if (seen.insert(leaf).second) out.push_back(leaf);
+        }
+    });
+    return out;
+}
+
+/**
+ * Returns the bytes of the node objects of expr,
+ * including the nodes held outside of their parent (e.g. the expressions of a sum),
+ * but not the cache they bind (see cache_bytes_by_type).
+ */
+template <class Derived>
+inline size_t object_bytes(const core::ExprBase<Derived>& expr)
+{
+    return sizeof(Derived) + core::details::outer_object_bytes(expr.self());
+}
+
+template <class ExprType>
+inline size_t object_bytes(const core::ExprBind<ExprType>& expr)
+{
+    return object_bytes(expr.get());
+}
+
+/**
+ * Returns the bytes of cache bound by the nodes of expr summed by node type name
+ * (see util::type_name).
+ * Only the caches actually bound are counted:
+ * the sub-expressions of a fused node or of a structure-of-arrays sum
+ * are counted as the node binding them,
+ * and nodes bound to the cache of an equal expression count nothing.
+ * If expr is bound, the total is the size of its cache.
+ * For a map_sum, only the term bound to its reserved cache is visited.
+ */
+template <class ExprType>
+inline std::map<std::string, size_t> cache_bytes_by_type(const ExprType& expr)
+{
+    std::map<std::string, size_t> out;
+    core::details::visit_cache(expr, [&](const auto& node,
+                                         const util::SizePack& size) {
+        using node_t = std::decay_t<decltype(node)>;
+        using value_t = typename node_t::value_t;
+        out[util::type_name<node_t>()] += size.sum() * sizeof(value_t);
+    });
+    return out;
+}
+
+/**
+ * Prints the number of nodes, depth, number of leaves,
+ * bytes of the node objects (see object_bytes),
+ * and cache bytes by node type of expr to os (see cache_bytes_by_type).
+ * The nodes and leaves of a map_sum are those of its current term.
+ */
+template <class ExprType>
+inline void memory_report(const ExprType& expr, std::ostream& os = std::cout)
+{
+    auto bytes = cache_bytes_by_type(expr);
+    size_t total = 0;
+    for (const auto& entry : bytes) total += entry.second;
+
+    os << "nodes:        " << node_count(expr) << '\n'
+       << "depth:        " << expr_depth(expr) << '\n'
+       << "leaves:       " << leaf_set(expr).size() << '\n'
+       << "object bytes: " << object_bytes(expr) << '\n'
+       << "cache bytes:  " << total << '\n';
+    for (const auto& entry : bytes) {
+        os << "  " << std::left << std::setw(30) << entry.first
+           << std::right << std::setw(12) << entry.second << '\n';
+    }
+}
+
+} // namespace ad
@@ -6,6 +6,7 @@
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/value.hpp>
 #include <fastad_bits/util/numeric.hpp>
+#include <fastad_bits/util/simd.hpp>
 
 namespace ad {
 namespace stat {
@@ -37,11 +38,7 @@ struct BernoulliBase:
     {
         begin = x_.bind_cache(begin);
         begin = p_.bind_cache(begin);
-        auto adj = begin.adj;
-        begin.adj = nullptr;
-        begin = value_adj_view_t::bind(begin);
-        begin.adj = adj;
-        return begin;
+        return value_adj_view_t::bind_value(begin);
     }
 
     util::SizePack bind_cache_size() const 
@@ -56,6 +53,13 @@ struct BernoulliBase:
         return {this->size(), 0}; 
     }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(x_);
+        f(p_);
+    }
+
 protected:
     x_t x_;
     p_t p_;
@@ -125,6 +129,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         x_.feval();
         p_.feval();
 
@@ -133,42 +138,40 @@ public:
         }
 
         // if out of range, clip p to [0,1]
-        if (!within_range()) {
-            if (p_.get() <= 0) {
-                return this->get() = (x_.get() == 0) ? 0 : util::neg_inf<value_t>;
-            } else {
-                return this->get() = (x_.get() == 1) ? 0 : util::neg_inf<value_t>;
-            }
-        }
-
-        if (x_.get() == 0) {
-            return this->get() = log_p_dual_;
-        } else if (x_.get() == 1) {
-            return this->get() = log_p_;
-        } else {
-            return this->get() = util::neg_inf<value_t>;
-        }
+        // every case is selected lane-wise if the values are packs (see ad::simd)
+        const auto& x = x_.get();
+        auto clipped = util::select(p_.get() <= 0,
+                util::select(x == 0, 0, util::neg_inf<value_t>),
+                util::select(x == 1, 0, util::neg_inf<value_t>));
+        auto in_range = util::select(x == 0, log_p_dual_,
+                util::select(x == 1, log_p_, util::neg_inf<value_t>));
+        return this->get() = util::select(within_range(), in_range, clipped);
     }
 
     void beval(value_t seed)
     {
-        if (seed == 0 || !within_range() || (x_.get() != 0 && x_.get() != 1)) return;
-
-        auto adj = (x_.get() == 0) ? -seed / (1-p_.get()) : seed / p_.get();
-        p_.beval(adj);
+        FASTAD_PROFILE(beval);
+        auto skip = (seed == 0) || !within_range() || 
+                    (x_.get() != 0 && x_.get() != 1);
+        if (util::all(skip)) return;
+
+        auto adj = util::select(x_.get() == 0, 
+                                -seed / (1-p_.get()), seed / p_.get());
+        p_.beval(util::select(skip, 0, adj));
     }
 
 private:
     void update_cache() {
-        if (within_range()) {
-            log_p_ = std::log(p_.get());
-            log_p_dual_ = std::log(1-p_.get());
+        if (util::any(within_range())) {
+            using std::log;
+            log_p_ = log(p_.get());
+            log_p_dual_ = log(1-p_.get());
         }
     }
 
-    bool within_range() const {
-        return 0 < p_.get() && 
-                p_.get() < 1;
+    auto within_range() const {
+        return (0 < p_.get()) && 
+                (p_.get() < 1);
     }
 
     value_t log_p_;
@@ -214,6 +217,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         x_.feval();
         p_.feval();
 
@@ -245,6 +249,7 @@ public:
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         if (seed == 0 || !within_range() || !is_x_zero_one_) return;
 
         value_t adj = (x_sum_ - (x_.size() * p_.get())) /
@@ -314,6 +319,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& x = x_.feval().array();
         auto&& p = p_.feval().array();
 
@@ -348,6 +354,7 @@ public:
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         if (seed == 0 || !is_x_zero_one_) return;
 
         auto&& x = x_.get().array();
@@ -390,7 +397,7 @@ inline auto bernoulli_adj_log_pdf(const XType& x,
                                   const PType& p)
 {
     using x_expr_t = util::convert_to_ad_t<XType>;
-    using p_expr_t = util::convert_to_ad_t<PType>;
+    using p_expr_t = util::convert_to_ad_as_t<PType, XType>;
     x_expr_t x_expr = x;
     p_expr_t p_expr = p;
     return stat::BernoulliAdjLogPDFNode<
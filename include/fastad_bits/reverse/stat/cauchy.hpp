@@ -6,6 +6,7 @@
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/value.hpp>
 #include <fastad_bits/util/numeric.hpp>
+#include <fastad_bits/util/simd.hpp>
 
 namespace ad {
 namespace stat {
@@ -45,11 +46,7 @@ struct CauchyBase:
         begin = x_.bind_cache(begin);
         begin = loc_.bind_cache(begin);
         begin = scale_.bind_cache(begin);
-        auto adj = begin.adj;
-        begin.adj = nullptr;
-        begin = value_adj_view_t::bind(begin);
-        begin.adj = adj;
-        return begin;
+        return value_adj_view_t::bind_value(begin);
     }
 
     util::SizePack bind_cache_size() const 
@@ -65,6 +62,14 @@ struct CauchyBase:
         return {this->size(), 0}; 
     }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(x_);
+        f(loc_);
+        f(scale_);
+    }
+
 protected:
     x_t x_;
     loc_t loc_;
@@ -133,22 +138,28 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& x = x_.feval();
         auto&& x0 = loc_.feval();
         auto&& gamma = scale_.feval();
 
-        if (!within_range()) {
+        if (util::all(!within_range())) {
             return this->get() = util::neg_inf<value_t>;
         }
 
+        using std::log;
         auto diff = x-x0;
         inner_term_ = gamma + (diff * diff) / gamma;
-        return this->get() = -std::log(inner_term_);
+        return this->get() = util::select(within_range(), 
+                                          -log(inner_term_), 
+                                          util::neg_inf<value_t>);
     }
 
     void beval(value_t seed)
     {
-        if (seed == 0 || !within_range()) return;
+        FASTAD_PROFILE(beval);
+        auto skip = (seed == 0) || !within_range();
+        if (util::all(skip)) return;
 
         auto&& x = x_.get();
         auto&& x0 = loc_.get();
@@ -159,13 +170,13 @@ public:
         auto x_adj = -x0_adj;
         auto gamma_adj = 1./gamma * (x0_adj * diff - 1);
 
-        scale_.beval(seed * gamma_adj);
-        loc_.beval(seed * x0_adj);
-        x_.beval(seed * x_adj);
+        scale_.beval(util::select(skip, 0, seed * gamma_adj));
+        loc_.beval(util::select(skip, 0, seed * x0_adj));
+        x_.beval(util::select(skip, 0, seed * x_adj));
     }
 
 private:
-    bool within_range() const {
+    auto within_range() const {
         return scale_.get() > 0;
     }
 
@@ -205,6 +216,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& x = x_.feval();
         auto&& x0 = loc_.feval();
         auto&& gamma = scale_.feval();
@@ -219,6 +231,7 @@ public:
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         if (seed == 0 || !within_range()) return;
 
         auto&& x = x_.get().array();
@@ -275,6 +288,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& x = x_.feval().array();
         auto&& x0 = loc_.feval();
         auto&& gamma = scale_.feval().array();
@@ -289,6 +303,7 @@ public:
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         if (seed == 0 || !within_range()) return;
 
         auto&& x = x_.get().array();
@@ -344,6 +359,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& x = x_.feval().array();
         auto&& x0 = loc_.feval().array();
         auto&& gamma = scale_.feval();
@@ -358,6 +374,7 @@ public:
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         if (seed == 0 || !within_range()) return;
 
         auto&& x = x_.get().array();
@@ -414,6 +431,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& x = x_.feval().array();
         auto&& x0 = loc_.feval().array();
         auto&& gamma = scale_.feval().array();
@@ -428,6 +446,7 @@ public:
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         if (seed == 0 || !within_range()) return;
 
         auto&& x = x_.get().array();
@@ -465,8 +484,8 @@ inline auto cauchy_adj_log_pdf(const XType& x,
                                const ScaleType& scale)
 {
     using x_expr_t = util::convert_to_ad_t<XType>;
-    using loc_expr_t = util::convert_to_ad_t<LocType>;
-    using scale_expr_t = util::convert_to_ad_t<ScaleType>;
+    using loc_expr_t = util::convert_to_ad_as_t<LocType, XType, ScaleType>;
+    using scale_expr_t = util::convert_to_ad_as_t<ScaleType, XType, LocType>;
     x_expr_t x_expr = x;
     loc_expr_t loc_expr = loc;
     scale_expr_t scale_expr = scale;
@@ -3,8 +3,10 @@
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/llt.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/numeric.hpp>
+#include <fastad_bits/util/simd.hpp>
 #include <Eigen/Dense>
 
 namespace ad {
@@ -45,11 +47,7 @@ struct NormalBase:
         begin = x_.bind_cache(begin);
         begin = mean_.bind_cache(begin);
         begin = sigma_.bind_cache(begin);
-        auto adj = begin.adj;
-        begin.adj = nullptr;
-        begin = value_adj_view_t::bind(begin);
-        begin.adj = adj;
-        return begin;
+        return value_adj_view_t::bind_value(begin);
     }
 
     util::SizePack bind_cache_size() const 
@@ -65,6 +63,14 @@ struct NormalBase:
         return {this->size(), 0}; 
     }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(x_);
+        f(mean_);
+        f(sigma_);
+    }
+
 protected:
     x_t x_;
     mean_t mean_;
@@ -140,11 +146,12 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& x = x_.feval();
         auto&& m = mean_.feval();
         auto&& s = sigma_.feval();
 
-        if (s <= 0) return this->get() = util::neg_inf<value_t>;
+        if (util::all(s <= 0)) return this->get() = util::neg_inf<value_t>;
 
         if constexpr (!util::is_constant_v<sigma_t>) {
             this->update_cache();
@@ -152,27 +159,32 @@ public:
 
         auto z = (x - m) / s;
         
-        return this->get() = -0.5 * z * z - log_sigma_; 
+        return this->get() = util::select(s <= 0, 
+                                          util::neg_inf<value_t>,
+                                          -0.5 * z * z - log_sigma_); 
     }
 
     void beval(value_t seed)
     {
-        if (seed == 0 || sigma_.get() <= 0) return;
+        FASTAD_PROFILE(beval);
+        auto skip = (seed == 0) || (sigma_.get() <= 0);
+        if (util::all(skip)) return;
 
         value_t inv_s = 1./sigma_.get();
         value_t z = (x_.get() - mean_.get()) * inv_s;
 
         if constexpr (!util::is_constant_v<sigma_t>) {
-            sigma_.beval(seed * (z*z - 1) * inv_s);
+            sigma_.beval(util::select(skip, 0, seed * (z*z - 1) * inv_s));
         }
-        value_t adj = seed * z * inv_s;
+        value_t adj = util::select(skip, 0, seed * z * inv_s);
         mean_.beval(adj);
         x_.beval(-adj);
     }
 
 private:
     void update_cache() {
-        log_sigma_ = std::log(sigma_.get());
+        using std::log;
+        log_sigma_ = log(sigma_.get());
     }
 
     value_t log_sigma_;
@@ -224,6 +236,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& x = x_.feval().array();
         auto&& m = mean_.feval();
         auto&& s = sigma_.feval();
@@ -249,6 +262,7 @@ public:
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         if (seed == 0 || sigma_.get() <= 0) return;
 
         value_t inv_s = 1./sigma_.get();
@@ -337,6 +351,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& x = x_.feval().array();
         auto&& m = mean_.feval().array();
         auto&& s = sigma_.feval();
@@ -355,6 +370,7 @@ public:
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         if (seed == 0 || sigma_.get() <= 0) return;
 
         value_t inv_s = 1./sigma_.get();
@@ -429,6 +445,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& x = x_.feval().array();
         auto&& m = mean_.feval();
         auto&& s = sigma_.feval().array();
@@ -454,6 +471,7 @@ public:
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         if (seed == 0 || !is_pos_def_) return;
 
         auto&& x = x_.get().array();
@@ -531,6 +549,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& x = x_.feval().array();
         auto&& m = mean_.feval().array();
         auto&& s = sigma_.feval().array();
@@ -550,6 +569,7 @@ public:
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         if (seed == 0 || !is_pos_def_) return;
 
         auto&& x = x_.get().array();
@@ -601,52 +621,64 @@ public:
     using base_t::x_;
     using base_t::mean_;
     using base_t::sigma_;
+    using llt_t = LLTFactor<value_t, 
+          typename util::shape_traits<sigma_t>::shape_t>;
 
     NormalAdjLogPDFNode(const x_t& x,
                         const mean_t& mean,
                         const sigma_t& sigma)
+        : NormalAdjLogPDFNode(x, mean, sigma, llt_t(sigma.rows()))
+    {}
+
+    NormalAdjLogPDFNode(const x_t& x,
+                        const mean_t& mean,
+                        const sigma_t& sigma,
+                        const llt_t& llt)
         : base_t(x, mean, sigma)
-        , llt_(sigma.rows())
-        , log_det_{0}
-        , is_pos_def_{false}
-        , inv_(sigma.rows(), sigma.cols())
-        , z_(mean.cols())
+        , llt_(llt)
+        , z_(x.rows())
     {
         // must be square matrix
         assert(sigma_.rows() == sigma_.cols());
         assert(x_.rows() == sigma_.rows());
 
         if constexpr (util::is_constant_v<sigma_t>) {
-            this->update_cache();
+            llt_.compute(sigma_.get());
         }
     }
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& x = x_.feval().array();
         auto&& m = mean_.feval();
         sigma_.feval();
 
         if constexpr (!util::is_constant_v<sigma_t>) {
-            this->update_cache();
+            llt_.compute(sigma_.get());
         }
 
-        if (!is_pos_def_) {
+        if (!llt_.valid()) {
             return this->get() = util::neg_inf<value_t>;
         }
-        
-        z_ = inv_ * (x - m).matrix();
-        value_t sq_term = (x - m).matrix().transpose() * z_;
-        
-        return this->get() = -0.5 * sq_term - log_det_; 
+
+        // z = sigma^{-1} (x - m), solved in-place
+        z_ = (x - m).matrix();
+        llt_.solve(z_);
+        value_t sq_term = (x - m).matrix().dot(z_);
+
+        return this->get() = -0.5 * sq_term - 0.5 * llt_.log_det();
     }
 
     void beval(value_t seed)
     {
-        if (seed == 0 || !is_pos_def_) return;
+        FASTAD_PROFILE(beval);
+        if (seed == 0 || !llt_.valid()) return;
 
+        // the inverse of sigma is solved at most once per factorization
         if constexpr (!util::is_constant_v<sigma_t>) {
-            auto adj = (-0.5 * seed) * (inv_ - z_ * z_.transpose());
+            auto adj = (-0.5 * seed) * 
+                (llt_.inverse() - z_.lazyProduct(z_.transpose()));
             sigma_.beval(adj.array());
         }
 
@@ -654,23 +686,15 @@ public:
         x_.beval((-seed) * z_.array());
     }
 
-private:
-    void update_cache() {
-        llt_.compute(sigma_.get());
-        is_pos_def_ = (llt_.info() == Eigen::Success);
-        if (is_pos_def_) {
-            log_det_ = std::log(llt_.matrixL().determinant());
-            inv_ = llt_.solve(mat_t::Identity(sigma_.rows(), sigma_.cols()));
-        }
-    }
+    /**
+     * Returns the factorization state shared with other nodes, if any (see ad::shared_llt).
+     */
+    const void* shared_state() const { return llt_.shared_state(); }
 
-    using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
+private:
     using vec_t = Eigen::Matrix<value_t, Eigen::Dynamic, 1>;
 
-    Eigen::LLT<mat_t, Eigen::Lower> llt_;
-    value_t log_det_;
-    bool is_pos_def_;
-    mat_t inv_;
+    llt_t llt_;
     vec_t z_;
 };
 
@@ -698,16 +722,22 @@ public:
     using base_t::x_;
     using base_t::mean_;
     using base_t::sigma_;
+    using llt_t = LLTFactor<value_t, 
+          typename util::shape_traits<sigma_t>::shape_t>;
 
     NormalAdjLogPDFNode(const x_t& x,
                         const mean_t& mean,
                         const sigma_t& sigma)
+        : NormalAdjLogPDFNode(x, mean, sigma, llt_t(sigma.rows()))
+    {}
+
+    NormalAdjLogPDFNode(const x_t& x,
+                        const mean_t& mean,
+                        const sigma_t& sigma,
+                        const llt_t& llt)
         : base_t(x, mean, sigma)
-        , llt_(sigma.rows())
-        , log_det_{0}
-        , is_pos_def_{false}
-        , inv_(sigma.rows(), sigma.cols())
-        , z_(mean.cols())
+        , llt_(llt)
+        , z_(x.rows())
     {
         // must be square matrix
         assert(sigma_.rows() == sigma_.cols());
@@ -715,36 +745,42 @@ public:
         assert(x_.rows() == sigma_.rows());
 
         if constexpr (util::is_constant_v<sigma_t>) {
-            this->update_cache();
+            llt_.compute(sigma_.get());
         }
     }
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         auto&& x = x_.feval();
         auto&& m = mean_.feval();
         sigma_.feval();
 
         if constexpr (!util::is_constant_v<sigma_t>) {
-            this->update_cache();
+            llt_.compute(sigma_.get());
         }
 
-        if (!is_pos_def_) {
+        if (!llt_.valid()) {
             return this->get() = util::neg_inf<value_t>;
         }
-        
-        z_ = inv_ * (x - m);
-        value_t sq_term = (x - m).transpose() * z_;
-        
-        return this->get() = -0.5 * sq_term - log_det_; 
+
+        // z = sigma^{-1} (x - m), solved in-place
+        z_ = x - m;
+        llt_.solve(z_);
+        value_t sq_term = (x - m).dot(z_);
+
+        return this->get() = -0.5 * sq_term - 0.5 * llt_.log_det();
     }
 
     void beval(value_t seed)
     {
-        if (seed == 0 || !is_pos_def_) return;
+        FASTAD_PROFILE(beval);
+        if (seed == 0 || !llt_.valid()) return;
 
+        // the inverse of sigma is solved at most once per factorization
         if constexpr (!util::is_constant_v<sigma_t>) {
-            auto adj = (-0.5 * seed) * (inv_ - z_ * z_.transpose());
+            auto adj = (-0.5 * seed) * 
+                (llt_.inverse() - z_.lazyProduct(z_.transpose()));
             sigma_.beval(adj.array());
         }
 
@@ -752,23 +788,15 @@ public:
         x_.beval((-seed) * z_.array());
     }
 
-private:
-    void update_cache() {
-        llt_.compute(sigma_.get());
-        is_pos_def_ = (llt_.info() == Eigen::Success);
-        if (is_pos_def_) {
-            log_det_ = std::log(llt_.matrixL().determinant());
-            inv_ = llt_.solve(mat_t::Identity(sigma_.rows(), sigma_.cols()));
-        }
-    }
+    /**
+     * Returns the factorization state shared with other nodes, if any (see ad::shared_llt).
+     */
+    const void* shared_state() const { return llt_.shared_state(); }
 
-    using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
+private:
     using vec_t = Eigen::Matrix<value_t, Eigen::Dynamic, 1>;
 
-    Eigen::LLT<mat_t, Eigen::Lower> llt_;
-    value_t log_det_;
-    bool is_pos_def_;
-    mat_t inv_;
+    llt_t llt_;
     vec_t z_;
 };
 
@@ -787,8 +815,8 @@ inline auto normal_adj_log_pdf(const XType& x,
                                const SigmaType& sigma)
 {
     using x_expr_t = util::convert_to_ad_t<XType>;
-    using mean_expr_t = util::convert_to_ad_t<MeanType>;
-    using sigma_expr_t = util::convert_to_ad_t<SigmaType>;
+    using mean_expr_t = util::convert_to_ad_as_t<MeanType, XType, SigmaType>;
+    using sigma_expr_t = util::convert_to_ad_as_t<SigmaType, XType, MeanType>;
     x_expr_t x_expr = x;
     mean_expr_t mean_expr = mean;
     sigma_expr_t sigma_expr = sigma;
@@ -796,4 +824,37 @@ inline auto normal_adj_log_pdf(const XType& x,
         x_expr_t, mean_expr_t, sigma_expr_t>(x_expr, mean_expr, sigma_expr);
 }
 
+/*
+ * Creates a normal log-pdf expression node with a matrix sigma
+ * that shares the Cholesky factorization llt with other nodes on sigma (see ad::shared_llt).
+ */
+template <class XType
+        , class MeanType
+        , class SigmaType
+        , class ValueType
+        , class ShapeType
+        , class = std::enable_if_t<
+            util::is_convertible_to_ad_v<XType> &&
+            util::is_convertible_to_ad_v<MeanType> &&
+            util::is_convertible_to_ad_v<SigmaType> &&
+            util::any_ad_v<XType, MeanType, SigmaType> > >
+inline auto normal_adj_log_pdf(const XType& x,
+                               const MeanType& mean,
+                               const SigmaType& sigma,
+                               const LLTFactor<ValueType, ShapeType>& llt)
+{
+    using x_expr_t = util::convert_to_ad_t<XType>;
+    using mean_expr_t = util::convert_to_ad_as_t<MeanType, XType, SigmaType>;
+    using sigma_expr_t = util::convert_to_ad_as_t<SigmaType, XType, MeanType>;
+    using node_t = stat::NormalAdjLogPDFNode<
+        x_expr_t, mean_expr_t, sigma_expr_t>;
+    static_assert(util::is_mat_v<sigma_expr_t>);
+    static_assert(std::is_same_v<typename node_t::llt_t,
+                                 LLTFactor<ValueType, ShapeType>>);
+    x_expr_t x_expr = x;
+    mean_expr_t mean_expr = mean;
+    sigma_expr_t sigma_expr = sigma;
+    return node_t(x_expr, mean_expr, sigma_expr, llt);
+}
+
 } // namespace ad
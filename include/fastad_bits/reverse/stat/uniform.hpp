@@ -5,6 +5,7 @@
 #include <fastad_bits/reverse/core/constant.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/numeric.hpp>
+#include <fastad_bits/util/simd.hpp>
 
 namespace ad {
 namespace stat {
@@ -44,11 +45,7 @@ struct UniformBase:
         begin = x_.bind_cache(begin);
         begin = min_.bind_cache(begin);
         begin = max_.bind_cache(begin);
-        auto adj = begin.adj;
-        begin.adj = nullptr;
-        begin = value_adj_view_t::bind(begin);
-        begin.adj = adj;
-        return begin;
+        return value_adj_view_t::bind_value(begin);
     }
 
     util::SizePack bind_cache_size() const 
@@ -64,6 +61,14 @@ struct UniformBase:
         return {this->size(), 0};
     }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(x_);
+        f(min_);
+        f(max_);
+    }
+
 protected:
     x_t x_;
     min_t min_;
@@ -137,6 +142,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         x_.feval();
         min_.feval();
         max_.feval();
@@ -147,29 +153,34 @@ public:
         }
 
         // if out of range
-        if (!within_range()) {
+        if (util::all(!within_range())) {
             return this->get() = util::neg_inf<value_t>;
         }
 
-        return this->get() = -log_diff_;
+        return this->get() = util::select(within_range(), 
+                                          -log_diff_, 
+                                          util::neg_inf<value_t>);
     }
 
     void beval(value_t seed)
     {
-        if (seed == 0 || !within_range()) return;
-        value_t adj = seed / (max_.get() - min_.get());
+        FASTAD_PROFILE(beval);
+        auto skip = (seed == 0) || !within_range();
+        if (util::all(skip)) return;
+        value_t adj = util::select(skip, 0, seed / (max_.get() - min_.get()));
         max_.beval(-adj);
         min_.beval(adj);
     }
 
 private:
     void update_cache() {
-        log_diff_ = std::log(max_.get() - min_.get());
+        using std::log;
+        log_diff_ = log(max_.get() - min_.get());
     }
 
-    bool within_range() const {
-        return min_.get() < x_.get() && 
-                x_.get() < max_.get();
+    auto within_range() const {
+        return (min_.get() < x_.get()) && 
+                (x_.get() < max_.get());
     }
 
     value_t log_diff_;
@@ -219,6 +230,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         x_.feval();
         min_.feval();
         max_.feval();
@@ -242,6 +254,7 @@ public:
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         if (seed == 0 || !within_range()) return;
         value_t adj = seed * static_cast<value_t>(x_.size()) /
             (max_.get() - min_.get());
@@ -313,6 +326,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         x_.feval();
         min_.feval();
         max_.feval();
@@ -335,6 +349,7 @@ public:
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         if (seed == 0 || !within_range()) return;
 
         auto&& min = min_.get();
@@ -406,6 +421,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         x_.feval();
         min_.feval();
         max_.feval();
@@ -428,6 +444,7 @@ public:
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         if (seed == 0 || !within_range()) return;
 
         auto&& min = min_.get().array();
@@ -496,6 +513,7 @@ public:
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         x_.feval();
         min_.feval();
         max_.feval();
@@ -517,6 +535,7 @@ public:
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         if (seed == 0 || !within_range()) return;
         auto&& min = min_.get().array();
         auto&& max = max_.get().array();
@@ -553,8 +572,8 @@ inline auto uniform_adj_log_pdf(const XType& x,
                                 const MaxType& max)
 {
     using x_expr_t = util::convert_to_ad_t<XType>;
-    using min_expr_t = util::convert_to_ad_t<MinType>;
-    using max_expr_t = util::convert_to_ad_t<MaxType>;
+    using min_expr_t = util::convert_to_ad_as_t<MinType, XType, MaxType>;
+    using max_expr_t = util::convert_to_ad_as_t<MaxType, XType, MinType>;
     x_expr_t x_expr = x;
     min_expr_t min_expr = min;
     max_expr_t max_expr = max;
@@ -3,6 +3,7 @@
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/llt.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/numeric.hpp>
 #include <Eigen/Dense>
@@ -48,11 +49,7 @@ struct WishartBase:
     {
         begin = x_.bind_cache(begin);
         begin = v_.bind_cache(begin);
-        auto adj = begin.adj;
-        begin.adj = nullptr;
-        begin = value_adj_view_t::bind(begin);
-        begin.adj = adj;
-        return begin;
+        return value_adj_view_t::bind_value(begin);
     }
 
     util::SizePack bind_cache_size() const 
@@ -68,6 +65,14 @@ struct WishartBase:
         return {this->size(), 0}; 
     }
 
+    template <class F>
+    void for_each_child(F&& f) const
+    {
+        f(x_);
+        f(v_);
+        f(n_);
+    }
+
 protected:
     x_t x_;
     v_t v_;
@@ -85,6 +90,12 @@ protected:
  *
  * Note: n MUST be a constant.
  *
+ * Both x and V are Cholesky factorized once per forward evaluation.
+ * The trace term tr(V^{-1} x) is computed as the squared norm of L_V^{-1} L_x
+ * by an in-place triangular solve, so no inverse is formed in forward evaluation.
+ * The inverses of x and V that the adjoints require are solved in-place
+ * into preallocated workspaces only in backward evaluation.
+ *
  * The only possible shape combinations are as follows:
  * x -> matrix (or self-adj), 
  * v -> matrix (or self-adj)
@@ -141,97 +152,86 @@ public:
         : base_t(x, v, n)
         , x_llt_(x.rows())
         , v_llt_(v.rows())
-        , log_x_det_(0)
-        , log_v_det_(0)
-        , is_x_pos_def_(false)
-        , is_v_pos_def_(false)
-        , x_inv_(x.rows(), x.cols())
-        , v_inv_(v.rows(), v.cols())
-        , xv_inv_(x.rows(), v.rows())
+        , m_(x.rows(), x.cols())
+        , vxv_(v.rows(), v.cols())
     {
         if constexpr (util::is_constant_v<v_t>) {
-            update_v_cache();
+            v_llt_.compute(v_.get());
         }
         if constexpr (util::is_constant_v<x_t>) {
-            update_x_cache();
+            x_llt_.compute(x_.get());
         }
     }
 
     const var_t& feval()
     {
+        FASTAD_PROFILE(feval);
         x_.feval();
         v_.feval();
         auto&& n = n_.feval();
 
         if constexpr (!util::is_constant_v<v_t>) {
-            update_v_cache();
+            v_llt_.compute(v_.get());
         }
         if constexpr (!util::is_constant_v<x_t>) {
-            update_x_cache();
+            x_llt_.compute(x_.get());
         }
 
         if (!valid()) {
             return this->get() = util::neg_inf<value_t>;
         }
 
+        // tr(V^{-1} x) = ||L_V^{-1} L_x||^2
+        m_ = x_llt_.matrixL();
+        v_llt_.matrixL().solveInPlace(m_);
+        value_t tr = m_.squaredNorm();
+
         value_t p = v_.rows();
-        return this->get() = (n-p-1.) * log_x_det_ 
-                              - 0.5 * xv_inv_.trace()
-                              - n * log_v_det_;
+        return this->get() = (n-p-1.) * 0.5 * x_llt_.log_det()
+                              - 0.5 * tr
+                              - n * 0.5 * v_llt_.log_det();
     }
 
     void beval(value_t seed)
     {
+        FASTAD_PROFILE(beval);
         if (seed == 0 || !valid()) return;
 
         value_t n = n_.get();
         value_t p = v_.rows();
 
-        auto x_adj = (0.5 * seed) * ((n-p-1) * x_inv_ - v_inv_);
-        auto v_adj = (0.5 * seed) * (v_inv_ * xv_inv_ - n * v_inv_);
-        v_.beval(v_adj.array());
-        x_.beval(x_adj.array());
-    }
-
-private:
-    void update_v_cache() {
-        v_llt_.compute(v_.get());
-        is_v_pos_def_ = (v_llt_.info() == Eigen::Success);
-        if (is_v_pos_def_) {
-            log_v_det_ = std::log(v_llt_.matrixL().determinant());
-            v_inv_ = v_llt_.solve(mat_t::Identity(v_.rows(), v_.cols()));
+        // V^{-1} x V^{-1} = (V^{-1} L_x) (V^{-1} L_x)^T
+        if constexpr (!util::is_constant_v<v_t>) {
+            m_ = x_llt_.matrixL();
+            v_llt_.solve(m_);
+            vxv_.noalias() = m_ * m_.transpose();
+            auto v_adj = (0.5 * seed) * (vxv_ - n * v_llt_.inverse());
+            v_.beval(v_adj.array());
         }
-    }
-
-    void update_x_cache() {
-        if (is_v_pos_def_) {
-            x_llt_.compute(x_.get());
-            is_x_pos_def_ = (x_llt_.info() == Eigen::Success);
-            if (is_x_pos_def_) {
-                log_x_det_ = std::log(x_llt_.matrixL().determinant());
-                x_inv_ = x_llt_.solve(mat_t::Identity(x_.rows(), x_.cols()));
-                xv_inv_ = x_.get() * v_inv_;
-            }
+        if constexpr (!util::is_constant_v<x_t>) {
+            auto x_adj = (0.5 * seed) * 
+                ((n-p-1) * x_llt_.inverse() - v_llt_.inverse());
+            x_.beval(x_adj.array());
         }
     }
 
-    bool valid() { 
-        return is_x_pos_def_ && 
-               is_v_pos_def_ && 
+private:
+    bool valid() const { 
+        return x_llt_.valid() && 
+               v_llt_.valid() && 
                (n_.get() + 1 > v_.rows());
     }
 
-    using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
+    // fixed-size if both x and v have the same fixed-size shape
+    using mat_shape_t = util::max_shape_t<
+        typename util::shape_traits<x_t>::shape_t,
+        typename util::shape_traits<v_t>::shape_t>;
+    using mat_t = util::constant_var_t<value_t, mat_shape_t>;
 
-    Eigen::LLT<mat_t, Eigen::Lower> x_llt_;
-    Eigen::LLT<mat_t, Eigen::Lower> v_llt_;
-    value_t log_x_det_;
-    value_t log_v_det_;
-    bool is_x_pos_def_;
-    bool is_v_pos_def_;
-    mat_t x_inv_;
-    mat_t v_inv_;
-    mat_t xv_inv_;
+    LLTFactor<value_t, mat_shape_t> x_llt_;
+    LLTFactor<value_t, mat_shape_t> v_llt_;
+    mat_t m_;
+    mat_t vxv_;
 };
 
 } // namespace stat
@@ -250,7 +250,7 @@ inline auto wishart_adj_log_pdf(const XType& x,
 {
     using x_expr_t = util::convert_to_ad_t<XType>;
     using v_expr_t = util::convert_to_ad_t<VType>;
-    using n_expr_t = util::convert_to_ad_t<NType>;
+    using n_expr_t = util::convert_to_ad_as_t<NType, XType, VType>;
     x_expr_t x_expr = x;
     v_expr_t v_expr = v;
     n_expr_t n_expr = n;
@@ -0,0 +1,139 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+#include <fastad_bits/util/macros.hpp>
+
+namespace ad {
+namespace util {
+
+/**
+ * AdjointScratch redirects the adjoints of leaves (see VarView)
+ * to private scratch buffers.
+ * When an expression is bound with a pointer pack whose leaf_adj points to a scratch,
+ * every leaf rebinds its adjoint to a zero-initialized scratch buffer of the same size,
+ * so that backward evaluation does not write to the shared adjoints.
+ * flush() then adds the scratch buffers to the shared adjoints
+ * in the order the leaves were first bound.
+ *
+ * Leaves viewing the same values share one buffer.
+ * The buffers are never moved once created,
+ * so rebinding an expression to the same scratch reuses them.
+ *
+ * A scratch may itself be redirected to a parent scratch (e.g. a map_sum in a parallel_sum),
+ * in which case its buffers are flushed into the buffers of the parent instead.
+ *
+ * @tparam  ValueType   underlying data type
+ */
+template <class ValueType>
+struct AdjointScratch
+{
+    using value_t = ValueType;
+
+    explicit AdjointScratch(AdjointScratch* parent = nullptr)
+        : parent_{parent}
+    {}
+
+    /**
+     * Returns the scratch buffer for the leaf viewing size values at val
+     * and adjoints at adj, creating it if it does not exist.
+     * If it exists, adj is ignored, since the leaf may already view the buffer.
+     * If the scratch has a parent, the new buffer replaces the buffer of the parent instead.
+     */
+    FASTAD_NOINLINE value_t* bind(const value_t* val, value_t* adj, size_t size)
+    {
+        auto key = std::make_pair(val, size);
+        if (entries_.size() <= max_linear_size) {
+            for (auto& entry : entries_) {
+                if (entry.key == key) return entry.scratch.data();
+            }
+        } else {
+            auto it = index_.find(key);
+            if (it != index_.end()) return entries_[it->second].scratch.data();
+        }
+        if (parent_) adj = parent_->bind(val, adj, size);
+        entries_.push_back({key, adj, std::vector<value_t>(size, value_t(0))});
+        if (entries_.size() > max_linear_size) {
+            // index every entry not indexed yet once the linear search is exceeded
+            for (size_t i = index_.size(); i < entries_.size(); ++i) {
+                index_.emplace(entries_[i].key, i);
+            }
+        }
+        return entries_.back().scratch.data();
+    }
+
+    /**
+     * Adds every scratch buffer to the adjoints it replaces.
+     */
+    void flush() const
+    {
+        for (const auto& entry : entries_) {
+            value_t* adj = entry.adj;
+            const auto& scratch = entry.scratch;
+            for (size_t i = 0; i < scratch.size(); ++i) {
+                adj[i] += scratch[i];
+            }
+        }
+    }
+
+    /**
+     * Adds every scratch buffer scaled by scale to the adjoints it replaces.
+     */
+    void flush(value_t scale) const
+    {
+        for (const auto& entry : entries_) {
+            value_t* adj = entry.adj;
+            const auto& scratch = entry.scratch;
+            for (size_t i = 0; i < scratch.size(); ++i) {
+                adj[i] += scale * scratch[i];
+            }
+        }
+    }
+
+    /**
+     * Zeroes every scratch buffer.
+     */
+    void zero()
+    {
+        for (auto& entry : entries_) {
+            std::fill(entry.scratch.begin(), entry.scratch.end(), value_t(0));
+        }
+    }
+
+    /**
+     * Calls f(val, adj, size) for every scratch buffer from the begin-th one,
+     * where adj are the adjoints it replaces.
+     */
+    template <class F>
+    void for_each(F f, size_t begin = 0) const
+    {
+        for (size_t i = begin; i < entries_.size(); ++i) {
+            const auto& entry = entries_[i];
+            f(entry.key.first, entry.adj, entry.scratch.size());
+        }
+    }
+
+    size_t size() const { return entries_.size(); }
+
+private:
+    using key_t = std::pair<const value_t*, size_t>;
+
+    struct entry_t
+    {
+        key_t key;
+        value_t* adj;
+        std::vector<value_t> scratch;
+    };
+
+    // leaves are looked up linearly until there are more than this many
+    static constexpr size_t max_linear_size = 16;
+
+    AdjointScratch* parent_;
+    std::map<key_t, size_t> index_;
+    std::vector<entry_t> entries_;
+};
+
+} // namespace util
+} // namespace ad
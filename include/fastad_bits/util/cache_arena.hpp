@@ -0,0 +1,154 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace ad {
+namespace util {
+
+/**
+ * CacheArena is a bump (region) allocator for expression caches.
+ * Many small ExprBind objects can carve their value and adjoint regions from
+ * one arena instead of allocating two heap buffers each.
+ * Allocation is a pointer bump in the current block.
+ * When the current block is exhausted, a new block of at least twice the size is added.
+ * Individual allocations are never freed: reset() releases every allocation at once.
+ * After a reset, all blocks are coalesced into a single block so that
+ * a workload of the same size afterwards fits in one contiguous region.
+ *
+ * Objects are not constructed or destroyed by the arena,
+ * so only trivially destructible types should be allocated.
+ * Any expression bound to the arena must not be used after reset() or destruction.
+ */
+
+struct CacheArena
+{
+    static constexpr size_t alignment = alignof(std::max_align_t);
+    static constexpr size_t default_block_size = 4096;
+
+    explicit CacheArena(size_t block_size = default_block_size)
+        : block_size_(std::max<size_t>(block_size, alignment))
+    {}
+
+    CacheArena(const CacheArena&) =delete;
+    CacheArena& operator=(const CacheArena&) =delete;
+    CacheArena(CacheArena&&) =default;
+    CacheArena& operator=(CacheArena&&) =default;
+
+    /**
+     * Allocates uninitialized memory for n objects of type T.
+     * The returned pointer is aligned to alignment.
+     *
+     * @tparam  T   trivially destructible type
+     * @param   n   number of objects
+     * @return  pointer to first object
+     */
+    template <class T>
+    T* allocate(size_t n)
+    {
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "CacheArena only holds trivially destructible types");
+        static_assert(alignof(T) <= alignment,
+                      "CacheArena cannot satisfy alignment of type");
+        return static_cast<T*>(allocate_bytes(n * sizeof(T)));
+    }
+
+    /**
+     * Releases every allocation at once.
+     * If more than one block was needed since construction or the last reset,
+     * the blocks are replaced by a single block of their total size.
+     */
+    void reset()
+    {
+        if (blocks_.size() > 1) {
+            size_t total = capacity();
+            blocks_.clear();
+            add_block(total);
+        }
+        curr_ = 0;
+        offset_ = 0;
+        bytes_in_use_ = 0;
+    }
+
+    /**
+     * Returns the number of bytes currently handed out (including alignment padding).
+     */
+    size_t bytes_in_use() const { return bytes_in_use_; }
+
+    /**
+     * Returns the maximum value bytes_in_use() has reached since construction.
+     */
+    size_t high_water_mark() const { return high_water_mark_; }
+
+    /**
+     * Returns the total number of bytes owned by the arena.
+     */
+    size_t capacity() const
+    {
+        size_t out = 0;
+        for (const auto& block : blocks_) out += block.size;
+        return out;
+    }
+
+    /**
+     * Returns the number of blocks owned by the arena.
+     */
+    size_t n_blocks() const { return blocks_.size(); }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<std::max_align_t[]> data;
+        size_t size;
+    };
+
+    static size_t align_up(size_t n)
+    {
+        return (n + alignment - 1) / alignment * alignment;
+    }
+
+    void add_block(size_t size)
+    {
+        size = align_up(size);
+        blocks_.push_back({
+            std::unique_ptr<std::max_align_t[]>(
+                new std::max_align_t[size / sizeof(std::max_align_t)]),
+            size});
+    }
+
+    void* allocate_bytes(size_t n)
+    {
+        n = align_up(n);
+
+        // find the first block (starting from the current one) that fits
+        while (curr_ < blocks_.size() && offset_ + n > blocks_[curr_].size) {
+            bytes_in_use_ += blocks_[curr_].size - offset_;
+            ++curr_;
+            offset_ = 0;
+        }
+
+        if (curr_ == blocks_.size()) {
+            size_t last_size = blocks_.empty() ? block_size_ / 2 : blocks_.back().size;
+            add_block(std::max(n, 2 * last_size));
+        }
+
+        auto* out = reinterpret_cast<char*>(blocks_[curr_].data.get()) + offset_;
+        offset_ += n;
+        bytes_in_use_ += n;
+        high_water_mark_ = std::max(high_water_mark_, bytes_in_use_);
+        return out;
+    }
+
+    std::vector<Block> blocks_;
+    size_t block_size_;
+    size_t curr_ = 0;
+    size_t offset_ = 0;
+    size_t bytes_in_use_ = 0;
+    size_t high_water_mark_ = 0;
+};
+
+} // namespace util
+} // namespace ad
@@ -0,0 +1,240 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <fastad_bits/util/type_traits.hpp>
+
+namespace ad {
+
+/**
+ * Tag to request common subexpression elimination when binding (see ad::bind).
+ */
+struct cse_t {};
+inline constexpr cse_t cse{};
+
+namespace util {
+
+/**
+ * Combines hash value h with seed (boost::hash_combine).
+ */
+inline size_t hash_combine(size_t seed, size_t h)
+{
+    return seed ^ (h + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+/*
+ * Checks if an expression type supports common subexpression elimination,
+ * i.e. it defines a static member cse_aware that is true.
+ * Leaves of such an expression (expressions without children, see has_children_v)
+ * define the member functions
+ *
+ *  size_t cse_hash() const
+ *  bool cse_equal(const T& other) const
+ *  bool cse_reads(const void* begin, const void* end) const
+ *
+ * where cse_hash and cse_equal identify the leaf,
+ * and cse_reads returns true if the leaf reads any memory in [begin, end).
+ * The hash, equality and reads of any other expression follow from its leaves
+ * (see cse_hash, cse_equal, cse_reads below),
+ * since expressions of the same type have the same structure.
+ * Expressions with children define the member function
+ *
+ *  bool cse_alias() const
+ *
+ * which returns true if the expression was bound to the cache of an equal expression.
+ */
+namespace details {
+
+template <class T, class = void>
+struct is_cse_aware : std::false_type
+{};
+
+template <class T>
+struct is_cse_aware<T, std::enable_if_t<T::cse_aware>> : std::true_type
+{};
+
+} // namespace details
+
+template <class T>
+inline constexpr bool is_cse_aware_v =
+    details::is_cse_aware<std::decay_t<T>>::value;
+
+/**
+ * Combines the hashes of the leaves of expression x in binding order.
+ */
+template <class T>
+inline size_t cse_hash(const T& x)
+{
+    if constexpr (has_children_v<T>) {
+        size_t h = 0;
+        x.for_each_child([&](const auto& child) {
+            h = hash_combine(h, cse_hash(child));
+        });
+        return h;
+    } else {
+        return x.cse_hash();
+    }
+}
+
+/**
+ * Returns true if expressions x and y of the same type have equal leaves.
+ */
+template <class T>
+inline bool cse_equal(const T& x, const T& y)
+{
+    if constexpr (has_children_v<T>) {
+        // children at the same position have the same type
+        bool equal = true;
+        size_t i = 0;
+        x.for_each_child([&](const auto& x_child) {
+            using child_t = std::decay_t<decltype(x_child)>;
+            size_t j = 0;
+            y.for_each_child([&](const auto& y_child) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(y_child)>, child_t>) {
+                    if (j == i) equal = equal && cse_equal(x_child, y_child);
+                }
+                ++j;
+            });
+            ++i;
+        });
+        return equal;
+    } else {
+        return x.cse_equal(y);
+    }
+}
+
+/**
+ * Returns true if any leaf of expression x reads memory in [begin, end).
+ */
+template <class T>
+inline bool cse_reads(const T& x, const void* begin, const void* end)
+{
+    if constexpr (has_children_v<T>) {
+        bool reads = false;
+        x.for_each_child([&](const auto& child) {
+            reads = reads || cse_reads(child, begin, end);
+        });
+        return reads;
+    } else {
+        return x.cse_reads(begin, end);
+    }
+}
+
+/**
+ * CSERegistry keeps track of the expressions bound so far
+ * while binding an expression with common subexpression elimination.
+ *
+ * An expression that is equal to an expression in the registry
+ * (same type, same structure, and same leaves) may view the cache of the latter
+ * instead of binding its own, and skip its forward evaluation,
+ * since the registered expression is always forward-evaluated first.
+ *
+ * Whenever a placeholder is written to (see EqNode, OpEqNode),
+ * all registered expressions that read it are invalidated,
+ * since a later expression reading the placeholder sees a different value.
+ * Registration can be suspended for sub-expressions that are not
+ * forward-evaluated exactly once in binding order (see IfElseNode);
+ * invalidation remains active while suspended.
+ */
+struct CSERegistry
+{
+    /**
+     * Finds a registered expression equal to node.
+     * @return  pointer to the registered expression or nullptr if none exists
+     *          or registration is suspended.
+     */
+    template <class NodeType>
+    NodeType* find(const NodeType& node) const
+    {
+        if (suspended_) return nullptr;
+        auto range = entries_.equal_range(key(node));
+        for (auto it = range.first; it != range.second; ++it) {
+            const entry_t& e = it->second;
+            if (e.type != std::type_index(typeid(NodeType))) continue;
+            auto* other = static_cast<NodeType*>(e.node);
+            if (cse_equal(*other, node)) return other;
+        }
+        return nullptr;
+    }
+
+    /**
+     * Registers node so that later equal expressions may view its cache.
+     * Does nothing if registration is suspended.
+     */
+    template <class NodeType>
+    void insert(NodeType& node)
+    {
+        if (suspended_) return;
+        entries_.emplace(key(node),
+                         entry_t{std::type_index(typeid(NodeType)),
+                                 &node,
+                                 &reads<NodeType>});
+    }
+
+    /**
+     * Removes node from the registry if it was registered.
+     */
+    void erase(const void* node)
+    {
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            if (it->second.node == node) it = entries_.erase(it);
+            else ++it;
+        }
+    }
+
+    /**
+     * Removes every registered expression that reads memory in [begin, end).
+     */
+    void invalidate(const void* begin, const void* end)
+    {
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            const entry_t& e = it->second;
+            if (e.reads(e.node, begin, end)) it = entries_.erase(it);
+            else ++it;
+        }
+    }
+
+    void suspend() { ++suspended_; }
+    void resume() { --suspended_; }
+    size_t size() const { return entries_.size(); }
+
+private:
+    struct entry_t
+    {
+        std::type_index type;
+        void* node;
+        bool (*reads)(const void*, const void*, const void*);
+    };
+
+    template <class NodeType>
+    static size_t key(const NodeType& node)
+    {
+        return hash_combine(std::type_index(typeid(NodeType)).hash_code(),
+                            cse_hash(node));
+    }
+
+    template <class NodeType>
+    static bool reads(const void* node, const void* begin, const void* end)
+    {
+        return cse_reads(*static_cast<const NodeType*>(node), begin, end);
+    }
+
+    std::unordered_multimap<size_t, entry_t> entries_;
+    size_t suspended_ = 0;
+};
+
+/**
+ * Returns true if [begin, end) and [x_begin, x_end) overlap.
+ */
+inline bool overlaps(const void* begin, const void* end,
+                     const void* x_begin, const void* x_end)
+{
+    std::less<const void*> lt;
+    return lt(begin, x_end) && lt(x_begin, end);
+}
+
+} // namespace util
+} // namespace ad
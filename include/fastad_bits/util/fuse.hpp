@@ -0,0 +1,119 @@
+#pragma once
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <fastad_bits/util/shape_traits.hpp>
+#include <Eigen/Core>
+
+namespace ad {
+namespace util {
+
+/*
+ * Checks if an expression type supports fused element-wise evaluation (see FusedNode),
+ * i.e. it defines a static member fuse_aware that is true.
+ * Such an expression defines
+ *
+ *  static constexpr size_t fuse_scalars
+ *  ptr_pack_t fuse_bind(ptr_pack_t begin)
+ *  auto fuse_make()
+ *  void fuse_feval(size_t begin, size_t n, V& v)
+ *  void fuse_beval(size_t begin, size_t n, const V& v, const S& seed, value_t* acc)
+ *  void fuse_flush(const value_t* acc)
+ *
+ * where fuse_scalars is the number of scalar variable leaves (VarView) in the expression,
+ * whose adjoints are accumulated into acc while evaluating and added to the leaves by fuse_flush.
+ * fuse_bind binds the leaves only, since the expression does not cache any values.
+ * fuse_make returns a default std::tuple of the values of every node of a block,
+ * whose first element is the value of the expression (see fuse_block_t),
+ * fuse_feval computes the values of elements [begin, begin + n) into v,
+ * and fuse_beval propagates seed (the adjoint of the block) down to the leaves.
+ * fuse_make is only used to deduce the tuple type so that blocks are never copied.
+ */
+namespace details {
+
+template <class T, class = void>
+struct is_fuse_aware : std::false_type
+{};
+
+template <class T>
+struct is_fuse_aware<T, std::enable_if_t<T::fuse_aware>> : std::true_type
+{};
+
+} // namespace details
+
+template <class T>
+inline constexpr bool is_fuse_aware_v =
+    details::is_fuse_aware<std::decay_t<T>>::value;
+
+/*
+ * Checks if an expression type can be rebuilt with its children transformed,
+ * i.e. it defines a static member fuse_rebuildable that is true.
+ * Such an expression defines
+ *
+ *  template <class F> auto fuse_rebuild(F&& f) const
+ *
+ * which returns the same kind of node built from f applied to each child.
+ * ad::fuse uses it to reach the element-wise subtrees under nodes
+ * that do not support fused evaluation themselves (e.g. sum, dot, if_else).
+ */
+namespace details {
+
+template <class T, class = void>
+struct is_fuse_rebuildable : std::false_type
+{};
+
+template <class T>
+struct is_fuse_rebuildable<T, std::enable_if_t<T::fuse_rebuildable>> : std::true_type
+{};
+
+} // namespace details
+
+template <class T>
+inline constexpr bool is_fuse_rebuildable_v =
+    details::is_fuse_rebuildable<std::decay_t<T>>::value;
+
+/**
+ * Returns the number of scalar variable leaves of T if T supports fused evaluation,
+ * and 0 otherwise.
+ */
+template <class T>
+constexpr size_t fuse_scalars()
+{
+    if constexpr (is_fuse_aware_v<T>) return std::decay_t<T>::fuse_scalars;
+    else return 0;
+}
+
+/**
+ * Number of elements evaluated at a time by fused evaluation.
+ * Blocks live on the stack and stay in L1 cache.
+ */
+inline constexpr size_t fuse_block_size = 128;
+
+/**
+ * Values of a block of an expression of shape ShapeType.
+ * Scalar expressions have the same value for all elements,
+ * and every other shape is treated as a flat array of elements.
+ */
+template <class ValueType, class ShapeType>
+using fuse_block_t = std::conditional_t<
+    std::is_same_v<ShapeType, ad::scl>,
+    ValueType,
+    Eigen::Array<ValueType, Eigen::Dynamic, 1, 0, fuse_block_size, 1> >;
+
+/**
+ * Returns a lightweight view of a block that can be passed by value to the functors.
+ */
+template <class T>
+inline auto fuse_view(const T& x)
+{
+    if constexpr (std::is_arithmetic_v<T>) {
+        return x;
+    } else {
+        using value_t = typename T::Scalar;
+        return Eigen::Map<const Eigen::Array<value_t, Eigen::Dynamic, 1>>(
+                x.data(), x.size());
+    }
+}
+
+} // namespace util
+} // namespace ad
@@ -0,0 +1,170 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <utility>
+#include <vector>
+#include <fastad_bits/util/adjoint_scratch.hpp>
+#include <fastad_bits/util/macros.hpp>
+
+namespace ad {
+namespace util {
+
+/**
+ * LeafRegistry collects the distinct leaves (see VarView) and placeholders (see EqNode)
+ * of an expression while it is bound (see ExprBind).
+ * Every entry is a range of adjoints, identified by the range of values it belongs to.
+ * Overlapping views of the same values (e.g. x and x[0]) are one entry:
+ * a view inside a registered range is ignored,
+ * and a view overlapping registered ranges replaces them with their union,
+ * which takes the place and the kind (leaf or placeholder) of the earliest of them.
+ *
+ * zero() resets all registered adjoints at once.
+ * Adjacent and overlapping ranges are merged first,
+ * so that variables allocated next to each other are reset with a single fill.
+ * gather() copies the adjoints of the leaves (not placeholders)
+ * into one flat buffer in the order the leaves were first bound.
+ *
+ * @tparam  ValueType   underlying data type
+ */
+template <class ValueType>
+struct LeafRegistry
+{
+    using value_t = ValueType;
+
+    /**
+     * Registers size adjoints at adj of the leaf viewing size values at val.
+     * A leaf inside a registered range is ignored.
+     */
+    FASTAD_NOINLINE void add(const value_t* val, value_t* adj, size_t size, bool placeholder = false)
+    {
+        if (!size) return;
+        const value_t* end = val + size;
+
+        // first registered range that may overlap [val, end)
+        auto it = index_.upper_bound(val);
+        if (it != index_.begin()) {
+            auto prev = std::prev(it);
+            const auto& entry = entries_[prev->second];
+            if (entry.val + entry.size > val) it = prev;
+        }
+        if (it == index_.end() || it->first >= end) {
+            index_.emplace(val, entries_.size());
+            entries_.push_back({val, adj, size, placeholder});
+            if (!placeholder) n_leaf_adj_ += size;
+            ++n_entries_;
+            ranges_.clear();
+            return;
+        }
+
+        const auto& first = entries_[it->second];
+        if (first.val <= val && end <= first.val + first.size) return;
+
+        // merge every overlapping range into the earliest registered one
+        size_t target = it->second;
+        const value_t* begin = val;
+        value_t* begin_adj = adj;
+        while (it != index_.end() && it->first < end) {
+            auto& entry = entries_[it->second];
+            target = std::min(target, it->second);
+            if (entry.val < begin) {
+                begin = entry.val;
+                begin_adj = entry.adj;
+            }
+            end = std::max(end, entry.val + entry.size);
+            if (!entry.placeholder) n_leaf_adj_ -= entry.size;
+            entry.size = 0;
+            --n_entries_;
+            it = index_.erase(it);
+        }
+        auto& merged = entries_[target];
+        merged.val = begin;
+        merged.adj = begin_adj;
+        merged.size = end - begin;
+        if (!merged.placeholder) n_leaf_adj_ += merged.size;
+        ++n_entries_;
+        index_.emplace(begin, target);
+        ranges_.clear();
+    }
+
+    /**
+     * Registers the leaves whose adjoints are redirected to scratch (see AdjointScratch),
+     * starting from its begin-th buffer.
+     */
+    void add(const AdjointScratch<value_t>& scratch, size_t begin = 0)
+    {
+        scratch.for_each([&](const value_t* val, value_t* adj, size_t size) {
+            add(val, adj, size);
+        }, begin);
+    }
+
+    /**
+     * Zeroes every registered adjoint.
+     */
+    void zero()
+    {
+        if (ranges_.empty()) merge_ranges();
+        for (const auto& range : ranges_) {
+            std::fill(range.first, range.second, value_t(0));
+        }
+    }
+
+    /**
+     * Copies the adjoints of every leaf to out in registration order.
+     * out must have size() values.
+     */
+    void gather(value_t* out) const
+    {
+        for (const auto& entry : entries_) {
+            if (entry.placeholder) continue;
+            out = std::copy(entry.adj, entry.adj + entry.size, out);
+        }
+    }
+
+    /**
+     * Returns the number of leaf adjoints (placeholders excluded).
+     */
+    size_t size() const { return n_leaf_adj_; }
+
+    /**
+     * Returns the number of registered leaves and placeholders.
+     */
+    size_t n_entries() const { return n_entries_; }
+
+private:
+    void merge_ranges()
+    {
+        for (const auto& entry : entries_) {
+            if (entry.size) ranges_.emplace_back(entry.adj, entry.adj + entry.size);
+        }
+        std::sort(ranges_.begin(), ranges_.end());
+        size_t n = 0;
+        for (const auto& range : ranges_) {
+            if (n && range.first <= ranges_[n-1].second) {
+                ranges_[n-1].second = std::max(ranges_[n-1].second, range.second);
+            } else {
+                ranges_[n++] = range;
+            }
+        }
+        ranges_.resize(n);
+    }
+
+    // entries merged into another one are kept with size 0
+    struct entry_t
+    {
+        const value_t* val;
+        value_t* adj;
+        size_t size;
+        bool placeholder;
+    };
+
+    std::map<const value_t*, size_t> index_;    // begin of values to live entry
+    std::vector<entry_t> entries_;
+    std::vector<std::pair<value_t*, value_t*>> ranges_;
+    size_t n_leaf_adj_ = 0;
+    size_t n_entries_ = 0;
+};
+
+} // namespace util
+} // namespace ad
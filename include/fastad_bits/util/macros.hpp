@@ -0,0 +1,38 @@
+#pragma once
+
+/*
+ * FASTAD_FLATTEN inlines every call made by a function, recursively.
+ * It is meant for functions that bind and evaluate an expression once per index
+ * (see MapSumNode::eval_term), whose speed would otherwise depend on how much inlining budget
+ * the rest of the translation unit leaves for the many small functions involved.
+ * It must only be applied to functions that call node methods,
+ * never user functors, which may be arbitrarily large.
+ *
+ * FASTAD_NOINLINE keeps a function out of line.
+ * It is meant for the cold paths taken while binding
+ * (see AdjointScratch, LeafRegistry, and cse_bind of UnaryNode and BinaryNode),
+ * so that they are not inlined into bind_cache of every node, nor into flattened loops.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define FASTAD_FLATTEN __attribute__((flatten))
+#define FASTAD_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define FASTAD_FLATTEN
+#define FASTAD_NOINLINE __declspec(noinline)
+#else
+#define FASTAD_FLATTEN
+#define FASTAD_NOINLINE
+#endif
+
+/*
+ * FASTAD_PROFILE(phase) times the rest of the enclosing feval or beval of a node
+ * if FASTAD_ENABLE_PROFILING is defined (see util::ProfileScope),
+ * and expands to nothing otherwise.
+ */
+#ifdef FASTAD_ENABLE_PROFILING
+#define FASTAD_PROFILE(phase) \
+    ::ad::util::ProfileScope fastad_profile_scope_( \
+            this->profile_stat(), ::ad::util::ProfilePhase::phase, *this)
+#else
+#define FASTAD_PROFILE(phase)
+#endif
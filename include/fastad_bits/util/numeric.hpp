@@ -1,5 +1,7 @@
 #pragma once
 #include <limits>
+#include <type_traits>
+#include <Eigen/Core>
 
 namespace ad {
 namespace util{
@@ -16,5 +18,48 @@ inline constexpr T neg_inf =
     -std::numeric_limits<T>::infinity() :
     std::numeric_limits<T>::lowest();
 
+/*
+ * Type in which reductions over values of type T are accumulated.
+ * Reduction nodes (SumIterNode, SumElemNode, MapSumNode, ParallelSumIterNode, DotNode, NormNode)
+ * take it as a template parameter, which their helpers expose as an optional first
+ * template argument, e.g. ad::sum<double>(x) for a float expression x
+ * accumulates in double while values and adjoints are still stored as float.
+ * AccumType of void means T itself.
+ */
+template <class T, class AccumType = void>
+using accum_t = std::conditional_t<std::is_void_v<AccumType>, T, AccumType>;
+
+/**
+ * Returns the sum of the elements of x accumulated in accum_t.
+ */
+template <class AccumType = void, class Derived>
+inline auto accum_sum(const Eigen::DenseBase<Derived>& x)
+{
+    using value_t = typename Derived::Scalar;
+    using accum_value_t = accum_t<value_t, AccumType>;
+    if constexpr (std::is_same_v<value_t, accum_value_t>) {
+        return x.sum();
+    } else {
+        return static_cast<value_t>(x.template cast<accum_value_t>().sum());
+    }
+}
+
+/**
+ * Returns the (lazy) matrix product of x and y accumulated in accum_t.
+ */
+template <class AccumType = void, class Derived1, class Derived2>
+inline auto accum_product(const Eigen::MatrixBase<Derived1>& x,
+                          const Eigen::MatrixBase<Derived2>& y)
+{
+    using value_t = typename Derived1::Scalar;
+    using accum_value_t = accum_t<value_t, AccumType>;
+    if constexpr (std::is_same_v<value_t, accum_value_t>) {
+        return x * y;
+    } else {
+        return (x.template cast<accum_value_t>() *
+                y.template cast<accum_value_t>()).template cast<value_t>();
+    }
+}
+
 } // namespace util
 } // namespace ad
@@ -0,0 +1,204 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fastad_bits/util/type_name.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+namespace ad {
+namespace util {
+
+/**
+ * Per-node instrumentation of forward and backward evaluation.
+ *
+ * If FASTAD_ENABLE_PROFILING is defined, every node (see ExprBase) owns a ProfileStat
+ * and wraps its feval and beval with a ProfileScope through FASTAD_PROFILE.
+ * A scope counts the calls and the ticks spent inside (including children).
+ * The first time a node is evaluated, it links itself as a child
+ * of the node being evaluated on the same thread, if any,
+ * which builds the tree printed by ad::profile_report.
+ * Nodes evaluated on worker threads (see ad::parallel_sum) are not linked.
+ *
+ * Otherwise, FASTAD_PROFILE expands to nothing (see util/macros.hpp),
+ * nodes own no statistics, and this header is not included by the nodes.
+ */
+
+enum class ProfilePhase { feval = 0, beval = 1 };
+
+/**
+ * Returns a low-overhead timestamp:
+ * the time-stamp counter (cycles) on x86 and nanoseconds elsewhere.
+ */
+inline uint64_t profile_ticks()
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+struct ProfileCounter
+{
+    uint64_t calls = 0;
+    uint64_t ticks = 0;
+};
+
+/**
+ * Statistics of a single node.
+ * Copies start empty, since a copied node is a different node of a different tree.
+ */
+struct ProfileStat
+{
+    ProfileStat() =default;
+    ProfileStat(const ProfileStat&) {}
+    ProfileStat& operator=(const ProfileStat&) { return *this; }
+
+    const ProfileCounter& counter(ProfilePhase phase) const
+    { return counters[static_cast<int>(phase)]; }
+
+    /**
+     * Returns the ticks spent in phase excluding the children.
+     */
+    uint64_t exclusive_ticks(ProfilePhase phase) const
+    {
+        uint64_t ticks = counter(phase).ticks;
+        for (const auto* child : children) {
+            uint64_t t = child->counter(phase).ticks;
+            ticks = (t < ticks) ? ticks - t : 0;
+        }
+        return ticks;
+    }
+
+    /**
+     * Resets the counters of the node and every child.
+     * The tree is kept.
+     */
+    void reset()
+    {
+        counters[0] = counters[1] = ProfileCounter();
+        for (auto* child : children) child->reset();
+    }
+
+    ProfileCounter counters[2];
+    std::string name;
+    size_t bytes = 0;
+    bool linked = false;
+    std::vector<ProfileStat*> children;
+};
+
+/**
+ * Returns the stack of nodes being evaluated on the current thread.
+ */
+inline std::vector<ProfileStat*>& profile_stack()
+{
+    static thread_local std::vector<ProfileStat*> stack;
+    return stack;
+}
+
+/**
+ * RAII timer of a node evaluation in phase.
+ * On the first evaluation of the node, it records the name and cache bytes of node
+ * (from single_bind_cache_size()) and links it to the enclosing node.
+ */
+struct ProfileScope
+{
+    template <class NodeType>
+    ProfileScope(ProfileStat& stat, ProfilePhase phase, const NodeType& node)
+        : counter_(stat.counters[static_cast<int>(phase)])
+    {
+        auto& stack = profile_stack();
+        if (!stat.linked) {
+            using value_t = typename NodeType::value_t;
+            stat.name = type_name<NodeType>();
+            stat.bytes = node.single_bind_cache_size().sum() * sizeof(value_t);
+            stat.linked = true;
+            // a node rebuilt in place (see MapSumNode) links again at the same address
+            if (!stack.empty()) {
+                auto& siblings = stack.back()->children;
+                if (std::find(siblings.begin(), siblings.end(), &stat) == siblings.end()) {
+                    siblings.push_back(&stat);
+                }
+            }
+        }
+        stack.push_back(&stat);
+        start_ = profile_ticks();
+    }
+
+    ~ProfileScope()
+    {
+        counter_.ticks += profile_ticks() - start_;
+        ++counter_.calls;
+        profile_stack().pop_back();
+    }
+
+    ProfileScope(const ProfileScope&) =delete;
+    ProfileScope& operator=(const ProfileScope&) =delete;
+
+private:
+    ProfileCounter& counter_;
+    uint64_t start_;
+};
+
+/**
+ * Calls f with the statistics of node and of every node below it in pre-order.
+ * Nodes are visited as const (see for_each_child), but their statistics are updated.
+ */
+template <class NodeType, class F>
+inline void for_each_profile_stat(const NodeType& node, F&& f)
+{
+    f(const_cast<ProfileStat&>(node.profile_stat()));
+    if constexpr (has_children_v<NodeType>) {
+        node.for_each_child([&](const auto& child) {
+            for_each_profile_stat(child, f);
+        });
+    }
+}
+
+/**
+ * Carries the counters of a tree of nodes over to the tree rebuilt in its place
+ * with the same structure (see MapSumNode), whose statistics start empty.
+ * save() copies the counters in pre-order before the tree is destroyed,
+ * and restore() copies them back into the rebuilt tree.
+ * Links are not carried: the rebuilt nodes link themselves again when evaluated.
+ */
+struct ProfileCarry
+{
+    template <class NodeType>
+    void save(const NodeType& node)
+    {
+        counters_.clear();
+        for_each_profile_stat(node, [&](ProfileStat& stat) {
+            counters_.push_back({stat.counters[0], stat.counters[1]});
+        });
+    }
+
+    template <class NodeType>
+    void restore(const NodeType& node)
+    {
+        size_t k = 0;
+        for_each_profile_stat(node, [&](ProfileStat& stat) {
+            if (k < counters_.size()) {
+                stat.counters[0] = counters_[k][0];
+                stat.counters[1] = counters_[k][1];
+            }
+            ++k;
+        });
+    }
+
+private:
+    std::vector<std::array<ProfileCounter, 2>> counters_;
+};
+
+} // namespace util
+} // namespace ad
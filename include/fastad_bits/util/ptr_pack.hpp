@@ -1,13 +1,36 @@
 #pragma once
+#include <fastad_bits/util/size_pack.hpp>
 
 namespace ad {
 namespace util {
 
+struct CSERegistry;
+template <class ValueType>
+struct AdjointScratch;
+template <class ValueType>
+struct LeafRegistry;
+
 /**
  * Pointer pack to wrap the binding material (see reverse/core).
  * This is just for abstraction purposes to minimize 
  * API changes if more pointers need to be added 
  * to member function "bind" for AD expressions.
+ *
+ * If interleaved is true, val and adj are the same cursor into a single buffer.
+ * A node then binds its values immediately followed by its adjoints,
+ * so that a scalar node stores [val, adj] next to each other.
+ * Nodes should only advance the pointers through the member functions below
+ * so that both layouts are handled.
+ *
+ * If cse is not null, the expression is bound with common subexpression elimination
+ * and cse points to the registry of expressions bound so far (see CSERegistry).
+ * If leaves is not null, leaves and placeholders register their adjoints to it
+ * (see LeafRegistry), except leaves bound to a scratch buffer,
+ * which are registered by the node owning the scratch.
+ * If leaf_adj is not null, leaves bind their adjoints to the scratch buffers
+ * it provides instead of the shared adjoints (see AdjointScratch).
+ * If forward is true, the expression is only forward evaluated:
+ * adjoints of the nodes view nothing and adj is never advanced (see layout::forward).
  */
 
 template <class ValueType>
@@ -16,13 +39,123 @@ struct PtrPack
     using value_t = ValueType;
 
     PtrPack(value_t* v,
-            value_t* a)
-        : val(v), adj(a)
+            value_t* a,
+            bool i = false)
+        : val(v), adj(a), interleaved(i)
     {}
 
+    /**
+     * Binds view to the next values and advances past them.
+     * @param   view    value viewer with member function value_t* bind(value_t*)
+     */
+    template <class ViewType>
+    void bind_val(ViewType& view)
+    {
+        val = view.bind(val);
+        if (interleaved) adj = val;
+    }
+
+    /**
+     * Binds view to the next adjoints and advances past them.
+     * @param   view    value viewer with member function value_t* bind(value_t*)
+     */
+    template <class ViewType>
+    void bind_adj(ViewType& view)
+    {
+        if (forward) {
+            view.bind(nullptr);
+            return;
+        }
+        adj = view.bind(adj);
+        if (interleaved) val = adj;
+    }
+
+    /**
+     * Gives back the last size(0) values and size(1) adjoints that were bound.
+     * @param   size    number of values and adjoints to give back
+     */
+    void release(const SizePack& size)
+    {
+        if (interleaved) {
+            val -= size(0) + size(1);
+            adj = val;
+        } else {
+            val -= size(0);
+            if (!forward) adj -= size(1);
+        }
+    }
+
+    /**
+     * Skips the next size(0) values and size(1) adjoints without binding them.
+     * @param   size    number of values and adjoints to skip
+     */
+    void skip(const SizePack& size)
+    {
+        if (interleaved) {
+            val += size(0) + size(1);
+            adj = val;
+        } else {
+            val += size(0);
+            if (!forward) adj += size(1);
+        }
+    }
+
     value_t* val;
     value_t* adj;
+    bool interleaved;
+    bool forward = false;
+    CSERegistry* cse = nullptr;
+    AdjointScratch<value_t>* leaf_adj = nullptr;
+    LeafRegistry<value_t>* leaves = nullptr;
 };
 
 } // namespace util
+
+/**
+ * Layout policies for the cache of a bound expression (see ad::bind).
+ * separate stores all values in one buffer and all adjoints in another.
+ * interleaved stores the adjoints of every node right after its values in one buffer.
+ * forward stores only the values, so that the expression can only be forward evaluated.
+ *
+ * cache_size converts the sizes reported by bind_cache_size()
+ * into the sizes of the value and adjoint buffers to allocate.
+ * ptr_pack creates the pointer pack to bind an expression to those buffers.
+ */
+namespace layout {
+
+struct separate
+{
+    static util::SizePack cache_size(const util::SizePack& size)
+    { return size; }
+
+    template <class T>
+    static util::PtrPack<T> ptr_pack(T* val, T* adj)
+    { return {val, adj}; }
+};
+
+struct interleaved
+{
+    static util::SizePack cache_size(const util::SizePack& size)
+    { return {size.sum(), 0}; }
+
+    template <class T>
+    static util::PtrPack<T> ptr_pack(T* val, T*)
+    { return {val, val, true}; }
+};
+
+struct forward
+{
+    static util::SizePack cache_size(const util::SizePack& size)
+    { return {size(0), 0}; }
+
+    template <class T>
+    static util::PtrPack<T> ptr_pack(T* val, T*)
+    {
+        util::PtrPack<T> out(val, nullptr);
+        out.forward = true;
+        return out;
+    }
+};
+
+} // namespace layout
 } // namespace ad
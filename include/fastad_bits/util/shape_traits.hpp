@@ -8,6 +8,40 @@ struct scl { static constexpr size_t dim = 0; };
 struct vec { static constexpr size_t dim = 1; };
 struct mat { static constexpr size_t dim = 2; };
 
+/**
+ * Fixed-size shapes.
+ * fixed_vec<N> is a vec and fixed_mat<R, C> is a mat whose extents are known at compile-time.
+ * Nodes on them view their values with fixed-size Eigen maps,
+ * so that Eigen can unroll the operations on small vectors and matrices.
+ */
+template <size_t N>
+struct fixed_vec: vec
+{
+    static constexpr int rows = N;
+    static constexpr int cols = 1;
+};
+
+template <size_t R, size_t C>
+struct fixed_mat: mat
+{
+    static constexpr int rows = R;
+    static constexpr int cols = C;
+};
+
+/**
+ * Sparse matrix in compressed storage (see Eigen::SparseMatrix).
+ * sparse is column-major (CSC) and sparse_row is row-major (CSR).
+ * Only the stored entries hold values and adjoints.
+ */
+template <int Options>
+struct basic_sparse 
+{ 
+    static constexpr size_t dim = 2; 
+    static constexpr int options = Options;
+};
+using sparse = basic_sparse<Eigen::ColMajor>;
+using sparse_row = basic_sparse<Eigen::RowMajor>;
+
 namespace util {
 
 template <class T>
@@ -42,13 +76,28 @@ inline constexpr bool is_scl_v =
 
 template <class T>
 inline constexpr bool is_vec_v =
-    std::is_same_v<details::get_shape_t<T>,
-                   vec>;
+    std::is_base_of_v<vec, details::get_shape_t<T>>;
 
 template <class T>
 inline constexpr bool is_mat_v =
     std::is_base_of_v<mat, details::get_shape_t<T>>;
 
+namespace details {
+
+template <class T>
+struct is_sparse_shape: std::false_type
+{};
+
+template <int Options>
+struct is_sparse_shape<basic_sparse<Options>>: std::true_type
+{};
+
+} // namespace details
+
+template <class T>
+inline constexpr bool is_sparse_v =
+    details::is_sparse_shape<details::get_shape_t<T>>::value;
+
 /**
  * Defines a mapping from shape tags to corresponding
  * Eigen::Map/scalar viewers.
@@ -56,6 +105,8 @@ inline constexpr bool is_mat_v =
  * scl -> T*
  * vec -> Map<Matrix<T, Dynamic, 1>>
  * mat -> Map<Matrix<T, Dynamic, Dynamic>>
+ * fixed_vec<N> -> Map<Matrix<T, N, 1>>
+ * fixed_mat<R, C> -> Map<Matrix<T, R, C>>
  */
 namespace details {
 
@@ -82,6 +133,20 @@ struct shape_to_raw_view<T, mat>
         Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> >;
 };
 
+template <class T, size_t N>
+struct shape_to_raw_view<T, fixed_vec<N>>
+{
+    using type = Eigen::Map<
+        Eigen::Matrix<T, N, 1> >;
+};
+
+template <class T, size_t R, size_t C>
+struct shape_to_raw_view<T, fixed_mat<R, C>>
+{
+    using type = Eigen::Map<
+        Eigen::Matrix<T, R, C> >;
+};
+
 } // namespace details
 
 template <class T, class ShapeType>
@@ -97,15 +162,22 @@ using shape_to_raw_view_t = typename
  * (FOLLOWING DEPRECATED: selfadjmat is deprecated) 
  * This is so that for cases when one is a mat and the other is selfadjmat, the result is mat,
  * and when both are selfadjmats, then the result is selfadjmat.
+ *
+ * Fixed-size shapes are kept only if both shapes are the same
+ * or the other one is a scalar.
+ * Otherwise the result is the dynamic vec or mat.
  */
 
 template <class T1, class T2>
 using max_shape_t = std::conditional_t<
-    std::is_same_v<T1, mat> ||
-    std::is_same_v<T2, mat>,
-    mat,
+    std::is_same_v<T1, T2>,
+    T1,
     std::conditional_t<
-        (T1::dim > T2::dim), T1, T2
+        (T1::dim == 0 || T2::dim == 0),
+        std::conditional_t<(T1::dim > T2::dim), T1, T2>,
+        std::conditional_t<
+            (T1::dim == 2 || T2::dim == 2), mat, vec
+        >
     >
 >;
 
@@ -0,0 +1,312 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/value.hpp>
+
+namespace ad {
+
+/**
+ * simd is a pack of W independent values of type T evaluated in lock step,
+ * e.g. W scenarios of the same model.
+ * It is meant as the value type of scalar variables and expressions:
+ * Var<simd<double, 4>> holds one value per lane,
+ * and every node applies its operation to every lane at once.
+ *
+ * Arithmetic and the math functions used by the unary functors are applied lane-wise.
+ * The loops have a fixed trip count of W, so that the compiler vectorizes them
+ * for the target instruction set (e.g. AVX for simd<double, 4> and -march=native).
+ * Arithmetic values (e.g. literals) are broadcast to every lane.
+ *
+ * Comparisons and logical operators return a pack of 1 (true) or 0 (false) per lane,
+ * which is how comparison nodes store their values.
+ * A pack is not convertible to bool: use util::any, util::all, and util::select,
+ * which also accept plain bools so that scalar code paths can be shared.
+ *
+ * @tparam  T   underlying floating-point type
+ * @tparam  W   number of lanes
+ */
+template <class T, size_t W>
+struct simd
+{
+    static_assert(std::is_floating_point_v<T>);
+    static_assert(W > 0);
+
+    using value_type = T;
+
+    static constexpr size_t size() { return W; }
+
+    constexpr simd() =default;
+
+    template <class U
+            , class = std::enable_if_t<std::is_arithmetic_v<U>> >
+    constexpr simd(U x)
+    {
+        for (size_t i = 0; i < W; ++i) v_[i] = static_cast<T>(x);
+    }
+
+    /**
+     * Returns the pack of the W values starting at p.
+     */
+    static simd load(const T* p)
+    {
+        simd out;
+        for (size_t i = 0; i < W; ++i) out.v_[i] = p[i];
+        return out;
+    }
+
+    /**
+     * Stores the W values of the pack starting at p.
+     */
+    void store(T* p) const
+    {
+        for (size_t i = 0; i < W; ++i) p[i] = v_[i];
+    }
+
+    constexpr T& operator[](size_t i) { return v_[i]; }
+    constexpr const T& operator[](size_t i) const { return v_[i]; }
+
+    simd& operator+=(const simd& x) 
+    { 
+        for (size_t i = 0; i < W; ++i) v_[i] += x.v_[i]; 
+        return *this; 
+    }
+
+    simd& operator-=(const simd& x) 
+    { 
+        for (size_t i = 0; i < W; ++i) v_[i] -= x.v_[i]; 
+        return *this; 
+    }
+
+    simd& operator*=(const simd& x) 
+    { 
+        for (size_t i = 0; i < W; ++i) v_[i] *= x.v_[i]; 
+        return *this; 
+    }
+
+    simd& operator/=(const simd& x) 
+    { 
+        for (size_t i = 0; i < W; ++i) v_[i] /= x.v_[i]; 
+        return *this; 
+    }
+
+private:
+    T v_[W] = {};
+};
+
+namespace util {
+namespace details {
+
+template <class T, size_t W>
+struct literal_type<simd<T, W>>
+{
+    using type = T;
+};
+
+} // namespace details
+
+/**
+ * Returns true if any (resp. every) lane of x is non-zero.
+ * For a bool, returns x.
+ */
+constexpr inline bool any(bool x) { return x; }
+constexpr inline bool all(bool x) { return x; }
+
+template <class T, size_t W>
+constexpr inline bool any(const simd<T, W>& x)
+{
+    bool out = false;
+    for (size_t i = 0; i < W; ++i) out = out || (x[i] != 0);
+    return out;
+}
+
+template <class T, size_t W>
+constexpr inline bool all(const simd<T, W>& x)
+{
+    bool out = true;
+    for (size_t i = 0; i < W; ++i) out = out && (x[i] != 0);
+    return out;
+}
+
+/**
+ * Returns a where cond is true and b elsewhere, lane-wise if cond is a pack.
+ * For a bool cond, this is cond ? a : b, except that both a and b are evaluated.
+ */
+template <class A, class B>
+constexpr inline auto select(bool cond, const A& a, const B& b)
+{
+    using out_t = std::common_type_t<A, B>;
+    return cond ? out_t(a) : out_t(b);
+}
+
+template <class T, size_t W, class A, class B>
+constexpr inline simd<T, W> select(const simd<T, W>& cond, const A& a, const B& b)
+{
+    const simd<T, W> x(a), y(b);
+    simd<T, W> out;
+    for (size_t i = 0; i < W; ++i) out[i] = (cond[i] != 0) ? x[i] : y[i];
+    return out;
+}
+
+} // namespace util
+
+/*
+ * Lane-wise operators.
+ * Every binary operator accepts two packs, or a pack and an arithmetic value,
+ * which is broadcast to every lane.
+ */
+#define FASTAD_SIMD_BINARY_OP(op, expr) \
+template <class T, size_t W> \
+constexpr inline auto operator op(const simd<T, W>& x, const simd<T, W>& y) \
+{ \
+    simd<T, W> out; \
+    for (size_t i = 0; i < W; ++i) out[i] = (expr); \
+    return out; \
+} \
+template <class T, size_t W, class U \
+        , class = std::enable_if_t<std::is_arithmetic_v<U>> > \
+constexpr inline auto operator op(const simd<T, W>& x, U y) \
+{ return x op simd<T, W>(y); } \
+template <class T, size_t W, class U \
+        , class = std::enable_if_t<std::is_arithmetic_v<U>> > \
+constexpr inline auto operator op(U x, const simd<T, W>& y) \
+{ return simd<T, W>(x) op y; }
+
+FASTAD_SIMD_BINARY_OP(+, x[i] + y[i])
+FASTAD_SIMD_BINARY_OP(-, x[i] - y[i])
+FASTAD_SIMD_BINARY_OP(*, x[i] * y[i])
+FASTAD_SIMD_BINARY_OP(/, x[i] / y[i])
+FASTAD_SIMD_BINARY_OP(<, T(x[i] < y[i]))
+FASTAD_SIMD_BINARY_OP(<=, T(x[i] <= y[i]))
+FASTAD_SIMD_BINARY_OP(>, T(x[i] > y[i]))
+FASTAD_SIMD_BINARY_OP(>=, T(x[i] >= y[i]))
+FASTAD_SIMD_BINARY_OP(==, T(x[i] == y[i]))
+FASTAD_SIMD_BINARY_OP(!=, T(x[i] != y[i]))
+FASTAD_SIMD_BINARY_OP(&&, T(x[i] != 0 && y[i] != 0))
+FASTAD_SIMD_BINARY_OP(||, T(x[i] != 0 || y[i] != 0))
+
+#undef FASTAD_SIMD_BINARY_OP
+
+template <class T, size_t W>
+constexpr inline simd<T, W> operator+(const simd<T, W>& x)
+{ return x; }
+
+template <class T, size_t W>
+constexpr inline simd<T, W> operator-(const simd<T, W>& x)
+{
+    simd<T, W> out;
+    for (size_t i = 0; i < W; ++i) out[i] = -x[i];
+    return out;
+}
+
+template <class T, size_t W>
+constexpr inline simd<T, W> operator!(const simd<T, W>& x)
+{
+    simd<T, W> out;
+    for (size_t i = 0; i < W; ++i) out[i] = T(x[i] == 0);
+    return out;
+}
+
+/*
+ * Lane-wise math functions, found by argument-dependent lookup
+ * from the unary functors (see UNARY_STRUCT).
+ */
+#define FASTAD_SIMD_UNARY_FUNC(name) \
+template <class T, size_t W> \
+inline simd<T, W> name(const simd<T, W>& x) \
+{ \
+    using std::name; \
+    simd<T, W> out; \
+    for (size_t i = 0; i < W; ++i) out[i] = name(x[i]); \
+    return out; \
+}
+
+FASTAD_SIMD_UNARY_FUNC(sin)
+FASTAD_SIMD_UNARY_FUNC(cos)
+FASTAD_SIMD_UNARY_FUNC(tan)
+FASTAD_SIMD_UNARY_FUNC(asin)
+FASTAD_SIMD_UNARY_FUNC(acos)
+FASTAD_SIMD_UNARY_FUNC(atan)
+FASTAD_SIMD_UNARY_FUNC(exp)
+FASTAD_SIMD_UNARY_FUNC(log)
+FASTAD_SIMD_UNARY_FUNC(sqrt)
+FASTAD_SIMD_UNARY_FUNC(erf)
+FASTAD_SIMD_UNARY_FUNC(abs)
+
+#undef FASTAD_SIMD_UNARY_FUNC
+
+template <class T, size_t W>
+inline simd<T, W> pow(const simd<T, W>& x, const simd<T, W>& y)
+{
+    using std::pow;
+    simd<T, W> out;
+    for (size_t i = 0; i < W; ++i) out[i] = pow(x[i], y[i]);
+    return out;
+}
+
+template <class T, size_t W, class U
+        , class = std::enable_if_t<std::is_arithmetic_v<U>> >
+inline simd<T, W> pow(const simd<T, W>& x, U y)
+{
+    return pow(x, simd<T, W>(y));
+}
+
+} // namespace ad
+
+namespace std {
+
+template <class T, size_t W>
+struct numeric_limits<ad::simd<T, W>>: numeric_limits<T>
+{
+    using pack_t = ad::simd<T, W>;
+    static constexpr pack_t min() noexcept { return numeric_limits<T>::min(); }
+    static constexpr pack_t max() noexcept { return numeric_limits<T>::max(); }
+    static constexpr pack_t lowest() noexcept { return numeric_limits<T>::lowest(); }
+    static constexpr pack_t epsilon() noexcept { return numeric_limits<T>::epsilon(); }
+    static constexpr pack_t infinity() noexcept { return numeric_limits<T>::infinity(); }
+    static constexpr pack_t quiet_NaN() noexcept { return numeric_limits<T>::quiet_NaN(); }
+};
+
+} // namespace std
+
+namespace Eigen {
+
+// Allows Eigen matrices and arrays of packs,
+// i.e. ad::Var<ad::simd<T, W>, ad::vec> and reverse-mode expressions of such variables.
+// Real is the underlying type so that Eigen's checks on the imaginary part
+// of a scalar compare plain values rather than packs.
+template <class T, size_t W>
+struct NumTraits<ad::simd<T, W>> : NumTraits<T>
+{
+    using Real = T;
+    using NonInteger = ad::simd<T, W>;
+    using Nested = ad::simd<T, W>;
+    using Literal = ad::simd<T, W>;
+
+    enum {
+        IsComplex = 0,
+        IsInteger = 0,
+        IsSigned = 1,
+        RequireInitialization = 0,
+        ReadCost = W * NumTraits<T>::ReadCost,
+        AddCost = W * NumTraits<T>::AddCost,
+        MulCost = W * NumTraits<T>::MulCost
+    };
+};
+
+// Allows mixing packs and their underlying data type in Eigen expressions.
+template <class T, size_t W>
+struct ScalarBinaryOpTraits<ad::simd<T, W>, T>
+{
+    using ReturnType = ad::simd<T, W>;
+};
+
+template <class T, size_t W>
+struct ScalarBinaryOpTraits<T, ad::simd<T, W>>
+{
+    using ReturnType = ad::simd<T, W>;
+};
+
+} // namespace Eigen
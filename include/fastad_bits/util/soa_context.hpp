@@ -0,0 +1,269 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include <Eigen/Core>
+#include <fastad_bits/util/adjoint_scratch.hpp>
+#include <fastad_bits/util/leaf_registry.hpp>
+#include <fastad_bits/util/numeric.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+
+namespace ad {
+namespace util {
+
+/*
+ * Checks if an expression type supports structure-of-arrays evaluation,
+ * i.e. it defines a static member soa_aware that is true.
+ * Such an expression is scalar.
+ * Unless it is a leaf (VarView or Constant), it defines
+ *
+ *  void soa_feval(SoAContext<value_t>& ctx, size_t self, const size_t* children) const
+ *  void soa_beval(SoAContext<value_t>& ctx, size_t self, const size_t* children) const
+ *
+ * where self is the slot of the expression in the context and
+ * children are the slots of its children (see for_each_child).
+ * soa_feval computes the values of self from the values of its children for all lanes,
+ * and soa_beval computes the adjoints of its children
+ * from the adjoint and values of self for all lanes.
+ * Neither recurses into the children: SoAContext traverses the expression.
+ */
+namespace details {
+
+template <class T, class = void>
+struct is_soa_aware : std::false_type
+{};
+
+template <class T>
+struct is_soa_aware<T, std::enable_if_t<T::soa_aware>> : std::true_type
+{};
+
+} // namespace details
+
+template <class T>
+inline constexpr bool is_soa_aware_v =
+    details::is_soa_aware<std::decay_t<T>>::value;
+
+/**
+ * SoAContext evaluates n expressions of the same type together, one node at a time,
+ * in a structure-of-arrays layout (see SumIterNode).
+ * Every node (slot) of the expressions has an array of n values and n adjoints,
+ * one for each expression (lane), so that the functor of a node
+ * is applied to all lanes as a single vectorized operation.
+ * Slots are numbered in pre-order, so that the root is slot 0.
+ * Every variable leaf additionally has an array of n pointers
+ * to the values and adjoints it views in every lane,
+ * and a flag whether it views the same variable in every lane,
+ * in which case its values are broadcast and its adjoints are reduced
+ * rather than gathered and scattered lane by lane.
+ *
+ * @tparam  ValueType   underlying data type
+ */
+template <class ValueType>
+struct SoAContext
+{
+    using value_t = ValueType;
+    using lanes_t = Eigen::Map<Eigen::Array<value_t, Eigen::Dynamic, 1>>;
+
+    /**
+     * Lays out the slots and leaves of n expressions of the same type as expr.
+     */
+    template <class T>
+    void layout(const T& expr, size_t n)
+    {
+        n_ = n;
+        slots_ = 0;
+        leaves_ = 0;
+        children_.clear();
+        layout_(expr);
+        leaf_vals_.resize(n * leaves_);
+        leaf_adjs_.resize(n * leaves_);
+        leaf_shared_.resize(leaves_);
+    }
+
+    size_t slots() const { return slots_; }
+
+    /**
+     * Binds the values and adjoints of every slot,
+     * each of size n * slots().
+     */
+    void bind(value_t* vals, value_t* adjs)
+    {
+        vals_ = vals;
+        adjs_ = adjs;
+    }
+
+    /**
+     * Records the leaves of expr as lane k and writes its constants.
+     * If leaf_adj is not null, the leaf adjoints are redirected to its scratch buffers
+     * (see AdjointScratch).
+     * Otherwise, if leaves is not null, the leaves are registered to it (see LeafRegistry).
+     */
+    template <class T>
+    void bind_lane(const T& expr, size_t k,
+                   AdjointScratch<value_t>* leaf_adj,
+                   LeafRegistry<value_t>* leaves)
+    {
+        size_t slot = 0;
+        size_t leaf = 0;
+        bind_lane_(expr, k, leaf_adj, leaves, slot, leaf);
+    }
+
+    /**
+     * Flags the leaves that view the same variable in every lane.
+     * Must be called after every lane is bound.
+     */
+    void share()
+    {
+        for (size_t j = 0; j < leaves_; ++j) {
+            auto vals = leaf_vals_.begin() + j * n_;
+            auto adjs = leaf_adjs_.begin() + j * n_;
+            leaf_shared_[j] =
+                std::all_of(vals, vals + n_, [&](auto v) { return v == vals[0]; }) &&
+                std::all_of(adjs, adjs + n_, [&](auto a) { return a == adjs[0]; });
+        }
+    }
+
+    /**
+     * Computes the values of every slot for all lanes.
+     * @return  values of the root for all lanes
+     */
+    template <class T>
+    lanes_t feval(const T& expr)
+    {
+        size_t slot = 0;
+        size_t leaf = 0;
+        feval_(expr, slot, leaf);
+        return val(0);
+    }
+
+    /**
+     * Propagates the adjoints of the root for all lanes to the leaves.
+     * The adjoints of a shared leaf are reduced in AccumType (see accum_t).
+     */
+    template <class AccumType = void, class T>
+    void beval(const T& expr)
+    {
+        size_t slot = 0;
+        size_t leaf = 0;
+        beval_<AccumType>(expr, slot, leaf);
+    }
+
+    /**
+     * Values of every lane of slot.
+     */
+    lanes_t val(size_t slot) { return lanes_t(vals_ + slot * n_, n_); }
+
+    /**
+     * Adjoints of every lane of slot.
+     */
+    lanes_t adj(size_t slot) { return lanes_t(adjs_ + slot * n_, n_); }
+
+    size_t lanes() const { return n_; }
+
+private:
+    using children_t = std::array<size_t, 2>;
+
+    template <class T>
+    size_t layout_(const T& x)
+    {
+        using expr_t = std::decay_t<T>;
+        const size_t self = slots_++;
+        children_.emplace_back();
+        if constexpr (has_children_v<expr_t>) {
+            size_t i = 0;
+            x.for_each_child([&](const auto& child) {
+                const size_t c = layout_(child);
+                children_[self][i++] = c;
+            });
+        } else if constexpr (is_var_view_v<expr_t>) {
+            ++leaves_;
+        }
+        return self;
+    }
+
+    template <class T>
+    void bind_lane_(const T& x, size_t k,
+                    AdjointScratch<value_t>* leaf_adj,
+                    LeafRegistry<value_t>* leaves,
+                    size_t& slot, size_t& leaf)
+    {
+        using expr_t = std::decay_t<T>;
+        const size_t self = slot++;
+        if constexpr (has_children_v<expr_t>) {
+            x.for_each_child([&](const auto& child) {
+                bind_lane_(child, k, leaf_adj, leaves, slot, leaf);
+            });
+        } else if constexpr (is_var_view_v<expr_t>) {
+            // adjoints of a leaf are written through its view
+            value_t* adj = const_cast<value_t*>(x.data_adj());
+            if (leaf_adj) adj = leaf_adj->bind(x.data(), adj, 1);
+            else if (leaves) leaves->add(x.data(), adj, 1);
+            leaf_vals_[leaf * n_ + k] = x.data();
+            leaf_adjs_[leaf * n_ + k] = adj;
+            ++leaf;
+        } else {
+            vals_[self * n_ + k] = x.feval();
+        }
+    }
+
+    template <class T>
+    void feval_(const T& x, size_t& slot, size_t& leaf)
+    {
+        using expr_t = std::decay_t<T>;
+        const size_t self = slot++;
+        if constexpr (has_children_v<expr_t>) {
+            x.for_each_child([&](const auto& child) {
+                feval_(child, slot, leaf);
+            });
+            x.soa_feval(*this, self, children_[self].data());
+        } else if constexpr (is_var_view_v<expr_t>) {
+            const value_t* const* vals = leaf_vals_.data() + leaf * n_;
+            if (leaf_shared_[leaf++]) {
+                val(self).setConstant(*vals[0]);
+                return;
+            }
+            value_t* a_val = val(self).data();
+            for (size_t k = 0; k < n_; ++k) {
+                a_val[k] = *vals[k];
+            }
+        }
+    }
+
+    template <class AccumType, class T>
+    void beval_(const T& x, size_t& slot, size_t& leaf)
+    {
+        using expr_t = std::decay_t<T>;
+        const size_t self = slot++;
+        if constexpr (has_children_v<expr_t>) {
+            x.soa_beval(*this, self, children_[self].data());
+            x.for_each_child([&](const auto& child) {
+                beval_<AccumType>(child, slot, leaf);
+            });
+        } else if constexpr (is_var_view_v<expr_t>) {
+            value_t* const* adjs = leaf_adjs_.data() + leaf * n_;
+            if (leaf_shared_[leaf++]) {
+                *adjs[0] += accum_sum<AccumType>(adj(self));
+                return;
+            }
+            const value_t* a_adj = adj(self).data();
+            for (size_t k = n_; k-- > 0;) {
+                *adjs[k] += a_adj[k];
+            }
+        }
+    }
+
+    size_t n_ = 0;
+    size_t slots_ = 0;
+    size_t leaves_ = 0;
+    value_t* vals_ = nullptr;
+    value_t* adjs_ = nullptr;
+    std::vector<children_t> children_;
+    std::vector<const value_t*> leaf_vals_;
+    std::vector<value_t*> leaf_adjs_;
+    std::vector<unsigned char> leaf_shared_;
+};
+
+} // namespace util
+} // namespace ad
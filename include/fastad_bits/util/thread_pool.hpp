@@ -0,0 +1,154 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace ad {
+namespace util {
+
+/**
+ * ThreadPool is a minimal fixed-size pool of worker threads.
+ * Jobs are pushed onto a single shared queue and picked up by idle workers.
+ * The pool is meant to be created once and reused across many calls
+ * so that thread creation is not paid on every evaluation.
+ *
+ * If a job throws, the first exception is stored and rethrown by wait().
+ * Remaining jobs still run to completion.
+ */
+
+struct ThreadPool
+{
+    using job_t = std::function<void()>;
+
+    /**
+     * Returns the default number of workers, which is the number of
+     * hardware threads reported by the system (at least 1).
+     */
+    static size_t default_n_threads()
+    {
+        size_t n = std::thread::hardware_concurrency();
+        return n ? n : 1;
+    }
+
+    explicit ThreadPool(size_t n_threads = default_n_threads())
+    {
+        n_threads = std::max<size_t>(n_threads, 1);
+        workers_.reserve(n_threads);
+        for (size_t i = 0; i < n_threads; ++i) {
+            workers_.emplace_back([this]() { this->run(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) =delete;
+    ThreadPool& operator=(const ThreadPool&) =delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            stop_ = true;
+        }
+        job_cv_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    /**
+     * Enqueues a job to be run by some worker.
+     * @param   job     callable with signature void()
+     */
+    void submit(job_t job)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            jobs_.push(std::move(job));
+            ++n_pending_;
+        }
+        job_cv_.notify_one();
+    }
+
+    /**
+     * Blocks until every submitted job has finished.
+     * Rethrows the first exception thrown by any of the jobs, if any.
+     */
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        done_cv_.wait(lock, [this]() { return n_pending_ == 0; });
+        if (error_) {
+            auto error = error_;
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * Splits the range [0, n) into at most size() contiguous blocks
+     * and calls f(begin, end) on each block from a worker.
+     * Blocks until all blocks have been processed.
+     * The partition only depends on n and size().
+     *
+     * @tparam  F       callable with signature void(size_t, size_t)
+     * @param   n       size of range
+     * @param   f       callable to run on each block
+     */
+    template <class F>
+    void parallel_for(size_t n, F&& f)
+    {
+        if (n == 0) return;
+        size_t n_blocks = std::min(n, size());
+        size_t block_size = n / n_blocks;
+        size_t remainder = n % n_blocks;
+        size_t begin = 0;
+        for (size_t i = 0; i < n_blocks; ++i) {
+            size_t end = begin + block_size + (i < remainder);
+            submit([&f, begin, end]() { f(begin, end); });
+            begin = end;
+        }
+        wait();
+    }
+
+    size_t size() const { return workers_.size(); }
+
+private:
+    void run()
+    {
+        while (true) {
+            job_t job;
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                job_cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+                if (stop_ && jobs_.empty()) return;
+                job = std::move(jobs_.front());
+                jobs_.pop();
+            }
+
+            std::exception_ptr error = nullptr;
+            try { job(); }
+            catch (...) { error = std::current_exception(); }
+
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                if (error && !error_) error_ = error;
+                if (--n_pending_ == 0) done_cv_.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::queue<job_t> jobs_;
+    std::mutex mtx_;
+    std::condition_variable job_cv_;
+    std::condition_variable done_cv_;
+    std::exception_ptr error_ = nullptr;
+    size_t n_pending_ = 0;
+    bool stop_ = false;
+};
+
+} // namespace util
+} // namespace ad
@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+#include <typeinfo>
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+namespace ad {
+namespace util {
+
+/**
+ * Returns the template name of type T without namespaces and template arguments,
+ * e.g. "BinaryNode" for ad::core::BinaryNode<...>.
+ * Used to label nodes in reports (see ad::profile_report, ad::memory_report).
+ */
+template <class T>
+inline std::string type_name()
+{
+    const char* raw = typeid(T).name();
+    std::string name = raw;
+#if defined(__GNUG__)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(raw, nullptr, nullptr, &status);
+    if (status == 0 && demangled) name = demangled;
+    std::free(demangled);
+#endif
+    name = name.substr(0, name.find('<'));
+    auto pos = name.rfind("::");
+    return pos == std::string::npos ? name : name.substr(pos + 2);
+}
+
+} // namespace util
+} // namespace ad
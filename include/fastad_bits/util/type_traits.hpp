@@ -12,6 +12,8 @@ template <class ValueType, class ShapeType>
 struct VarView;
 template <class ValueType, class ShapeType>
 struct Var;
+template <class T, size_t W>
+struct simd;
 
 namespace core {
 
@@ -118,6 +120,26 @@ template <class T>
 inline constexpr bool is_var_v =
     details::is_var<T>::value;
 
+/*
+ * Check if type T is a pack of values (see ad::simd)
+ */
+namespace details {
+
+template <class T>
+struct is_simd : std::false_type
+{};
+
+template <class T, size_t W>
+struct is_simd<simd<T, W>>:
+    std::true_type
+{};
+
+} // namespace details
+
+template <class T>
+inline constexpr bool is_simd_v =
+    details::is_simd<std::decay_t<T>>::value;
+
 /*
  * Check if type T is Constant
  */
@@ -125,6 +147,41 @@ template <class T>
 inline constexpr bool is_constant_v =
     std::is_base_of_v<core::ConstantBase<T>, T>;
 
+/*
+ * Check if expression type T has sub-expressions, i.e. it defines
+ *
+ *  template <class F>
+ *  void for_each_child(F&& f) const
+ *
+ * which calls f on each of its sub-expressions in the order they are bound.
+ * Expressions without it (leaves and constants) are the leaves of the tree.
+ * Any traversal of an expression (see ad::visit, CSERegistry, SoAContext)
+ * goes through for_each_child.
+ */
+namespace details {
+
+struct noop_child_visitor
+{
+    template <class T>
+    void operator()(const T&) const {}
+};
+
+template <class T, class = void>
+struct has_children : std::false_type
+{};
+
+template <class T>
+struct has_children<T, std::void_t<
+    decltype(std::declval<const T&>().for_each_child(noop_child_visitor()))> >:
+    std::true_type
+{};
+
+} // namespace details
+
+template <class T>
+inline constexpr bool has_children_v =
+    details::has_children<std::decay_t<T>>::value;
+
 /**
  * Constant represents constants in a mathematical formula.
  * It owns the constant values rather than viewing them elsewhere.
@@ -154,6 +211,18 @@ struct constant_var<ValueType, ad::mat>
     using type = Eigen::Matrix<ValueType, Eigen::Dynamic, Eigen::Dynamic>;
 };
 
+template <class ValueType, size_t N>
+struct constant_var<ValueType, ad::fixed_vec<N>>
+{
+    using type = Eigen::Matrix<ValueType, N, 1>;
+};
+
+template <class ValueType, size_t R, size_t C>
+struct constant_var<ValueType, ad::fixed_mat<R, C>>
+{
+    using type = Eigen::Matrix<ValueType, R, C>;
+};
+
 } // namespace details
 
 template <class ValueType, class ShapeType>
@@ -188,6 +257,42 @@ template <class... Ts>
 using common_value_t = typename
     details::common_value<Ts...>::type;
 
+/*
+ * Get the shape of Eigen type T:
+ * vec or mat if its extents are dynamic,
+ * fixed_vec or fixed_mat if they are known at compile-time,
+ * and void for any other T.
+ */
+namespace details {
+
+template <class T, class = void>
+struct eigen_shape
+{
+    using type = void;
+};
+
+template <class T>
+struct eigen_shape<T, std::enable_if_t<is_eigen_v<T>>>
+{
+    static constexpr int rows = T::RowsAtCompileTime;
+    static constexpr int cols = T::ColsAtCompileTime;
+    static constexpr bool dynamic = (rows == Eigen::Dynamic);
+    static constexpr bool fixed = !dynamic && (cols != Eigen::Dynamic);
+
+    using type = std::conditional_t<
+        cols == 1,
+        std::conditional_t<dynamic, ad::vec, ad::fixed_vec<(dynamic ? 1 : rows)>>,
+        std::conditional_t<
+            dynamic && cols == Eigen::Dynamic, ad::mat,
+            std::conditional_t<fixed, 
+                ad::fixed_mat<(fixed ? rows : 1), (fixed ? cols : 1)>, void> > >;
+};
+
+} // namespace details
+
+template <class T>
+using eigen_shape_t = typename details::eigen_shape<T>::type;
+
 /*
  * Convert T to correct corresponding AD expression.
  * Note that some Eigen specializations require code duplication -
@@ -220,23 +325,19 @@ struct convert_to_ad<T, std::enable_if_t<std::is_arithmetic_v<T>>>
     using type = core::Constant<T, ad::scl>;
 };
 
-// specialization: column vector
+// specialization: pack of values (see ad::simd)
 template <class T>
-struct convert_to_ad<T, std::enable_if_t<
-    is_eigen_v<T> &&
-    T::ColsAtCompileTime == 1 > >
+struct convert_to_ad<T, std::enable_if_t<is_simd_v<T>>>
 {
-    using type = core::Constant<typename T::Scalar, ad::vec>;
+    using type = core::Constant<T, ad::scl>;
 };
 
-// specialization: matrix 
+// specialization: column vector or matrix (see eigen_shape_t)
 template <class T>
 struct convert_to_ad<T, std::enable_if_t<
-    is_eigen_v<T> &&
-    T::RowsAtCompileTime == Eigen::Dynamic &&
-    T::ColsAtCompileTime == Eigen::Dynamic> >
+    !std::is_void_v<eigen_shape_t<T>> > >
 {
-    using type = core::Constant<typename T::Scalar, ad::mat>;
+    using type = core::Constant<typename T::Scalar, eigen_shape_t<T>>;
 };
 
 } // namespace details
@@ -245,6 +346,64 @@ template <class T>
 using convert_to_ad_t = typename
     details::convert_to_ad<T>::type;
 
+/*
+ * Converts T to an AD expression as in convert_to_ad_t,
+ * except that an arithmetic T becomes a scalar constant of the common value type
+ * of the AD-like objects (see any_ad_v) in Others, if there are any.
+ * Literals such as 0.5 in 0.5 * x then do not promote the value type of x.
+ */
+namespace details {
+
+template <class T, class = void>
+struct ad_value
+{
+    using type = void;
+};
+
+template <class T>
+struct ad_value<T, std::enable_if_t<is_expr_v<T> || is_var_v<T>>>
+{
+    using type = typename expr_traits<convert_to_ad_t<T>>::value_t;
+};
+
+template <class... Ts>
+struct ad_common_value
+{
+    using type = void;
+};
+
+template <class T, class... Ts>
+struct ad_common_value<T, Ts...>
+{
+    using first_t = typename ad_value<T>::type;
+    using rest_t = typename ad_common_value<Ts...>::type;
+    using type = std::conditional_t<
+        std::is_void_v<first_t>, rest_t,
+        typename std::conditional_t<
+            std::is_void_v<rest_t>, 
+            std::common_type<first_t>,
+            std::common_type<first_t, rest_t> >::type >;
+};
+
+template <class T, class ValueType, class = void>
+struct convert_to_ad_as
+{
+    using type = convert_to_ad_t<T>;
+};
+
+template <class T, class ValueType>
+struct convert_to_ad_as<T, ValueType, std::enable_if_t<
+    std::is_arithmetic_v<T> && !std::is_void_v<ValueType> > >
+{
+    using type = core::Constant<ValueType, ad::scl>;
+};
+
+} // namespace details
+
+template <class T, class... Others>
+using convert_to_ad_as_t = typename details::convert_to_ad_as<
+    T, typename details::ad_common_value<Others...>::type>::type;
+
 /*
  * Checks if T can be converted to AD expression as specified by
  * convert_to_ad_t
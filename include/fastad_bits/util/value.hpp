@@ -1,4 +1,5 @@
 #pragma once
+#include <type_traits>
 #include <utility>
 #include <fastad_bits/util/type_traits.hpp>
 #include <Eigen/Dense>
@@ -33,6 +34,39 @@ auto cast_to(const XType& x)
     }
 };
 
+/*
+ * Converts a literal to the scalar type of T, where T is a scalar or an Eigen object,
+ * so that literals in functors do not promote float values to double.
+ * Any other T (e.g. forward-mode dual numbers) keeps the literal as double.
+ */
+namespace details {
+
+template <class T, class = void>
+struct literal_type
+{
+    using type = double;
+};
+
+template <class T>
+struct literal_type<T, std::enable_if_t<std::is_arithmetic_v<T>>>
+{
+    using type = T;
+};
+
+template <class T>
+struct literal_type<T, std::void_t<typename T::Scalar>>
+{
+    using type = typename T::Scalar;
+};
+
+} // namespace details
+
+template <class T>
+constexpr inline auto literal(double x)
+{
+    return static_cast<typename details::literal_type<T>::type>(x);
+}
+
 template <class T>
 constexpr inline void ones(T& x) 
 {
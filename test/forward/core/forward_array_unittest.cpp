@@ -0,0 +1,153 @@
+#include <fastad_bits/forward/core/forward_array.hpp>
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ad {
+
+struct forward_array_fixture: ::testing::Test
+{
+protected:
+    using vec_t = Eigen::VectorXd;
+    using mat_t = Eigen::MatrixXd;
+
+    size_t n = 7;
+    vec_t w;
+    vec_t dw;
+
+    forward_array_fixture()
+        : w(vec_t::LinSpaced(n, 0.1, 0.9))
+        , dw(vec_t::LinSpaced(n, -1., 2.))
+    {}
+
+    // checks x against element-wise scalar forward evaluation of f
+    template <class ArrayType, class F>
+    void check(const ArrayType& x, F f)
+    {
+        for (size_t i = 0; i < x.size(); ++i) {
+            ForwardVar<double> xi(w(i), dw(i));
+            ForwardVar<double> res = f(xi);
+            // derivative formulas of the functors and of ADForward may round differently
+            EXPECT_NEAR(x.get_value()(i), res.get_value(),
+                        1e-14 * std::max(1., std::abs(res.get_value())));
+            EXPECT_NEAR(x.get_adjoint()(i), res.get_adjoint(),
+                        1e-14 * std::max(1., std::abs(res.get_adjoint())));
+        }
+    }
+};
+
+TEST_F(forward_array_fixture, constructor)
+{
+    ForwardArray<double> x(n);
+    EXPECT_EQ(x.size(), n);
+    EXPECT_EQ(x.cols(), 1ul);
+    EXPECT_DOUBLE_EQ(x.get_value().norm(), 0.);
+    EXPECT_DOUBLE_EQ(x.get_adjoint().norm(), 0.);
+
+    ForwardArray<double, mat> y(2, 3);
+    EXPECT_EQ(y.rows(), 2ul);
+    EXPECT_EQ(y.cols(), 3ul);
+
+    ForwardArray<double> z(w, dw);
+    EXPECT_EQ(z.get_value(), w);
+    EXPECT_EQ(z.get_adjoint(), dw);
+}
+
+TEST_F(forward_array_fixture, unary)
+{
+    ForwardArray<double> x(w, dw);
+    check(-x, [](const auto& x) { return -x; });
+    check(ad::sin(x), [](const auto& x) { return ad::sin(x); });
+    check(ad::cos(x), [](const auto& x) { return ad::cos(x); });
+    check(ad::tan(x), [](const auto& x) { return ad::tan(x); });
+    check(ad::asin(x), [](const auto& x) { return ad::asin(x); });
+    check(ad::acos(x), [](const auto& x) { return ad::acos(x); });
+    check(ad::atan(x), [](const auto& x) { return ad::atan(x); });
+    check(ad::exp(x), [](const auto& x) { return ad::exp(x); });
+    check(ad::log(x), [](const auto& x) { return ad::log(x); });
+    check(ad::sqrt(x), [](const auto& x) { return ad::sqrt(x); });
+    check(ad::erf(x), [](const auto& x) { return ad::erf(x); });
+}
+
+TEST_F(forward_array_fixture, binary)
+{
+    ForwardArray<double> x(w, dw);
+    check(x + x, [](const auto& x) { return x + x; });
+    check(x - ad::sin(x), [](const auto& x) { return x - ad::sin(x); });
+    check(x * ad::exp(x), [](const auto& x) { return x * ad::exp(x); });
+    check(ad::cos(x) / x, [](const auto& x) { return ad::cos(x) / x; });
+}
+
+TEST_F(forward_array_fixture, binary_constant)
+{
+    ForwardArray<double> x(w, dw);
+    check(2. * x + 1, [](const auto& x) { return 2. * x + 1; });
+    check(1. - x / 3, [](const auto& x) { return 1. - x / 3; });
+    check(2. / x - x * 4., [](const auto& x) { return 2. / x - x * 4.; });
+}
+
+TEST_F(forward_array_fixture, composite)
+{
+    ForwardArray<double> x(w, dw);
+    auto f = [](const auto& x) {
+        return ad::exp(-x * x / 2.) * ad::sin(x) + ad::sqrt(1. + x * x);
+    };
+    check(f(x), f);
+
+    ForwardVar<double> s = ad::sum(f(x));
+    double sum = 0, dsum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        ForwardVar<double> res = f(ForwardVar<double>(w(i), dw(i)));
+        sum += res.get_value();
+        dsum += res.get_adjoint();
+    }
+    EXPECT_NEAR(s.get_value(), sum, 1e-14);
+    EXPECT_NEAR(s.get_adjoint(), dsum, 1e-14);
+}
+
+TEST_F(forward_array_fixture, mat)
+{
+    mat_t v = mat_t::Random(2, 3);
+    mat_t dv = mat_t::Random(2, 3);
+    ForwardArray<double, mat> x(v, dv);
+    auto res = ad::exp(x) * x;
+    for (size_t j = 0; j < 3; ++j) {
+        for (size_t i = 0; i < 2; ++i) {
+            ForwardVar<double> xij(v(i,j), dv(i,j));
+            ForwardVar<double> rij = ad::exp(xij) * xij;
+            EXPECT_DOUBLE_EQ(res.get_value()(i,j), rij.get_value());
+            EXPECT_DOUBLE_EQ(res.get_adjoint()(i,j), rij.get_adjoint());
+        }
+    }
+}
+
+// Exp that counts the elements it maps
+struct CountedExp
+{
+    static inline size_t count = 0;
+
+    template <class T>
+    static auto fmap(const T& x)
+    {
+        count += x.size();
+        return core::Exp::fmap(x);
+    }
+
+    template <class S, class T, class U>
+    static auto bmap(const S& seed, const T& x, const U& f)
+    {
+        return core::Exp::bmap(seed, x, f);
+    }
+};
+
+// An rvalue reuses its storage but still maps every element only once.
+TEST_F(forward_array_fixture, rvalue_fmap_once)
+{
+    ForwardArray<double> x(w, dw);
+    CountedExp::count = 0;
+    auto res = core::details::forward_array_unary<CountedExp>(x * 2.);
+    EXPECT_EQ(CountedExp::count, n);
+    check(res, [](const auto& x) { return ad::exp(x * 2.); });
+}
+
+} // namespace ad
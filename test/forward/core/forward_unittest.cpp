@@ -112,6 +112,14 @@ TEST_F(adforward_fixture, erf)
     EXPECT_DOUBLE_EQ(res.get_adjoint(), 1.2698234671866558e-7);
 }
 
+TEST_F(adforward_fixture, erf_direction)
+{
+    ForwardVar<double> x(0, 2);
+    ForwardVar<double> res = ad::erf(x);
+    EXPECT_DOUBLE_EQ(res.get_value(), 0.);
+    EXPECT_DOUBLE_EQ(res.get_adjoint(), 2 * 1.1283791670955126);
+}
+
 ////////////////////////////////////////////////////////////
 // Binary
 ////////////////////////////////////////////////////////////
@@ -148,4 +156,122 @@ TEST_F(adforward_fixture, div)
     EXPECT_DOUBLE_EQ(res.get_adjoint(), 1./3 + 4./9);    // directional derivative in direction (1,1)
 }
 
+TEST_F(adforward_fixture, mixed_constant)
+{
+    ForwardVar<double> x(4, 1);
+    ForwardVar<double> res = 2. * x + 1;
+    EXPECT_DOUBLE_EQ(res.get_value(), 9);
+    EXPECT_DOUBLE_EQ(res.get_adjoint(), 2);
+    res = 1. - x / 2;
+    EXPECT_DOUBLE_EQ(res.get_value(), -1);
+    EXPECT_DOUBLE_EQ(res.get_adjoint(), -0.5);
+    res = 1. / x;
+    EXPECT_DOUBLE_EQ(res.get_value(), 0.25);
+    EXPECT_DOUBLE_EQ(res.get_adjoint(), -1./16);
+}
+
+TEST_F(adforward_fixture, compound_assign)
+{
+    ForwardVar<double> x(4, 1), y(3, -1);
+    x -= y;
+    EXPECT_DOUBLE_EQ(x.get_value(), 1);
+    EXPECT_DOUBLE_EQ(x.get_adjoint(), 2);
+    x *= y;
+    EXPECT_DOUBLE_EQ(x.get_value(), 3);
+    EXPECT_DOUBLE_EQ(x.get_adjoint(), 5);
+    x /= y;
+    EXPECT_DOUBLE_EQ(x.get_value(), 1);
+    EXPECT_DOUBLE_EQ(x.get_adjoint(), 2);
+}
+
+TEST_F(adforward_fixture, comparison)
+{
+    // only values are compared
+    ForwardVar<double> x(4, 1), y(4, -1), z(3, 1);
+    EXPECT_TRUE(x == y);
+    EXPECT_FALSE(x != y);
+    EXPECT_TRUE(z < x);
+    EXPECT_TRUE(z <= x);
+    EXPECT_TRUE(x > z);
+    EXPECT_TRUE(x >= y);
+    EXPECT_TRUE(x == 4);
+    EXPECT_TRUE(0. < z);
+}
+
+////////////////////////////////////////////////////////////
+// Multiple tangent lanes
+////////////////////////////////////////////////////////////
+
+TEST_F(adforward_fixture, lanes_gradient)
+{
+    // gradient of f(x, y) = sin(x) * y + exp(x / y) - 2 / y in one pass
+    using fvar_t = ForwardVar<double, 2>;
+    using lanes_t = fvar_t::adjoint_type;
+    double xv = 0.3, yv = 1.7;
+    fvar_t x(xv, lanes_t(1, 0));
+    fvar_t y(yv, lanes_t(0, 1));
+    fvar_t res = ad::sin(x) * y + ad::exp(x / y) - 2 / y;
+
+    double e = std::exp(xv / yv);
+    EXPECT_DOUBLE_EQ(res.get_value(), std::sin(xv) * yv + e - 2 / yv);
+    EXPECT_DOUBLE_EQ(res.get_adjoint()(0), std::cos(xv) * yv + e / yv);
+    EXPECT_DOUBLE_EQ(res.get_adjoint()(1),
+                     std::sin(xv) - e * xv / (yv * yv) + 2 / (yv * yv));
+}
+
+TEST_F(adforward_fixture, lanes_match_single_lane)
+{
+    // every lane must agree with a single-lane pass in the same direction
+    constexpr int N = 8;
+    using fvar_t = ForwardVar<double, N>;
+    Eigen::Array<double, N, 1> dir = Eigen::Array<double, N, 1>::LinSpaced(-1., 2.);
+    fvar_t x(0.4, dir);
+    fvar_t res = ad::tan(x) + ad::log(ad::sqrt(x)) * ad::erf(x) +
+                 ad::asin(x) - ad::acos(x) * ad::atan(x) + ad::cos(-x) / 3.;
+
+    for (int i = 0; i < N; ++i) {
+        ForwardVar<double> xi(0.4, dir(i));
+        ForwardVar<double> ri = ad::tan(xi) + ad::log(ad::sqrt(xi)) * ad::erf(xi) +
+                                ad::asin(xi) - ad::acos(xi) * ad::atan(xi) + ad::cos(-xi) / 3.;
+        EXPECT_DOUBLE_EQ(res.get_value(), ri.get_value());
+        EXPECT_NEAR(res.get_adjoint()(i), ri.get_adjoint(), 1e-14);
+    }
+}
+
+TEST_F(adforward_fixture, lanes_dynamic)
+{
+    using fvar_t = ForwardVar<double, Eigen::Dynamic>;
+    using lanes_t = fvar_t::adjoint_type;
+    fvar_t x(2., lanes_t::Constant(5, 1.));
+    fvar_t y(3., lanes_t::LinSpaced(5, 0., 4.));
+    fvar_t res = 1. + x * y;
+    EXPECT_DOUBLE_EQ(res.get_value(), 7.);
+    ASSERT_EQ(res.get_adjoint().size(), 5);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_DOUBLE_EQ(res.get_adjoint()(i), 3. + 2. * i);
+    }
+    res += x;
+    EXPECT_DOUBLE_EQ(res.get_value(), 9.);
+    EXPECT_DOUBLE_EQ(res.get_adjoint()(4), 12.);
+
+    // constants have no lanes
+    fvar_t acc = 0.;
+    EXPECT_EQ(acc.get_adjoint().size(), 0);
+    acc += y;
+    acc = acc * fvar_t(2.);
+    EXPECT_DOUBLE_EQ(acc.get_value(), 6.);
+    ASSERT_EQ(acc.get_adjoint().size(), 5);
+    EXPECT_DOUBLE_EQ(acc.get_adjoint()(4), 8.);
+}
+
+TEST_F(adforward_fixture, lanes_default)
+{
+    ForwardVar<double, 4> x;
+    EXPECT_DOUBLE_EQ(x.get_value(), 0.);
+    EXPECT_TRUE((x.get_adjoint() == 0).all());
+    ForwardVar<double, 4> y(3.);
+    EXPECT_DOUBLE_EQ(y.get_value(), 3.);
+    EXPECT_TRUE((y.get_adjoint() == 0).all());
+}
+
 } // namespace ad
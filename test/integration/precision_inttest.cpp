@@ -0,0 +1,199 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <vector>
+#include <fastad>
+#include <fastad_bits/reverse/core/det.hpp>
+#include <fastad_bits/reverse/core/log_det.hpp>
+
+namespace ad {
+namespace core {
+
+// Every leaf kind of a model with value type T.
+template <class T>
+struct precision_model
+{
+    using value_t = T;
+
+    Var<T> x, y;
+    Var<T, vec> v, w, u;
+    Var<T, mat> m;
+    Eigen::Matrix<T, Eigen::Dynamic, 1> c;
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> id;
+    std::vector<T> d;
+
+    precision_model()
+        : x(0.3), y(1.7), v(5), w(5), u(3), m(3, 3), c(5), id(3, 3), d{1, 2, 3}
+    {
+        for (size_t i = 0; i < 5; ++i) {
+            v.get(i, 0) = 0.1 * i + 0.2;
+            w.get(i, 0) = 0.3 * i - 0.1;
+            c(i) = 1. - 0.2 * i;
+        }
+        for (size_t i = 0; i < 3; ++i) {
+            u.get(i, 0) = 0.1 * i + 0.5;
+        }
+        m.get() << 2, 0.5, 0.1,
+                   0.5, 3, 0.2,
+                   0.1, 0.2, 4;
+        id.setIdentity();
+    }
+
+    std::vector<double> grad() const
+    {
+        std::vector<double> g = {x.get_adj(), y.get_adj()};
+        for (size_t i = 0; i < 5; ++i) {
+            g.push_back(v.get_adj(i, 0));
+            g.push_back(w.get_adj(i, 0));
+        }
+        for (size_t j = 0; j < 3; ++j) {
+            g.push_back(u.get_adj(j, 0));
+            for (size_t i = 0; i < 3; ++i) {
+                g.push_back(m.get_adj(i, j));
+            }
+        }
+        return g;
+    }
+};
+
+struct precision_fixture : ::testing::Test
+{
+protected:
+    // Compares float against double evaluation of the same expression f
+    // and checks that the float expression does not get promoted to double.
+    template <class F>
+    void check(F f, double tol = 1e-5)
+    {
+        precision_model<double> md;
+        precision_model<float> mf;
+        auto ed = ad::bind(f(md));
+        auto ef = ad::bind(f(mf));
+        static_assert(std::is_same_v<
+                typename util::expr_traits<std::decay_t<decltype(ef.get())>>::value_t, float>);
+
+        double vd = ad::autodiff(ed);
+        float vf = ad::autodiff(ef);
+        EXPECT_NEAR(vf, vd, tol * (1. + std::abs(vd)));
+
+        auto gd = md.grad();
+        auto gf = mf.grad();
+        for (size_t i = 0; i < gd.size(); ++i) {
+            EXPECT_NEAR(gf[i], gd[i], tol * (1. + std::abs(gd[i])));
+        }
+    }
+};
+
+TEST_F(precision_fixture, unary)
+{
+    check([](auto& m) {
+        return ad::sin(m.x) + ad::cos(m.x) + ad::tan(m.x) + ad::asin(m.x) +
+               ad::acos(m.x) + ad::atan(m.x) + ad::exp(m.x) + ad::log(m.y) +
+               ad::sqrt(m.y) + ad::erf(m.x) + ad::pow<3>(m.x) + ad::pow<-2>(m.y);
+    });
+}
+
+// Literals take the value type of the other operand.
+TEST_F(precision_fixture, binary_literal)
+{
+    check([](auto& m) {
+        return 0.5 * m.x - m.x / 2. + m.x * m.y - (m.x - m.y) + 3 * (-m.x) +
+               ad::sum(ad::constant(m.c) * m.v * 1.5);
+    });
+}
+
+TEST_F(precision_fixture, vec_unary)
+{
+    check([](auto& m) {
+        return ad::sum(ad::exp(m.v) + ad::sqrt(m.v) + ad::erf(m.w) + ad::atan(m.w));
+    });
+}
+
+TEST_F(precision_fixture, sum_iter)
+{
+    check([](auto& m) {
+        return ad::sum(m.d.begin(), m.d.end(),
+                [&](auto di) { return m.x * di + ad::sin(m.y * di); });
+    });
+}
+
+TEST_F(precision_fixture, prod_iter)
+{
+    check([](auto& m) {
+        return ad::prod(m.d.begin(), m.d.end(),
+                [&](auto di) { return m.x + di; });
+    });
+}
+
+TEST_F(precision_fixture, dot_norm)
+{
+    check([](auto& m) {
+        return ad::sum(ad::dot(m.m, m.u)) + ad::norm(m.v);
+    });
+}
+
+TEST_F(precision_fixture, det)
+{
+    check([](auto& m) { return ad::det<DetLLT>(m.m); });
+    check([](auto& m) { return ad::log_det<LogDetLLT>(m.m); });
+    check([](auto& m) { return ad::log_det<LogDetLDLT>(m.m); });
+    check([](auto& m) { return ad::log_det(m.m); });
+}
+
+TEST_F(precision_fixture, if_else)
+{
+    check([](auto& m) { return ad::if_else(m.x < m.y, m.x * 2., 1.); });
+}
+
+TEST_F(precision_fixture, stat)
+{
+    check([](auto& m) { return ad::normal_adj_log_pdf(m.v, m.x, m.y); });
+    check([](auto& m) { return ad::normal_adj_log_pdf(m.v, m.w, 2.); });
+    check([](auto& m) { return ad::cauchy_adj_log_pdf(m.v, m.x, m.y); });
+    check([](auto& m) { return ad::uniform_adj_log_pdf(m.x, -1., 2.); });
+    check([](auto& m) { return ad::bernoulli_adj_log_pdf(1, m.x); });
+    check([](auto& m) { return ad::wishart_adj_log_pdf(m.m, m.id, 5.); });
+}
+
+TEST_F(precision_fixture, fuse)
+{
+    check([](auto& m) {
+        return ad::sum(ad::fuse(ad::exp(-0.5 * ad::pow<2>((m.v - m.x) / m.y)) * m.w));
+    });
+}
+
+// Long reductions lose precision in float unless accumulated in double.
+TEST_F(precision_fixture, long_sum)
+{
+    static_assert(std::is_same_v<util::accum_t<float>, float>);
+    static_assert(std::is_same_v<util::accum_t<float, double>, double>);
+
+    constexpr size_t n = 1 << 20;
+    std::vector<float> data(n, 0.1f);
+    double expected = n * double(0.1f);
+
+    Var<float> x(1.f);
+    auto expr = ad::bind(ad::sum(data.begin(), data.end(),
+                [&](float di) { return x * di; }));
+    float f = ad::autodiff(expr);
+    EXPECT_NEAR(f, expected, 1e-1 * expected);
+    EXPECT_NEAR(x.get_adj(), expected, 1e-1 * expected);
+
+    Var<float> y(1.f);
+    auto mixed = ad::bind(ad::sum<double>(data.begin(), data.end(),
+                [&](float di) { return y * di; }));
+    float g = ad::autodiff(mixed);
+    EXPECT_NEAR(g, expected, 1e-6 * expected);
+    EXPECT_NEAR(y.get_adj(), expected, 1e-6 * expected);
+}
+
+TEST_F(precision_fixture, long_sum_elem)
+{
+    constexpr size_t n = 1 << 20;
+    Var<float, vec> v(n);
+    v.get().setConstant(0.1f);
+    double expected = n * double(0.1f);
+    auto expr = ad::bind(ad::sum<double>(v));
+    EXPECT_NEAR(ad::evaluate(expr), expected, 1e-6 * expected);
+}
+
+} // namespace core
+} // namespace ad
@@ -0,0 +1,111 @@
+#include "gtest/gtest.h"
+#include <fastad_bits/reverse/core/batch.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+
+namespace ad {
+namespace core {
+
+struct batch_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+    using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
+
+    size_t n_rows = 37;
+    size_t n_vars = 3;
+    mat_t inputs;
+    mat_t outputs;
+    mat_t expected;
+
+    // f(x) = sin(x0) * cos(x1) + x2 * sum_i exp(x_i)
+    static constexpr auto f = [](auto& x, auto& w) {
+        w.resize(1);
+        return (w[0] = ad::sin(x[0]) * ad::cos(x[1]),
+                w[0] + x[2] * ad::sum(x.begin(), x.end(),
+                            [](const auto& xi) { return ad::exp(xi); }));
+    };
+
+    batch_fixture()
+        : inputs(mat_t::Random(n_rows, n_vars))
+        , outputs(n_rows, n_vars + 1)
+        , expected(n_rows, n_vars + 1)
+    {
+        // serially compute expected values and gradients
+        std::vector<Var<value_t>> x(n_vars);
+        std::vector<Var<value_t>> w;
+        auto expr = ad::bind(f(x, w));
+        for (size_t i = 0; i < n_rows; ++i) {
+            for (size_t j = 0; j < n_vars; ++j) {
+                x[j].get() = inputs(i, j);
+                x[j].reset_adj();
+            }
+            for (auto& wj : w) wj.reset_adj();
+            expected(i, 0) = ad::autodiff(expr);
+            for (size_t j = 0; j < n_vars; ++j) {
+                expected(i, j+1) = x[j].get_adj();
+            }
+        }
+    }
+
+    void check()
+    {
+        for (size_t i = 0; i < n_rows; ++i) {
+            for (size_t j = 0; j < n_vars + 1; ++j) {
+                EXPECT_DOUBLE_EQ(outputs(i, j), expected(i, j));
+            }
+        }
+    }
+};
+
+TEST_F(batch_fixture, one_thread)
+{
+    batch_autodiff(f, inputs, outputs, 1);
+    check();
+}
+
+TEST_F(batch_fixture, many_threads)
+{
+    batch_autodiff(f, inputs, outputs, 4);
+    check();
+}
+
+TEST_F(batch_fixture, more_threads_than_rows)
+{
+    n_rows = 2;
+    inputs.conservativeResize(n_rows, n_vars);
+    outputs.resize(n_rows, n_vars + 1);
+    batch_autodiff(f, inputs, outputs, 8);
+    check();
+}
+
+TEST_F(batch_fixture, reuse_pool)
+{
+    util::ThreadPool pool(3);
+    batch_autodiff(f, inputs, outputs, pool);
+    check();
+    outputs.setZero();
+    batch_autodiff(f, inputs, outputs, pool);
+    check();
+}
+
+TEST_F(batch_fixture, analytic)
+{
+    batch_autodiff(f, inputs, outputs, 2);
+    for (size_t i = 0; i < n_rows; ++i) {
+        value_t x0 = inputs(i, 0);
+        value_t x1 = inputs(i, 1);
+        value_t x2 = inputs(i, 2);
+        value_t s = std::exp(x0) + std::exp(x1) + std::exp(x2);
+        EXPECT_NEAR(outputs(i, 0), std::sin(x0) * std::cos(x1) + x2 * s, 1e-14);
+        EXPECT_NEAR(outputs(i, 1), std::cos(x0) * std::cos(x1) + x2 * std::exp(x0), 1e-14);
+        EXPECT_NEAR(outputs(i, 2), -std::sin(x0) * std::sin(x1) + x2 * std::exp(x1), 1e-14);
+        EXPECT_NEAR(outputs(i, 3), s + x2 * std::exp(x2), 1e-14);
+    }
+}
+
+} // namespace core
+} // namespace ad
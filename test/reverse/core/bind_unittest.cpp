@@ -3,7 +3,13 @@
 #include <fastad_bits/reverse/core/eq.hpp>
 #include <fastad_bits/reverse/core/binary.hpp>
 #include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/if_else.hpp>
 #include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/norm.hpp>
+#include <fastad_bits/reverse/core/pow.hpp>
+#include <fastad_bits/reverse/core/prod.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
 
 namespace ad {
 
@@ -58,4 +64,350 @@ TEST_F(bind_fixture, bind_test_rref)
     test(make_expr_bind());
 }
 
+// placeholders w3, w4 are reset but excluded from the gradient,
+// and w3 is registered once although it is also read.
+TEST_F(bind_fixture, bind_test_reset_adjoints) 
+{
+    auto expr_bind = make_expr_bind();
+    EXPECT_EQ(expr_bind.leaves().n_entries(), 4ul);
+    EXPECT_EQ(expr_bind.leaves().size(), 2ul);
+
+    test(expr_bind);
+    auto grad = expr_bind.gradient();
+    EXPECT_EQ(grad.size(), 2);
+    EXPECT_DOUBLE_EQ(grad(0), w1.get_adj());
+    EXPECT_DOUBLE_EQ(grad(1), w2.get_adj());
+
+    expr_bind.reset_adjoints();
+    EXPECT_DOUBLE_EQ(w1.get_adj(), 0.);
+    EXPECT_DOUBLE_EQ(w2.get_adj(), 0.);
+    EXPECT_DOUBLE_EQ(w3.get_adj(), 0.);
+    EXPECT_DOUBLE_EQ(w4.get_adj(), 0.);
+    test(expr_bind);
+}
+
+// Views of the same values are one entry, whichever is bound first.
+TEST_F(bind_fixture, bind_test_overlapping_views) 
+{
+    auto expr_bind = ad::bind(vec_expr(0) * ad::sum(vec_expr) + vec_expr(vec_size - 1));
+    EXPECT_EQ(expr_bind.leaves().n_entries(), 1ul);
+    EXPECT_EQ(expr_bind.leaves().size(), vec_size);
+
+    ad::autodiff(expr_bind);
+    auto grad = expr_bind.gradient();
+    ASSERT_EQ(static_cast<size_t>(grad.size()), vec_size);
+    for (size_t i = 0; i < vec_size; ++i) {
+        EXPECT_DOUBLE_EQ(grad(i), vec_expr.get_adj(i, 0));
+    }
+
+    // sub-views registered before the whole vector are merged into it
+    auto sub = ad::bind(vec_expr(1) * vec_expr(2) + ad::sum(vec_expr));
+    EXPECT_EQ(sub.leaves().n_entries(), 1ul);
+    EXPECT_EQ(sub.leaves().size(), vec_size);
+    sub.reset_adjoints();
+    ad::autodiff(sub);
+    grad = sub.gradient();
+    ASSERT_EQ(static_cast<size_t>(grad.size()), vec_size);
+    for (size_t i = 0; i < vec_size; ++i) {
+        EXPECT_DOUBLE_EQ(grad(i), vec_expr.get_adj(i, 0));
+    }
+    EXPECT_DOUBLE_EQ(grad(1), 1. + vec_expr.get()(2));
+}
+
+TEST_F(bind_fixture, bind_test_fresh) 
+{
+    auto expr_bind = ad::bind(ad::sin(w1) * w2 + w1 * w3);
+    value_t first = ad::autodiff(expr_bind, ad::fresh);
+    auto grad = expr_bind.gradient();
+    value_t second = ad::autodiff(expr_bind, ad::fresh);
+    EXPECT_DOUBLE_EQ(first, second);
+    EXPECT_EQ(grad.size(), 3);
+    EXPECT_DOUBLE_EQ(grad(0), std::cos(1.) * 2. + 3.);
+    EXPECT_DOUBLE_EQ(grad(1), std::sin(1.));
+    EXPECT_DOUBLE_EQ(grad(2), 1.);
+    EXPECT_TRUE(grad.isApprox(expr_bind.gradient()));
+}
+
+TEST_F(bind_fixture, bind_test_arena) 
+{
+    CacheArena arena;
+    {
+        auto expr_bind = ad::bind((w3 = w1 * w2, w4 = w3 * w3), arena);
+        test(expr_bind);
+    }
+    w1.reset_adj();
+    w2.reset_adj();
+    w3.reset_adj();
+    w4.reset_adj();
+
+    // only placeholders are needed above, so nothing is carved out
+    EXPECT_EQ(arena.bytes_in_use(), 0ul);
+
+    {
+        auto expr_bind = ad::bind(w1 * w2 + w3 * w4, arena);
+        EXPECT_GE(arena.bytes_in_use(), 6 * sizeof(value_t));
+        EXPECT_DOUBLE_EQ(ad::autodiff(expr_bind), 10.);
+        EXPECT_DOUBLE_EQ(w1.get_adj(), 2.);
+        EXPECT_DOUBLE_EQ(w4.get_adj(), 2.);
+    }
+    size_t bytes = arena.bytes_in_use();
+    arena.reset();
+    EXPECT_EQ(arena.bytes_in_use(), 0ul);
+    EXPECT_EQ(arena.high_water_mark(), bytes);
+
+    auto expr_bind = ad::bind(w1 * w2 + w3 * w4, arena);
+    EXPECT_EQ(arena.bytes_in_use(), bytes);
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr_bind), 10.);
+}
+
+TEST_F(bind_fixture, bind_test_interleaved) 
+{
+    auto expr_bind = ad::bind<layout::interleaved>(
+            (w3 = w1 * w2, w4 = w3 * w3));
+    test(expr_bind);
+    w1.reset_adj();
+    w2.reset_adj();
+    w3.reset_adj();
+    w4.reset_adj();
+    test(expr_bind);
+}
+
+TEST_F(bind_fixture, bind_test_interleaved_adjacent) 
+{
+    auto expr_bind = ad::bind<layout::interleaved>(w1 * w2 + w3 * w4);
+    auto& expr = expr_bind.get();
+    EXPECT_EQ(expr.data_adj(), expr.data() + 1);
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr_bind), 14.);
+    EXPECT_DOUBLE_EQ(w1.get_adj(), 2.);
+    EXPECT_DOUBLE_EQ(w2.get_adj(), 1.);
+    EXPECT_DOUBLE_EQ(w3.get_adj(), 4.);
+    EXPECT_DOUBLE_EQ(w4.get_adj(), 3.);
+}
+
+TEST_F(bind_fixture, bind_test_interleaved_arena) 
+{
+    CacheArena arena;
+    auto expr_bind = ad::bind<layout::interleaved>(w1 * w2 + w3 * w4, arena);
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr_bind), 14.);
+    EXPECT_DOUBLE_EQ(w4.get_adj(), 3.);
+}
+
+TEST_F(bind_fixture, bind_test_interleaved_mixed) 
+{
+    // mixes vector nodes, value-only nodes, extra adjoint caches, 
+    // and placeholders whose expression roots are released.
+    Var<value_t, vec> v(vec_size);
+    v.get() << 0.1, -0.2, 0.3, 0.7, -1.3;
+    auto make_expr = [&]() {
+        return (w3 = ad::sum(ad::sin(v) * v) + ad::prod(ad::exp(v)),
+                w4 = ad::pow<3>(w3) + ad::norm(v * w1) + ad::sum(v * v) * w2,
+                w4 * w3 + (w1 < w2) * w1);
+    };
+
+    auto separate = ad::bind(make_expr());
+    value_t expected = ad::autodiff(separate);
+    Eigen::VectorXd expected_adj = v.get_adj();
+    value_t expected_w1_adj = w1.get_adj();
+    value_t expected_w2_adj = w2.get_adj();
+
+    v.reset_adj();
+    w1.reset_adj();
+    w2.reset_adj();
+    w3.reset_adj();
+    w4.reset_adj();
+
+    auto interleaved = ad::bind<layout::interleaved>(make_expr());
+    value_t actual = ad::autodiff(interleaved);
+    EXPECT_DOUBLE_EQ(actual, expected);
+    for (size_t i = 0; i < vec_size; ++i) {
+        EXPECT_DOUBLE_EQ(v.get_adj(i, 0), expected_adj(i));
+    }
+    EXPECT_DOUBLE_EQ(w1.get_adj(), expected_w1_adj);
+    EXPECT_DOUBLE_EQ(w2.get_adj(), expected_w2_adj);
+}
+
+// Forward-only binding allocates no adjoints and can be rebound to a full bind.
+TEST_F(bind_fixture, bind_test_forward) 
+{
+    Var<value_t, vec> v(vec_size);
+    v.get() << 0.1, -0.2, 0.3, 0.7, -1.3;
+    auto make_expr = [&]() {
+        return (w3 = ad::sum(ad::sin(v) * v) + ad::prod(ad::exp(v)),
+                w4 = ad::pow<3>(w3) + ad::norm(v * w1) + ad::sum(v * v) * w2,
+                w4 * w3 + (w1 < w2) * w1);
+    };
+
+    CacheArena arena;
+    auto separate = ad::bind(make_expr(), arena);
+    size_t bytes = arena.bytes_in_use();
+    value_t expected = ad::autodiff(separate);
+    Eigen::VectorXd expected_adj = v.get_adj();
+    v.reset_adj();
+    w1.reset_adj();
+    w2.reset_adj();
+    w3.reset_adj();
+    w4.reset_adj();
+
+    arena.reset();
+    auto forward = ad::bind_forward(make_expr(), arena);
+    EXPECT_LT(arena.bytes_in_use(), bytes);
+    EXPECT_DOUBLE_EQ(ad::evaluate(forward), expected);
+    EXPECT_EQ(forward.get().data_adj(), nullptr);
+    EXPECT_DOUBLE_EQ(v.get_adj(0, 0), 0.);
+    EXPECT_TRUE(forward.forward_only());
+
+    forward.rebind();
+    EXPECT_FALSE(forward.forward_only());
+    EXPECT_DOUBLE_EQ(ad::autodiff(forward), expected);
+    for (size_t i = 0; i < vec_size; ++i) {
+        EXPECT_DOUBLE_EQ(v.get_adj(i, 0), expected_adj(i));
+    }
+}
+
+#ifndef NDEBUG
+// Backward evaluation of a forward-only binding is asserted against.
+TEST_F(bind_fixture, bind_test_forward_death) 
+{
+    auto forward = ad::bind_forward(w1 * w2 + w1);
+    EXPECT_DEATH(ad::autodiff(forward), "forward_only");
+    EXPECT_DEATH(ad::evaluate_adj(forward), "forward_only");
+    EXPECT_DEATH(ad::autodiff(forward, ad::fresh), "forward_only");
+    auto forward_cse = ad::bind<layout::forward>(w1 * w2 + w1 * w2, ad::cse);
+    EXPECT_DEATH(ad::autodiff(forward_cse), "forward_only");
+}
+#endif
+
+// Common subexpression elimination gives the same values and adjoints
+// as binding without elimination.
+struct bind_cse_fixture : bind_fixture
+{
+protected:
+    Var<value_t, vec> v{vec_size};
+
+    bind_cse_fixture()
+    {
+        v.get() << 0.1, -0.2, 0.3, 0.7, -1.3;
+    }
+
+    void reset()
+    {
+        v.reset_adj();
+        w1.reset_adj();
+        w2.reset_adj();
+        w3.reset_adj();
+        w4.reset_adj();
+    }
+
+    template <class F, class Layout = layout::separate>
+    void test_cse(F make_expr, Layout = Layout())
+    {
+        reset();
+        auto expr_bind = ad::bind<Layout>(make_expr());
+        value_t expected = ad::autodiff(expr_bind);
+        Eigen::VectorXd expected_v_adj = v.get_adj();
+        std::array<value_t, 4> expected_adj = 
+            {w1.get_adj(), w2.get_adj(), w3.get_adj(), w4.get_adj()};
+
+        reset();
+        auto cse_bind = ad::bind<Layout>(make_expr(), ad::cse);
+        // evaluate twice to check that nothing is left stale
+        ad::autodiff(cse_bind);
+        reset();
+        value_t actual = ad::autodiff(cse_bind);
+        EXPECT_DOUBLE_EQ(actual, expected);
+        for (size_t i = 0; i < vec_size; ++i) {
+            EXPECT_DOUBLE_EQ(v.get_adj(i, 0), expected_v_adj(i));
+        }
+        EXPECT_DOUBLE_EQ(w1.get_adj(), expected_adj[0]);
+        EXPECT_DOUBLE_EQ(w2.get_adj(), expected_adj[1]);
+        EXPECT_DOUBLE_EQ(w3.get_adj(), expected_adj[2]);
+        EXPECT_DOUBLE_EQ(w4.get_adj(), expected_adj[3]);
+    }
+};
+
+TEST_F(bind_cse_fixture, bind_cse_scalar) 
+{
+    auto make_expr = [&]() {
+        return ad::sin(w1) * ad::sin(w1) + ad::exp(ad::sin(w1)) * (w2 + 1.) / (w2 + 1.);
+    };
+    test_cse(make_expr);
+
+    CacheArena arena;
+    ad::bind(make_expr(), arena);
+    size_t bytes = arena.bytes_in_use();
+    arena.reset();
+    ad::bind(make_expr(), arena, ad::cse);
+    // 2 copies of sin(w1) and 1 copy of w2 + 1 are eliminated
+    EXPECT_LT(arena.bytes_in_use(), bytes);
+}
+
+TEST_F(bind_cse_fixture, bind_cse_vec) 
+{
+    test_cse([&]() {
+        return ad::sum(ad::sin(v * w1) * ad::sin(v * w1)) + 
+               ad::norm(ad::sin(v * w1)) * ad::sum(ad::exp(v) - ad::exp(v));
+    });
+}
+
+TEST_F(bind_cse_fixture, bind_cse_interleaved) 
+{
+    test_cse([&]() {
+        return ad::sum(ad::sin(v * w1) * ad::sin(v * w1)) + 
+               ad::cos(w2) * ad::cos(w2);
+    }, layout::interleaved());
+}
+
+// the root of a placeholder expression views the placeholder,
+// and may itself be a common subexpression.
+TEST_F(bind_cse_fixture, bind_cse_placeholder) 
+{
+    test_cse([&]() {
+        return (w3 = ad::sin(w1) * w2,
+                w4 = ad::sin(w1) * w2,
+                ad::sin(w1) * w2 + w3 * w4);
+    });
+}
+
+// expressions reading a variable are not shared across writes to the variable
+TEST_F(bind_cse_fixture, bind_cse_invalidate) 
+{
+    test_cse([&]() {
+        return (w3 = ad::sin(w1) * w2,
+                w1 += w2,
+                w4 = ad::sin(w1) * w2,
+                w3 * w4);
+    });
+    test_cse([&]() {
+        return (w3 = w1 * w2,
+                w4 = ad::exp(w3),
+                w3 = w2 * w2,
+                ad::exp(w3) * w4);
+    });
+}
+
+// expressions inside a branch are not always evaluated and are never shared
+// leaves shared by common subexpressions are still registered once
+TEST_F(bind_cse_fixture, bind_cse_gradient) 
+{
+    auto expr_bind = ad::bind(ad::sum(ad::sin(v * w1) * ad::sin(v * w1)) + w2, ad::cse);
+    ad::autodiff(expr_bind);
+    auto grad = expr_bind.gradient();
+    EXPECT_EQ(grad.size(), static_cast<long>(vec_size + 2));
+    ad::autodiff(expr_bind, ad::fresh);
+    EXPECT_TRUE(grad.isApprox(expr_bind.gradient()));
+}
+
+TEST_F(bind_cse_fixture, bind_cse_if_else) 
+{
+    test_cse([&]() {
+        return (w3 = ad::if_else(w1 < w2, ad::cos(w1), ad::sin(w1)),
+                w3 + ad::sin(w1));
+    });
+    test_cse([&]() {
+        return (w3 = ad::sin(w1),
+                w4 = ad::if_else(w1 < w2, ad::sin(w1), ad::cos(w1)),
+                w3 * w4);
+    });
+}
+
 } // namespace ad
@@ -0,0 +1,90 @@
+#include <testutil/base_fixture.hpp>
+#include <fastad_bits/reverse/core/cholesky.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+
+namespace ad {
+namespace core {
+
+struct cholesky_fixture : base_fixture
+{
+protected:
+    using cholesky_t = CholeskyNode<mat_expr_view_t>;
+
+    Eigen::ArrayXXd seed;
+    cholesky_t cholesky;
+
+    cholesky_fixture()
+        : base_fixture(5, 4, 4)
+        , seed(4, 4)
+        , cholesky{mat_expr}
+    {
+        seed << 2.34, -3.2, 3.4, 1.23455,
+                0.1, 0.5, -1.2, 2.,
+                -0.3, 1.1, 0.7, -2.2,
+                1.5, 0.2, -0.9, 0.4;
+
+        mat_expr.get() << 8, 3, 1, 5,
+                          3, 5, 1, 3,
+                          1, 1, 1, 0,
+                          5, 3, 0, 7;
+
+        this->bind(cholesky);
+    }
+
+    // <seed, L(a)>, where only the lower triangle of seed matters
+    value_t f(const Eigen::MatrixXd& a) const
+    {
+        Eigen::MatrixXd L = a.llt().matrixL();
+        return (seed * L.array()).sum();
+    }
+};
+
+TEST_F(cholesky_fixture, cholesky_feval)
+{
+    Eigen::MatrixXd actual = mat_expr.get().llt().matrixL();
+    check_near(cholesky.feval(), actual, 1e-14);
+}
+
+// The adjoint is symmetric, so a symmetric perturbation of
+// a(i,j) and a(j,i) by h/2 each changes f by h * adj(i,j).
+TEST_F(cholesky_fixture, cholesky_beval)
+{
+    cholesky.feval();
+    cholesky.beval(seed);
+
+    Eigen::MatrixXd a = mat_expr.get();
+    const value_t h = 1e-6;
+    for (int i = 0; i < a.rows(); ++i) {
+        for (int j = 0; j < a.cols(); ++j) {
+            Eigen::MatrixXd e = Eigen::MatrixXd::Zero(a.rows(), a.cols());
+            e(i,j) += 0.5;
+            e(j,i) += 0.5;
+            value_t fd = (f(a + h * e) - f(a - h * e)) / (2 * h);
+            EXPECT_NEAR(mat_expr.get_adj()(i,j), fd, 1e-7);
+        }
+    }
+}
+
+TEST_F(cholesky_fixture, cholesky_not_pos_def)
+{
+    mat_expr.get()(0,0) = -1;
+    auto& L = cholesky.feval();
+    EXPECT_TRUE(L.array().isNaN().all());
+    cholesky.beval(seed);
+    check_eq(mat_expr.get_adj(), Eigen::MatrixXd::Zero(4, 4));
+}
+
+TEST_F(cholesky_fixture, cholesky_const)
+{
+    auto x = ad::constant(mat_expr.get());
+    Eigen::MatrixXd actual = x.get().llt().matrixL();
+    auto res = ad::cholesky(x);
+    static_assert(std::is_same_v<
+            std::decay_t<decltype(res)>,
+            Constant<value_t, mat>
+            >);
+    check_near(res.get(), actual, 1e-14);
+}
+
+} // namespace core
+} // namespace ad
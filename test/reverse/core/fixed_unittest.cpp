@@ -0,0 +1,139 @@
+#include "gtest/gtest.h"
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/cholesky.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/det.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/inverse.hpp>
+#include <fastad_bits/reverse/core/log_det.hpp>
+#include <fastad_bits/reverse/core/pow.hpp>
+#include <fastad_bits/reverse/core/solve.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/trace.hpp>
+#include <fastad_bits/reverse/core/transpose.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/stat/wishart.hpp>
+
+namespace ad {
+namespace core {
+
+struct fixed_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+    using fvec_t = Var<value_t, fixed_vec<3>>;
+    using fmat_t = Var<value_t, fixed_mat<3, 3>>;
+
+    fvec_t x;
+    fmat_t a;
+    Var<value_t, vec> ex;
+    Var<value_t, mat> ea;
+
+    fixed_fixture()
+        : ex(3), ea(3, 3)
+    {
+        x.get() << 0.3, -1.2, 2.;
+        a.get() << 2, 0.5, 0.1,
+                   0.5, 3, 0.2,
+                   0.1, 0.2, 4;
+        ex.get() = x.get();
+        ea.get() = a.get();
+    }
+
+    template <class F>
+    void check(F f)
+    {
+        auto expr = ad::bind(f(x, a));
+        auto expected = ad::bind(f(ex, ea));
+        EXPECT_NEAR(ad::autodiff(expr), ad::autodiff(expected), 1e-12);
+        for (size_t i = 0; i < 3; ++i) {
+            EXPECT_NEAR(x.get_adj(i, 0), ex.get_adj(i, 0), 1e-12);
+            for (size_t j = 0; j < 3; ++j) {
+                EXPECT_NEAR(a.get_adj(i, j), ea.get_adj(i, j), 1e-12);
+            }
+        }
+    }
+};
+
+// Nodes on fixed-size shapes keep the compile-time extents.
+TEST_F(fixed_fixture, shapes)
+{
+    using fvec_shape_t = fixed_vec<3>;
+    auto unary = ad::sin(x) * x + 2.;
+    static_assert(std::is_same_v<decltype(unary)::shape_t, fvec_shape_t>);
+    static_assert(std::is_same_v<decltype(unary)::var_t,
+                  Eigen::Map<Eigen::Matrix<value_t, 3, 1>>>);
+
+    auto prod = ad::dot(a, x);
+    static_assert(std::is_same_v<decltype(prod)::shape_t, fvec_shape_t>);
+    auto mat_prod = ad::dot(a, a);
+    static_assert(std::is_same_v<decltype(mat_prod)::shape_t, fixed_mat<3, 3>>);
+
+    // mixing with dynamic shapes falls back to dynamic shapes
+    auto mixed = x + ex;
+    static_assert(std::is_same_v<decltype(mixed)::shape_t, vec>);
+    auto dyn_prod = ad::dot(ea, x);
+    static_assert(std::is_same_v<decltype(dyn_prod)::shape_t, vec>);
+
+    // fixed-size Eigen objects become fixed-size constants
+    Eigen::Vector3d c(1, 2, 3);
+    Eigen::Matrix3d m = Eigen::Matrix3d::Identity();
+    static_assert(std::is_same_v<decltype(ad::constant(c)),
+                  Constant<value_t, fvec_shape_t>>);
+    static_assert(std::is_same_v<decltype(ad::constant(m)),
+                  Constant<value_t, fixed_mat<3, 3>>>);
+    static_assert(std::is_same_v<decltype(x * c)::shape_t, fvec_shape_t>);
+}
+
+TEST_F(fixed_fixture, bind_cache_size)
+{
+    auto expr = ad::sum(ad::dot(a, x) * x);
+    auto expected = ad::sum(ad::dot(ea, ex) * ex);
+    EXPECT_EQ(expr.bind_cache_size()(0), expected.bind_cache_size()(0));
+    EXPECT_EQ(expr.bind_cache_size()(1), expected.bind_cache_size()(1));
+}
+
+TEST_F(fixed_fixture, elementwise)
+{
+    check([](auto& x, auto&) {
+        return ad::sum(ad::exp(x) * ad::pow<2>(x) - x / 2.);
+    });
+}
+
+TEST_F(fixed_fixture, dot)
+{
+    check([](auto& x, auto& a) {
+        return ad::sum(ad::dot(a, x) * x) + ad::sum(ad::dot(a, a));
+    });
+}
+
+TEST_F(fixed_fixture, det)
+{
+    check([](auto&, auto& a) { return ad::det(a); });
+    check([](auto&, auto& a) { return ad::det<DetLLT>(a); });
+    check([](auto&, auto& a) { return ad::log_det<LogDetLDLT>(a); });
+    check([](auto&, auto& a) { return ad::log_det<LogDetLLT>(a); });
+}
+
+TEST_F(fixed_fixture, linalg)
+{
+    check([](auto& x, auto& a) {
+        return ad::sum(ad::solve(a, x) * x) + 
+               ad::sum(ad::solve<SolveLLT>(ad::transpose(a), x));
+    });
+    check([](auto&, auto& a) {
+        return ad::trace(ad::dot(ad::inverse<SolveLDLT>(a), ad::cholesky(a)));
+    });
+}
+
+TEST_F(fixed_fixture, wishart)
+{
+    Eigen::Matrix3d v = Eigen::Matrix3d::Identity() * 2.;
+    check([&](auto&, auto& a) { return ad::wishart_adj_log_pdf(a, v, 5.); });
+}
+
+} // namespace core
+} // namespace ad
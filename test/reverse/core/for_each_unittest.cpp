@@ -3,6 +3,11 @@
 #include <fastad_bits/reverse/core/eq.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
 #include <fastad_bits/reverse/core/for_each.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <numeric>
 
 namespace ad {
 namespace core {
@@ -42,5 +47,120 @@ TEST_F(for_each_fixture, scl_beval)
     EXPECT_DOUBLE_EQ(scl_expr.get_adj(), seed);
 }
 
+////////////////////////////////////////////////////////////
+// Checkpointed for-each
+////////////////////////////////////////////////////////////
+
+struct checkpoint_for_each_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+
+    size_t n_steps = 10;
+    Var<value_t> x;
+    std::vector<Var<value_t>> w;
+    std::vector<size_t> steps;
+
+    checkpoint_for_each_fixture()
+        : x(0.7)
+        , w(n_steps + 1)
+        , steps(n_steps)
+    {
+        w[0].get() = 0.3;
+        std::iota(steps.begin(), steps.end(), 0);
+    }
+
+    // time-step w[i+1] = w[i] + 0.1 * sin(w[i] * x) * exp(-w[i])
+    auto step()
+    {
+        return [&](size_t i) {
+            return w[i+1] = w[i] + 0.1 * ad::sin(w[i] * x) * ad::exp(-w[i]);
+        };
+    }
+
+    void reset_adj()
+    {
+        x.reset_adj();
+        for (auto& wi : w) wi.reset_adj();
+    }
+
+    // returns (value, dx, dw0) using regular for_each
+    std::array<value_t, 3> expected()
+    {
+        auto expr = ad::bind(ad::for_each(steps.begin(), steps.end(), step()));
+        reset_adj();
+        value_t f = ad::autodiff(expr);
+        std::array<value_t, 3> out = {f, x.get_adj(), w[0].get_adj()};
+        reset_adj();
+        return out;
+    }
+
+    template <class ExprType>
+    void check(ExprType& expr)
+    {
+        auto exp = expected();
+        reset_adj();
+        value_t f = ad::autodiff(expr);
+        EXPECT_DOUBLE_EQ(f, exp[0]);
+        EXPECT_DOUBLE_EQ(x.get_adj(), exp[1]);
+        EXPECT_DOUBLE_EQ(w[0].get_adj(), exp[2]);
+    }
+};
+
+TEST_F(checkpoint_for_each_fixture, strides)
+{
+    for (size_t stride : {1, 2, 3, 4, 9, 10, 11}) {
+        auto expr = ad::bind(
+                ad::checkpointed_for_each(steps.begin(), steps.end(), step(), stride));
+        check(expr);
+    }
+}
+
+TEST_F(checkpoint_for_each_fixture, bind_cache_size)
+{
+    auto full = ad::for_each(steps.begin(), steps.end(), step());
+    auto step_size = full.bind_cache_size() / n_steps;
+    for (size_t stride : {1, 3, 10, 20}) {
+        auto expr = ad::checkpointed_for_each(steps.begin(), steps.end(), step(), stride);
+        util::SizePack expected = 
+            step_size * std::min(stride, n_steps) + util::SizePack(1, 0);
+        EXPECT_EQ(expr.bind_cache_size()(0), expected(0));
+        EXPECT_EQ(expr.bind_cache_size()(1), expected(1));
+        EXPECT_EQ(expr.stride(), stride);
+    }
+}
+
+TEST_F(checkpoint_for_each_fixture, interleaved)
+{
+    auto expr = ad::bind<layout::interleaved>(
+            ad::checkpointed_for_each(steps.begin(), steps.end(), step(), 3));
+    check(expr);
+}
+
+TEST_F(checkpoint_for_each_fixture, repeated_beval)
+{
+    auto expr = ad::bind(
+            ad::checkpointed_for_each(steps.begin(), steps.end(), step(), 4));
+    auto exp = expected();
+    reset_adj();
+    value_t f = ad::evaluate(expr);
+    EXPECT_DOUBLE_EQ(f, exp[0]);
+    for (int k = 0; k < 2; ++k) {
+        ad::evaluate_adj(expr);
+        EXPECT_DOUBLE_EQ(x.get_adj(), exp[1]);
+        EXPECT_DOUBLE_EQ(w[0].get_adj(), exp[2]);
+        // value is not clobbered by recomputation
+        EXPECT_DOUBLE_EQ(expr.get().get(), exp[0]);
+        reset_adj();
+    }
+}
+
+TEST_F(checkpoint_for_each_fixture, empty)
+{
+    auto expr = ad::checkpointed_for_each(steps.begin(), steps.begin(), step(), 3);
+    EXPECT_EQ(expr.bind_cache_size()(0), 0ul);
+    EXPECT_EQ(expr.bind_cache_size()(1), 0ul);
+}
+
 } // namespace core
 } // namespace ad
@@ -0,0 +1,194 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/fuse.hpp>
+#include <fastad_bits/reverse/core/if_else.hpp>
+#include <fastad_bits/reverse/core/pow.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+
+namespace ad {
+namespace core {
+
+struct fuse_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+    using vec_t = Var<value_t, vec>;
+    using mat_t = Var<value_t, mat>;
+
+    // not a multiple of the block size
+    size_t n = 301;
+    vec_t x, ex;
+    Var<value_t> mu, sigma, emu, esigma;
+    Eigen::VectorXd c;
+
+    fuse_fixture()
+        : x(n), ex(n)
+        , mu(0.3), sigma(1.7), emu(0.3), esigma(1.7)
+        , c(n)
+    {
+        for (size_t i = 0; i < n; ++i) {
+            x.get(i, 0) = ex.get(i, 0) = std::sin(0.37 * i);
+            c(i) = 0.01 * i;
+        }
+    }
+
+    template <class XType, class MuType, class SigmaType>
+    auto kernel(const XType& x, const MuType& mu, const SigmaType& sigma) const
+    {
+        return ad::exp(-0.5 * ad::pow<2>((x - mu) / sigma)) * ad::constant(c) +
+                ad::sin(x) * x - ad::pow<-1>(sigma) * mu;
+    }
+
+    // adjoints of leaves read more than once are accumulated in a different order
+    void check_adjoints(value_t tol = 1e-14) const
+    {
+        EXPECT_NEAR(mu.get_adj(), emu.get_adj(), tol * (1. + std::abs(emu.get_adj())));
+        EXPECT_NEAR(sigma.get_adj(), esigma.get_adj(),
+                    tol * (1. + std::abs(esigma.get_adj())));
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_NEAR(x.get_adj(i, 0), ex.get_adj(i, 0),
+                        tol * (1. + std::abs(ex.get_adj(i, 0))));
+        }
+    }
+};
+
+TEST_F(fuse_fixture, matches_unfused)
+{
+    auto expr = ad::bind(ad::sum(ad::fuse(kernel(x, mu, sigma))));
+    auto expected = ad::bind(ad::sum(kernel(ex, emu, esigma)));
+    value_t f = ad::autodiff(expr);
+    value_t ef = ad::autodiff(expected);
+    EXPECT_NEAR(f, ef, 1e-14 * std::abs(ef));
+    check_adjoints();
+
+    // second evaluation accumulates the adjoints again
+    ad::autodiff(expr);
+    ad::autodiff(expected);
+    check_adjoints();
+}
+
+TEST_F(fuse_fixture, values)
+{
+    auto expr = ad::fuse(kernel(x, mu, sigma));
+    auto expected = kernel(ex, emu, esigma);
+    auto b = ad::bind(expr);
+    auto eb = ad::bind(expected);
+    ad::evaluate(b);
+    ad::evaluate(eb);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_DOUBLE_EQ(b.get().get()(i), eb.get().get()(i));
+    }
+}
+
+// Only the root caches its value and adjoint.
+TEST_F(fuse_fixture, bind_cache_size)
+{
+    auto expr = ad::fuse(kernel(x, mu, sigma));
+    auto unfused = kernel(x, mu, sigma);
+    EXPECT_EQ(expr.bind_cache_size()(0), n);
+    EXPECT_EQ(expr.bind_cache_size()(1), n);
+    EXPECT_GT(unfused.bind_cache_size()(0), 5 * n);
+}
+
+TEST_F(fuse_fixture, mat)
+{
+    mat_t m(7, 40), em(7, 40);
+    for (size_t j = 0; j < 40; ++j) {
+        for (size_t i = 0; i < 7; ++i) {
+            m.get(i, j) = em.get(i, j) = std::cos(0.1 * i + 0.3 * j);
+        }
+    }
+    auto expr = ad::bind(ad::sum(ad::fuse(ad::log(m * m + mu) * sigma)));
+    auto expected = ad::bind(ad::sum(ad::log(em * em + emu) * esigma));
+    EXPECT_NEAR(ad::autodiff(expr), ad::autodiff(expected), 1e-12);
+    EXPECT_NEAR(mu.get_adj(), emu.get_adj(), 1e-12);
+    EXPECT_NEAR(sigma.get_adj(), esigma.get_adj(), 1e-12);
+    for (size_t j = 0; j < 40; ++j) {
+        for (size_t i = 0; i < 7; ++i) {
+            EXPECT_DOUBLE_EQ(m.get_adj(i, j), em.get_adj(i, j));
+        }
+    }
+}
+
+// Fused node inside a larger expression, reading a leaf also read outside of it.
+TEST_F(fuse_fixture, subexpression)
+{
+    auto expr = ad::bind(ad::sum(ad::fuse(kernel(x, mu, sigma)) * x) * mu);
+    auto expected = ad::bind(ad::sum(kernel(ex, emu, esigma) * ex) * emu);
+    EXPECT_NEAR(ad::autodiff(expr), ad::autodiff(expected), 1e-12);
+    check_adjoints(1e-12);
+}
+
+TEST_F(fuse_fixture, interleaved)
+{
+    auto expr = ad::bind<layout::interleaved>(ad::sum(ad::fuse(kernel(x, mu, sigma))));
+    auto expected = ad::bind(ad::sum(kernel(ex, emu, esigma)));
+    EXPECT_NEAR(ad::autodiff(expr), ad::autodiff(expected), 1e-12);
+    check_adjoints();
+}
+
+// The fusable subtree sits under a node that is not fuse-aware.
+TEST_F(fuse_fixture, under_sum)
+{
+    auto expr = ad::fuse(ad::sum(ad::exp(-0.5 * ad::pow<2>((x - mu) / sigma))));
+    auto expected = ad::sum(ad::exp(-0.5 * ad::pow<2>((ex - emu) / esigma)));
+    // only the root of the argument of sum caches values
+    EXPECT_EQ(expr.bind_cache_size()(0), n + 1);
+    auto b = ad::bind(expr);
+    auto eb = ad::bind(expected);
+    EXPECT_NEAR(ad::autodiff(b), ad::autodiff(eb), 1e-12);
+    check_adjoints(1e-12);
+}
+
+TEST_F(fuse_fixture, under_dot)
+{
+    Eigen::MatrixXd a(3, n);
+    for (size_t j = 0; j < n; ++j) {
+        for (size_t i = 0; i < 3; ++i) {
+            a(i, j) = std::cos(0.2 * i + 0.01 * j);
+        }
+    }
+    auto expr = ad::bind(ad::sum(ad::fuse(
+                    ad::dot(ad::constant(a), kernel(x, mu, sigma)) * mu)));
+    auto expected = ad::bind(ad::sum(
+                    ad::dot(ad::constant(a), kernel(ex, emu, esigma)) * emu));
+    EXPECT_NEAR(ad::autodiff(expr), ad::autodiff(expected), 1e-12);
+    check_adjoints(1e-12);
+}
+
+TEST_F(fuse_fixture, under_if_else)
+{
+    auto expr = ad::bind(ad::fuse(ad::if_else(
+                    mu < sigma,
+                    ad::sum(kernel(x, mu, sigma)),
+                    ad::sum(ad::sin(x) * sigma))));
+    auto expected = ad::bind(ad::if_else(
+                    emu < esigma,
+                    ad::sum(kernel(ex, emu, esigma)),
+                    ad::sum(ad::sin(ex) * esigma)));
+    EXPECT_NEAR(ad::autodiff(expr), ad::autodiff(expected), 1e-12);
+    check_adjoints(1e-12);
+}
+
+// Expressions with no element-wise subtree on vectors or matrices are not fusable.
+TEST_F(fuse_fixture, not_fusable)
+{
+    auto scl = ad::sin(mu) * sigma;
+    static_assert(!is_fusable_v<decltype(scl)>);
+    auto cst = ad::constant(c) * 2.;
+    static_assert(!is_fusable_v<decltype(cst)>);
+    auto leaf = ad::sum(x) * mu;
+    static_assert(!is_fusable_v<decltype(leaf)>);
+    auto red = ad::sum(x) * ad::sin(x);
+    static_assert(is_fusable_v<decltype(red)>);
+}
+
+} // namespace core
+} // namespace ad
@@ -1,31 +1,47 @@
 #define _USE_MATH_DEFINES
-#include <fastad_bits/reverse/core/math.hpp>
-#include <fastad_bits/reverse/core/hessian.hpp>
 #include "gtest/gtest.h"
+#include <cmath>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/hessian.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
 
 namespace ad {
+namespace core {
 
-auto F_lmda = [](const auto& x, const auto&) {
+auto F_lmda = [](auto& x, auto&) {
     return ad::sin(x[0]) * ad::exp(x[0]) - x[0] + ad::tan(x[0]);
 };
 
-auto G_lmda = [](const auto& x, const auto&) {
+auto G_lmda = [](auto& x, auto&) {
     return ad::sin(x[0]) * ad::cos(x[1]);
 };
 
-auto H_lmda = [](const auto& x, const auto&) {
+auto H_lmda = [](auto& x, auto&) {
     return ad::sin(x[0]) + x[0] * x[0] + x[1] * x[1] + ad::cos(x[2] * x[3]);
 };
 
+// uses placeholders, constants, division, and erf
+auto K_lmda = [](auto& x, auto& w) {
+    w.resize(2);
+    return (w[0] = x[0] * x[1] / (1. + x[2] * x[2]),
+            w[1] = ad::erf(w[0]) + 2. * ad::sqrt(x[1]),
+            w[0] * w[1] + ad::log(x[2]));
+};
+
 struct hessian_fixture: ::testing::Test
 {
 protected:
+    using value_t = double;
+    using vec_t = Eigen::Matrix<value_t, Eigen::Dynamic, 1>;
+    using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
 
-    // Test functions
     // WOLFRAM-ALPHA HARD-CODED NUMBERS
-    // Test Hessian of a H_lmda
+    // Test Hessian of H_lmda
     template <class Mat>
-    void h_hess_test(Mat const& mat)
+    void h_hess_test(const Mat& mat)
     {
         EXPECT_NEAR(mat(0, 0), 1.15853, 1e-5);
         for (int i = 0; i < 2; ++i)
@@ -37,49 +53,49 @@ protected:
         EXPECT_NEAR(mat(3, 3), -7.59469, 1e-5);
     }
 
-    // Test gradient of a H_lmda computed while computing hessian
-    template <class Mat>
-    void h_grad_test(Mat const& mat)
+    // Test gradient of H_lmda computed while computing hessian
+    template <class Vec>
+    void h_grad_test(const Vec& vec)
     {
-        EXPECT_NEAR(mat(0, 0), 2.5403, 1e-4);
-        EXPECT_NEAR(mat(0, 1), 4, 1e-1);
-        EXPECT_NEAR(mat(0, 2), 2.14629, 1e-5);
-        EXPECT_NEAR(mat(0, 3), 1.60972, 1e-5);
+        EXPECT_NEAR(vec(0), 2.5403, 1e-4);
+        EXPECT_NEAR(vec(1), 4, 1e-1);
+        EXPECT_NEAR(vec(2), 2.14629, 1e-5);
+        EXPECT_NEAR(vec(3), 1.60972, 1e-5);
     }
-
 };
 
-// Hessian (second derivative) of a univariate function
-// Verify that algorithm approach is correct
-TEST_F(hessian_fixture, one_dimensional) {
-    using T = double;
-    Vec<ForwardVar<T>> x = {{2.1}};
-    x[0].get_value().set_adjoint(1);
-    auto gen = make_exgen<ForwardVar<T>>(F_lmda);
-    auto expr = std::get<0>(gen.generate(x));
-    autodiff(expr);
-
-    T value = x[0].get_value().get_value(); // get forward variable value
-    double deriv = 
+// Nested evaluation of a reverse-mode expression of forward variables.
+// Verify that algorithm approach is correct.
+TEST_F(hessian_fixture, one_dimensional)
+{
+    std::vector<Var<ForwardVar<value_t>>> x(1);
+    std::vector<Var<ForwardVar<value_t>>> w;
+    x[0].get() = ForwardVar<value_t>(2.1, 1);
+    auto expr = ad::bind(F_lmda(x, w));
+    ForwardVar<value_t> f = ad::autodiff(expr);
+
+    value_t value = 2.1;
+    value_t deriv =
         (std::cos(value) + std::sin(value)) *
-        std::exp(value) - 
+        std::exp(value) -
         1 + 1 / (std::cos(value) * std::cos(value));
-    double hessian = 
-        2 * (std::cos(value)*std::exp(value) + 
-        std::sin(value) / 
+    value_t hessian =
+        2 * (std::cos(value)*std::exp(value) +
+        std::sin(value) /
         (std::cos(value) * std::cos(value) * std::cos(value)));
-    double deriv_test = expr.get_value().get_adjoint();
-    double hessian_test = x[0].get_adjoint().get_adjoint();
-    EXPECT_DOUBLE_EQ(deriv_test, deriv);
-    EXPECT_DOUBLE_EQ(hessian_test, hessian);
+    EXPECT_DOUBLE_EQ(f.get_adjoint(), deriv);
+    EXPECT_DOUBLE_EQ(x[0].get_adj().get_value(), deriv);
+    EXPECT_DOUBLE_EQ(x[0].get_adj().get_adjoint(), hessian);
 }
 
 // Hessian of a bivariate function
-TEST_F(hessian_fixture, two_dimensional) {
-    using T = double;
-    T x[] = { M_PI / 3 , M_PI / 6 };
-    Mat<T> hess;
-    hessian(hess, x, x + 2, G_lmda);
+TEST_F(hessian_fixture, two_dimensional)
+{
+    vec_t x(2);
+    x << M_PI / 3, M_PI / 6;
+    mat_t hess(2, 2);
+    value_t f = ad::hessian(G_lmda, x, hess);
+    EXPECT_DOUBLE_EQ(f, std::sin(x(0)) * std::cos(x(1)));
     EXPECT_DOUBLE_EQ(hess(0, 0), -0.75);
     EXPECT_DOUBLE_EQ(hess(1, 1), -0.75);
     EXPECT_DOUBLE_EQ(hess(0, 1), -0.25);
@@ -87,15 +103,123 @@ TEST_F(hessian_fixture, two_dimensional) {
 }
 
 // Hessian multivariate
-TEST_F(hessian_fixture, multi_dimensional) {
-    using T = double;
+TEST_F(hessian_fixture, multi_dimensional)
+{
     // DON'T CHANGE THESE NUMBERS
-    T x[] = { 1.,2.,3.,4. };
-    Mat<T> hess;
-    Mat<T> grad;
-    hessian(hess, grad, x, x + 4, H_lmda);
+    vec_t x(4);
+    x << 1., 2., 3., 4.;
+    mat_t hess(4, 4);
+    vec_t grad(4);
+    ad::hessian(H_lmda, x, hess, grad);
     h_hess_test(hess);
     h_grad_test(grad);
 }
 
+// Hessian is symmetric and agrees with finite differences of the gradient
+// even when the expression uses placeholders.
+TEST_F(hessian_fixture, placeholders)
+{
+    vec_t x(3);
+    x << 0.3, 1.7, 0.9;
+    mat_t hess(3, 3);
+    vec_t grad(3);
+    ad::hessian(K_lmda, x, hess, grad);
+
+    auto gradient = [](const vec_t& x) {
+        vec_t H_unused(3);
+        vec_t grad(3);
+        ad::hessian_vector(K_lmda, x, vec_t::Zero(3), H_unused, grad);
+        return grad;
+    };
+
+    const value_t h = 1e-6;
+    for (int j = 0; j < 3; ++j) {
+        vec_t xp = x; xp(j) += h;
+        vec_t xm = x; xm(j) -= h;
+        vec_t fd = (gradient(xp) - gradient(xm)) / (2 * h);
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_NEAR(hess(i, j), fd(i), 1e-6);
+            EXPECT_NEAR(hess(i, j), hess(j, i), 1e-12);
+        }
+    }
+    vec_t expected = gradient(x);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_DOUBLE_EQ(grad(i), expected(i));
+    }
+}
+
+// Hessian-vector product agrees with the full Hessian
+TEST_F(hessian_fixture, hessian_vector)
+{
+    vec_t x(4);
+    x << 1., 2., 3., 4.;
+    vec_t v(4);
+    v << 0.5, -1., 2., 0.25;
+    mat_t hess(4, 4);
+    vec_t Hv(4);
+    vec_t grad(4);
+    ad::hessian(H_lmda, x, hess);
+    value_t f = ad::hessian_vector(H_lmda, x, v, Hv, grad);
+
+    EXPECT_DOUBLE_EQ(f, std::sin(1.) + 1. + 4. + std::cos(12.));
+    h_grad_test(grad);
+    vec_t expected = hess * v;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_NEAR(Hv(i), expected(i), 1e-12);
+    }
+}
+
+// A bound expression computes several products at the same point
+TEST_F(hessian_fixture, hessian_vector_bound)
+{
+    vec_t x(3);
+    x << 0.3, 1.7, 0.9;
+    mat_t hess(3, 3);
+    vec_t grad(3);
+    value_t f = ad::hessian(K_lmda, x, hess, grad);
+
+    std::vector<Var<ForwardVar<value_t>>> xv(3);
+    std::vector<Var<ForwardVar<value_t>>> w;
+    auto expr = ad::bind(K_lmda(xv, w));
+
+    vec_t v(3), Hv(3), g(3);
+    for (int j = 0; j < 3; ++j) {
+        v.setZero();
+        v(j) = 1;
+        EXPECT_DOUBLE_EQ(ad::hessian_vector(expr, xv, w, x, v, Hv, g), f);
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_DOUBLE_EQ(Hv(i), hess(i, j));
+            EXPECT_DOUBLE_EQ(g(i), grad(i));
+        }
+    }
+
+    v << 0.5, -1., 2.;
+    ad::hessian_vector(expr, xv, w, x, v, Hv);
+    vec_t expected = hess * v;
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_NEAR(Hv(i), expected(i), 1e-12);
+    }
+}
+
+// Vector-shaped variables of forward variables
+TEST_F(hessian_fixture, vec_var)
+{
+    Var<ForwardVar<value_t>, vec> x(3);
+    x.get() << ForwardVar<value_t>(0.1, 1),
+               ForwardVar<value_t>(0.2, 0),
+               ForwardVar<value_t>(0.3, 0);
+    auto expr = ad::bind(ad::sum(ad::sin(x) * x));
+    ad::autodiff(expr);
+
+    // d/dx_i = cos(x_i) x_i + sin(x_i), d^2/dx_i^2 = 2cos(x_i) - x_i sin(x_i)
+    for (size_t i = 0; i < 3; ++i) {
+        value_t xi = x.get(i, 0).get_value();
+        EXPECT_DOUBLE_EQ(x.get_adj(i, 0).get_value(),
+                         std::cos(xi) * xi + std::sin(xi));
+        EXPECT_DOUBLE_EQ(x.get_adj(i, 0).get_adjoint(),
+                         (i == 0) ? 2 * std::cos(xi) - xi * std::sin(xi) : 0.);
+    }
+}
+
+} // namespace core
 } // namespace ad
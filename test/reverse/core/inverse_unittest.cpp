@@ -0,0 +1,114 @@
+#include <testutil/base_fixture.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/inverse.hpp>
+
+namespace ad {
+namespace core {
+
+struct inverse_fixture : base_fixture
+{
+protected:
+    using inverse_plu_t = InverseNode<SolvePartialPivLU<value_t>, mat_expr_view_t>;
+    using inverse_ldlt_t = InverseNode<SolveLDLT<value_t>, mat_expr_view_t>;
+    using inverse_llt_t = InverseNode<SolveLLT<value_t>, mat_expr_view_t>;
+
+    Eigen::ArrayXXd seed;
+    inverse_plu_t inverse_plu;
+    inverse_ldlt_t inverse_ldlt;
+    inverse_llt_t inverse_llt;
+
+    inverse_fixture()
+        : base_fixture(5, 4, 4)
+        , seed(4, 4)
+        , inverse_plu{mat_expr}
+        , inverse_ldlt{mat_expr}
+        , inverse_llt{mat_expr}
+    {
+        seed << 2.34, -3.2, 3.4, 1.23455,
+                0.1, 0.5, -1.2, 2.,
+                -0.3, 1.1, 0.7, -2.2,
+                1.5, 0.2, -0.9, 0.4;
+
+        // note that all these expressions require the same
+        // cache sizes, so we may bind all of them to the same cache at once
+        // so long as only one expression gets evaluated in each test
+        this->bind(inverse_plu);
+        this->bind(inverse_ldlt);
+        this->bind(inverse_llt);
+    }
+
+    void init_plu()
+    {
+        mat_expr.get() << 2, 3, 1, 5,
+                          3, 5, -1, 3,
+                          -2, 3, 1, 0,
+                          -1, -1, 2, 7;
+    }
+
+    void init_ldlt()
+    {
+        init_llt();
+    }
+
+    void init_llt()
+    {
+        mat_expr.get() << 8, 3, 1, 5,
+                          3, 5, 1, 3,
+                          1, 1, 1, 0,
+                          5, 3, 0, 7;
+    }
+
+    template <class T>
+    void check_inverse(T& expr)
+    {
+        Eigen::MatrixXd inv = mat_expr.get().inverse();
+        Eigen::MatrixXd adj = -inv.transpose() * seed.matrix() * inv.transpose();
+
+        check_near(expr.feval(), inv, 1e-13);
+        expr.beval(seed);
+        check_near(mat_expr.get_adj(), adj, 1e-13);
+    }
+};
+
+TEST_F(inverse_fixture, inverse_plu)
+{
+    init_plu();
+    check_inverse(inverse_plu);
+}
+
+TEST_F(inverse_fixture, inverse_ldlt)
+{
+    init_ldlt();
+    check_inverse(inverse_ldlt);
+}
+
+TEST_F(inverse_fixture, inverse_llt)
+{
+    init_llt();
+    check_inverse(inverse_llt);
+}
+
+TEST_F(inverse_fixture, inverse_singular)
+{
+    mat_expr.get().setZero();
+    auto& inv = inverse_plu.feval();
+    EXPECT_TRUE(inv.array().isNaN().all());
+    inverse_plu.beval(seed);
+    check_eq(mat_expr.get_adj(), Eigen::MatrixXd::Zero(4, 4));
+}
+
+TEST_F(inverse_fixture, inverse_const)
+{
+    init_plu();
+    auto x = ad::constant(mat_expr.get());
+    Eigen::MatrixXd actual = x.get().inverse();
+    auto res = ad::inverse(x);
+    static_assert(std::is_same_v<
+            std::decay_t<decltype(res)>,
+            Constant<value_t, mat>
+            >);
+    check_near(res.get(), actual, 1e-13);
+}
+
+} // namespace core
+} // namespace ad
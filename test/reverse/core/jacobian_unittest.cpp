@@ -0,0 +1,230 @@
+#include "gtest/gtest.h"
+#include <testutil/base_fixture.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/jacobian.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+
+namespace ad {
+namespace core {
+
+struct jacobian_fixture : base_fixture
+{
+protected:
+    using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
+    mat_t J;
+};
+
+TEST_F(jacobian_fixture, scl)
+{
+    auto expr = ad::sum(ad::sin(vec_expr));
+    bind(expr);
+    J.resize(1, vec_size);
+    value_t res = jacobian(expr, vec_expr, J);
+    EXPECT_DOUBLE_EQ(res, vec_expr.get().array().sin().sum());
+    for (size_t j = 0; j < vec_size; ++j) {
+        EXPECT_DOUBLE_EQ(J(0, j), std::cos(vec_expr.get()(j)));
+        EXPECT_DOUBLE_EQ(vec_expr.get_adj(j, 0), 0.);
+    }
+}
+
+TEST_F(jacobian_fixture, vec_unary)
+{
+    auto expr = ad::exp(vec_expr) * vec_expr;
+    bind(expr);
+    J.resize(vec_size, vec_size);
+    auto res = jacobian(expr, vec_expr, J);
+    for (size_t i = 0; i < vec_size; ++i) {
+        value_t x = vec_expr.get()(i);
+        EXPECT_DOUBLE_EQ(res(i), std::exp(x) * x);
+        for (size_t j = 0; j < vec_size; ++j) {
+            EXPECT_DOUBLE_EQ(J(i, j), (i == j) ? std::exp(x) * (1 + x) : 0.);
+        }
+    }
+}
+
+TEST_F(jacobian_fixture, dot_wrt_vec)
+{
+    mat_t A = mat_t::Random(3, vec_size);
+    auto expr = ad::dot(A, vec_expr);
+    bind(expr);
+    J.resize(3, vec_size);
+    jacobian(expr, vec_expr, J);
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < vec_size; ++j) {
+            EXPECT_DOUBLE_EQ(J(i, j), A(i, j));
+        }
+    }
+}
+
+TEST_F(jacobian_fixture, dot_wrt_mat)
+{
+    Eigen::VectorXd b = Eigen::VectorXd::Random(mat_cols);
+    auto expr = ad::dot(mat_expr, b);
+    bind(expr);
+    J.resize(mat_rows, mat_size);
+    jacobian(expr, mat_expr, J);
+    for (size_t i = 0; i < mat_rows; ++i) {
+        for (size_t k = 0; k < mat_rows; ++k) {
+            for (size_t l = 0; l < mat_cols; ++l) {
+                EXPECT_DOUBLE_EQ(J(i, k + l * mat_rows), (i == k) ? b(l) : 0.);
+            }
+        }
+    }
+}
+
+TEST_F(jacobian_fixture, mat_output)
+{
+    auto expr = mat_expr * mat_expr;
+    bind(expr);
+    J.resize(mat_size, mat_size);
+    jacobian(expr, mat_expr, J);
+    for (size_t i = 0; i < mat_size; ++i) {
+        for (size_t j = 0; j < mat_size; ++j) {
+            EXPECT_DOUBLE_EQ(J(i, j), (i == j) ? 2 * mat_expr.get()(i) : 0.);
+        }
+    }
+}
+
+TEST_F(jacobian_fixture, expr_bind)
+{
+    mat_t A = mat_t::Random(4, vec_size);
+    auto expr = ad::bind(ad::dot(A, ad::sin(vec_expr)));
+    J.resize(4, vec_size);
+    jacobian(expr, vec_expr, J);
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < vec_size; ++j) {
+            EXPECT_DOUBLE_EQ(J(i, j), A(i, j) * std::cos(vec_expr.get()(j)));
+        }
+    }
+}
+
+// placeholder adjoints must not carry over from previous rows
+TEST_F(jacobian_fixture, placeholder)
+{
+    Var<value_t, vec> w(vec_size);
+    auto expr = (w = vec_expr * 3., w * w);
+    bind(expr);
+    J.resize(vec_size, vec_size);
+    jacobian(expr, vec_expr, J);
+    for (size_t i = 0; i < vec_size; ++i) {
+        value_t x = vec_expr.get()(i);
+        for (size_t j = 0; j < vec_size; ++j) {
+            EXPECT_DOUBLE_EQ(J(i, j), (i == j) ? 18 * x : 0.);
+        }
+        EXPECT_DOUBLE_EQ(w.get_adj(i, 0), 0.);
+    }
+}
+
+TEST_F(jacobian_fixture, placeholder_expr_bind)
+{
+    Var<value_t, vec> w(vec_size);
+    auto expr = ad::bind((w = ad::sin(vec_expr), w * w));
+    J.resize(vec_size, vec_size);
+    jacobian(expr, vec_expr, J);
+    for (size_t i = 0; i < vec_size; ++i) {
+        value_t x = vec_expr.get()(i);
+        for (size_t j = 0; j < vec_size; ++j) {
+            EXPECT_DOUBLE_EQ(J(i, j), (i == j) ? 2 * std::sin(x) * std::cos(x) : 0.);
+        }
+        EXPECT_DOUBLE_EQ(w.get_adj(i, 0), 0.);
+    }
+}
+
+// adjoints of leaves other than x must not carry over from previous rows
+TEST_F(jacobian_fixture, other_leaf)
+{
+    auto expr = vec_expr * vec_expr * scl_expr;
+    bind(expr);
+    J.resize(vec_size, vec_size);
+    jacobian(expr, vec_expr, J);
+    for (size_t i = 0; i < vec_size; ++i) {
+        value_t x = vec_expr.get()(i);
+        EXPECT_DOUBLE_EQ(J(i, i), 2 * x * scl_expr.get());
+    }
+    EXPECT_DOUBLE_EQ(scl_expr.get_adj(), 0.);
+}
+
+// 7 outputs with 4 lanes: one full and one partial backward evaluation
+TEST_F(jacobian_fixture, lanes_vec)
+{
+    constexpr size_t K = 4;
+    using pack_t = ad::simd<value_t, K>;
+    mat_t A = mat_t::Random(7, vec_size);
+    Eigen::Matrix<pack_t, Eigen::Dynamic, Eigen::Dynamic> Ap = A.cast<pack_t>();
+    Eigen::VectorXd x = vec_expr.get();
+    J.resize(7, vec_size);
+    auto res = jacobian<K>([&](auto& xv) {
+        return ad::dot(Ap, ad::sin(xv) * 2.);
+    }, x, J);
+    Eigen::VectorXd expected = A * (2. * x.array().sin()).matrix();
+    for (size_t i = 0; i < 7; ++i) {
+        EXPECT_DOUBLE_EQ(res(i), expected(i));
+        for (size_t j = 0; j < vec_size; ++j) {
+            EXPECT_DOUBLE_EQ(J(i, j), 2 * A(i, j) * std::cos(x(j)));
+        }
+    }
+}
+
+TEST_F(jacobian_fixture, lanes_scl)
+{
+    Eigen::VectorXd x = vec_expr.get();
+    J.resize(1, vec_size);
+    value_t res = jacobian([](auto& xv) {
+        return ad::sum(ad::exp(xv));
+    }, x, J);
+    EXPECT_DOUBLE_EQ(res, x.array().exp().sum());
+    for (size_t j = 0; j < vec_size; ++j) {
+        EXPECT_DOUBLE_EQ(J(0, j), std::exp(x(j)));
+    }
+}
+
+// placeholder adjoints must not carry over from previous backward evaluations
+TEST_F(jacobian_fixture, lanes_placeholder)
+{
+    constexpr size_t K = 2;
+    using pack_t = ad::simd<value_t, K>;
+    Var<pack_t, vec> w(vec_size);
+    Eigen::VectorXd x = vec_expr.get();
+    J.resize(vec_size, vec_size);
+    jacobian<K>([&](auto& xv) {
+        return (w = xv * 3., w * w);
+    }, x, J);
+    for (size_t i = 0; i < vec_size; ++i) {
+        for (size_t j = 0; j < vec_size; ++j) {
+            EXPECT_DOUBLE_EQ(J(i, j), (i == j) ? 18 * x(i) : 0.);
+        }
+    }
+}
+
+// lanes must agree with one backward evaluation per row
+TEST_F(jacobian_fixture, lanes_matches_rows)
+{
+    using pack_t = ad::simd<value_t, 4>;
+    mat_t A = mat_t::Random(5, vec_size);
+    Eigen::Matrix<pack_t, Eigen::Dynamic, Eigen::Dynamic> Ap = A.cast<pack_t>();
+    Eigen::VectorXd x = vec_expr.get();
+
+    mat_t J_lanes(5, vec_size);
+    jacobian([&](auto& xv) {
+        return ad::exp(ad::dot(Ap, xv * xv)) + xv(0) * xv(1);
+    }, x, J_lanes);
+
+    auto expr = ad::bind(ad::exp(ad::dot(A, vec_expr * vec_expr)) +
+                         vec_expr(0) * vec_expr(1));
+    J.resize(5, vec_size);
+    jacobian(expr, vec_expr, J);
+
+    for (size_t i = 0; i < 5; ++i) {
+        for (size_t j = 0; j < vec_size; ++j) {
+            EXPECT_DOUBLE_EQ(J_lanes(i, j), J(i, j));
+        }
+    }
+}
+
+} // namespace core
+} // namespace ad
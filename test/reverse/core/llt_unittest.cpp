@@ -0,0 +1,168 @@
+#include "gtest/gtest.h"
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/det.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/inverse.hpp>
+#include <fastad_bits/reverse/core/llt.hpp>
+#include <fastad_bits/reverse/core/log_det.hpp>
+#include <fastad_bits/reverse/core/solve.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/stat/normal.hpp>
+
+namespace ad {
+namespace core {
+
+struct llt_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+    using llt_t = LLTFactor<value_t>;
+
+    Var<value_t, vec> x;
+    Var<value_t, vec> mu;
+    Var<value_t, mat> sigma;
+    Var<value_t, vec> ex;
+    Var<value_t, vec> emu;
+    Var<value_t, mat> esigma;
+    Eigen::MatrixXd a;
+    Eigen::MatrixXd b;
+
+    llt_fixture()
+        : x(4), mu(4), sigma(4, 4)
+        , ex(4), emu(4), esigma(4, 4)
+        , a(4, 4), b(4, 4)
+    {
+        a << 8, 3, 1, 5,
+             3, 5, 1, 3,
+             1, 1, 1, 0,
+             5, 3, 0, 7;
+        b = a + Eigen::MatrixXd::Identity(4, 4);
+
+        x.get() << 0.3, -1.2, 2., 0.5;
+        mu.get() << 0.1, 0.2, -0.4, 1.;
+        sigma.get() = a;
+        ex.get() = x.get();
+        emu.get() = mu.get();
+        esigma.get() = a;
+    }
+
+    template <class T, class U>
+    void check(T& expr, U& expected)
+    {
+        EXPECT_NEAR(ad::autodiff(expr), ad::autodiff(expected), 1e-10);
+        for (size_t i = 0; i < 4; ++i) {
+            EXPECT_NEAR(x.get_adj(i, 0), ex.get_adj(i, 0), 1e-10);
+            EXPECT_NEAR(mu.get_adj(i, 0), emu.get_adj(i, 0), 1e-10);
+            for (size_t j = 0; j < 4; ++j) {
+                EXPECT_NEAR(sigma.get_adj(i, j), esigma.get_adj(i, j), 1e-10);
+            }
+        }
+    }
+};
+
+TEST_F(llt_fixture, factor)
+{
+    llt_t llt(4);
+    EXPECT_FALSE(llt.valid());
+    llt.compute(a);
+    EXPECT_TRUE(llt.valid());
+    EXPECT_NEAR(llt.det(), a.determinant(), 1e-10);
+    EXPECT_NEAR(llt.log_det(), std::log(a.determinant()), 1e-12);
+    Eigen::MatrixXd inv = a.inverse();
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            EXPECT_NEAR(llt.inverse()(i, j), inv(i, j), 1e-12);
+        }
+    }
+
+    // refactorizes only when the matrix changes
+    llt.compute(a);
+    EXPECT_NEAR(llt.log_det(), std::log(a.determinant()), 1e-12);
+    llt.compute(b);
+    EXPECT_NEAR(llt.log_det(), std::log(b.determinant()), 1e-12);
+    inv = b.inverse();
+    EXPECT_NEAR(llt.inverse()(1, 2), inv(1, 2), 1e-12);
+
+    Eigen::MatrixXd c = -a;
+    llt.compute(c);
+    EXPECT_FALSE(llt.valid());
+}
+
+TEST_F(llt_fixture, copies)
+{
+    // copies of a private factor are independent
+    llt_t llt(4);
+    llt.compute(a);
+    llt_t copy = llt;
+    copy.compute(b);
+    EXPECT_NEAR(llt.log_det(), std::log(a.determinant()), 1e-12);
+    EXPECT_NEAR(copy.log_det(), std::log(b.determinant()), 1e-12);
+
+    // copies of a shared factor share the factorization
+    auto shared = ad::shared_llt(sigma);
+    auto shared_copy = shared;
+    shared_copy.compute(a);
+    EXPECT_TRUE(shared.valid());
+    EXPECT_NEAR(shared.log_det(), std::log(a.determinant()), 1e-12);
+    shared.compute(b);
+    EXPECT_NEAR(shared_copy.log_det(), std::log(b.determinant()), 1e-12);
+}
+
+TEST_F(llt_fixture, shared)
+{
+    auto llt = ad::shared_llt(sigma);
+    auto expr = ad::bind(
+            ad::det(sigma, llt) +
+            ad::log_det(sigma, llt) +
+            ad::sum(ad::solve(sigma, x, llt)) +
+            ad::sum(ad::inverse(sigma, llt)) +
+            ad::normal_adj_log_pdf(x, mu, sigma, llt));
+    auto expected = ad::bind(
+            ad::det<DetLLT>(esigma) +
+            ad::log_det<LogDetLLT>(esigma) +
+            ad::sum(ad::solve<SolveLLT>(esigma, ex)) +
+            ad::sum(ad::inverse<SolveLLT>(esigma)) +
+            ad::normal_adj_log_pdf(ex, emu, esigma));
+    check(expr, expected);
+
+    // a new value of sigma is factorized again
+    sigma.get() = b;
+    esigma.get() = b;
+    sigma.reset_adj();
+    esigma.reset_adj();
+    x.reset_adj();
+    ex.reset_adj();
+    mu.reset_adj();
+    emu.reset_adj();
+    check(expr, expected);
+}
+
+TEST_F(llt_fixture, shared_not_pos_def)
+{
+    sigma.get() = -a;
+    auto llt = ad::shared_llt(sigma);
+    auto expr = ad::bind(ad::normal_adj_log_pdf(x, mu, sigma, llt));
+    EXPECT_EQ(ad::autodiff(expr), util::neg_inf<value_t>);
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            EXPECT_DOUBLE_EQ(sigma.get_adj(i, j), 0.);
+        }
+    }
+}
+
+TEST_F(llt_fixture, shared_const)
+{
+    auto c = ad::constant(a);
+    auto llt = ad::shared_llt(c);
+    auto res = ad::log_det(c, llt);
+    static_assert(std::is_same_v<
+            std::decay_t<decltype(res)>,
+            Constant<value_t, scl>
+            >);
+    EXPECT_NEAR(res.get(), std::log(a.determinant()), 1e-12);
+}
+
+} // namespace core
+} // namespace ad
@@ -0,0 +1,183 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <vector>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/map_sum.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+
+namespace ad {
+namespace core {
+
+struct map_sum_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+
+    size_t n = 101;
+    std::vector<value_t> x;
+    std::vector<value_t> y;
+    Var<value_t> mu, sigma, emu, esigma;
+
+    map_sum_fixture()
+        : x(n), y(n)
+        , mu(0.3), sigma(1.7), emu(0.3), esigma(1.7)
+    {
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = std::sin(0.37 * i);
+            y[i] = 0.01 * i;
+        }
+    }
+
+    // Normal log-likelihood (up to constants) of y given x.
+    template <class MuType, class SigmaType>
+    auto term(size_t i, const MuType& mu, const SigmaType& sigma) const
+    {
+        return (ad::constant(y[i]) - mu * x[i]) * (ad::constant(y[i]) - mu * x[i]) /
+                (sigma * sigma) + ad::log(sigma);
+    }
+};
+
+TEST_F(map_sum_fixture, matches_sum)
+{
+    auto expr = ad::bind(ad::map_sum(n,
+                [&](size_t i) { return term(i, mu, sigma); }));
+
+    std::vector<size_t> idx(n);
+    for (size_t i = 0; i < n; ++i) idx[i] = i;
+    auto expected = ad::bind(ad::sum(idx.begin(), idx.end(),
+                [&](size_t i) { return term(i, emu, esigma); }));
+
+    // gradients are accumulated in a different order
+    auto near = [](value_t a, value_t b) {
+        EXPECT_NEAR(a, b, 1e-12 * (1. + std::abs(b)));
+    };
+    near(ad::autodiff(expr), ad::autodiff(expected));
+    near(mu.get_adj(), emu.get_adj());
+    near(sigma.get_adj(), esigma.get_adj());
+
+    // second evaluation accumulates the adjoints again
+    ad::autodiff(expr);
+    near(mu.get_adj(), 2 * emu.get_adj());
+    near(sigma.get_adj(), 2 * esigma.get_adj());
+}
+
+// Cache is the size of a single term.
+TEST_F(map_sum_fixture, cache_size)
+{
+    auto f = [&](size_t i) { return term(i, mu, sigma); };
+    auto expr = ad::map_sum(n, f);
+    auto one = f(0);
+    util::SizePack size = one.bind_cache_size() + util::SizePack(1, 0);
+    EXPECT_TRUE((expr.bind_cache_size() == size).all());
+}
+
+// Forward evaluation only does not touch the leaf adjoints,
+// and does not double-count the gradient of the following backward evaluation.
+TEST_F(map_sum_fixture, evaluate_then_autodiff)
+{
+    auto expr = ad::bind(ad::map_sum(n,
+                [&](size_t i) { return term(i, mu, sigma); }));
+    value_t f = ad::evaluate(expr);
+    EXPECT_DOUBLE_EQ(mu.get_adj(), 0.);
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), f);
+
+    auto expected = ad::bind(ad::map_sum(n,
+                [&](size_t i) { return term(i, emu, esigma); }));
+    ad::autodiff(expected);
+    EXPECT_DOUBLE_EQ(mu.get_adj(), emu.get_adj());
+}
+
+// Every backward evaluation adds the gradient of the last forward evaluation
+// scaled by its seed.
+TEST_F(map_sum_fixture, beval_twice)
+{
+    auto expr = ad::bind(ad::map_sum(n,
+                [&](size_t i) { return term(i, mu, sigma); }));
+    auto expected = ad::bind(ad::map_sum(n,
+                [&](size_t i) { return term(i, emu, esigma); }));
+    ad::evaluate(expr);
+    ad::evaluate_adj(expr, 2.);
+    ad::evaluate_adj(expr, 0.5);
+    ad::autodiff(expected, 2.5);
+    EXPECT_NEAR(mu.get_adj(), emu.get_adj(), 1e-12 * std::abs(emu.get_adj()));
+    EXPECT_NEAR(sigma.get_adj(), esigma.get_adj(),
+                1e-12 * std::abs(esigma.get_adj()));
+}
+
+// Placeholders and leaves shared with the rest of the expression.
+TEST_F(map_sum_fixture, placeholder)
+{
+    Var<value_t> w, ew;
+    auto expr = ad::bind((
+        w = ad::map_sum(n, [&](size_t i) { return term(i, mu, sigma); }),
+        w * w + mu));
+
+    std::vector<size_t> idx(n);
+    for (size_t i = 0; i < n; ++i) idx[i] = i;
+    auto expected = ad::bind((
+        ew = ad::sum(idx.begin(), idx.end(),
+                [&](size_t i) { return term(i, emu, esigma); }),
+        ew * ew + emu));
+
+    EXPECT_NEAR(ad::autodiff(expr), ad::autodiff(expected), 1e-9);
+    EXPECT_NEAR(mu.get_adj(), emu.get_adj(), 1e-9 * std::abs(emu.get_adj()));
+    EXPECT_NEAR(sigma.get_adj(), esigma.get_adj(),
+                1e-9 * std::abs(esigma.get_adj()));
+}
+
+// Leaves of the terms are registered on the first forward evaluation (see ExprBind).
+TEST_F(map_sum_fixture, gradient)
+{
+    auto expr = ad::bind(ad::map_sum(n,
+                [&](size_t i) { return term(i, mu, sigma); }));
+    EXPECT_EQ(expr.leaves().size(), 0ul);
+
+    ad::autodiff(expr);
+    EXPECT_EQ(expr.leaves().size(), 2ul);
+    value_t mu_adj = mu.get_adj();
+    ad::autodiff(expr, ad::fresh);
+    auto grad = expr.gradient();
+    EXPECT_DOUBLE_EQ(grad(0), mu_adj);
+    EXPECT_DOUBLE_EQ(grad(1), sigma.get_adj());
+    EXPECT_EQ(expr.leaves().size(), 2ul);
+}
+
+// Terms are not backward evaluated when bound for forward evaluation only.
+TEST_F(map_sum_fixture, forward)
+{
+    auto expr = ad::bind_forward(ad::map_sum(n,
+                [&](size_t i) { return term(i, mu, sigma); }));
+    auto expected = ad::bind(ad::map_sum(n,
+                [&](size_t i) { return term(i, emu, esigma); }));
+    EXPECT_DOUBLE_EQ(ad::evaluate(expr), ad::evaluate(expected));
+
+    expr.rebind();
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), ad::autodiff(expected));
+    EXPECT_DOUBLE_EQ(mu.get_adj(), emu.get_adj());
+    EXPECT_EQ(expr.leaves().size(), 2ul);
+}
+
+TEST_F(map_sum_fixture, empty)
+{
+    auto expr = ad::bind(ad::map_sum(0,
+                [&](size_t i) { return term(i, mu, sigma); }));
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), 0.);
+    EXPECT_DOUBLE_EQ(mu.get_adj(), 0.);
+}
+
+TEST_F(map_sum_fixture, constant)
+{
+    auto expr = ad::map_sum(3,
+                [&](size_t i) { return ad::constant(value_t(i * i)); });
+    EXPECT_DOUBLE_EQ(ad::evaluate(expr), 5.);
+}
+
+} // namespace core
+} // namespace ad
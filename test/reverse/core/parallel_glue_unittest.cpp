@@ -0,0 +1,171 @@
+#include "gtest/gtest.h"
+#include <vector>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/det.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/llt.hpp>
+#include <fastad_bits/reverse/core/log_det.hpp>
+#include <fastad_bits/reverse/core/map_sum.hpp>
+#include <fastad_bits/reverse/core/parallel_glue.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+
+namespace ad {
+namespace core {
+
+struct parallel_glue_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+
+    Var<value_t> x{0.5}, y{2.}, z{-1.3};
+    Var<value_t> w1, w2, w3, w4;
+    Var<value_t, vec> v{4};
+
+    parallel_glue_fixture()
+    {
+        v.get() << 0.1, 0.2, 0.3, 0.4;
+    }
+
+    // Returns the value and the adjoints of x, y, z, v
+    // after backward evaluating expr twice.
+    template <class ExprType>
+    std::vector<value_t> run(ExprType& expr)
+    {
+        ad::autodiff(expr);
+        std::vector<value_t> out = {ad::autodiff(expr, ad::fresh)};
+        out.push_back(x.get_adj());
+        out.push_back(y.get_adj());
+        out.push_back(z.get_adj());
+        for (size_t i = 0; i < v.size(); ++i) out.push_back(v.get_adj(i, 0));
+        return out;
+    }
+};
+
+TEST_F(parallel_glue_fixture, dependencies)
+{
+    util::ThreadPool pool(2);
+    auto expr = ad::bind_parallel((
+        w1 = ad::sin(x) * x,
+        w2 = ad::exp(y),
+        w3 = w1 * w2 + ad::sum(v),
+        w3 * z), pool);
+
+    const auto& node = expr.get();
+    EXPECT_TRUE(node.dependencies(0).empty());
+    EXPECT_TRUE(node.dependencies(1).empty());
+    EXPECT_EQ(node.dependencies(2), (std::vector<size_t>{0, 1}));
+    EXPECT_EQ(node.dependencies(3), (std::vector<size_t>{2}));
+}
+
+TEST_F(parallel_glue_fixture, matches_glue)
+{
+    auto make_expr = [&]() {
+        return (w1 = ad::sin(x) * y,
+                w2 = ad::exp(y) * z + ad::sum(v * v),
+                w3 = ad::cos(z) * x,
+                w4 = w1 * w2 + w3,
+                w4 * x + ad::sum(v));
+    };
+    auto serial = ad::bind(make_expr());
+    auto expected = run(serial);
+
+    for (size_t n_threads = 1; n_threads <= 4; ++n_threads) {
+        util::ThreadPool pool(n_threads);
+        auto expr = ad::bind_parallel(make_expr(), pool);
+        auto actual = run(expr);
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_DOUBLE_EQ(actual[i], expected[i]);
+        }
+    }
+}
+
+// Compound assignments to the same placeholder are ordered in both passes.
+TEST_F(parallel_glue_fixture, op_eq)
+{
+    auto make_expr = [&]() {
+        return (w1 = x * y,
+                w1 += ad::sin(z),
+                w2 = ad::exp(x),
+                w1 *= w2,
+                w1 * z);
+    };
+    auto serial = ad::bind(make_expr());
+    auto expected = run(serial);
+
+    util::ThreadPool pool(3);
+    auto expr = ad::bind_parallel(make_expr(), pool);
+    EXPECT_EQ(expr.get().dependencies(1), (std::vector<size_t>{0}));
+    EXPECT_TRUE(expr.get().dependencies(2).empty());
+    EXPECT_EQ(expr.get().dependencies(3), (std::vector<size_t>{0, 1, 2}));
+
+    auto actual = run(expr);
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_DOUBLE_EQ(actual[i], expected[i]);
+    }
+}
+
+// A map_sum is ordered with every other statement.
+TEST_F(parallel_glue_fixture, map_sum)
+{
+    std::vector<value_t> d = {1., 2., 3.};
+    util::ThreadPool pool(2);
+    auto expr = ad::bind_parallel((
+        w1 = ad::exp(y),
+        w2 = ad::map_sum(d.size(), [&](size_t i) { return x * d[i]; }),
+        w3 = ad::sin(z),
+        w1 + w2 + w3), pool);
+
+    EXPECT_TRUE(expr.get().dependencies(0).empty());
+    EXPECT_EQ(expr.get().dependencies(1), (std::vector<size_t>{0}));
+    EXPECT_EQ(expr.get().dependencies(2), (std::vector<size_t>{1}));
+
+    value_t f = ad::autodiff(expr);
+    EXPECT_DOUBLE_EQ(f, std::exp(2.) + 3. + std::sin(-1.3));
+    EXPECT_DOUBLE_EQ(x.get_adj(), 6.);
+    EXPECT_DOUBLE_EQ(y.get_adj(), std::exp(2.));
+    EXPECT_DOUBLE_EQ(z.get_adj(), std::cos(-1.3));
+}
+
+// Statements sharing a factorization are ordered.
+TEST_F(parallel_glue_fixture, shared_llt)
+{
+    Var<value_t, mat> sigma(2, 2);
+    sigma.get() << 2., 0.5, 0.5, 1.;
+    util::ThreadPool pool(2);
+
+    auto priv = ad::bind_parallel((
+        w1 = ad::log_det<LogDetLLT>(sigma),
+        w2 = ad::det<DetLLT>(sigma),
+        w1 + w2), pool);
+    EXPECT_TRUE(priv.get().dependencies(1).empty());
+
+    auto llt = ad::shared_llt(sigma);
+    auto expr = ad::bind_parallel((
+        w1 = ad::log_det(sigma, llt),
+        w2 = ad::det(sigma, llt),
+        w1 + w2), pool);
+    EXPECT_EQ(expr.get().dependencies(1), (std::vector<size_t>{0}));
+
+    value_t det = 2. - 0.25;
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), std::log(det) + det);
+    EXPECT_DOUBLE_EQ(sigma.get_adj(0, 0), 1. / det + 1.);
+    EXPECT_DOUBLE_EQ(sigma.get_adj(1, 1), 2. / det + 2.);
+}
+
+TEST_F(parallel_glue_fixture, single)
+{
+    util::ThreadPool pool(2);
+    auto expr = ad::bind_parallel(ad::sin(x) * y, pool);
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), std::sin(0.5) * 2.);
+    EXPECT_DOUBLE_EQ(x.get_adj(), std::cos(0.5) * 2.);
+    EXPECT_DOUBLE_EQ(y.get_adj(), std::sin(0.5));
+}
+
+} // namespace core
+} // namespace ad
@@ -0,0 +1,305 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <vector>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/log_det.hpp>
+#include <fastad_bits/reverse/core/map_sum.hpp>
+#include <fastad_bits/reverse/core/parallel_sum.hpp>
+#include <fastad_bits/reverse/core/solve.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+
+namespace ad {
+namespace core {
+
+struct parallel_sum_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+
+    size_t n = 1003;
+    std::vector<value_t> data;
+
+    parallel_sum_fixture()
+        : data(n)
+    {
+        for (size_t i = 0; i < n; ++i) {
+            data[i] = std::sin(0.37 * i) + 0.01 * i;
+        }
+    }
+
+    // Normal log-likelihood (up to constants) of data w.r.t. mu, sigma
+    // and a quadratic penalty on w, summed with f.
+    template <class SumType>
+    auto run(SumType sum, size_t& n_leaves, std::vector<value_t>& grad)
+    {
+        Var<value_t> mu(0.3), sigma(1.7);
+        std::vector<Var<value_t>> w(n);
+        for (size_t i = 0; i < n; ++i) w[i].get() = 0.001 * i;
+
+        std::vector<size_t> idx(n);
+        for (size_t i = 0; i < n; ++i) idx[i] = i;
+
+        auto expr = ad::bind(sum(idx.begin(), idx.end(),
+                [&](size_t i) {
+                    return (data[i] - mu) * (data[i] - mu) / (sigma * sigma) +
+                            ad::log(sigma) + w[i] * w[i] * data[i];
+                }));
+        value_t f = 0;
+        // evaluating twice accumulates adjoints twice
+        ad::autodiff(expr);
+        f = ad::autodiff(expr);
+
+        n_leaves = 2 + n;
+        grad.clear();
+        grad.push_back(mu.get_adj());
+        grad.push_back(sigma.get_adj());
+        for (const auto& wi : w) grad.push_back(wi.get_adj());
+        return f;
+    }
+};
+
+TEST_F(parallel_sum_fixture, matches_sum)
+{
+    size_t n_leaves;
+    std::vector<value_t> expected, actual;
+    value_t f_expected = run(
+            [](auto b, auto e, auto&& f) { return ad::sum(b, e, f); },
+            n_leaves, expected);
+
+    util::ThreadPool pool(3);
+    value_t f = run(
+            [&](auto b, auto e, auto&& f) {
+                return ad::parallel_sum(b, e, f, parallel_policy(pool, 64));
+            },
+            n_leaves, actual);
+
+    EXPECT_NEAR(f, f_expected, 1e-9 * std::abs(f_expected));
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(actual[i], expected[i], 1e-9 * (1. + std::abs(expected[i])));
+    }
+}
+
+// Value and gradient do not depend on the number of threads.
+TEST_F(parallel_sum_fixture, deterministic)
+{
+    size_t n_leaves;
+    std::vector<value_t> expected, actual;
+    value_t f_expected = 0;
+
+    for (size_t n_threads = 1; n_threads <= 4; ++n_threads) {
+        util::ThreadPool pool(n_threads);
+        value_t f = run(
+                [&](auto b, auto e, auto&& f) {
+                    return ad::parallel_sum(b, e, f, parallel_policy(pool, 50));
+                },
+                n_leaves, actual);
+        if (n_threads == 1) {
+            f_expected = f;
+            expected = actual;
+            continue;
+        }
+        EXPECT_EQ(f, f_expected);
+        EXPECT_EQ(actual, expected);
+    }
+}
+
+// The number of partitions, hence of scratch buffers, only depends on the policy.
+TEST_F(parallel_sum_fixture, partitions)
+{
+    util::ThreadPool pool(2);
+    Var<value_t> x(0.5);
+    std::vector<value_t> v(n, 1.);
+    auto f = [&](value_t vi) { return x * vi; };
+
+    auto expr = ad::parallel_sum(v.begin(), v.end(), f, parallel_policy(pool));
+    EXPECT_EQ(expr.n_partitions(), parallel_policy::default_n_partitions);
+
+    auto small = ad::parallel_sum(v.begin(), v.begin() + 3, f, parallel_policy(pool));
+    EXPECT_EQ(small.n_partitions(), 3ul);
+
+    auto expr_bind = ad::bind(ad::parallel_sum(v.begin(), v.end(), f,
+                                               parallel_policy(pool, 7)));
+    EXPECT_EQ(expr_bind.get().n_partitions(), 7ul);
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr_bind), 0.5 * n);
+    EXPECT_DOUBLE_EQ(x.get_adj(), static_cast<value_t>(n));
+}
+
+// Placeholders outside of the terms and leaves shared with the rest of the expression.
+TEST_F(parallel_sum_fixture, placeholder)
+{
+    util::ThreadPool pool(2);
+    Var<value_t> x(0.5), ex(0.5);
+    Var<value_t> w, ew;
+    std::vector<value_t> v = {1., 2., 3., 4., 5.};
+
+    auto expr = ad::bind((
+        w = ad::parallel_sum(v.begin(), v.end(),
+                [&](value_t vi) { return ad::sin(x * vi); },
+                parallel_policy(pool, 2)),
+        w * w + x));
+    auto expected = ad::bind((
+        ew = ad::sum(v.begin(), v.end(),
+                [&](value_t vi) { return ad::sin(ex * vi); }),
+        ew * ew + ex));
+
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), ad::autodiff(expected));
+    EXPECT_DOUBLE_EQ(x.get_adj(), ex.get_adj());
+}
+
+// Terms sharing a factorization are evaluated serially.
+TEST_F(parallel_sum_fixture, shared_llt)
+{
+    util::ThreadPool pool(4);
+    Eigen::MatrixXd a(3, 3);
+    a << 4, 1, 0.5,
+         1, 3, 0.2,
+         0.5, 0.2, 2;
+    Var<value_t, mat> sigma(3, 3), esigma(3, 3);
+    Var<value_t, vec> x(3), ex(3);
+    sigma.get() = esigma.get() = a;
+    x.get() << 0.3, -1.2, 2.;
+    ex.get() = x.get();
+
+    auto llt = ad::shared_llt(sigma);
+    auto node = ad::parallel_sum(data.begin(), data.end(),
+            [&](value_t d) {
+                return ad::log_det(sigma, llt) * d + ad::sum(ad::solve(sigma, x, llt));
+            },
+            parallel_policy(pool, 16));
+    EXPECT_TRUE(node.serial());
+    auto expr = ad::bind(node);
+    auto expected = ad::bind(ad::sum(data.begin(), data.end(),
+            [&](value_t d) {
+                return ad::log_det<LogDetLLT>(esigma) * d +
+                        ad::sum(ad::solve<SolveLLT>(esigma, ex));
+            }));
+    EXPECT_NEAR(ad::autodiff(expr), ad::autodiff(expected), 1e-8);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_NEAR(x.get_adj(i, 0), ex.get_adj(i, 0), 1e-8);
+        for (size_t j = 0; j < 3; ++j) {
+            EXPECT_NEAR(sigma.get_adj(i, j), esigma.get_adj(i, j), 1e-8);
+        }
+    }
+
+    // private factorizations are evaluated in parallel
+    auto private_node = ad::parallel_sum(data.begin(), data.end(),
+            [&](value_t d) { return ad::log_det<LogDetLLT>(sigma) * d; },
+            parallel_policy(pool, 16));
+    EXPECT_FALSE(private_node.serial());
+}
+
+// Leaves redirected to the scratch buffers are registered when bound (see ExprBind).
+TEST_F(parallel_sum_fixture, gradient)
+{
+    util::ThreadPool pool(2);
+    Var<value_t> x(0.5), y(2.);
+    Var<value_t> w;
+    std::vector<value_t> v = {1., 2., 3., 4., 5.};
+
+    auto expr = ad::bind((
+        w = ad::parallel_sum(v.begin(), v.end(),
+                [&](value_t vi) { return ad::sin(x * vi); },
+                parallel_policy(pool, 2)),
+        w * y + x));
+    EXPECT_EQ(expr.leaves().size(), 2ul);
+
+    ad::autodiff(expr);
+    ad::autodiff(expr, ad::fresh);
+    auto grad = expr.gradient();
+    EXPECT_DOUBLE_EQ(grad(0), x.get_adj());
+    EXPECT_DOUBLE_EQ(grad(1), y.get_adj());
+    EXPECT_DOUBLE_EQ(grad(1), w.get());
+}
+
+// Terms that are sums themselves redirect the leaves of every summand.
+TEST_F(parallel_sum_fixture, nested_sum)
+{
+    util::ThreadPool pool(2);
+    Var<value_t> x(0.5), ex(0.5);
+    std::vector<value_t> v = {1., 2., 3., 4., 5.};
+
+    auto inner = [&](const auto& x, value_t vi) {
+        return ad::sum(v.begin(), v.end(),
+                [&, vi](value_t vj) { return ad::sin(x * vi) * vj; });
+    };
+    auto expr = ad::bind(ad::parallel_sum(v.begin(), v.end(),
+                [&](value_t vi) { return inner(x, vi); },
+                parallel_policy(pool, 2)));
+    auto expected = ad::bind(ad::sum(v.begin(), v.end(),
+                [&](value_t vi) { return inner(ex, vi); }));
+
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), ad::autodiff(expected));
+    EXPECT_DOUBLE_EQ(x.get_adj(), ex.get_adj());
+}
+
+// Terms that are map_sums redirect the leaves of every term they rebind,
+// including leaves first reached during evaluation, which are registered after it.
+TEST_F(parallel_sum_fixture, nested_map_sum)
+{
+    std::vector<value_t> v = {1., 2., 3., 4., 5.};
+    Var<value_t> ex(0.5);
+    std::vector<Var<value_t>> ew(v.size());
+    for (size_t j = 0; j < v.size(); ++j) ew[j].get() = 0.1 * j;
+
+    auto inner = [&](const auto& x, const auto& w, value_t vi) {
+        return ad::map_sum(v.size(), [&, vi](size_t j) {
+            return ad::sin(x * vi) * w[j];
+        });
+    };
+    auto expected = ad::bind(ad::sum(v.begin(), v.end(),
+                [&](value_t vi) { return inner(ex, ew, vi); }));
+    value_t f_expected = ad::autodiff(expected);
+
+    for (size_t n_threads = 1; n_threads <= 3; ++n_threads) {
+        util::ThreadPool pool(n_threads);
+        Var<value_t> x(0.5);
+        std::vector<Var<value_t>> w(v.size());
+        for (size_t j = 0; j < v.size(); ++j) w[j].get() = 0.1 * j;
+
+        auto expr = ad::bind(ad::parallel_sum(v.begin(), v.end(),
+                    [&](value_t vi) { return inner(x, w, vi); },
+                    parallel_policy(pool, 2)));
+        EXPECT_DOUBLE_EQ(ad::autodiff(expr), f_expected);
+        EXPECT_DOUBLE_EQ(x.get_adj(), ex.get_adj());
+        for (size_t j = 0; j < v.size(); ++j) {
+            EXPECT_DOUBLE_EQ(w[j].get_adj(), ew[j].get_adj());
+        }
+
+        EXPECT_EQ(expr.leaves().size(), 1 + v.size());
+        expr.reset_adjoints();
+        EXPECT_DOUBLE_EQ(x.get_adj(), 0.);
+        for (const auto& wj : w) EXPECT_DOUBLE_EQ(wj.get_adj(), 0.);
+    }
+}
+
+TEST_F(parallel_sum_fixture, empty)
+{
+    util::ThreadPool pool(2);
+    Var<value_t> x(1.);
+    std::vector<value_t> v;
+    auto expr = ad::bind(ad::parallel_sum(v.begin(), v.end(),
+                [&](value_t vi) { return x * vi; },
+                parallel_policy(pool)));
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), 0.);
+    EXPECT_DOUBLE_EQ(x.get_adj(), 0.);
+}
+
+TEST_F(parallel_sum_fixture, constant)
+{
+    util::ThreadPool pool(2);
+    std::vector<value_t> v = {1., 2., 3.};
+    auto expr = ad::parallel_sum(v.begin(), v.end(),
+                [&](value_t vi) { return ad::constant(vi * vi); },
+                parallel_policy(pool));
+    EXPECT_DOUBLE_EQ(ad::evaluate(expr), 14.);
+}
+
+} // namespace core
+} // namespace ad
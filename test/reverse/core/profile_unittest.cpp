@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+#include <sstream>
+#include <vector>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/map_sum.hpp>
+#include <fastad_bits/reverse/core/profile.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+
+// This file is built both with and without FASTAD_ENABLE_PROFILING.
+
+namespace ad {
+namespace core {
+
+struct profile_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+
+    Var<value_t> x{0.5}, y{2.}, w;
+    Var<value_t, vec> v{4};
+    std::vector<value_t> d = {1., 2., 3.};
+
+    profile_fixture()
+    {
+        v.get() << 0.1, 0.2, 0.3, 0.4;
+    }
+
+    auto make_expr()
+    {
+        return (w = x * y,
+                ad::sum(d.begin(), d.end(), [&](value_t di) { return w * di; }) +
+                ad::sum(ad::sin(v * x)));
+    }
+};
+
+#ifdef FASTAD_ENABLE_PROFILING
+
+TEST_F(profile_fixture, tree)
+{
+    auto expr = ad::bind(make_expr());
+    ad::autodiff(expr);
+    ad::autodiff(expr);
+
+    const auto& root = expr.get().profile_stat();
+    EXPECT_EQ(root.name, "GlueNode");
+    EXPECT_EQ(root.counter(util::ProfilePhase::feval).calls, 2ul);
+    EXPECT_EQ(root.counter(util::ProfilePhase::beval).calls, 2ul);
+    ASSERT_EQ(root.children.size(), 2ul);
+
+    const auto& eq = *root.children[0];
+    EXPECT_EQ(eq.name, "EqNode");
+    ASSERT_EQ(eq.children.size(), 1ul);
+    EXPECT_EQ(eq.children[0]->name, "BinaryNode");
+
+    const auto& add = *root.children[1];
+    ASSERT_EQ(add.children.size(), 2ul);
+    EXPECT_EQ(add.children[0]->name, "SumIterNode");
+    // terms are evaluated in structure-of-arrays layout, not as nodes
+    EXPECT_EQ(add.children[0]->children.size(), 0ul);
+    EXPECT_EQ(add.children[1]->name, "SumElemNode");
+
+    // v * x and sin(v * x) bind 4 values and 4 adjoints each
+    const auto& sin_node = *add.children[1]->children[0];
+    EXPECT_EQ(sin_node.name, "UnaryNode");
+    EXPECT_EQ(sin_node.bytes, 8 * sizeof(value_t));
+    EXPECT_EQ(sin_node.children[0]->bytes, 8 * sizeof(value_t));
+
+    for (auto phase : {util::ProfilePhase::feval, util::ProfilePhase::beval}) {
+        EXPECT_LE(root.exclusive_ticks(phase), root.counter(phase).ticks);
+        EXPECT_GE(root.counter(phase).ticks, add.counter(phase).ticks);
+    }
+
+    std::ostringstream os;
+    ad::profile_report(expr, os);
+    EXPECT_NE(os.str().find("  EqNode"), std::string::npos);
+    EXPECT_NE(os.str().find("    SumIterNode"), std::string::npos);
+
+    ad::profile_reset(expr);
+    EXPECT_EQ(root.counter(util::ProfilePhase::feval).calls, 0ul);
+    EXPECT_EQ(sin_node.counter(util::ProfilePhase::beval).calls, 0ul);
+    EXPECT_EQ(root.children.size(), 2ul);
+}
+
+// Every term of a map_sum is rebuilt in place of the previous one.
+// The term is linked once and holds the counters of every term.
+TEST_F(profile_fixture, map_sum)
+{
+    auto expr = ad::bind(ad::map_sum(5, [&](size_t i) {
+        return ad::sin(x * static_cast<value_t>(i));
+    }));
+    ad::autodiff(expr);
+    ad::autodiff(expr);
+
+    const auto& root = expr.get().profile_stat();
+    EXPECT_EQ(root.name, "MapSumNode");
+    ASSERT_EQ(root.children.size(), 1ul);
+
+    // feval evaluates every term forward and backward, and beval only adds the gradient
+    const auto& term = *root.children[0];
+    EXPECT_EQ(term.name, "UnaryNode");
+    EXPECT_EQ(term.counter(util::ProfilePhase::feval).calls, 10ul);
+    EXPECT_EQ(term.counter(util::ProfilePhase::beval).calls, 10ul);
+    ASSERT_EQ(term.children.size(), 1ul);
+    EXPECT_EQ(term.children[0]->name, "BinaryNode");
+    EXPECT_EQ(term.children[0]->counter(util::ProfilePhase::feval).calls, 10ul);
+
+    EXPECT_GE(root.counter(util::ProfilePhase::feval).ticks,
+              term.counter(util::ProfilePhase::feval).ticks +
+              term.counter(util::ProfilePhase::beval).ticks);
+
+    ad::profile_reset(expr);
+    EXPECT_EQ(term.counter(util::ProfilePhase::feval).calls, 0ul);
+    ad::autodiff(expr);
+    EXPECT_EQ(root.children.size(), 1ul);
+    EXPECT_EQ(term.counter(util::ProfilePhase::feval).calls, 5ul);
+}
+
+// Copies of a node start without statistics.
+TEST_F(profile_fixture, copy)
+{
+    auto expr = ad::bind(make_expr());
+    ad::autodiff(expr);
+    auto copy = expr.get();
+    EXPECT_EQ(copy.profile_stat().counter(util::ProfilePhase::feval).calls, 0ul);
+    EXPECT_TRUE(copy.profile_stat().children.empty());
+}
+
+#else
+
+// Nodes hold no statistics when profiling is disabled.
+TEST_F(profile_fixture, disabled)
+{
+    static_assert(std::is_empty_v<ExprBase<Var<value_t>>>);
+    auto expr = ad::bind(make_expr());
+    ad::autodiff(expr);
+    std::ostringstream os;
+    ad::profile_report(expr, os);
+    EXPECT_NE(os.str().find("disabled"), std::string::npos);
+}
+
+#endif
+
+} // namespace core
+} // namespace ad
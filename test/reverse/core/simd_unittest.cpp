@@ -0,0 +1,138 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <vector>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/if_else.hpp>
+#include <fastad_bits/reverse/core/pow.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/stat/bernoulli.hpp>
+#include <fastad_bits/reverse/stat/cauchy.hpp>
+#include <fastad_bits/reverse/stat/normal.hpp>
+#include <fastad_bits/reverse/stat/uniform.hpp>
+#include <fastad_bits/util/simd.hpp>
+
+namespace ad {
+namespace core {
+
+struct simd_fixture : ::testing::Test
+{
+protected:
+    static constexpr size_t W = 4;
+    using value_t = double;
+    using pack_t = ad::simd<value_t, W>;
+
+    std::vector<value_t> xs = {0.5, -1.2, 2.3, 0.};
+    std::vector<value_t> ys = {2., 0.7, -0.4, 1.5};
+
+    // Evaluates make_expr on packs of xs and ys and on every lane separately,
+    // and checks that the value and the adjoints of each lane are the same.
+    template <class F>
+    void check(F make_expr)
+    {
+        Var<pack_t> x(pack_t::load(xs.data())), y(pack_t::load(ys.data()));
+        Var<pack_t> w;
+        auto expr = ad::bind(make_expr(x, y, w));
+        pack_t f = ad::autodiff(expr);
+
+        for (size_t i = 0; i < W; ++i) {
+            Var<value_t> xi(xs[i]), yi(ys[i]);
+            Var<value_t> wi;
+            auto expr_i = ad::bind(make_expr(xi, yi, wi));
+            value_t fi = ad::autodiff(expr_i);
+            EXPECT_DOUBLE_EQ(f[i], fi) << "lane " << i;
+            EXPECT_DOUBLE_EQ(x.get_adj()[i], xi.get_adj()) << "lane " << i;
+            EXPECT_DOUBLE_EQ(y.get_adj()[i], yi.get_adj()) << "lane " << i;
+        }
+    }
+};
+
+TEST_F(simd_fixture, pack)
+{
+    pack_t x = pack_t::load(xs.data());
+    pack_t y = 2. * x + 1;
+    value_t out[W];
+    y.store(out);
+    for (size_t i = 0; i < W; ++i) EXPECT_DOUBLE_EQ(out[i], 2. * xs[i] + 1);
+
+    pack_t c = (x < 1.) && (x != 0.);
+    EXPECT_DOUBLE_EQ(c[0], 1.);
+    EXPECT_DOUBLE_EQ(c[1], 1.);
+    EXPECT_DOUBLE_EQ(c[2], 0.);
+    EXPECT_DOUBLE_EQ(c[3], 0.);
+    EXPECT_TRUE(util::any(c));
+    EXPECT_FALSE(util::all(c));
+    EXPECT_DOUBLE_EQ(util::select(c, x, -x)[2], -2.3);
+    EXPECT_DOUBLE_EQ(util::select(true, 1, 2.5), 1.);
+}
+
+TEST_F(simd_fixture, unary_binary)
+{
+    check([](const auto& x, const auto& y, auto&) {
+        return ad::sin(x) * ad::cos(y) + ad::exp(x - y) / (ad::erf(y) + 2.) -
+               ad::sqrt(x * x + 1.) * ad::atan(y) + ad::log(y * y + 0.5);
+    });
+}
+
+TEST_F(simd_fixture, glue)
+{
+    check([](const auto& x, const auto& y, auto& w) {
+        return (w = x * y + 1., w * w - ad::tan(x * 0.1) + 3. * ad::asin(y * 0.2));
+    });
+}
+
+TEST_F(simd_fixture, pow)
+{
+    check([](const auto& x, const auto& y, auto&) {
+        return ad::pow<3>(x) + ad::pow<-2>(y) + ad::pow<0>(x) * y;
+    });
+}
+
+// Each lane takes its own branch.
+TEST_F(simd_fixture, if_else)
+{
+    check([](const auto& x, const auto& y, auto&) {
+        return ad::if_else((x < y) && (x != 0.), x * y, ad::exp(y) - x);
+    });
+}
+
+TEST_F(simd_fixture, sum)
+{
+    std::vector<value_t> d = {1., 2., 3.};
+    check([&](const auto& x, const auto& y, auto&) {
+        return ad::sum(d.begin(), d.end(), [&](value_t di) {
+            return ad::sin(x * di) * y;
+        });
+    });
+}
+
+TEST_F(simd_fixture, stat)
+{
+    check([](const auto& x, const auto& y, auto&) {
+        return ad::normal_adj_log_pdf(x, 0.3, y) +
+               ad::cauchy_adj_log_pdf(x, y, 2.) +
+               ad::uniform_adj_log_pdf(x, -1.5, 2.) +
+               ad::bernoulli_adj_log_pdf(1., ad::exp(-y * y));
+    });
+}
+
+// Packs are constants of every lane.
+TEST_F(simd_fixture, constant)
+{
+    Var<pack_t> x(pack_t::load(xs.data()));
+    pack_t k = pack_t::load(ys.data());
+    auto expr = ad::bind(x * k + ad::constant(k) * 2.);
+    pack_t f = ad::autodiff(expr);
+    for (size_t i = 0; i < W; ++i) {
+        EXPECT_DOUBLE_EQ(f[i], xs[i] * ys[i] + 2. * ys[i]);
+        EXPECT_DOUBLE_EQ(x.get_adj()[i], ys[i]);
+    }
+}
+
+} // namespace core
+} // namespace ad
@@ -0,0 +1,159 @@
+#include <testutil/base_fixture.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/solve.hpp>
+
+namespace ad {
+namespace core {
+
+struct solve_fixture : base_fixture
+{
+protected:
+    using solve_plu_t = SolveNode<SolvePartialPivLU<value_t>, mat_expr_view_t, vec_expr_view_t>;
+    using solve_ldlt_t = SolveNode<SolveLDLT<value_t>, mat_expr_view_t, vec_expr_view_t>;
+    using solve_llt_t = SolveNode<SolveLLT<value_t>, mat_expr_view_t, vec_expr_view_t>;
+    using solve_mat_t = SolveNode<SolvePartialPivLU<value_t>, mat_expr_view_t, mat_expr_view_t>;
+
+    mat_expr_t rhs_mat;
+    aVectorXd vseed;
+    Eigen::ArrayXXd mseed;
+
+    solve_plu_t solve_plu;
+    solve_ldlt_t solve_ldlt;
+    solve_llt_t solve_llt;
+    solve_mat_t solve_mat;
+
+    solve_fixture()
+        : base_fixture(4, 4, 4)
+        , rhs_mat(4, 2)
+        , vseed(4)
+        , mseed(4, 2)
+        , solve_plu(mat_expr, vec_expr)
+        , solve_ldlt(mat_expr, vec_expr)
+        , solve_llt(mat_expr, vec_expr)
+        , solve_mat(mat_expr, rhs_mat)
+    {
+        vec_expr.get() << 1.3, -2.1, 0.4, 3.2;
+        rhs_mat.get() << 1.3, 0.2,
+                         -2.1, 1.,
+                         0.4, -0.7,
+                         3.2, 2.5;
+        vseed << 2.3, 1.32, -0.4, 0.9;
+        mseed << 2.34, -3.2, 3.4, 1.23455,
+                 0.1, 0.5, -1.2, 2.;
+
+        // solve_mat needs the most cache,
+        // so we may bind all of them to the same cache at once
+        // so long as only one expression gets evaluated in each test
+        val_buf.resize(solve_mat.bind_cache_size()(0));
+        adj_buf.resize(solve_mat.bind_cache_size()(1));
+        ptr_pack_t ptr_pack(val_buf.data(), adj_buf.data());
+        solve_mat.bind_cache(ptr_pack);
+        solve_plu.bind_cache(ptr_pack);
+        solve_ldlt.bind_cache(ptr_pack);
+        solve_llt.bind_cache(ptr_pack);
+    }
+
+    void init_plu()
+    {
+        mat_expr.get() << 2, 3, 1, 5,
+                          3, 5, -1, 3,
+                          -2, 3, 1, 0,
+                          -1, -1, 2, 7;
+    }
+
+    void init_ldlt()
+    {
+        init_llt();
+    }
+
+    void init_llt()
+    {
+        mat_expr.get() << 8, 3, 1, 5,
+                          3, 5, 1, 3,
+                          1, 1, 1, 0,
+                          5, 3, 0, 7;
+    }
+
+    template <class T, class U>
+    void check_solve(T& expr, U& b, const Eigen::ArrayXXd& seed)
+    {
+        Eigen::MatrixXd a = mat_expr.get();
+        Eigen::MatrixXd x = a.inverse() * b.get();
+        Eigen::MatrixXd b_adj = a.inverse().transpose() * seed.matrix();
+        Eigen::MatrixXd a_adj = -b_adj * x.transpose();
+
+        check_near(expr.feval(), x, 1e-13);
+        expr.beval(seed);
+        check_near(mat_expr.get_adj(), a_adj, 1e-13);
+        check_near(b.get_adj(), b_adj, 1e-13);
+    }
+};
+
+TEST_F(solve_fixture, solve_plu)
+{
+    init_plu();
+    check_solve(solve_plu, vec_expr, vseed);
+}
+
+TEST_F(solve_fixture, solve_ldlt)
+{
+    init_ldlt();
+    check_solve(solve_ldlt, vec_expr, vseed);
+}
+
+TEST_F(solve_fixture, solve_llt)
+{
+    init_llt();
+    check_solve(solve_llt, vec_expr, vseed);
+}
+
+TEST_F(solve_fixture, solve_mat)
+{
+    init_plu();
+    check_solve(solve_mat, rhs_mat, mseed);
+}
+
+TEST_F(solve_fixture, solve_singular)
+{
+    mat_expr.get().setZero();
+    auto& x = solve_plu.feval();
+    EXPECT_TRUE(x.array().isNaN().all());
+    solve_plu.beval(vseed);
+    check_eq(mat_expr.get_adj(), Eigen::MatrixXd::Zero(4, 4));
+    check_eq(vec_expr.get_adj(), Eigen::VectorXd::Zero(4));
+}
+
+// A constant matrix is only factorized at construction.
+TEST_F(solve_fixture, solve_const_mat)
+{
+    init_plu();
+    Eigen::MatrixXd a = mat_expr.get();
+    auto expr = ad::solve(a, vec_expr);
+    this->bind(expr);
+    Eigen::VectorXd x = a.inverse() * vec_expr.get();
+    check_near(expr.feval(), x, 1e-13);
+
+    vec_expr.get() *= 2.;
+    check_near(expr.feval(), 2. * x, 1e-13);
+
+    expr.beval(vseed);
+    Eigen::VectorXd b_adj = a.inverse().transpose() * vseed.matrix();
+    check_near(vec_expr.get_adj(), b_adj, 1e-13);
+}
+
+TEST_F(solve_fixture, solve_const)
+{
+    init_plu();
+    auto a = ad::constant(mat_expr.get());
+    auto b = ad::constant(vec_expr.get());
+    Eigen::VectorXd actual = mat_expr.get().inverse() * vec_expr.get();
+    auto res = ad::solve(a, b);
+    static_assert(std::is_same_v<
+            std::decay_t<decltype(res)>,
+            Constant<value_t, vec>
+            >);
+    check_near(res.get(), actual, 1e-13);
+}
+
+} // namespace core
+} // namespace ad
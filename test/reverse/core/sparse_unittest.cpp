@@ -0,0 +1,141 @@
+#include "gtest/gtest.h"
+#include <vector>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/sparse.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+
+namespace ad {
+namespace core {
+
+struct sparse_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+    using triplet_t = Eigen::Triplet<value_t>;
+
+    size_t rows = 7;
+    size_t cols = 5;
+    Eigen::SparseMatrix<value_t> x_csc;
+    Eigen::SparseMatrix<value_t, Eigen::RowMajor> x_csr;
+    Eigen::MatrixXd x_dense;
+
+    Var<value_t, vec> beta, ebeta;
+    Var<value_t, mat> b, eb;
+
+    sparse_fixture()
+        : x_csc(rows, cols)
+        , x_csr(rows, cols)
+        , beta(cols), ebeta(cols)
+        , b(cols, 3), eb(cols, 3)
+    {
+        std::vector<triplet_t> triplets = {
+            {0, 0, 1.5}, {0, 3, -2.}, {2, 1, 0.3}, {3, 4, 4.1},
+            {4, 0, -0.7}, {6, 2, 2.2}, {6, 4, 0.9}
+        };
+        x_csc.setFromTriplets(triplets.begin(), triplets.end());
+        x_csr = x_csc;
+        x_dense = x_csc;
+
+        for (size_t i = 0; i < cols; ++i) {
+            beta.get(i, 0) = ebeta.get(i, 0) = 0.2 * i - 0.3;
+            for (size_t j = 0; j < 3; ++j) {
+                b.get(i, j) = eb.get(i, j) = 0.1 * i * j + 0.5;
+            }
+        }
+    }
+
+    // adjoints of the stored entries match the dense adjoints, others are not stored
+    template <class SparseVarType>
+    void check_sparse_adj(const SparseVarType& x, const Var<value_t, mat>& ex) const
+    {
+        EXPECT_EQ(x.get_adj().nonZeros(), 7);
+        for (int o = 0; o < x.get_adj().outerSize(); ++o) {
+            for (typename SparseVarType::var_t::InnerIterator it(x.get_adj(), o); it; ++it) {
+                EXPECT_DOUBLE_EQ(it.value(), ex.get_adj(it.row(), it.col()));
+            }
+        }
+    }
+};
+
+TEST_F(sparse_fixture, var_csc_vec)
+{
+    Var<value_t, sparse> x(x_csc);
+    Var<value_t, mat> ex(rows, cols);
+    ex.get() = x_dense;
+
+    auto expr = ad::bind(ad::sum(ad::sin(ad::dot(x, beta))));
+    auto expected = ad::bind(ad::sum(ad::sin(ad::dot(ex, ebeta))));
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), ad::autodiff(expected));
+    for (size_t i = 0; i < cols; ++i) {
+        EXPECT_DOUBLE_EQ(beta.get_adj(i, 0), ebeta.get_adj(i, 0));
+    }
+    check_sparse_adj(x, ex);
+}
+
+TEST_F(sparse_fixture, var_csr_mat)
+{
+    Var<value_t, sparse_row> x(x_csr);
+    Var<value_t, mat> ex(rows, cols);
+    ex.get() = x_dense;
+
+    auto expr = ad::bind(ad::sum(ad::dot(x, b) * ad::dot(x, b)));
+    auto expected = ad::bind(ad::sum(ad::dot(ex, eb) * ad::dot(ex, eb)));
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), ad::autodiff(expected));
+    for (size_t i = 0; i < cols; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            EXPECT_DOUBLE_EQ(b.get_adj(i, j), eb.get_adj(i, j));
+        }
+    }
+    check_sparse_adj(x, ex);
+}
+
+TEST_F(sparse_fixture, constant_view)
+{
+    auto expr = ad::bind(ad::sum(ad::dot(ad::constant_view(x_csc), beta)));
+    auto expected = ad::bind(ad::sum(ad::dot(ad::constant(x_dense), ebeta)));
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), ad::autodiff(expected));
+    for (size_t i = 0; i < cols; ++i) {
+        EXPECT_DOUBLE_EQ(beta.get_adj(i, 0), ebeta.get_adj(i, 0));
+    }
+
+    static_assert(std::is_same_v<decltype(ad::constant_view(x_csr)),
+                  ConstantView<value_t, sparse_row>>);
+}
+
+TEST_F(sparse_fixture, constant)
+{
+    Eigen::VectorXd c = beta.get();
+    auto expr = ad::dot(ad::constant_view(x_csc), ad::constant(c));
+    static_assert(std::is_same_v<decltype(expr), Constant<value_t, vec>>);
+    Eigen::VectorXd expected = x_dense * c;
+    for (size_t i = 0; i < rows; ++i) {
+        EXPECT_DOUBLE_EQ(expr.get()(i), expected(i));
+    }
+}
+
+// A sparse leaf caches nothing, and its adjoints are only its nnz.
+TEST_F(sparse_fixture, bind_cache_size)
+{
+    Var<value_t, sparse> x(x_csc);
+    auto expr = ad::dot(x, beta);
+    EXPECT_EQ(expr.bind_cache_size()(0), rows);
+    EXPECT_EQ(expr.bind_cache_size()(1), rows);
+    EXPECT_EQ(x.size(), 7ul);
+}
+
+TEST_F(sparse_fixture, var_copy)
+{
+    Var<value_t, sparse> x(x_csc);
+    Var<value_t, sparse> y(x);
+    EXPECT_NE(x.data(), y.data());
+    EXPECT_NE(x.data_adj(), y.data_adj());
+    EXPECT_DOUBLE_EQ(y.get().coeff(6, 2), 2.2);
+}
+
+} // namespace core
+} // namespace ad
@@ -1,7 +1,13 @@
 #include "gtest/gtest.h"
+#include <cmath>
 #include <fastad_bits/reverse/core/unary.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
 #include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/pow.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
 #include <testutil/base_fixture.hpp>
 
 namespace ad {
@@ -255,5 +261,97 @@ TEST_F(sum_fixture, vec_expr_constant)
     EXPECT_DOUBLE_EQ(res, actual);
 }
 
+// Sum (iter) SoA TEST
+
+struct sum_soa_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+
+    size_t n = 37;
+    std::vector<value_t> x;
+    Var<value_t> mu, sigma, emu, esigma;
+    std::vector<Var<value_t>> w, ew;
+
+    sum_soa_fixture()
+        : x(n), mu(0.3), sigma(1.7), emu(0.3), esigma(1.7), w(n), ew(n)
+    {
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = std::sin(0.37 * i);
+            w[i].get() = ew[i].get() = 0.1 * i - 1.;
+        }
+    }
+
+    template <class MuType, class SigmaType, class WType>
+    auto term(size_t i, const MuType& mu, const SigmaType& sigma, const WType& w) const
+    {
+        return -ad::constant(0.5) * ad::pow<2>((x[i] - mu * w) / sigma) -
+                ad::log(sigma) + ad::exp(-w * w) / (2. + ad::sin(mu));
+    }
+};
+
+TEST_F(sum_soa_fixture, matches_terms)
+{
+    using term_t = decltype(term(0, mu, sigma, w[0]));
+    static_assert(util::is_soa_aware_v<term_t>);
+
+    std::vector<size_t> idx(n);
+    for (size_t i = 0; i < n; ++i) idx[i] = i;
+    auto expr = ad::bind(ad::sum(idx.begin(), idx.end(),
+                [&](size_t i) { return term(i, mu, sigma, w[i]); }));
+    value_t f = ad::autodiff(expr, 2.);
+
+    // evaluate every term separately
+    value_t expected = 0;
+    for (size_t i = 0; i < n; ++i) {
+        auto e = ad::bind(term(i, emu, esigma, ew[i]));
+        expected += ad::autodiff(e, 2.);
+    }
+
+    auto near = [](value_t a, value_t b) {
+        EXPECT_NEAR(a, b, 1e-12 * (1. + std::abs(b)));
+    };
+    near(f, expected);
+    near(mu.get_adj(), emu.get_adj());
+    near(sigma.get_adj(), esigma.get_adj());
+    for (size_t i = 0; i < n; ++i) {
+        near(w[i].get_adj(), ew[i].get_adj());
+    }
+}
+
+TEST_F(sum_soa_fixture, bind_cache_size)
+{
+    std::vector<size_t> idx(n);
+    for (size_t i = 0; i < n; ++i) idx[i] = i;
+    auto expr = ad::sum(idx.begin(), idx.end(),
+                [&](size_t i) { return term(i, mu, sigma, w[i]); });
+    // every term has 24 nodes
+    const size_t size = n * 24 + 1;
+    EXPECT_EQ(expr.bind_cache_size()(0), size);
+    EXPECT_EQ(expr.bind_cache_size()(1), size);
+}
+
+TEST_F(sum_soa_fixture, interleaved)
+{
+    std::vector<size_t> idx(n);
+    for (size_t i = 0; i < n; ++i) idx[i] = i;
+    auto f = [&](size_t i) { return term(i, mu, sigma, w[i]); };
+    auto ef = [&](size_t i) { return term(i, emu, esigma, ew[i]); };
+    auto expr = ad::bind<layout::interleaved>(ad::sum(idx.begin(), idx.end(), f));
+    auto expected = ad::bind(ad::sum(idx.begin(), idx.end(), ef));
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), ad::autodiff(expected));
+    EXPECT_DOUBLE_EQ(mu.get_adj(), emu.get_adj());
+    EXPECT_DOUBLE_EQ(sigma.get_adj(), esigma.get_adj());
+}
+
+TEST_F(sum_soa_fixture, empty)
+{
+    std::vector<size_t> idx;
+    auto expr = ad::bind(ad::sum(idx.begin(), idx.end(),
+                [&](size_t i) { return term(i, mu, sigma, w[i]); }));
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), 0.);
+    EXPECT_DOUBLE_EQ(mu.get_adj(), 0.);
+}
+
 } // namespace core
 } // namespace ad
@@ -0,0 +1,140 @@
+#define _USE_MATH_DEFINES
+#include "gtest/gtest.h"
+#include <cmath>
+#include <vector>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/tape.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+
+namespace ad {
+namespace core {
+
+struct tape_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+
+    Tape<value_t> tape;
+};
+
+TEST_F(tape_fixture, leaf)
+{
+    auto x = tape.var(3.);
+    EXPECT_EQ(tape.size(), 1ul);
+    EXPECT_DOUBLE_EQ(ad::autodiff(x), 3.);
+    EXPECT_DOUBLE_EQ(x.get_adj(), 1.);
+}
+
+TEST_F(tape_fixture, unary)
+{
+    const value_t x_val = 0.3;
+    auto x = tape.var(x_val);
+    auto y = ad::exp(ad::sin(x)) + ad::sqrt(x) - ad::log(x) + ad::erf(x);
+    value_t f = ad::autodiff(y);
+
+    EXPECT_DOUBLE_EQ(f, std::exp(std::sin(x_val)) + std::sqrt(x_val) -
+                        std::log(x_val) + std::erf(x_val));
+    EXPECT_DOUBLE_EQ(x.get_adj(),
+                     std::cos(x_val) * std::exp(std::sin(x_val)) +
+                     0.5 / std::sqrt(x_val) - 1. / x_val +
+                     2. / std::sqrt(M_PI) * std::exp(-x_val * x_val));
+}
+
+TEST_F(tape_fixture, binary_constants)
+{
+    auto x = tape.var(2.);
+    auto y = tape.var(5.);
+    auto z = (2. * x - y / 4.) * (1. - x) / y + 3.;
+    ad::autodiff(z, 2.);
+
+    // z = (2x - y/4)(1 - x)/y + 3
+    EXPECT_DOUBLE_EQ(z.get_value(), (4. - 1.25) * (-1.) / 5. + 3.);
+    EXPECT_DOUBLE_EQ(x.get_adj(), 2. * (2. * (1. - 2.) - (4. - 1.25)) / 5.);
+    EXPECT_DOUBLE_EQ(y.get_adj(), 2. * (-0.25 * (1. - 2.) / 5. -
+                                        (4. - 1.25) * (1. - 2.) / 25.));
+}
+
+// The tape records a different graph depending on the data.
+TEST_F(tape_fixture, data_dependent)
+{
+    auto f = [&](value_t x_val, value_t& dfdx) {
+        tape.clear();
+        auto x = tape.var(x_val);
+        auto y = x;
+        while (y < 100.) y *= x;
+        if (y > 200.) y = -y;
+        auto out = ad::autodiff(y);
+        dfdx = x.get_adj();
+        return out;
+    };
+
+    value_t dfdx = 0;
+    // x^3
+    EXPECT_DOUBLE_EQ(f(5., dfdx), 125.);
+    EXPECT_DOUBLE_EQ(dfdx, 3. * 25.);
+    // -x^4
+    EXPECT_DOUBLE_EQ(f(4., dfdx), -256.);
+    EXPECT_DOUBLE_EQ(dfdx, -4. * 64.);
+}
+
+// Tape leaves created from Var accumulate into the Var adjoints
+// and agree with the expression template engine.
+TEST_F(tape_fixture, var_leaves)
+{
+    Var<value_t> x(0.7), y(-1.3);
+    Var<value_t> ex(0.7), ey(-1.3);
+
+    auto tx = tape.var(x);
+    auto ty = tape.var(y);
+    auto tw = tx * ty - ad::cos(tx);
+    auto tf = ty * tw + ad::exp(tw - tx);
+    value_t f = ad::autodiff(tf);
+
+    Var<value_t> w;
+    auto expr = ad::bind((w = ex * ey - ad::cos(ex),
+                          ey * w + ad::exp(w - ex)));
+    value_t expected = ad::autodiff(expr);
+
+    EXPECT_DOUBLE_EQ(f, expected);
+    EXPECT_DOUBLE_EQ(x.get_adj(), ex.get_adj());
+    EXPECT_DOUBLE_EQ(y.get_adj(), ey.get_adj());
+
+    // second sweep accumulates like Var adjoints do
+    ad::autodiff(tf);
+    EXPECT_DOUBLE_EQ(x.get_adj(), 2 * ex.get_adj());
+    EXPECT_DOUBLE_EQ(y.get_adj(), 2 * ey.get_adj());
+}
+
+// Sweeping from an intermediate only propagates the entries it depends on.
+TEST_F(tape_fixture, intermediate)
+{
+    auto x = tape.var(2.);
+    auto y = x * x;
+    auto z = y * x;
+    ad::autodiff(y);
+    EXPECT_DOUBLE_EQ(x.get_adj(), 4.);
+    ad::autodiff(z);
+    EXPECT_DOUBLE_EQ(x.get_adj(), 12.);
+    EXPECT_DOUBLE_EQ(y.get_adj(), 2.);
+}
+
+TEST_F(tape_fixture, clear_keeps_recording)
+{
+    auto x = tape.var(1.);
+    x = x + 1.;
+    EXPECT_EQ(tape.size(), 2ul);
+    tape.clear();
+    EXPECT_EQ(tape.size(), 0ul);
+    auto y = tape.var(2.);
+    auto z = y * y;
+    EXPECT_DOUBLE_EQ(ad::autodiff(z), 4.);
+    EXPECT_DOUBLE_EQ(y.get_adj(), 4.);
+}
+
+} // namespace core
+} // namespace ad
@@ -0,0 +1,64 @@
+#include <testutil/base_fixture.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/trace.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+
+namespace ad {
+namespace core {
+
+struct trace_fixture : base_fixture
+{
+protected:
+    using unary_t = MockUnary;
+    using mat_unary_t = UnaryNode<unary_t, mat_expr_view_t>;
+    using trace_t = TraceNode<mat_expr_view_t>;
+    using trace_unary_t = TraceNode<mat_unary_t>;
+
+    value_t seed = 3.14;
+    trace_t trace;
+    trace_unary_t trace_unary;
+
+    trace_fixture()
+        : base_fixture()
+        , trace{mat_expr}
+        , trace_unary{{mat_expr}}
+    {
+        this->bind(trace_unary);
+        trace.bind_cache({val_buf.data(), adj_buf.data()});
+    }
+};
+
+// trace of a non-square matrix sums its leading diagonal
+TEST_F(trace_fixture, trace)
+{
+    check_eq(trace.feval(), 3.1 + 5.1);
+    trace.beval(seed);
+    Eigen::MatrixXd adj(2, 3);
+    adj << seed, 0, 0,
+           0, seed, 0;
+    check_eq(mat_expr.get_adj(), adj);
+}
+
+TEST_F(trace_fixture, trace_unary)
+{
+    check_eq(trace_unary.feval(), 2 * (3.1 + 5.1));
+    trace_unary.beval(seed);
+    Eigen::MatrixXd adj(2, 3);
+    adj << 2 * seed, 0, 0,
+           0, 2 * seed, 0;
+    check_eq(mat_expr.get_adj(), adj);
+}
+
+TEST_F(trace_fixture, trace_const)
+{
+    auto x = ad::constant(mat_expr.get());
+    auto res = ad::trace(x);
+    static_assert(std::is_same_v<
+            std::decay_t<decltype(res)>,
+            Constant<value_t, scl>
+            >);
+    check_eq(res.get(), 3.1 + 5.1);
+}
+
+} // namespace core
+} // namespace ad
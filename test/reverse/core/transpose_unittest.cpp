@@ -0,0 +1,93 @@
+#include <testutil/base_fixture.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/transpose.hpp>
+
+namespace ad {
+namespace core {
+
+struct transpose_fixture : base_fixture
+{
+protected:
+    using transpose_t = TransposeNode<mat_expr_view_t>;
+
+    Eigen::ArrayXXd seed;
+    transpose_t transpose;
+
+    transpose_fixture()
+        : base_fixture()
+        , seed(3, 2)
+        , transpose{mat_expr}
+    {
+        seed << 2.34, -3.2,
+                3.4, 1.23455,
+                0.1, 0.5;
+        this->bind(transpose);
+    }
+};
+
+TEST_F(transpose_fixture, transpose)
+{
+    Eigen::MatrixXd actual = mat_expr.get().transpose();
+    check_eq(transpose.feval(), actual);
+    transpose.beval(seed);
+    check_eq(mat_expr.get_adj(), seed.matrix().transpose());
+}
+
+TEST_F(transpose_fixture, transpose_scalar_seed)
+{
+    transpose.feval();
+    transpose.beval(2.);
+    check_eq(mat_expr.get_adj(), Eigen::MatrixXd::Constant(2, 3, 2.));
+}
+
+// the seed is passed down without being copied into an adjoint cache
+TEST_F(transpose_fixture, transpose_bind_cache_size)
+{
+    auto size = transpose.single_bind_cache_size();
+    EXPECT_EQ(size(0), 6ul);
+    EXPECT_EQ(size(1), 0ul);
+}
+
+// sum(A^T A) = sum_{i,j} (A^T A)_{ij}, whose adjoint is A 1 1^T + A 1 1^T
+TEST_F(transpose_fixture, transpose_dot)
+{
+    auto expr = ad::bind(ad::sum(ad::dot(ad::transpose(mat_expr), mat_expr)));
+    Eigen::MatrixXd a = mat_expr.get();
+    check_eq(ad::evaluate(expr), (a.transpose() * a).sum());
+    ad::autodiff(expr);
+    Eigen::MatrixXd ones = Eigen::MatrixXd::Ones(3, 3);
+    check_near(mat_expr.get_adj(), 2 * a * ones, 1e-14);
+}
+
+TEST_F(transpose_fixture, transpose_fixed)
+{
+    Var<value_t, fixed_mat<2, 3>> x;
+    x.get() = mat_expr.get();
+    auto node = ad::transpose(x);
+    static_assert(std::is_same_v<
+            typename util::shape_traits<decltype(node)>::shape_t,
+            fixed_mat<3, 2>
+            >);
+    auto expr = ad::bind(ad::sum(node));
+    check_eq(ad::autodiff(expr), mat_expr.get().sum());
+    check_eq(x.get_adj(), Eigen::MatrixXd::Ones(2, 3));
+}
+
+TEST_F(transpose_fixture, transpose_const)
+{
+    auto x = ad::constant(mat_expr.get());
+    auto res = ad::transpose(x);
+    static_assert(std::is_same_v<
+            std::decay_t<decltype(res)>,
+            Constant<value_t, mat>
+            >);
+    Eigen::MatrixXd actual = mat_expr.get().transpose();
+    check_eq(res.get(), actual);
+}
+
+} // namespace core
+} // namespace ad
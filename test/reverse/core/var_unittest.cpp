@@ -27,6 +27,8 @@ TEST_F(var_fixture, var_ctors)
     test_ctor(scl_v_t());
     test_ctor(vec_v_t(1));
     test_ctor(mat_v_t(1,2));
+    test_ctor(Var<value_t, fixed_vec<3>>());
+    test_ctor(Var<value_t, fixed_mat<2,3>>());
 }
 
 } // namespace core
@@ -0,0 +1,174 @@
+#include "gtest/gtest.h"
+#include <sstream>
+#include <vector>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/fuse.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/if_else.hpp>
+#include <fastad_bits/reverse/core/map_sum.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/visit.hpp>
+#include <fastad_bits/reverse/stat/normal.hpp>
+
+namespace ad {
+namespace core {
+
+struct visit_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+
+    Var<value_t> x{0.5}, y{2.}, w;
+    Var<value_t, vec> v{4};
+    std::vector<value_t> d = {1., 2., 3.};
+};
+
+TEST_F(visit_fixture, pre_order)
+{
+    auto expr = ad::sin(x) * y + x;
+    std::vector<std::string> names;
+    std::vector<size_t> depths;
+    ad::visit(expr, [&](const auto& node, size_t depth) {
+        names.push_back(util::type_name<std::decay_t<decltype(node)>>());
+        depths.push_back(depth);
+    });
+    std::vector<std::string> expected_names = {
+        "BinaryNode", "BinaryNode", "UnaryNode", "VarView", "VarView", "VarView"
+    };
+    std::vector<size_t> expected_depths = {0, 1, 2, 3, 2, 1};
+    EXPECT_EQ(names, expected_names);
+    EXPECT_EQ(depths, expected_depths);
+    EXPECT_EQ(ad::node_count(expr), 6ul);
+    EXPECT_EQ(ad::expr_depth(expr), 3ul);
+}
+
+// Placeholders are not children, leaves viewing the same values are one leaf,
+// and containers of expressions visit every element.
+TEST_F(visit_fixture, leaf_set)
+{
+    auto expr = (w = x * y,
+                 ad::sum(d.begin(), d.end(), [&](value_t di) { return w * di; }) +
+                 ad::if_else(x < y, ad::sum(v), ad::constant(1.)));
+    auto leaves = ad::leaf_set(expr);
+    ASSERT_EQ(leaves.size(), 4ul);
+    EXPECT_EQ(leaves[0].first, x.data());
+    EXPECT_EQ(leaves[1].first, y.data());
+    EXPECT_EQ(leaves[2].first, w.data());
+    EXPECT_EQ(leaves[3].first, v.data());
+    EXPECT_EQ(leaves[3].second, 4ul);
+}
+
+TEST_F(visit_fixture, stat)
+{
+    auto expr = ad::normal_adj_log_pdf(v, x, y);
+    EXPECT_EQ(ad::node_count(expr), 4ul);
+    EXPECT_EQ(ad::leaf_set(expr).size(), 3ul);
+}
+
+TEST_F(visit_fixture, map_sum)
+{
+    auto expr = ad::map_sum(3, [&](size_t i) { return x * d[i]; });
+    EXPECT_EQ(ad::node_count(expr), 4ul);
+}
+
+// Nodes held in the vector of a sum are counted, nodes stored inline are not counted twice.
+TEST_F(visit_fixture, object_bytes)
+{
+    auto inline_expr = ad::sin(x) * y + x;
+    EXPECT_EQ(ad::object_bytes(inline_expr), sizeof(inline_expr));
+
+    auto term = [&](value_t di) { return ad::sin(x * di) * y; };
+    auto expr = ad::sum(d.begin(), d.end(), term) + x;
+    EXPECT_EQ(ad::object_bytes(expr),
+              sizeof(expr) + d.size() * sizeof(decltype(term(0.))));
+
+    auto expr_bind = ad::bind(ad::sum(d.begin(), d.end(), term));
+    EXPECT_EQ(ad::object_bytes(expr_bind),
+              sizeof(expr_bind.get()) + d.size() * sizeof(decltype(term(0.))));
+}
+
+TEST_F(visit_fixture, cache_bytes_by_type)
+{
+    auto expr = ad::bind(ad::sum(ad::sin(v) * ad::cos(v)) + x);
+    auto bytes = ad::cache_bytes_by_type(expr);
+    EXPECT_EQ(bytes["UnaryNode"], 16 * sizeof(value_t));
+    EXPECT_EQ(bytes["VarView"], 0ul);
+
+    size_t total = 0;
+    for (const auto& entry : bytes) total += entry.second;
+    auto size = expr.get().bind_cache_size();
+    EXPECT_EQ(total, (size(0) + size(1)) * sizeof(value_t));
+
+    std::ostringstream os;
+    ad::memory_report(expr, os);
+    EXPECT_NE(os.str().find("nodes:        8"), std::string::npos);
+    EXPECT_NE(os.str().find("UnaryNode"), std::string::npos);
+}
+
+// the total of cache_bytes_by_type
+template <class ExprType>
+inline size_t cache_bytes(const ExprType& expr)
+{
+    size_t total = 0;
+    for (const auto& entry : ad::cache_bytes_by_type(expr)) total += entry.second;
+    return total;
+}
+
+TEST_F(visit_fixture, cache_bytes_fuse)
+{
+    Var<value_t, vec> u(100);
+    auto expr = ad::bind(ad::sum(ad::fuse(ad::exp(u - x) * u)));
+    auto bytes = ad::cache_bytes_by_type(expr);
+    EXPECT_EQ(bytes["FusedNode"], 200 * sizeof(value_t));
+    EXPECT_EQ(bytes["BinaryNode"], 0ul);
+    EXPECT_EQ(bytes["UnaryNode"], 0ul);
+    EXPECT_EQ(cache_bytes(expr),
+              expr.get().bind_cache_size().sum() * sizeof(value_t));
+}
+
+TEST_F(visit_fixture, cache_bytes_soa)
+{
+    auto expr = ad::bind(ad::sum(d.begin(), d.end(), [&](value_t di) {
+        return ad::sin(x) * di + y;
+    }));
+    auto bytes = ad::cache_bytes_by_type(expr);
+    EXPECT_EQ(bytes["SumIterNode"], cache_bytes(expr));
+    EXPECT_EQ(bytes["UnaryNode"], 0ul);
+    EXPECT_EQ(cache_bytes(expr),
+              expr.get().bind_cache_size().sum() * sizeof(value_t));
+}
+
+TEST_F(visit_fixture, cache_bytes_cse)
+{
+    CacheArena arena;
+    auto expr = ad::bind(ad::sin(v) * ad::sin(v) + ad::sin(v), arena, ad::cse);
+    auto bytes = ad::cache_bytes_by_type(expr);
+
+    // only the first sin is bound
+    EXPECT_EQ(bytes["UnaryNode"], 8 * sizeof(value_t));
+    EXPECT_EQ(bytes["BinaryNode"], 16 * sizeof(value_t));
+    EXPECT_EQ(cache_bytes(expr), arena.bytes_in_use());
+    EXPECT_LT(cache_bytes(expr),
+              expr.get().bind_cache_size().sum() * sizeof(value_t));
+}
+
+TEST_F(visit_fixture, cache_bytes_eq)
+{
+    auto expr = ad::bind((w = ad::sin(x) * y, ad::map_sum(3, [&](size_t i) {
+        return ad::cos(w) * d[i];
+    })));
+    auto bytes = ad::cache_bytes_by_type(expr);
+
+    // the root of the assigned expression views w
+    EXPECT_EQ(bytes["EqNode"], 0ul);
+    EXPECT_EQ(bytes["BinaryNode"], 2 * sizeof(value_t));
+    EXPECT_EQ(cache_bytes(expr),
+              expr.get().bind_cache_size().sum() * sizeof(value_t));
+}
+
+} // namespace core
+} // namespace ad
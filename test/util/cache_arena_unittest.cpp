@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <fastad_bits/util/cache_arena.hpp>
+
+namespace ad {
+namespace util {
+
+struct cache_arena_fixture : ::testing::Test
+{
+protected:
+    CacheArena arena{256};
+};
+
+TEST_F(cache_arena_fixture, default_empty)
+{
+    EXPECT_EQ(arena.bytes_in_use(), 0ul);
+    EXPECT_EQ(arena.high_water_mark(), 0ul);
+    EXPECT_EQ(arena.capacity(), 0ul);
+    EXPECT_EQ(arena.n_blocks(), 0ul);
+}
+
+TEST_F(cache_arena_fixture, allocate_aligned)
+{
+    double* x = arena.allocate<double>(3);
+    double* y = arena.allocate<double>(1);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(x) % CacheArena::alignment, 0ul);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(y) % CacheArena::alignment, 0ul);
+    EXPECT_LE(x + 3, y);
+    EXPECT_EQ(arena.n_blocks(), 1ul);
+    EXPECT_GE(arena.bytes_in_use(), 4 * sizeof(double));
+    EXPECT_EQ(arena.bytes_in_use(), arena.high_water_mark());
+}
+
+TEST_F(cache_arena_fixture, grow)
+{
+    arena.allocate<double>(20);
+    EXPECT_EQ(arena.n_blocks(), 1ul);
+    // does not fit in first block
+    double* x = arena.allocate<double>(100);
+    EXPECT_EQ(arena.n_blocks(), 2ul);
+    for (size_t i = 0; i < 100; ++i) x[i] = i;
+    EXPECT_GE(arena.capacity(), 120 * sizeof(double));
+}
+
+TEST_F(cache_arena_fixture, reset_coalesce)
+{
+    arena.allocate<double>(20);
+    arena.allocate<double>(100);
+    size_t hwm = arena.high_water_mark();
+    size_t capacity = arena.capacity();
+    arena.reset();
+    EXPECT_EQ(arena.bytes_in_use(), 0ul);
+    EXPECT_EQ(arena.high_water_mark(), hwm);
+    EXPECT_EQ(arena.n_blocks(), 1ul);
+    EXPECT_EQ(arena.capacity(), capacity);
+
+    // same workload fits in single block now
+    arena.allocate<double>(20);
+    arena.allocate<double>(100);
+    EXPECT_EQ(arena.n_blocks(), 1ul);
+    EXPECT_EQ(arena.high_water_mark(), hwm);
+}
+
+TEST_F(cache_arena_fixture, reset_reuse)
+{
+    double* x = arena.allocate<double>(4);
+    arena.reset();
+    double* y = arena.allocate<double>(4);
+    EXPECT_EQ(x, y);
+}
+
+} // namespace util
+} // namespace ad
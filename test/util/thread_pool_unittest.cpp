@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include <fastad_bits/util/thread_pool.hpp>
+
+namespace ad {
+namespace util {
+
+struct thread_pool_fixture : ::testing::Test
+{
+protected:
+    ThreadPool pool{3};
+};
+
+TEST_F(thread_pool_fixture, size)
+{
+    EXPECT_EQ(pool.size(), 3ul);
+    ThreadPool empty(0);
+    EXPECT_EQ(empty.size(), 1ul);
+}
+
+TEST_F(thread_pool_fixture, submit_wait)
+{
+    std::atomic<int> count(0);
+    for (int i = 0; i < 100; ++i) {
+        pool.submit([&]() { ++count; });
+    }
+    pool.wait();
+    EXPECT_EQ(count.load(), 100);
+}
+
+TEST_F(thread_pool_fixture, parallel_for_covers_range)
+{
+    std::vector<int> hits(10, 0);
+    pool.parallel_for(hits.size(),
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) ++hits[i];
+        });
+    for (int h : hits) EXPECT_EQ(h, 1);
+}
+
+TEST_F(thread_pool_fixture, parallel_for_small_range)
+{
+    std::atomic<int> n_blocks(0);
+    pool.parallel_for(2, [&](size_t begin, size_t end) {
+        EXPECT_EQ(end, begin + 1);
+        ++n_blocks;
+    });
+    EXPECT_EQ(n_blocks.load(), 2);
+    pool.parallel_for(0, [&](size_t, size_t) { ++n_blocks; });
+    EXPECT_EQ(n_blocks.load(), 2);
+}
+
+TEST_F(thread_pool_fixture, rethrow)
+{
+    pool.submit([]() { throw std::runtime_error("error"); });
+    pool.submit([]() {});
+    EXPECT_THROW(pool.wait(), std::runtime_error);
+    // error is cleared after being rethrown
+    pool.submit([]() {});
+    EXPECT_NO_THROW(pool.wait());
+}
+
+} // namespace util
+} // namespace ad
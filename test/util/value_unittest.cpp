@@ -16,5 +16,13 @@ TEST_F(value_fixture, ones_scl)
     EXPECT_DOUBLE_EQ(x, 1.);
 }
 
+TEST_F(value_fixture, literal)
+{
+    static_assert(std::is_same_v<decltype(literal<float>(0.5)), float>);
+    static_assert(std::is_same_v<decltype(literal<Eigen::ArrayXf>(0.5)), float>);
+    static_assert(std::is_same_v<decltype(literal<Eigen::MatrixXd>(0.5)), double>);
+    EXPECT_FLOAT_EQ(literal<float>(0.1), 0.1f);
+}
+
 } // namespace util
 } // namespace ad